@@ -12,6 +12,10 @@
 /* ヘッダサイズ */
 #define SRLA_HEADER_SIZE            30
 
+/* 総サンプル数が未確定であることを示すヘッダのサンプル数
+ * ストリーミングエンコードの途中で出力されるヘッダに記録される */
+#define SRLA_NUM_SAMPLES_UNKNOWN    0xFFFFFFFFUL
+
 /* 処理可能な最大チャンネル数 */
 #define SRLA_MAX_NUM_CHANNELS       8
 
@@ -24,6 +28,9 @@
 /* パラメータプリセット数 */
 #define SRLA_NUM_PARAMETER_PRESETS  7
 
+/* 並列エンコード・デコードで使用できる最大スレッド数 */
+#define SRLA_MAX_NUM_THREADS        256
+
 
 /* API結果型 */
 typedef enum SRLAApiResultTag {
@@ -37,6 +44,13 @@ typedef enum SRLAApiResultTag {
     SRLA_APIRESULT_NG                       /* 分類不能な失敗               */
 } SRLAApiResult;
 
+/* インターリーブPCMのサンプル形式 */
+typedef enum SRLAPcmFormatTag {
+    SRLA_PCM_FORMAT_INT16 = 0,              /* 16bit整数（int16_t）                      */
+    SRLA_PCM_FORMAT_INT24,                  /* 24bit整数（3バイト詰め リトルエンディアン） */
+    SRLA_PCM_FORMAT_INT32                   /* 32bit整数（int32_t）                      */
+} SRLAPcmFormat;
+
 /* ヘッダ情報 */
 struct SRLAHeader {
     uint32_t format_version;                        /* フォーマットバージョン         */
@@ -9,11 +9,22 @@ struct SRLADecoderConfig {
     uint32_t max_num_channels; /* 最大チャンネル数 */
     uint32_t max_num_parameters; /* 最大パラメータ数 */
     uint8_t check_checksum; /* チェックサムによるデータ破損検査を行うか？ 1:ON それ以外:OFF */
+    uint32_t max_num_threads; /* 並列デコードで使用する最大スレッド数（0は1と同じ） */
+    uint32_t max_num_samples_per_block; /* ストリーミング・インターリーブ出力のデコードで扱うブロックあたり最大サンプル数
+                                         * （0のときインターリーブ出力のデコードは使用できない） */
 };
 
 /* デコーダハンドル */
 struct SRLADecoder;
 
+/* ストリーミングデコーダハンドル */
+struct SRLAStreamDecoder;
+
+/* ストリーミングデコーダの出力コールバック
+ * ブロックのデコードが完了するたびに、そのブロックのサンプルを渡す */
+typedef void (*SRLAStreamDecoder_OutputCallback)(
+        const int32_t *const *samples, uint32_t num_channels, uint32_t num_samples, void *user_data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -48,6 +59,68 @@ SRLAApiResult SRLADecoder_DecodeWhole(
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples);
 
+/* 単一データブロックをインターリーブしてデコード
+ * bufferにはformat形式でヘッダのチャンネル数分インターリーブしたサンプルを書き出す
+ * コンフィグのmax_num_samples_per_blockを越えるブロックはデコードできない */
+SRLAApiResult SRLADecoder_DecodeBlockInterleaved(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        void *buffer, SRLAPcmFormat format, uint32_t buffer_num_samples,
+        uint32_t *decode_size, uint32_t *num_decode_samples);
+
+/* ヘッダを含めて全ブロックをインターリーブしてデコード */
+SRLAApiResult SRLADecoder_DecodeWholeInterleaved(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        void *buffer, SRLAPcmFormat format, uint32_t buffer_num_samples);
+
+/* ヘッダを含めて全ブロックを複数スレッドでデコード
+ * ブロックヘッダを走査してデータを連続したブロック区間に分け、各スレッドで並列にデコードする */
+SRLAApiResult SRLADecoder_DecodeWholeParallel(
+        struct SRLADecoder *decoder, uint32_t num_threads,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples);
+
+/* 指定サンプルを含むブロックの探索
+ * データ末尾にシークテーブルがあれば二分探索で直前のシーク点を求め、そこからブロックヘッダを辿る
+ * シークテーブルがなければ先頭ブロックから辿る。事前にヘッダをセットしておくこと
+ * block_offsetにデータ先頭からのブロック位置、num_skip_samplesにブロック先頭から読み捨てるサンプル数を返す */
+SRLAApiResult SRLADecoder_Seek(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t sample_index,
+        uint32_t *block_offset, uint32_t *num_skip_samples);
+
+/* ストリーミングデコーダハンドルの作成に必要なワークサイズの計算 */
+int32_t SRLAStreamDecoder_CalculateWorkSize(const struct SRLADecoderConfig *config);
+
+/* ストリーミングデコーダハンドルの作成 */
+struct SRLAStreamDecoder *SRLAStreamDecoder_Create(const struct SRLADecoderConfig *config, void *work, int32_t work_size);
+
+/* ストリーミングデコーダハンドルの破棄 */
+void SRLAStreamDecoder_Destroy(struct SRLAStreamDecoder *stream_decoder);
+
+/* ストリーミングデコードの開始
+ * 以降に入力されるデータの先頭はヘッダでなければならない */
+SRLAApiResult SRLAStreamDecoder_Start(
+        struct SRLAStreamDecoder *stream_decoder,
+        SRLAStreamDecoder_OutputCallback output_callback, void *user_data);
+
+/* 任意サイズのデータを入力
+ * ブロックが揃うたびにデコードしてコールバックで出力する
+ * 同期コードの不一致やデータ破損を検知したら、次の同期コードを探して再同期する */
+SRLAApiResult SRLAStreamDecoder_Push(
+        struct SRLAStreamDecoder *stream_decoder, const uint8_t *data, uint32_t data_size);
+
+/* ストリーミングデコードで取得したヘッダの取得
+ * ヘッダ分のデータが入力されるまではSRLA_APIRESULT_INSUFFICIENT_DATAを返す */
+SRLAApiResult SRLAStreamDecoder_GetHeader(
+        const struct SRLAStreamDecoder *stream_decoder, struct SRLAHeader *header);
+
+/* ストリーミングデコードの終了
+ * 途中で再同期が発生していたらSRLA_APIRESULT_DETECT_DATA_CORRUPTIONを、
+ * 末尾に不完全なブロックが残っていたらSRLA_APIRESULT_INSUFFICIENT_DATAを返す */
+SRLAApiResult SRLAStreamDecoder_Finish(struct SRLAStreamDecoder *stream_decoder);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -15,6 +15,9 @@ struct SRLAEncodeParameter {
     uint32_t ltp_order; /* LTP次数 */
     uint32_t num_svr_filter_learning_iteration; /* SVRフィルタ学習繰り返し回数 */
     uint8_t preset; /* エンコードパラメータプリセット */
+    uint8_t estimate_partition_cost; /* 可変ブロック分割探索で推定符号長を使うか（1:推定符号長 0:実際の符号長） */
+    uint8_t sliding_lookahead; /* 先読み区間の先頭部分の分割だけを確定させ、区間をスライドさせながら探索するか（1:スライド 0:区間毎に全て確定） 補足）スライド時は先読みサンプル数を最大ブロックサンプル数程度にすると高速 */
+    uint32_t seek_table_interval; /* シークテーブルに記録するシーク点の間隔[サンプル]（0のときシークテーブルを出力しない） */
 };
 
 /* エンコーダコンフィグ */
@@ -24,6 +27,7 @@ struct SRLAEncoderConfig {
     uint32_t max_num_samples_per_block; /* ブロックあたりサンプル数の上限値 */
     uint32_t max_num_lookahead_samples; /* 最大先読みサンプル数 */
     uint32_t max_num_parameters; /* 最大のパラメータ数 */
+    uint32_t max_num_threads; /* 並列エンコードで使用する最大スレッド数（0は1と同じ） */
 };
 
 /* エンコーダハンドル */
@@ -33,6 +37,14 @@ struct SRLAEncoder;
 typedef void (*SRLAEncoder_EncodeBlockCallback)(
     uint32_t num_samples, uint32_t progress_samples, const uint8_t* encoded_block_data, uint32_t block_data_size);
 
+/* ストリーミングエンコーダハンドル */
+struct SRLAStreamEncoder;
+
+/* ストリーミングエンコーダの出力コールバック
+ * ヘッダとエンコードが確定したブロックのデータを出力順に渡す */
+typedef void (*SRLAStreamEncoder_OutputCallback)(
+    const uint8_t *data, uint32_t data_size, void *user_data);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -65,12 +77,28 @@ SRLAApiResult SRLAEncoder_EncodeBlock(
     const int32_t *const *input, uint32_t num_samples,
     uint8_t *data, uint32_t data_size, uint32_t *output_size);
 
-/* 最適なブロック分割探索を含めたエンコード */
+/* インターリーブ入力の単一データブロックエンコード
+ * inputはformat形式でヘッダのチャンネル数分インターリーブしたサンプル
+ * SRLAEncoder_EncodeBlockに同じサンプルをチャンネル毎に渡した場合と同一の出力になる */
+SRLAApiResult SRLAEncoder_EncodeBlockInterleaved(
+    struct SRLAEncoder *encoder,
+    const void *input, SRLAPcmFormat format, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size);
+
+/* 最適なブロック分割探索を含めたエンコード（単一スレッド） */
 SRLAApiResult SRLAEncoder_EncodeOptimalPartitionedBlock(
     struct SRLAEncoder *encoder,
     const int32_t *const *input, uint32_t num_samples,
     uint8_t *data, uint32_t data_size, uint32_t *output_size);
 
+/* 最適なブロック分割探索を含めたエンコード
+ * ブロック分割探索のコスト計算をnum_threadsスレッドで並列に行う（num_threadsはコンフィグの最大スレッド数以下）
+ * 出力はSRLAEncoder_EncodeOptimalPartitionedBlockと同一になる */
+SRLAApiResult SRLAEncoder_EncodeOptimalPartitionedBlockParallel(
+    struct SRLAEncoder *encoder, uint32_t num_threads,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size);
+
 /* ヘッダ含めファイル全体をエンコード */
 SRLAApiResult SRLAEncoder_EncodeWhole(
     struct SRLAEncoder *encoder,
@@ -78,6 +106,54 @@ SRLAApiResult SRLAEncoder_EncodeWhole(
     uint8_t *data, uint32_t data_size, uint32_t *output_size,
     SRLAEncoder_EncodeBlockCallback encode_callback);
 
+/* ヘッダ含めファイル全体を複数スレッドでエンコード
+ * 先読みサンプル数単位の区間を各スレッドに割り当てて並列にエンコードする
+ * 先読み区間をスライドさせる場合は区間を順に処理し、ブロック分割探索のコスト計算を並列に行う
+ * 出力はSRLAEncoder_EncodeWholeと同一になる */
+SRLAApiResult SRLAEncoder_EncodeWholeParallel(
+    struct SRLAEncoder *encoder, uint32_t num_threads,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    SRLAEncoder_EncodeBlockCallback encode_callback);
+
+/* シークテーブルの付加
+ * dataの先頭encoded_data_sizeバイトのエンコード済みデータのブロックヘッダを辿り、
+ * seek_table_interval サンプル以上離れたブロック毎にシーク点を記録したシークテーブルを末尾に書き出す
+ * output_sizeにはシークテーブルを含めた全体のサイズを返す */
+SRLAApiResult SRLAEncoder_AppendSeekTable(
+    uint8_t *data, uint32_t data_size, uint32_t encoded_data_size,
+    uint32_t seek_table_interval, uint32_t *output_size);
+
+/* ストリーミングエンコーダハンドル作成に必要なワークサイズ計算 */
+int32_t SRLAStreamEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config);
+
+/* ストリーミングエンコーダハンドル作成 */
+struct SRLAStreamEncoder *SRLAStreamEncoder_Create(const struct SRLAEncoderConfig *config, void *work, int32_t work_size);
+
+/* ストリーミングエンコーダハンドルの破棄 */
+void SRLAStreamEncoder_Destroy(struct SRLAStreamEncoder *stream_encoder);
+
+/* ストリーミングエンコードの開始
+ * 総サンプル数をSRLA_NUM_SAMPLES_UNKNOWNとした暫定ヘッダをコールバックで出力する
+ * offset_lshiftは入力全体でオフセットされている左シフト量（不明な場合は0）
+ * 以降のSRLAStreamEncoder_Pushで下位offset_lshiftビットが0でないサンプルを入力するとエラーを返す
+ * シークテーブルは出力できないため、parameterのseek_table_intervalが0でない場合はエラーを返す
+ * （必要な場合は出力全体に対してSRLAEncoder_AppendSeekTableを使う） */
+SRLAApiResult SRLAStreamEncoder_Start(
+    struct SRLAStreamEncoder *stream_encoder, const struct SRLAEncodeParameter *parameter,
+    uint32_t offset_lshift, SRLAStreamEncoder_OutputCallback output_callback, void *user_data);
+
+/* 任意サンプル数の入力を追加
+ * 先読みサンプル数までを内部にバッファし、エンコードが確定したブロックをコールバックで出力する */
+SRLAApiResult SRLAStreamEncoder_Push(
+    struct SRLAStreamEncoder *stream_encoder, const int32_t *const *input, uint32_t num_samples);
+
+/* ストリーミングエンコードの終了
+ * バッファに残ったサンプルを全てエンコードして出力し、総サンプル数を記録した確定ヘッダをheader_dataに書き出す
+ * 出力先が書き戻し可能な場合は、先頭の暫定ヘッダを確定ヘッダで上書きする */
+SRLAApiResult SRLAStreamEncoder_Finish(
+    struct SRLAStreamEncoder *stream_encoder, uint8_t *header_data, uint32_t header_data_size);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
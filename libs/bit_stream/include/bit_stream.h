@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #include <limits.h>
 
@@ -26,7 +27,7 @@
 
 /* ビットストリーム構造体 */
 struct BitStream {
-    uint32_t bit_buffer; /* ビットの一時バッファ */
+    uint64_t bit_buffer; /* ビットの一時バッファ（[Reader]下位bit_countビットが未読, [Writer]下位32ビットを使用） */
     uint32_t bit_count; /* [Reader]バッファ残りビット数, [Writer]メモリ書き出しまでのビット数 */
     const uint8_t *memory_image; /* メモリ領域先頭 */
     const uint8_t *memory_tail;/* メモリ領域末尾 */
@@ -63,6 +64,65 @@ extern "C" uint32_t BitStream_NLZSoft(uint32_t x);
 uint32_t BitStream_NLZSoft(uint32_t x);
 #endif
 
+/* 64bit値のNLZの計算 */
+#if defined(__GNUC__)
+/* ビルトイン関数を使用 */
+#define BITSTREAM_NLZ64(x) (((x) > 0) ? (uint32_t)__builtin_clzll(x) : 64U)
+#else
+/* 上位・下位32bitに分けて計算 */
+#define BITSTREAM_NLZ64(x)\
+    ((((x) >> 32) > 0) ? BITSTREAM_NLZ((uint32_t)((x) >> 32)) : (32U + BITSTREAM_NLZ((uint32_t)(x))))
+#endif
+
+/* ビッグエンディアンで並んだ8バイトの読み出し（アラインメント不問） */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define BITSTREAM_LOAD_UINT64BE(dst, ptr)\
+    do {\
+        uint64_t __load;\
+        memcpy(&__load, (ptr), sizeof(uint64_t));\
+        (dst) = __builtin_bswap64(__load);\
+    } while (0)
+#elif defined(_MSC_VER)
+#include <stdlib.h>
+#define BITSTREAM_LOAD_UINT64BE(dst, ptr)\
+    do {\
+        uint64_t __load;\
+        memcpy(&__load, (ptr), sizeof(uint64_t));\
+        (dst) = _byteswap_uint64(__load);\
+    } while (0)
+#else
+#define BITSTREAM_LOAD_UINT64BE(dst, ptr)\
+    do {\
+        (dst) = ((uint64_t)(ptr)[0] << 56) | ((uint64_t)(ptr)[1] << 48)\
+            | ((uint64_t)(ptr)[2] << 40) | ((uint64_t)(ptr)[3] << 32)\
+            | ((uint64_t)(ptr)[4] << 24) | ((uint64_t)(ptr)[5] << 16)\
+            | ((uint64_t)(ptr)[6] <<  8) | ((uint64_t)(ptr)[7] <<  0);\
+    } while (0)
+#endif
+
+/* [Reader]バッファが56ビット以上になるまでメモリから補充（ビット数が56未満のときのみ使用）
+ * 8バイト以上残っていればバイト数分岐なしの8バイトロードで補充し、
+ * 終端付近では終端を越えないよう1バイトずつ補充する */
+#define BITSTREAM_READER_REFILL(stream)\
+    do {\
+        assert((stream)->bit_count < 56);\
+        if (((stream)->memory_tail - (stream)->memory_p) >= 8) {\
+            uint64_t __next;\
+            /* 空いているバイト数（1以上7以下） */\
+            const uint32_t __nbytes = (63 - (stream)->bit_count) >> 3;\
+            BITSTREAM_LOAD_UINT64BE(__next, (stream)->memory_p);\
+            (stream)->bit_buffer = ((stream)->bit_buffer << (8 * __nbytes)) | (__next >> (64 - 8 * __nbytes));\
+            (stream)->memory_p += __nbytes;\
+            (stream)->bit_count += 8 * __nbytes;\
+        } else {\
+            while (((stream)->bit_count <= 56) && ((stream)->memory_p < (stream)->memory_tail)) {\
+                (stream)->bit_buffer = ((stream)->bit_buffer << 8) | (stream)->memory_p[0];\
+                (stream)->memory_p++;\
+                (stream)->bit_count += 8;\
+            }\
+        }\
+    } while (0)
+
 #if !defined(BITSTREAM_USE_MACROS)
 
 #ifdef __cplusplus
@@ -96,6 +156,13 @@ void BitReader_GetBits(struct BitStream *stream, uint32_t *val, uint32_t nbits);
 /* つぎの1にぶつかるまで読み込み、その間に読み込んだ0のランレングスを取得 */
 void BitReader_GetZeroRunLength(struct BitStream *stream, uint32_t *runlength);
 
+/* 読み込み位置を進めずに nbits 取得（最大32bit）し、その値を右詰めして出力
+ * 終端を越えた分のビットは0で埋める */
+void BitReader_PeekBits(struct BitStream *stream, uint32_t *val, uint32_t nbits);
+
+/* nbits 読み飛ばす（直前のBitReader_PeekBitsで取得したビット数以下に限る） */
+void BitReader_SkipBits(struct BitStream *stream, uint32_t nbits);
+
 /* バッファにたまったビットをクリア */
 void BitStream_Flush(struct BitStream *stream);
 
@@ -112,9 +179,6 @@ extern "C" {
 /* 下位ビットを取り出すためのマスク */
 extern const uint32_t g_bitstream_lower_bits_mask[33];
 
-/* ラン長のパターンテーブル */
-extern const uint32_t g_bitstream_zerobit_runlength_table[0x100];
-
 #ifdef __cplusplus
 }
 #endif
@@ -309,8 +373,6 @@ extern const uint32_t g_bitstream_zerobit_runlength_table[0x100];
 /* nbits 取得（最大32bit）し、その値を右詰めして出力 */
 #define BitReader_GetBits(stream, val, nbits)\
     do {\
-        uint32_t __tmp, __nbits;\
-        \
         /* 引数チェック */\
         assert((void *)(stream) != NULL);\
         assert((void *)(val) != NULL);\
@@ -321,81 +383,97 @@ extern const uint32_t g_bitstream_zerobit_runlength_table[0x100];
         /* 入力可能な最大ビット数を越えてないか確認 */\
         assert((nbits) <= 32);\
         \
-        /* バッファから取り出す */\
-        if ((nbits) <= (stream)->bit_count) {\
-            (stream)->bit_count -= (nbits);\
-            (*(val)) = BITSTREAM_GETLOWERBITS((stream)->bit_buffer >> (stream)->bit_count, (nbits));\
-            break;\
+        /* バッファが足りなければ補充 */\
+        if ((nbits) > (stream)->bit_count) {\
+            BITSTREAM_READER_REFILL(stream);\
         }\
         \
-        /* 現在のバッファ容量よりも多くのビットが要求されたらメモリから読み出し */\
-        __nbits = (nbits);\
-        /* 残りのビットを上位ビットにセット */\
-        __nbits -= (stream)->bit_count;\
-        __tmp = BITSTREAM_GETLOWERBITS((stream)->bit_buffer, (stream)->bit_count) << __nbits;\
-        \
         /* 終端に達していないかチェック */\
-        assert((stream)->memory_p >= (stream)->memory_image);\
-        assert((stream)->memory_p < (stream)->memory_tail);\
+        assert((nbits) <= (stream)->bit_count);\
         \
-        /* メモリから読み出し */\
-        (stream)->bit_buffer\
-            = ((uint32_t)(stream)->memory_p[0] << 24) | ((uint32_t)(stream)->memory_p[1] << 16)\
-            | ((uint32_t)(stream)->memory_p[2] <<  8) | ((uint32_t)(stream)->memory_p[3] <<  0);\
-        (stream)->memory_p += 4;\
-        (stream)->bit_count = 32;\
-        \
-        /* 端数ビットの処理 残ったビット分をtmpの最上位ビットにセット */\
-        (stream)->bit_count -= __nbits;\
-        __tmp |= BITSTREAM_GETLOWERBITS((stream)->bit_buffer >> (stream)->bit_count, __nbits);\
-        \
-        /* 正常終了 */\
-        (*(val)) = __tmp;\
+        /* バッファから取り出す */\
+        (stream)->bit_count -= (nbits);\
+        (*(val)) = BITSTREAM_GETLOWERBITS((uint32_t)((stream)->bit_buffer >> (stream)->bit_count), (nbits));\
     } while (0)
 
 /* つぎの1にぶつかるまで読み込み、その間に読み込んだ0のランレングスを取得 */
 #define BitReader_GetZeroRunLength(stream, runlength)\
     do {\
-        uint32_t __run;\
+        uint32_t __run = 0;\
         \
         /* 引数チェック */\
         assert((void *)(stream) != NULL);\
         assert((void *)(runlength) != NULL);\
         \
-        /* 上位ビットからの連続する0を計測 */\
-        __run = BITSTREAM_NLZ(BITSTREAM_GETLOWERBITS((stream)->bit_buffer, (stream)->bit_count)) + (stream)->bit_count - 32;\
-        \
-        /* 読み込んだ分カウントを減らす */\
-        assert((stream)->bit_count >= __run);\
-        (stream)->bit_count -= __run;\
-        \
-        /* バッファが空の時 */\
-        while (!(stream)->bit_count) {\
-            /* 1バイト読み込み再度計測 */\
-            uint32_t __tmp_run;\
+        for (;;) {\
+            uint64_t __top;\
             \
-            /* 終端に達していないかチェック */\
-            assert((stream)->memory_p >= (stream)->memory_image);\
-            assert((stream)->memory_p < (stream)->memory_tail);\
+            /* バッファが空の時は補充 */\
+            if ((stream)->bit_count == 0) {\
+                BITSTREAM_READER_REFILL(stream);\
+                /* 終端に達していないかチェック */\
+                assert((stream)->bit_count > 0);\
+                if ((stream)->bit_count == 0) {\
+                    break;\
+                }\
+            }\
+            \
+            /* 未読のビットを最上位に詰め、上位ビットからの連続する0を計測 */\
+            __top = (stream)->bit_buffer << (64 - (stream)->bit_count);\
+            if (__top != 0) {\
+                const uint32_t __nlz = BITSTREAM_NLZ64(__top);\
+                /* 0の連続と続く1を読み込んだ分カウントを減らす */\
+                __run += __nlz;\
+                (stream)->bit_count -= __nlz + 1;\
+                break;\
+            }\
             \
-            /* メモリから読み出し ビットバッファにセットし直して再度ランを計測 */\
-            (stream)->bit_buffer = (stream)->memory_p[0];\
-            (stream)->memory_p++;\
-            /* テーブルによりラン長を取得 */\
-            __tmp_run = g_bitstream_zerobit_runlength_table[(stream)->bit_buffer];\
-            (stream)->bit_count = 8 - __tmp_run;\
-            /* ランを加算 */\
-            __run += __tmp_run;\
+            /* バッファ内は全て0 */\
+            __run += (stream)->bit_count;\
+            (stream)->bit_count = 0;\
         }\
         \
-        /* 続く1を空読み */\
-        assert((stream)->bit_count >= 1);\
-        (stream)->bit_count -= 1;\
-        \
         /* 正常終了 */\
         (*(runlength)) = __run;\
     } while (0)
 
+/* 読み込み位置を進めずに nbits 取得（最大32bit）し、その値を右詰めして出力
+ * 終端を越えた分のビットは0で埋める */
+#define BitReader_PeekBits(stream, val, nbits)\
+    do {\
+        /* 引数チェック */\
+        assert((void *)(stream) != NULL);\
+        assert((void *)(val) != NULL);\
+        \
+        /* 読み込みモードでない場合はアサート */\
+        assert((stream)->flags & BITSTREAM_FLAGS_MODE_READ);\
+        \
+        /* 取得可能な最大ビット数を越えてないか確認 */\
+        assert((nbits) <= 32);\
+        \
+        /* バッファが足りなければ補充 */\
+        if ((nbits) > (stream)->bit_count) {\
+            BITSTREAM_READER_REFILL(stream);\
+        }\
+        \
+        if ((nbits) <= (stream)->bit_count) {\
+            (*(val)) = BITSTREAM_GETLOWERBITS((uint32_t)((stream)->bit_buffer >> ((stream)->bit_count - (nbits))), (nbits));\
+        } else {\
+            (*(val)) = (uint32_t)((uint64_t)BITSTREAM_GETLOWERBITS((uint32_t)(stream)->bit_buffer, (stream)->bit_count) << ((nbits) - (stream)->bit_count));\
+        }\
+    } while (0)
+
+/* nbits 読み飛ばす（直前のBitReader_PeekBitsで取得したビット数以下に限る） */
+#define BitReader_SkipBits(stream, nbits)\
+    do {\
+        /* 引数チェック */\
+        assert((void *)(stream) != NULL);\
+        \
+        /* バッファに残っている分しか読み飛ばせない */\
+        assert((nbits) <= (stream)->bit_count);\
+        (stream)->bit_count -= (nbits);\
+    } while (0)
+
 /* バッファにたまったビットをクリア */
 #define BitStream_Flush(stream)\
     do {\
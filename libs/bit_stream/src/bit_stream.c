@@ -14,26 +14,6 @@ const uint32_t g_bitstream_lower_bits_mask[33] = {
     0x1FFFFFFFU, 0x3FFFFFFFU, 0x7FFFFFFFU, 0xFFFFFFFFU
 };
 
-/* 0のラン長パターンテーブル（注意：上位ビットからのラン長） */
-const uint32_t g_bitstream_zerobit_runlength_table[256] = {
-    8, 7, 6, 6, 5, 5, 5, 5, 4, 4, 4, 4, 4, 4, 4, 4,
-    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
-};
-
 /* NLZ計算のためのテーブル */
 #define UNUSED 99
 static const uint32_t st_nlz10_table[64] = {
@@ -237,8 +217,6 @@ void BitWriter_PutZeroRun(struct BitStream *stream, uint32_t runlength)
 /* nbits 取得（最大32bit）し、その値を右詰めして出力 */
 void BitReader_GetBits(struct BitStream *stream, uint32_t *val, uint32_t nbits)
 {
-    uint32_t tmp = 0;
-
     /* 引数チェック */
     assert(stream != NULL);
     assert(val != NULL);
@@ -249,81 +227,97 @@ void BitReader_GetBits(struct BitStream *stream, uint32_t *val, uint32_t nbits)
     /* 入力可能な最大ビット数を越えてないか確認 */
     assert(nbits <= 32);
 
-    /* バッファから取り出す */
-    if (nbits <= stream->bit_count) {
-        stream->bit_count -= nbits;
-        (*val) = BITSTREAM_GETLOWERBITS(stream->bit_buffer >> stream->bit_count, nbits);
-        return;
+    /* バッファが足りなければ補充 */
+    if (nbits > stream->bit_count) {
+        BITSTREAM_READER_REFILL(stream);
     }
 
-    /* 現在のバッファ容量よりも多くのビットが要求されたらメモリから読み出し */
-
-    /* 残りのビットを上位ビットにセット */
-    nbits -= stream->bit_count;
-    tmp = BITSTREAM_GETLOWERBITS(stream->bit_buffer, stream->bit_count) << nbits;
-
     /* 終端に達していないかチェック */
-    assert(stream->memory_p >= stream->memory_image);
-    assert(stream->memory_p < stream->memory_tail);
-
-    /* メモリから読み出し */
-    stream->bit_buffer
-        = ((uint32_t)stream->memory_p[0] << 24) | ((uint32_t)stream->memory_p[1] << 16)
-        | ((uint32_t)stream->memory_p[2] << 8) | ((uint32_t)stream->memory_p[3] << 0);
-    stream->memory_p += 4;
-    stream->bit_count = 32;
+    assert(nbits <= stream->bit_count);
 
-    /* 端数ビットの処理 残ったビット分をtmpの最上位ビットにセット */
+    /* バッファから取り出す */
     stream->bit_count -= nbits;
-    tmp |= BITSTREAM_GETLOWERBITS(stream->bit_buffer >> stream->bit_count, nbits);
-
-    /* 正常終了 */
-    (*val) = tmp;
+    (*val) = BITSTREAM_GETLOWERBITS((uint32_t)(stream->bit_buffer >> stream->bit_count), nbits);
 }
 
 /* つぎの1にぶつかるまで読み込み、その間に読み込んだ0のランレングスを取得 */
 void BitReader_GetZeroRunLength(struct BitStream *stream, uint32_t *runlength)
 {
-    uint32_t run;
+    uint32_t run = 0;
 
     /* 引数チェック */
     assert(stream != NULL);
     assert(runlength != NULL);
 
-    /* 上位ビットからの連続する0を計測 */
-    run = BITSTREAM_NLZ(BITSTREAM_GETLOWERBITS(stream->bit_buffer, stream->bit_count)) + stream->bit_count - 32;
+    for (;;) {
+        uint64_t top;
 
-    /* 読み込んだ分カウントを減らす */
-    assert(stream->bit_count >= run);
-    stream->bit_count -= run;
+        /* バッファが空の時は補充 */
+        if (stream->bit_count == 0) {
+            BITSTREAM_READER_REFILL(stream);
+            /* 終端に達していないかチェック */
+            assert(stream->bit_count > 0);
+            if (stream->bit_count == 0) {
+                break;
+            }
+        }
 
-    /* バッファが空の時 */
-    while (!stream->bit_count) {
-        /* 1バイト読み込み再度計測 */
-        uint32_t tmp_run;
+        /* 未読のビットを最上位に詰め、上位ビットからの連続する0を計測 */
+        top = stream->bit_buffer << (64 - stream->bit_count);
+        if (top != 0) {
+            const uint32_t nlz = BITSTREAM_NLZ64(top);
+            /* 0の連続と続く1を読み込んだ分カウントを減らす */
+            run += nlz;
+            stream->bit_count -= nlz + 1;
+            break;
+        }
 
-        /* 終端に達していないかチェック */
-        assert(stream->memory_p >= stream->memory_image);
-        assert(stream->memory_p < stream->memory_tail);
-
-        /* メモリから読み出し ビットバッファにセットし直して再度ランを計測 */
-        stream->bit_buffer = stream->memory_p[0];
-        stream->memory_p++;
-        /* テーブルによりラン長を取得 */
-        tmp_run = g_bitstream_zerobit_runlength_table[stream->bit_buffer];
-        stream->bit_count = 8 - tmp_run;
-        /* ランを加算 */
-        run += tmp_run;
+        /* バッファ内は全て0 */
+        run += stream->bit_count;
+        stream->bit_count = 0;
     }
 
-    /* 続く1を空読み */
-    assert(stream->bit_count >= 1);
-    stream->bit_count -= 1;
-
     /* 正常終了 */
     (*runlength) = run;
 }
 
+/* 読み込み位置を進めずに nbits 取得（最大32bit）し、その値を右詰めして出力
+ * 終端を越えた分のビットは0で埋める */
+void BitReader_PeekBits(struct BitStream *stream, uint32_t *val, uint32_t nbits)
+{
+    /* 引数チェック */
+    assert(stream != NULL);
+    assert(val != NULL);
+
+    /* 読み込みモードでない場合はアサート */
+    assert(stream->flags & BITSTREAM_FLAGS_MODE_READ);
+
+    /* 取得可能な最大ビット数を越えてないか確認 */
+    assert(nbits <= 32);
+
+    /* バッファが足りなければ補充 */
+    if (nbits > stream->bit_count) {
+        BITSTREAM_READER_REFILL(stream);
+    }
+
+    if (nbits <= stream->bit_count) {
+        (*val) = BITSTREAM_GETLOWERBITS((uint32_t)(stream->bit_buffer >> (stream->bit_count - nbits)), nbits);
+    } else {
+        (*val) = (uint32_t)((uint64_t)BITSTREAM_GETLOWERBITS((uint32_t)stream->bit_buffer, stream->bit_count) << (nbits - stream->bit_count));
+    }
+}
+
+/* nbits 読み飛ばす（直前のBitReader_PeekBitsで取得したビット数以下に限る） */
+void BitReader_SkipBits(struct BitStream *stream, uint32_t nbits)
+{
+    /* 引数チェック */
+    assert(stream != NULL);
+
+    /* バッファに残っている分しか読み飛ばせない */
+    assert(nbits <= stream->bit_count);
+    stream->bit_count -= nbits;
+}
+
 /* バッファにたまったビットをクリア（読み込み/書き込み位置を次のバイト境界に移動） */
 void BitStream_Flush(struct BitStream *stream)
 {
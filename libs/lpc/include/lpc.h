@@ -56,6 +56,13 @@ LPCApiResult LPCCalculator_CalculateMultipleLPCCoefficients(
     const double* data, uint32_t num_samples, double **lpc_coefs, double *error_vars, uint32_t max_coef_order,
     LPCWindowType window_type, double regular_term);
 
+/* 与えられた標本自己相関からLevinson-Durbin再帰計算により各次数の誤差分散を求める（倍精度） */
+/* 窓の影響は考慮しないため、必要に応じて呼び出し側で正規化すること */
+/* error_varsは0次の誤差分散からmax_coef_order次の分散まで求めるためerror_varsのサイズはmax_coef_order+1要する */
+LPCApiResult LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(
+    struct LPCCalculator *lpcc,
+    const double *auto_corr, uint32_t max_coef_order, double *error_vars, double regular_term);
+
 /* 補助関数法よりLPC係数を求める（倍精度） */
 LPCApiResult LPCCalculator_CalculateLPCCoefficientsAF(
     struct LPCCalculator *lpcc,
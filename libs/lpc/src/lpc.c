@@ -8,6 +8,7 @@
 #include <assert.h>
 
 #include "fft.h"
+#include "srla_simd.h"
 
 /* メモリアラインメント */
 #define LPC_ALIGNMENT 16
@@ -21,6 +22,9 @@
 #define LPC_PITCH_AUTOCORR_THRESHOULD 0.1
 /* 最大自己相関値からどの比率のピークをピッチとして採用するか */
 #define LPC_PITCH_RATIO_VS_MAX_THRESHOULD 0.9
+/* 自己相関を直接計算する最大ラグ数（これを超える場合はFFTで計算）
+ * 直接計算とFFTでは丸め誤差が異なるため、命令セットによらず同じ値を使う */
+#define LPC_MAX_NUM_DIRECT_LAGS 128
 
 /* nの倍数切り上げ */
 #define LPC_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
@@ -42,6 +46,20 @@ typedef enum LPCErrorTag {
     LPC_ERROR_INVALID_ARGUMENT
 } LPCError;
 
+/* 窓関数適用と自己相関計算の関数テーブル */
+struct LPCFunctions {
+    /* 窓関数の適用 */
+    LPCError (*apply_window)(
+        LPCWindowType window_type, const double *input, uint32_t num_samples, double *output);
+    /*（標本）自己相関の計算 */
+    LPCError (*calculate_auto_correlation)(
+        const double *data, uint32_t num_samples, double *auto_corr, uint32_t order);
+    /* 窓関数を適用しつつ（標本）自己相関を計算 窓を掛けた信号はoutputに出力 */
+    LPCError (*calculate_windowed_auto_correlation)(
+        LPCWindowType window_type, const double *input, uint32_t num_samples,
+        double *output, double *auto_corr, uint32_t order);
+};
+
 /* LPC計算ハンドル */
 struct LPCCalculator {
     uint32_t max_order; /* 最大次数 */
@@ -57,10 +75,14 @@ struct LPCCalculator {
     double *error_vars; /* 残差分散 */
     double *buffer; /* 入力信号のバッファ領域 */
     double *work_buffer; /* 計算用バッファ */
+    const struct LPCFunctions *functions; /* 実行環境に合わせて選択した窓関数適用・自己相関計算関数 */
     uint8_t alloced_by_own; /* 自分で領域確保したか？ */
     void *work; /* ワーク領域先頭ポインタ */
 };
 
+/* 命令セットに対応する窓関数適用・自己相関計算関数テーブルを取得 */
+static const struct LPCFunctions *LPC_GetFunctions(SRLASIMDInstructionSet instruction_set);
+
 /* round関数（C89で定義されていない） */
 static double LPC_Round(double d)
 {
@@ -218,6 +240,9 @@ struct LPCCalculator* LPCCalculator_Create(const struct LPCCalculatorConfig *con
     /* バッファオーバーフローチェック */
     assert((work_ptr - (uint8_t *)work) <= work_size);
 
+    /* 実行環境で使える命令セットの関数を選択 */
+    lpcc->functions = LPC_GetFunctions(SRLASIMD_GetInstructionSet());
+
     return lpcc;
 }
 
@@ -232,6 +257,13 @@ void LPCCalculator_Destroy(struct LPCCalculator *lpcc)
     }
 }
 
+/* Welch窓の重み 左右対称な位置で同じ値になるよう小さい方の位置から掛ける */
+static double LPC_WelchWindowWeight(double divisor, uint32_t smpl, uint32_t num_samples)
+{
+    const uint32_t rsmpl = num_samples - 1 - smpl;
+    return (smpl <= rsmpl) ? (divisor * smpl * rsmpl) : (divisor * rsmpl * smpl);
+}
+
 /* 窓関数の適用 */
 static LPCError LPC_ApplyWindow(
     LPCWindowType window_type, const double *input, uint32_t num_samples, double *output)
@@ -258,10 +290,14 @@ static LPCError LPC_ApplyWindow(
             uint32_t smpl;
             const double divisor = 4.0 * pow(num_samples - 1, -2.0);
             for (smpl = 0; smpl < (num_samples >> 1); smpl++) {
-                const double weight = divisor * smpl * (num_samples - 1 - smpl);
+                const double weight = LPC_WelchWindowWeight(divisor, smpl, num_samples);
                 output[smpl] = input[smpl] * weight;
                 output[num_samples - smpl - 1] = input[num_samples - smpl - 1] * weight;
             }
+            /* サンプル数が奇数の時は中央のサンプルが残る */
+            if (num_samples & 1) {
+                output[smpl] = input[smpl] * LPC_WelchWindowWeight(divisor, smpl, num_samples);
+            }
         }
         break;
     default:
@@ -289,13 +325,288 @@ static double LPC_ComputeWindowInverseSquaredSum(LPCWindowType window_type, cons
     return 1.0;
 }
 
+/* lag .. lag + 3 の4ラグ分の自己相関を計算
+ * 命令セットによらず結果を一致させるため、AVX2版と同じ順序（4レーン×2組の部分和）で加算する */
+static void LPC_CalculateAutoCorrelation4Lags(
+    const double *data, uint32_t num_samples, uint32_t lag, double *auto_corr)
+{
+    uint32_t i, j, k, l;
+    const uint32_t num_common = num_samples - (lag + 3); /* 4ラグ全てで積を取れるサンプル数 */
+    double acc0[4][4], acc1[4][4];
+
+    assert(num_samples >= (lag + 4));
+
+    for (k = 0; k < 4; k++) {
+        for (l = 0; l < 4; l++) {
+            acc0[k][l] = acc1[k][l] = 0.0;
+        }
+    }
+
+    for (i = 0; (i + 8) <= num_common; i += 8) {
+        for (k = 0; k < 4; k++) {
+            for (l = 0; l < 4; l++) {
+                acc0[k][l] += data[i + l] * data[i + lag + k + l];
+                acc1[k][l] += data[i + 4 + l] * data[i + 4 + lag + k + l];
+            }
+        }
+    }
+    for (; (i + 4) <= num_common; i += 4) {
+        for (k = 0; k < 4; k++) {
+            for (l = 0; l < 4; l++) {
+                acc0[k][l] += data[i + l] * data[i + lag + k + l];
+            }
+        }
+    }
+    for (k = 0; k < 4; k++) {
+        auto_corr[k] = ((acc0[k][0] + acc1[k][0]) + (acc0[k][1] + acc1[k][1]))
+            + ((acc0[k][2] + acc1[k][2]) + (acc0[k][3] + acc1[k][3]));
+    }
+
+    /* 余ったサンプル分の処理 */
+    for (k = 0; k < 4; k++) {
+        for (j = i; (j + lag + k) < num_samples; j++) {
+            auto_corr[k] += data[j] * data[j + lag + k];
+        }
+    }
+}
+
+/* lag .. order - 1 のラグの自己相関を計算 */
+static void LPC_CalculateAutoCorrelationFromLag(
+    const double *data, uint32_t num_samples, double *auto_corr, uint32_t lag, uint32_t order)
+{
+    uint32_t i, l;
+
+    /* 4ラグずつまとめて計算 */
+    for (; (lag + 4) <= order; lag += 4) {
+        LPC_CalculateAutoCorrelation4Lags(data, num_samples, lag, &auto_corr[lag]);
+    }
+
+    /* 余ったラグ分の処理 */
+    for (; lag < order; lag++) {
+        const uint32_t num_common = num_samples - lag;
+        double acc0[4] = { 0.0, 0.0, 0.0, 0.0 }, acc1[4] = { 0.0, 0.0, 0.0, 0.0 };
+        for (i = 0; (i + 8) <= num_common; i += 8) {
+            for (l = 0; l < 4; l++) {
+                acc0[l] += data[i + l] * data[i + lag + l];
+                acc1[l] += data[i + 4 + l] * data[i + 4 + lag + l];
+            }
+        }
+        auto_corr[lag] = ((acc0[0] + acc1[0]) + (acc0[1] + acc1[1])) + ((acc0[2] + acc1[2]) + (acc0[3] + acc1[3]));
+        for (; i < num_common; i++) {
+            auto_corr[lag] += data[i] * data[i + lag];
+        }
+    }
+}
+
 /*（標本）自己相関の計算 */
 static LPCError LPC_CalculateAutoCorrelation(
     const double *data, uint32_t num_samples, double *auto_corr, uint32_t order)
 {
-    uint32_t i, lag;
-    double tmp;
+    assert(num_samples >= order);
+
+    /* 引数チェック */
+    if (data == NULL || auto_corr == NULL) {
+        return LPC_ERROR_INVALID_ARGUMENT;
+    }
+
+    LPC_CalculateAutoCorrelationFromLag(data, num_samples, auto_corr, 0, order);
+
+    return LPC_ERROR_OK;
+}
+
+/* 窓関数を適用しつつ（標本）自己相関を計算
+ * 最初の4ラグはAVX2版と同じ順序（4レーンの部分和）で加算する */
+static LPCError LPC_CalculateWindowedAutoCorrelation(
+    LPCWindowType window_type, const double *input, uint32_t num_samples,
+    double *output, double *auto_corr, uint32_t order)
+{
+    uint32_t i, j, k, l;
+    LPCError err;
+
+    /* 引数チェック */
+    if (input == NULL || output == NULL || auto_corr == NULL) {
+        return LPC_ERROR_INVALID_ARGUMENT;
+    }
+
+    if ((err = LPC_ApplyWindow(window_type, input, num_samples, output)) != LPC_ERROR_OK) {
+        return err;
+    }
+
+    /* 矩形窓/Welch窓以外、または次数やサンプル数が少ないときは通常の自己相関計算 */
+    if (((window_type != LPC_WINDOWTYPE_RECTANGULAR) && (window_type != LPC_WINDOWTYPE_WELCH))
+            || (order < 4) || (num_samples < 8)) {
+        return LPC_CalculateAutoCorrelation(output, num_samples, auto_corr, order);
+    }
+
+    assert(num_samples >= order);
+
+    /* ラグ0〜3 */
+    {
+        double acc[4][4];
+        for (k = 0; k < 4; k++) {
+            for (l = 0; l < 4; l++) {
+                acc[k][l] = 0.0;
+            }
+        }
+        for (i = 0; (i + 8) <= num_samples; i += 4) {
+            for (k = 0; k < 4; k++) {
+                for (l = 0; l < 4; l++) {
+                    acc[k][l] += output[i + l] * output[i + l + k];
+                }
+            }
+        }
+        for (k = 0; k < 4; k++) {
+            auto_corr[k] = (acc[k][0] + acc[k][1]) + (acc[k][2] + acc[k][3]);
+            for (j = i; (j + k) < num_samples; j++) {
+                auto_corr[k] += output[j] * output[j + k];
+            }
+        }
+    }
+
+    /* 残りのラグ */
+    LPC_CalculateAutoCorrelationFromLag(output, num_samples, auto_corr, 4, order);
+
+    return LPC_ERROR_OK;
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* AVX2版の関数属性
+ * FMAを使うと積和の丸めがスカラー版と変わるため、AVX2のみを有効にしてスカラー版とビット単位で結果を一致させる */
+#if defined(_MSC_VER)
+#define LPC_TARGET_AVX2
+#else
+#define LPC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/* Welch窓の重み（4サンプル分） LPC_WelchWindowWeightと同じ順序で掛ける */
+LPC_TARGET_AVX2 static __m256d LPC_WelchWindowWeightAVX2(__m256d vdivisor, __m256d vsmpl, __m256d vlast)
+{
+    const __m256d vrsmpl = _mm256_sub_pd(vlast, vsmpl);
+    return _mm256_mul_pd(_mm256_mul_pd(vdivisor, _mm256_min_pd(vsmpl, vrsmpl)), _mm256_max_pd(vsmpl, vrsmpl));
+}
+
+/* 4要素の和を4本分まとめて計算 [sum(v0), sum(v1), sum(v2), sum(v3)]を返す */
+LPC_TARGET_AVX2 static __m256d LPC_HorizontalAdd4AVX2(__m256d v0, __m256d v1, __m256d v2, __m256d v3)
+{
+    const __m256d t0 = _mm256_hadd_pd(v0, v1);
+    const __m256d t1 = _mm256_hadd_pd(v2, v3);
+    return _mm256_add_pd(_mm256_permute2f128_pd(t0, t1, 0x20), _mm256_permute2f128_pd(t0, t1, 0x31));
+}
+
+/* 窓関数の適用 AVX2版 */
+LPC_TARGET_AVX2 static LPCError LPC_ApplyWindowAVX2(
+    LPCWindowType window_type, const double *input, uint32_t num_samples, double *output)
+{
+    uint32_t smpl;
+
+    /* Welch窓以外はスカラー版で処理 */
+    if (window_type != LPC_WINDOWTYPE_WELCH) {
+        return LPC_ApplyWindow(window_type, input, num_samples, output);
+    }
+
+    /* 引数チェック */
+    if (input == NULL || output == NULL) {
+        return LPC_ERROR_INVALID_ARGUMENT;
+    }
+
+    {
+        const double divisor = 4.0 * pow(num_samples - 1, -2.0);
+        const __m256d vdivisor = _mm256_set1_pd(divisor);
+        const __m256d vlast = _mm256_set1_pd((double)(num_samples - 1));
+        const __m256d vstep = _mm256_set1_pd(4.0);
+        __m256d vsmpl = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+        for (smpl = 0; (smpl + 4) <= num_samples; smpl += 4) {
+            const __m256d vweight = LPC_WelchWindowWeightAVX2(vdivisor, vsmpl, vlast);
+            _mm256_storeu_pd(&output[smpl], _mm256_mul_pd(_mm256_loadu_pd(&input[smpl]), vweight));
+            vsmpl = _mm256_add_pd(vsmpl, vstep);
+        }
+        for (; smpl < num_samples; smpl++) {
+            output[smpl] = input[smpl] * LPC_WelchWindowWeight(divisor, smpl, num_samples);
+        }
+    }
 
+    return LPC_ERROR_OK;
+}
+
+/* lag .. lag + 3 の4ラグ分の自己相関を計算 AVX2版
+ * 入力の読み込みを4ラグで共有し、8本のアキュムレータで加算のレイテンシを隠す */
+LPC_TARGET_AVX2 static void LPC_CalculateAutoCorrelation4LagsAVX2(
+    const double *data, uint32_t num_samples, uint32_t lag, double *auto_corr)
+{
+    uint32_t i, j, k;
+    const uint32_t num_common = num_samples - (lag + 3); /* 4ラグ全てで積を取れるサンプル数 */
+    __m256d vacc0 = _mm256_setzero_pd(), vacc1 = _mm256_setzero_pd();
+    __m256d vacc2 = _mm256_setzero_pd(), vacc3 = _mm256_setzero_pd();
+    __m256d vacc4 = _mm256_setzero_pd(), vacc5 = _mm256_setzero_pd();
+    __m256d vacc6 = _mm256_setzero_pd(), vacc7 = _mm256_setzero_pd();
+
+    assert(num_samples >= (lag + 4));
+
+    for (i = 0; (i + 8) <= num_common; i += 8) {
+        const __m256d vx0 = _mm256_loadu_pd(&data[i + 0]);
+        const __m256d vx1 = _mm256_loadu_pd(&data[i + 4]);
+        const double *d = &data[i + lag];
+        vacc0 = _mm256_add_pd(_mm256_mul_pd(vx0, _mm256_loadu_pd(&d[0])), vacc0);
+        vacc1 = _mm256_add_pd(_mm256_mul_pd(vx0, _mm256_loadu_pd(&d[1])), vacc1);
+        vacc2 = _mm256_add_pd(_mm256_mul_pd(vx0, _mm256_loadu_pd(&d[2])), vacc2);
+        vacc3 = _mm256_add_pd(_mm256_mul_pd(vx0, _mm256_loadu_pd(&d[3])), vacc3);
+        vacc4 = _mm256_add_pd(_mm256_mul_pd(vx1, _mm256_loadu_pd(&d[4])), vacc4);
+        vacc5 = _mm256_add_pd(_mm256_mul_pd(vx1, _mm256_loadu_pd(&d[5])), vacc5);
+        vacc6 = _mm256_add_pd(_mm256_mul_pd(vx1, _mm256_loadu_pd(&d[6])), vacc6);
+        vacc7 = _mm256_add_pd(_mm256_mul_pd(vx1, _mm256_loadu_pd(&d[7])), vacc7);
+    }
+    for (; (i + 4) <= num_common; i += 4) {
+        const __m256d vx = _mm256_loadu_pd(&data[i]);
+        const double *d = &data[i + lag];
+        vacc0 = _mm256_add_pd(_mm256_mul_pd(vx, _mm256_loadu_pd(&d[0])), vacc0);
+        vacc1 = _mm256_add_pd(_mm256_mul_pd(vx, _mm256_loadu_pd(&d[1])), vacc1);
+        vacc2 = _mm256_add_pd(_mm256_mul_pd(vx, _mm256_loadu_pd(&d[2])), vacc2);
+        vacc3 = _mm256_add_pd(_mm256_mul_pd(vx, _mm256_loadu_pd(&d[3])), vacc3);
+    }
+    _mm256_storeu_pd(auto_corr, LPC_HorizontalAdd4AVX2(
+            _mm256_add_pd(vacc0, vacc4), _mm256_add_pd(vacc1, vacc5),
+            _mm256_add_pd(vacc2, vacc6), _mm256_add_pd(vacc3, vacc7)));
+
+    /* 余ったサンプル分の処理 */
+    for (k = 0; k < 4; k++) {
+        for (j = i; (j + lag + k) < num_samples; j++) {
+            auto_corr[k] += data[j] * data[j + lag + k];
+        }
+    }
+}
+
+/* lag .. order - 1 のラグの自己相関を計算 AVX2版 */
+LPC_TARGET_AVX2 static void LPC_CalculateAutoCorrelationFromLagAVX2(
+    const double *data, uint32_t num_samples, double *auto_corr, uint32_t lag, uint32_t order)
+{
+    uint32_t i;
+
+    /* 4ラグずつまとめて計算 */
+    for (; (lag + 4) <= order; lag += 4) {
+        LPC_CalculateAutoCorrelation4LagsAVX2(data, num_samples, lag, &auto_corr[lag]);
+    }
+
+    /* 余ったラグ分の処理 */
+    for (; lag < order; lag++) {
+        const uint32_t num_common = num_samples - lag;
+        __m256d vacc0 = _mm256_setzero_pd(), vacc1 = _mm256_setzero_pd();
+        DECLALIGN(32) double sum[4];
+        for (i = 0; (i + 8) <= num_common; i += 8) {
+            vacc0 = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(&data[i + 0]), _mm256_loadu_pd(&data[i + lag + 0])), vacc0);
+            vacc1 = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(&data[i + 4]), _mm256_loadu_pd(&data[i + lag + 4])), vacc1);
+        }
+        _mm256_store_pd(sum, _mm256_add_pd(vacc0, vacc1));
+        auto_corr[lag] = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+        for (; i < num_common; i++) {
+            auto_corr[lag] += data[i] * data[i + lag];
+        }
+    }
+}
+
+/*（標本）自己相関の計算 AVX2版 */
+LPC_TARGET_AVX2 static LPCError LPC_CalculateAutoCorrelationAVX2(
+    const double *data, uint32_t num_samples, double *auto_corr, uint32_t order)
+{
     assert(num_samples >= order);
 
     /* 引数チェック */
@@ -303,28 +614,122 @@ static LPCError LPC_CalculateAutoCorrelation(
         return LPC_ERROR_INVALID_ARGUMENT;
     }
 
-    /* 係数初期化 */
-    for (lag = 0; lag < order; lag++) {
-        auto_corr[lag] = 0.0;
+    LPC_CalculateAutoCorrelationFromLagAVX2(data, num_samples, auto_corr, 0, order);
+
+    return LPC_ERROR_OK;
+}
+
+/* 窓関数を適用しつつ（標本）自己相関を計算 AVX2版
+ * 窓を掛けながら最初の4ラグの積和を取り、窓を掛けた信号を読み直す回数を1回減らす */
+LPC_TARGET_AVX2 static LPCError LPC_CalculateWindowedAutoCorrelationAVX2(
+    LPCWindowType window_type, const double *input, uint32_t num_samples,
+    double *output, double *auto_corr, uint32_t order)
+{
+    uint32_t i, j, k;
+    LPCError err;
+
+    /* 引数チェック */
+    if (input == NULL || output == NULL || auto_corr == NULL) {
+        return LPC_ERROR_INVALID_ARGUMENT;
     }
 
-    /* 次数の代わりにデータ側のラグに注目した自己相関係数計算 */
-    for (i = 0; i <= num_samples - order; i++) {
-        tmp = data[i];
-        /* 同じラグを持ったデータ積和を取る */
-        for (lag = 0; lag < order; lag++) {
-            auto_corr[lag] += tmp * data[i + lag];
+    /* 矩形窓/Welch窓以外、または次数やサンプル数が少ないときは窓の適用と自己相関計算を分けて行う */
+    if (((window_type != LPC_WINDOWTYPE_RECTANGULAR) && (window_type != LPC_WINDOWTYPE_WELCH))
+            || (order < 4) || (num_samples < 8)) {
+        if ((err = LPC_ApplyWindowAVX2(window_type, input, num_samples, output)) != LPC_ERROR_OK) {
+            return err;
         }
+        return LPC_CalculateAutoCorrelationAVX2(output, num_samples, auto_corr, order);
     }
-    for (; i < num_samples; i++) {
-        tmp = data[i];
-        for (lag = 0; lag < num_samples - i; lag++) {
-            auto_corr[lag] += tmp * data[i + lag];
+
+    assert(num_samples >= order);
+
+    {
+        const uint8_t is_welch = (window_type == LPC_WINDOWTYPE_WELCH) ? 1 : 0;
+        const double divisor = is_welch ? (4.0 * pow(num_samples - 1, -2.0)) : 1.0;
+        const __m256d vdivisor = _mm256_set1_pd(divisor);
+        const __m256d vlast = _mm256_set1_pd((double)(num_samples - 1));
+        const __m256d vstep = _mm256_set1_pd(4.0);
+        __m256d vsmpl = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+        __m256d vacc0 = _mm256_setzero_pd(), vacc1 = _mm256_setzero_pd();
+        __m256d vacc2 = _mm256_setzero_pd(), vacc3 = _mm256_setzero_pd();
+        __m256d vy0, vy1;
+
+/* 窓を掛けた4サンプルを取得 */
+#define LPC_LOAD_WINDOWED(smpl)\
+        (is_welch ? _mm256_mul_pd(_mm256_loadu_pd(&input[smpl]), LPC_WelchWindowWeightAVX2(vdivisor, vsmpl, vlast))\
+                  : _mm256_loadu_pd(&input[smpl]))
+
+        /* 先頭4サンプル */
+        vy0 = LPC_LOAD_WINDOWED(0);
+        _mm256_storeu_pd(&output[0], vy0);
+        vsmpl = _mm256_add_pd(vsmpl, vstep);
+
+        /* 次の4サンプルに窓を掛けてレジスタ上でずらし、ラグ0〜3の積和を取る */
+        for (i = 0; (i + 8) <= num_samples; i += 4) {
+            __m256d vmid;
+            vy1 = LPC_LOAD_WINDOWED(i + 4);
+            _mm256_storeu_pd(&output[i + 4], vy1);
+            vsmpl = _mm256_add_pd(vsmpl, vstep);
+            vmid = _mm256_permute2f128_pd(vy0, vy1, 0x21); /* y[i + 2] .. y[i + 5] */
+            vacc0 = _mm256_add_pd(_mm256_mul_pd(vy0, vy0), vacc0);
+            vacc1 = _mm256_add_pd(_mm256_mul_pd(vy0, _mm256_shuffle_pd(vy0, vmid, 0x5)), vacc1);
+            vacc2 = _mm256_add_pd(_mm256_mul_pd(vy0, vmid), vacc2);
+            vacc3 = _mm256_add_pd(_mm256_mul_pd(vy0, _mm256_shuffle_pd(vmid, vy1, 0x5)), vacc3);
+            vy0 = vy1;
+        }
+#undef LPC_LOAD_WINDOWED
+
+        /* 窓を掛けていない残りのサンプル */
+        for (j = i + 4; j < num_samples; j++) {
+            output[j] = is_welch ? (input[j] * LPC_WelchWindowWeight(divisor, j, num_samples)) : input[j];
+        }
+
+        /* ラグ0〜3の結果をまとめ、余ったサンプル分を加える */
+        {
+            DECLALIGN(32) double sum[4];
+            _mm256_store_pd(sum, LPC_HorizontalAdd4AVX2(vacc0, vacc1, vacc2, vacc3));
+            for (k = 0; k < 4; k++) {
+                for (j = i; (j + k) < num_samples; j++) {
+                    sum[k] += output[j] * output[j + k];
+                }
+                auto_corr[k] = sum[k];
+            }
         }
     }
 
+    /* 残りのラグは窓を掛けた信号から計算 */
+    LPC_CalculateAutoCorrelationFromLagAVX2(output, num_samples, auto_corr, 4, order);
+
     return LPC_ERROR_OK;
 }
+#endif
+
+/* 命令セットごとの窓関数適用・自己相関計算関数テーブル（どの命令セットでも結果はビット単位で一致） */
+static const struct LPCFunctions st_lpc_functions_scalar = {
+    LPC_ApplyWindow, LPC_CalculateAutoCorrelation, LPC_CalculateWindowedAutoCorrelation
+};
+#if defined(SRLA_ENABLE_X86_SIMD)
+static const struct LPCFunctions st_lpc_functions_avx2 = {
+    LPC_ApplyWindowAVX2, LPC_CalculateAutoCorrelationAVX2, LPC_CalculateWindowedAutoCorrelationAVX2
+};
+#endif
+
+/* 命令セットに対応する窓関数適用・自己相関計算関数テーブルを取得 */
+static const struct LPCFunctions *LPC_GetFunctions(SRLASIMDInstructionSet instruction_set)
+{
+    switch (instruction_set) {
+#if defined(SRLA_ENABLE_X86_SIMD)
+    case SRLA_SIMD_AVX512:
+    case SRLA_SIMD_AVX2:
+        return &st_lpc_functions_avx2;
+#endif
+    default:
+        break;
+    }
+
+    return &st_lpc_functions_scalar;
+}
 
 /* FFTによる（標本）自己相関の計算 data_bufferの内容は破壊される */
 static LPCError LPC_CalculateAutoCorrelationByFFT(
@@ -450,24 +855,23 @@ static LPCError LPC_CalculateCoef(
         return LPC_ERROR_INVALID_ARGUMENT;
     }
 
-    /* 窓関数を適用 */
-    if (LPC_ApplyWindow(window_type, data, num_samples, lpcc->buffer) != LPC_ERROR_OK) {
-        return LPC_ERROR_NG;
-    }
-
-    /* 自己相関を計算 */
-#if 0
-    if (LPC_CalculateAutoCorrelation(
-            lpcc->buffer, num_samples, lpcc->auto_corr, coef_order + 1) != LPC_ERROR_OK) {
-        return LPC_ERROR_NG;
-    }
-#else
-    if (LPC_CalculateAutoCorrelationByFFT(
-            lpcc->buffer, lpcc->work_buffer, lpcc->max_num_buffer_samples,
-            num_samples, lpcc->auto_corr, coef_order + 1) != LPC_ERROR_OK) {
-        return LPC_ERROR_NG;
+    /* 窓関数を適用し自己相関を計算 */
+    if (((coef_order + 1) <= LPC_MAX_NUM_DIRECT_LAGS) && (num_samples > coef_order)) {
+        /* ラグ数が少ないときは直接計算 */
+        if (lpcc->functions->calculate_windowed_auto_correlation(window_type,
+                data, num_samples, lpcc->buffer, lpcc->auto_corr, coef_order + 1) != LPC_ERROR_OK) {
+            return LPC_ERROR_NG;
+        }
+    } else {
+        if (lpcc->functions->apply_window(window_type, data, num_samples, lpcc->buffer) != LPC_ERROR_OK) {
+            return LPC_ERROR_NG;
+        }
+        if (LPC_CalculateAutoCorrelationByFFT(
+                lpcc->buffer, lpcc->work_buffer, lpcc->max_num_buffer_samples,
+                num_samples, lpcc->auto_corr, coef_order + 1) != LPC_ERROR_OK) {
+            return LPC_ERROR_NG;
+        }
     }
-#endif
 
     /* 入力サンプル数が少ないときは、係数が発散することが多数
     * => 無音データとして扱い、係数はすべて0とする */
@@ -569,6 +973,39 @@ LPCApiResult LPCCalculator_CalculateMultipleLPCCoefficients(
     return LPC_APIRESULT_OK;
 }
 
+/* 与えられた標本自己相関からLevinson-Durbin再帰計算により各次数の誤差分散を求める（倍精度） */
+LPCApiResult LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(
+    struct LPCCalculator *lpcc,
+    const double *auto_corr, uint32_t max_coef_order, double *error_vars, double regular_term)
+{
+    /* 引数チェック */
+    if ((lpcc == NULL) || (auto_corr == NULL) || (error_vars == NULL)) {
+        return LPC_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 次数チェック */
+    if (max_coef_order > lpcc->max_order) {
+        return LPC_APIRESULT_EXCEED_MAX_ORDER;
+    }
+
+    /* 自己相関をコピーし0次相関を強調(Ridge正則化) */
+    memcpy(lpcc->auto_corr, auto_corr, sizeof(double) * (max_coef_order + 1));
+    lpcc->auto_corr[0] *= (1.0 + regular_term);
+
+    /* 0次の場合は分散そのもの */
+    if (max_coef_order == 0) {
+        error_vars[0] = lpcc->auto_corr[0];
+        return LPC_APIRESULT_OK;
+    }
+
+    /* 再帰計算を実行 */
+    if (LPC_LevinsonDurbinRecursion(lpcc, lpcc->auto_corr, max_coef_order, lpcc->parcor_coef, error_vars) != LPC_ERROR_OK) {
+        return LPC_APIRESULT_FAILED_TO_CALCULATION;
+    }
+
+    return LPC_APIRESULT_OK;
+}
+
 /* コレスキー分解 */
 static LPCError LPC_CholeskyDecomposition(
     double **Amat, int32_t dim, double *inv_diag)
@@ -853,7 +1290,7 @@ static LPCError LPC_CalculateCoefBurg(
 
     /* 自己共分散行列計算 */
     for (i = 0; i <= coef_order; i++) {
-        if ((err = LPC_CalculateAutoCorrelation(
+        if ((err = lpcc->functions->calculate_auto_correlation(
                         data, num_samples - i, &cov[i][i], coef_order + 1 - i)) != LPC_ERROR_OK) {
             return err;
         }
@@ -1586,7 +2023,7 @@ LPCApiResult LPCCalculator_CalculateLTPCoefficients(
     }
 
     /* 窓関数を適用 */
-    if (LPC_ApplyWindow(window_type, data, num_samples, lpcc->buffer) != LPC_ERROR_OK) {
+    if (lpcc->functions->apply_window(window_type, data, num_samples, lpcc->buffer) != LPC_ERROR_OK) {
         return LPC_APIRESULT_NG;
     }
 
@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H_INCLUDED
+#define MAPPED_FILE_H_INCLUDED
+
+#include <stdint.h>
+
+/* アクセスパターンのヒント */
+typedef enum MappedFileAccessPatternTag {
+    MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL = 0, /* 先頭から順に読む */
+    MAPPED_FILE_ACCESS_PATTERN_RANDOM          /* 任意の位置を読む */
+} MappedFileAccessPattern;
+
+/* 読み込み専用でメモリにマップしたファイル */
+struct MappedFile;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ファイルを読み込み専用でマップ 失敗時はNULLを返す
+ * マップできない環境・ファイルでは全体をメモリに読み込む */
+struct MappedFile *MappedFile_Open(const char *filename, MappedFileAccessPattern access_pattern);
+
+/* マップを解除してファイルを閉じる */
+void MappedFile_Close(struct MappedFile *file);
+
+/* ファイルデータ先頭の取得 */
+const uint8_t *MappedFile_GetData(const struct MappedFile *file);
+
+/* ファイルサイズの取得 */
+uint64_t MappedFile_GetSize(const struct MappedFile *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAPPED_FILE_H_INCLUDED */
@@ -0,0 +1,223 @@
+/* mmapを使うためにPOSIXの機能を有効化 */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "mapped_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* マップできなかった場合に一度に読み込むサイズ */
+#define MAPPED_FILE_READ_UNIT_SIZE (1UL << 24)
+
+/* 読み込み専用でメモリにマップしたファイル */
+struct MappedFile {
+    const uint8_t *data; /* ファイルデータ先頭 */
+    uint64_t size; /* ファイルサイズ */
+    uint8_t mapped; /* マップしているか？（0のときはmallocした領域に読み込んでいる） */
+#if defined(_WIN32)
+    HANDLE file_handle; /* ファイルハンドル */
+    HANDLE mapping_handle; /* マッピングハンドル */
+#endif
+};
+
+/* ファイル全体をメモリに読み込む 成功時は1を返す */
+static int MappedFile_ReadWhole(struct MappedFile *file, const char *filename)
+{
+    FILE *fp;
+    uint8_t *buffer;
+    uint64_t progress;
+
+    /* サイズがアドレス空間に収まらない */
+    if (file->size > (uint64_t)((size_t)-1)) {
+        return 0;
+    }
+
+    if ((fp = fopen(filename, "rb")) == NULL) {
+        return 0;
+    }
+
+    /* 空ファイルでも有効なポインタを返すため最低1byte確保 */
+    if ((buffer = (uint8_t *)malloc((size_t)((file->size > 0) ? file->size : 1))) == NULL) {
+        fclose(fp);
+        return 0;
+    }
+
+    /* freadの引数がsize_tに収まるよう分割して読み込む */
+    progress = 0;
+    while (progress < file->size) {
+        const uint64_t remain = file->size - progress;
+        const size_t read_size = (size_t)((remain < MAPPED_FILE_READ_UNIT_SIZE) ? remain : MAPPED_FILE_READ_UNIT_SIZE);
+        if (fread(&buffer[progress], sizeof(uint8_t), read_size, fp) != read_size) {
+            free(buffer);
+            fclose(fp);
+            return 0;
+        }
+        progress += read_size;
+    }
+    fclose(fp);
+
+    file->data = buffer;
+    file->mapped = 0;
+    return 1;
+}
+
+#if defined(_WIN32)
+/* ファイルをマップ 成功時は1を返す */
+static int MappedFile_Map(struct MappedFile *file, const char *filename, MappedFileAccessPattern access_pattern)
+{
+    LARGE_INTEGER file_size;
+    const DWORD flags = (access_pattern == MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL)
+        ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+
+    file->file_handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+    if (file->file_handle == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    if (!GetFileSizeEx(file->file_handle, &file_size)) {
+        CloseHandle(file->file_handle);
+        return 0;
+    }
+    file->size = (uint64_t)file_size.QuadPart;
+
+    /* 空ファイルはマップできない */
+    if ((file->size == 0) || (file->size > (uint64_t)((size_t)-1))) {
+        CloseHandle(file->file_handle);
+        return 0;
+    }
+
+    if ((file->mapping_handle = CreateFileMappingA(file->file_handle, NULL, PAGE_READONLY, 0, 0, NULL)) == NULL) {
+        CloseHandle(file->file_handle);
+        return 0;
+    }
+    if ((file->data = (const uint8_t *)MapViewOfFile(file->mapping_handle, FILE_MAP_READ, 0, 0, 0)) == NULL) {
+        CloseHandle(file->mapping_handle);
+        CloseHandle(file->file_handle);
+        return 0;
+    }
+
+    file->mapped = 1;
+    return 1;
+}
+
+/* マップの解除 */
+static void MappedFile_Unmap(struct MappedFile *file)
+{
+    UnmapViewOfFile((LPCVOID)file->data);
+    CloseHandle(file->mapping_handle);
+    CloseHandle(file->file_handle);
+}
+#else
+/* ファイルをマップ 成功時は1を返す */
+static int MappedFile_Map(struct MappedFile *file, const char *filename, MappedFileAccessPattern access_pattern)
+{
+    int fd;
+    struct stat fstat_buf;
+    void *addr;
+
+    if ((fd = open(filename, O_RDONLY)) < 0) {
+        return 0;
+    }
+    if (fstat(fd, &fstat_buf) != 0) {
+        close(fd);
+        return 0;
+    }
+    file->size = (uint64_t)fstat_buf.st_size;
+
+    /* 通常のファイル以外・空ファイルはマップできない */
+    if (!S_ISREG(fstat_buf.st_mode) || (file->size == 0) || (file->size > (uint64_t)((size_t)-1))) {
+        close(fd);
+        return 0;
+    }
+
+    addr = mmap(NULL, (size_t)file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /* マップ後はファイル記述子は不要 */
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return 0;
+    }
+
+    /* アクセスパターンのヒントを与える（失敗しても動作には影響しない） */
+    (void)posix_madvise(addr, (size_t)file->size,
+        (access_pattern == MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL) ? POSIX_MADV_SEQUENTIAL : POSIX_MADV_RANDOM);
+
+    file->data = (const uint8_t *)addr;
+    file->mapped = 1;
+    return 1;
+}
+
+/* マップの解除 */
+static void MappedFile_Unmap(struct MappedFile *file)
+{
+    munmap((void *)file->data, (size_t)file->size);
+}
+#endif
+
+/* ファイルを読み込み専用でマップ */
+struct MappedFile *MappedFile_Open(const char *filename, MappedFileAccessPattern access_pattern)
+{
+    struct MappedFile *file;
+
+    /* 引数チェック */
+    if (filename == NULL) {
+        return NULL;
+    }
+
+    if ((file = (struct MappedFile *)malloc(sizeof(struct MappedFile))) == NULL) {
+        return NULL;
+    }
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = 0;
+
+    /* マップを試み、失敗したら全体を読み込む */
+    if (!MappedFile_Map(file, filename, access_pattern)) {
+        if (!MappedFile_ReadWhole(file, filename)) {
+            free(file);
+            return NULL;
+        }
+    }
+
+    return file;
+}
+
+/* マップを解除してファイルを閉じる */
+void MappedFile_Close(struct MappedFile *file)
+{
+    if (file != NULL) {
+        if (file->mapped) {
+            MappedFile_Unmap(file);
+        } else {
+            free((void *)file->data);
+        }
+        free(file);
+    }
+}
+
+/* ファイルデータ先頭の取得 */
+const uint8_t *MappedFile_GetData(const struct MappedFile *file)
+{
+    if (file == NULL) {
+        return NULL;
+    }
+    return file->data;
+}
+
+/* ファイルサイズの取得 */
+uint64_t MappedFile_GetSize(const struct MappedFile *file)
+{
+    if (file == NULL) {
+        return 0;
+    }
+    return file->size;
+}
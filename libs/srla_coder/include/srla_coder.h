@@ -4,9 +4,25 @@
 #include <stdint.h>
 #include "bit_stream.h"
 
+/* 復号テーブルで一度に参照するビット数 */
+#define SRLACODER_DECODE_TABLE_BITS 10
+/* 復号テーブルの1エントリで復号する最大の値の数 */
+#define SRLACODER_DECODE_TABLE_MAX_NUM_VALUES (SRLACODER_DECODE_TABLE_BITS / 2)
+/* 復号テーブルを用意するRiceパラメータ(k2)の数（0からこの値未満まで） */
+#define SRLACODER_NUM_DECODE_TABLES 4
+
 /* 符号化ハンドル */
 struct SRLACoder;
 
+/* 再帰的Rice符号の複数値同時復号テーブル */
+struct SRLACoderDecodeTable {
+    struct {
+        uint8_t num_values; /* 参照ビット内で復号できた値の数（0のときは参照ビットに収まらない長い符号） */
+        uint8_t num_bits; /* 復号できた値の符号長の合計 */
+        int16_t values[SRLACODER_DECODE_TABLE_MAX_NUM_VALUES]; /* 復号した値 */
+    } entries[SRLACODER_NUM_DECODE_TABLES][1 << SRLACODER_DECODE_TABLE_BITS];
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,8 +42,12 @@ uint32_t SRLACoder_ComputeCodeLength(struct SRLACoder *coder, const int32_t *dat
 /* 符号付き整数配列の符号化 */
 void SRLACoder_Encode(struct SRLACoder *coder, struct BitStream *stream, const int32_t *data, uint32_t num_samples);
 
+/* 復号テーブルの作成 */
+void SRLACoder_BuildDecodeTable(struct SRLACoderDecodeTable *table);
+
 /* 符号付き整数配列の復号 */
-void SRLACoder_Decode(struct BitStream *stream, int32_t *data, uint32_t num_samples);
+void SRLACoder_Decode(
+    const struct SRLACoderDecodeTable *table, struct BitStream *stream, int32_t *data, uint32_t num_samples);
 
 #ifdef __cplusplus
 }
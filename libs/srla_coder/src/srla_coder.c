@@ -8,6 +8,7 @@
 
 #include "srla_internal.h"
 #include "srla_utility.h"
+#include "srla_simd.h"
 
 /* マクロ展開を使用する */
 #define SRLACODER_USE_MACROS 1
@@ -20,6 +21,8 @@
 #define SRLACODER_MAX_NUM_PARTITIONS (1 << SRLACODER_LOG2_MAX_NUM_PARTITIONS)
 /* パラメータ記録領域ビット数 */
 #define SRLACODER_RICE_PARAMETER_BITS 5
+/* 再帰的Rice符号の2段目パラメータの最大値 補足）1段目のパラメータ(2段目 + 1)が31を越えると閾値(1 << k1)を32bitで表せない */
+#define SRLACODER_MAX_RECURSIVE_RICE_PARAMETER 30
 /* ガンマ符号長サイズ */
 #define SRLACODER_GAMMA_BITS(uint) (((uint) == 0) ? 1 : ((2 * SRLAUTILITY_LOG2CEIL(uint + 2)) - 1))
 
@@ -31,14 +34,29 @@ typedef enum SRLACoderCodeTypeTag {
     SRLACODER_CODE_TYPE_INVALID
 } SRLACoderCodeType;
 
+/* 符号長計算関数テーブル（命令セットによらず結果は一致する） */
+struct SRLACoderFunctions {
+    /* 配列に対してRice符号長を計算 */
+    uint32_t (*rice_code_length)(const uint32_t *data, uint32_t num_samples, uint32_t k);
+    /* 配列に対して再帰的Rice符号長を計算 */
+    uint32_t (*recursive_rice_code_length)(const uint32_t *data, uint32_t num_samples, uint32_t k1, uint32_t k2);
+    /* 符号付き整数を符号なし整数に変換してバッファに記録し、和と最大値を求める */
+    void (*convert_to_uint32_and_sum)(
+        const int32_t *data, uint32_t num_samples, uint32_t *uval_buffer, uint64_t *sum, uint32_t *max_uval);
+};
+
 /* 符号化ハンドル */
 struct SRLACoder {
     uint8_t alloced_by_own;
     double part_mean[SRLACODER_LOG2_MAX_NUM_PARTITIONS + 1][SRLACODER_MAX_NUM_PARTITIONS];
     uint32_t *uval_buffer;
+    const struct SRLACoderFunctions *functions; /* 実行環境に合わせて選択した符号長計算関数 */
     void *work;
 };
 
+/* 命令セットに対応する符号長計算関数テーブルを取得 */
+static const struct SRLACoderFunctions *SRLACoder_GetFunctions(SRLASIMDInstructionSet instruction_set);
+
 /* 符号化ハンドルの作成に必要なワークサイズの計算 */
 int32_t SRLACoder_CalculateWorkSize(uint32_t max_num_samples)
 {
@@ -92,6 +110,9 @@ struct SRLACoder* SRLACoder_Create(uint32_t max_num_samples, void *work, int32_t
     coder->alloced_by_own = tmp_alloc_by_own;
     coder->work = work;
 
+    /* 実行環境で使える命令セットの符号長計算関数を選択 */
+    coder->functions = SRLACoder_GetFunctions(SRLASIMD_GetInstructionSet());
+
     /* 分割情報を初期化 */
     {
         uint32_t i, j;
@@ -258,32 +279,43 @@ static void RecursiveRice_GetCode(struct BitStream *stream, uint32_t k1, uint32_
 }
 #endif
 
+/* Riceパラメータkが切り替わる平均値の閾値表
+ * 平均値がi番目の値以上のとき最適なパラメータはi+1以上
+ * round(log2(log(OPTX) / log(1 - rho))) >= k を平均値について解いた 1 / expm1(-ln(OPTX) / 2^(k - 0.5)) の値 */
+static const double st_rice_parameter_mean_thresholds[] = {
+    1.6564844782391659, 3.7542035502043434, 7.9789222209055346, 16.443089163267061,
+    33.378799080315645, 67.253908336588097, 135.0059717360358, 270.5110210003615,
+    541.52158076447552, 1083.5429309107781, 2167.5857465124636, 4335.6714353703801,
+    8671.8428419134871, 17344.185669413338, 34688.871331619855, 69378.242659636308,
+    138756.98531747091, 277514.47063404095, 555029.44126763148, 1110059.3825350376,
+    2220119.2650699629, 4440239.03013987, 8880478.5602797102, 17760957.620559409,
+    35521915.741118811, 71043831.982237622, 142087664.46447521, 284175329.42895043,
+    568350659.35790086, 1136701319.2158017, 2273402638.9316034
+};
+
 /* 最適な符号化パラメータの計算 */
 static void SRLACoder_CalculateOptimalRiceParameter(
     const double mean, uint32_t *optk, double *bits_per_sample)
 {
     uint32_t k;
-    double rho, fk, bps;
-#define OPTX 0.5127629514437670454896078808815218508243560791015625 /* (x - 1)^2 + ln(2) x ln(x) = 0 の解 */
+    const uint32_t max_k = sizeof(st_rice_parameter_mean_thresholds) / sizeof(st_rice_parameter_mean_thresholds[0]);
 
-    /* 幾何分布のパラメータを最尤推定 */
-    rho = 1.0 / (1.0 + mean);
-
-    /* 最適なパラメータの計算 */
-    k = (uint32_t)SRLAUTILITY_MAX(0, SRLAUtility_Round(SRLAUtility_Log2(log(OPTX) / log(1.0 - rho))));
-
-    /* 平均符号長の計算 */
-    fk = pow(1.0 - rho, (double)(1 << k));
-    bps = k + (1.0 / (1.0 - fk));
+    /* 閾値表から最適なパラメータを求める（超越関数を使わない） */
+    k = 0;
+    while ((k < max_k) && (mean >= st_rice_parameter_mean_thresholds[k])) {
+        k++;
+    }
 
     /* 結果出力 */
     (*optk) = k;
 
+    /* 平均符号長の計算 */
     if (bits_per_sample != NULL) {
-        (*bits_per_sample) = bps;
+        /* 幾何分布のパラメータを最尤推定 */
+        const double rho = 1.0 / (1.0 + mean);
+        const double fk = pow(1.0 - rho, (double)(1 << k));
+        (*bits_per_sample) = k + (1.0 / (1.0 - fk));
     }
-
-#undef OPTX
 }
 
 /* k1に関する偏微分係数の計算 */
@@ -305,7 +337,7 @@ static void SRLACoder_CalculateOptimalRecursiveRiceParameter(
     {
 #define MLNOPTX (0.66794162356) /* -ln(0.5127629514437670454896078808815218508243560791015625) */
         const uint32_t opt_golomb_param = (uint32_t)SRLAUTILITY_MAX(1, MLNOPTX * (1.0 + mean));
-        k2 = SRLAUTILITY_LOG2FLOOR(opt_golomb_param);
+        k2 = SRLAUTILITY_MIN(SRLACODER_MAX_RECURSIVE_RICE_PARAMETER, SRLAUTILITY_LOG2FLOOR(opt_golomb_param));
         k1 = k2 + 1;
 
 #undef MLNOPTX
@@ -323,10 +355,20 @@ static void SRLACoder_CalculateOptimalRecursiveRiceParameter(
     }
 }
 
-/* Rice符号長の出力 */
-static uint32_t Rice_GetCodeLength(uint32_t k, uint32_t uval)
+/* 配列に対してRice符号長を計算 */
+static uint32_t Rice_ComputeCodeLength(const uint32_t *data, uint32_t num_samples, uint32_t k)
 {
-    return 1 + k  + (uval >> k);
+    uint32_t smpl, length;
+
+    SRLA_ASSERT(data != NULL);
+
+    length = (k + 1) * num_samples;
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        length += (data[smpl] >> k);
+    }
+
+    return length;
 }
 
 /* 配列に対して再帰的Rice符号長を計算 */
@@ -339,6 +381,8 @@ static uint32_t RecursiveRice_ComputeCodeLength(const uint32_t *data, uint32_t n
 
     SRLA_ASSERT((k2 + 1) == k1);
     length = (k1 + 1) * num_samples;
+
+    /* 1段目を超えた分を2段目のパラメータで割った値の和を求める */
     for (smpl = 0; smpl < num_samples; smpl++) {
         length += (SRLAUTILITY_MAX(0, (int32_t)data[smpl] - (int32_t)k1pow) >> k2);
     }
@@ -346,12 +390,337 @@ static uint32_t RecursiveRice_ComputeCodeLength(const uint32_t *data, uint32_t n
     return length;
 }
 
+/* 符号付き整数を符号なし整数に変換してバッファに記録し、和と最大値を求める */
+static void SRLACoder_ConvertToUint32AndSum(
+    const int32_t *data, uint32_t num_samples, uint32_t *uval_buffer, uint64_t *sum, uint32_t *max_uval)
+{
+    uint32_t smpl, tmp_max = 0;
+    uint64_t tmp_sum = 0;
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(uval_buffer != NULL);
+    SRLA_ASSERT(sum != NULL);
+    SRLA_ASSERT(max_uval != NULL);
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        const uint32_t uval = SRLAUTILITY_SINT32_TO_UINT32(data[smpl]);
+        uval_buffer[smpl] = uval;
+        tmp_sum += uval;
+        tmp_max = SRLAUTILITY_MAX(tmp_max, uval);
+    }
+
+    (*sum) = tmp_sum;
+    (*max_uval) = tmp_max;
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* 32bit整数4要素の水平加算 */
+SRLA_TARGET_SSE41 static uint32_t SRLACoder_HorizontalAdd128(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(v);
+}
+
+/* 32bit整数8要素の水平加算 */
+SRLA_TARGET_AVX2 static uint32_t SRLACoder_HorizontalAdd256(__m256i v)
+{
+    __m128i v128 = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    v128 = _mm_add_epi32(v128, _mm_shuffle_epi32(v128, _MM_SHUFFLE(1, 0, 3, 2)));
+    v128 = _mm_add_epi32(v128, _mm_shuffle_epi32(v128, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (uint32_t)_mm_cvtsi128_si32(v128);
+}
+
+/* 配列に対してRice符号長を計算 SSE4.1版 */
+SRLA_TARGET_SSE41 static uint32_t Rice_ComputeCodeLengthSSE41(const uint32_t *data, uint32_t num_samples, uint32_t k)
+{
+    uint32_t smpl = 0, length;
+    const __m128i vk = _mm_cvtsi32_si128((int32_t)k);
+    __m128i vlength = _mm_setzero_si128();
+
+    SRLA_ASSERT(data != NULL);
+
+    for (; (smpl + 4) <= num_samples; smpl += 4) {
+        const __m128i vdata = _mm_loadu_si128((const __m128i *)&data[smpl]);
+        vlength = _mm_add_epi32(vlength, _mm_srl_epi32(vdata, vk));
+    }
+    length = (k + 1) * smpl + SRLACoder_HorizontalAdd128(vlength);
+
+    /* 余ったサンプル分の処理 */
+    return length + Rice_ComputeCodeLength(&data[smpl], num_samples - smpl, k);
+}
+
+/* 配列に対してRice符号長を計算 AVX2版 */
+SRLA_TARGET_AVX2 static uint32_t Rice_ComputeCodeLengthAVX2(const uint32_t *data, uint32_t num_samples, uint32_t k)
+{
+    uint32_t smpl = 0, length;
+    const __m128i vk = _mm_cvtsi32_si128((int32_t)k);
+    __m256i vlength = _mm256_setzero_si256();
+
+    SRLA_ASSERT(data != NULL);
+
+    for (; (smpl + 8) <= num_samples; smpl += 8) {
+        const __m256i vdata = _mm256_loadu_si256((const __m256i *)&data[smpl]);
+        vlength = _mm256_add_epi32(vlength, _mm256_srl_epi32(vdata, vk));
+    }
+    length = (k + 1) * smpl + SRLACoder_HorizontalAdd256(vlength);
+
+    /* 余ったサンプル分の処理 */
+    return length + Rice_ComputeCodeLength(&data[smpl], num_samples - smpl, k);
+}
+
+/* 配列に対して再帰的Rice符号長を計算 SSE4.1版 */
+SRLA_TARGET_SSE41 static uint32_t RecursiveRice_ComputeCodeLengthSSE41(const uint32_t *data, uint32_t num_samples, uint32_t k1, uint32_t k2)
+{
+    uint32_t smpl = 0, length;
+    const __m128i vk1pow = _mm_set1_epi32((int32_t)(1U << k1));
+    const __m128i vk2 = _mm_cvtsi32_si128((int32_t)k2);
+    const __m128i vzero = _mm_setzero_si128();
+    __m128i vlength = _mm_setzero_si128();
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT((k2 + 1) == k1);
+
+    /* 1段目を超えた分を2段目のパラメータで割った値の和を求める */
+    for (; (smpl + 4) <= num_samples; smpl += 4) {
+        const __m128i vdata = _mm_loadu_si128((const __m128i *)&data[smpl]);
+        const __m128i vexcess = _mm_max_epi32(vzero, _mm_sub_epi32(vdata, vk1pow));
+        vlength = _mm_add_epi32(vlength, _mm_srl_epi32(vexcess, vk2));
+    }
+    length = (k1 + 1) * smpl + SRLACoder_HorizontalAdd128(vlength);
+
+    /* 余ったサンプル分の処理 */
+    return length + RecursiveRice_ComputeCodeLength(&data[smpl], num_samples - smpl, k1, k2);
+}
+
+/* 配列に対して再帰的Rice符号長を計算 AVX2版 */
+SRLA_TARGET_AVX2 static uint32_t RecursiveRice_ComputeCodeLengthAVX2(const uint32_t *data, uint32_t num_samples, uint32_t k1, uint32_t k2)
+{
+    uint32_t smpl = 0, length;
+    const __m256i vk1pow = _mm256_set1_epi32((int32_t)(1U << k1));
+    const __m128i vk2 = _mm_cvtsi32_si128((int32_t)k2);
+    const __m256i vzero = _mm256_setzero_si256();
+    __m256i vlength = _mm256_setzero_si256();
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT((k2 + 1) == k1);
+
+    /* 1段目を超えた分を2段目のパラメータで割った値の和を求める */
+    for (; (smpl + 8) <= num_samples; smpl += 8) {
+        const __m256i vdata = _mm256_loadu_si256((const __m256i *)&data[smpl]);
+        const __m256i vexcess = _mm256_max_epi32(vzero, _mm256_sub_epi32(vdata, vk1pow));
+        vlength = _mm256_add_epi32(vlength, _mm256_srl_epi32(vexcess, vk2));
+    }
+    length = (k1 + 1) * smpl + SRLACoder_HorizontalAdd256(vlength);
+
+    /* 余ったサンプル分の処理 */
+    return length + RecursiveRice_ComputeCodeLength(&data[smpl], num_samples - smpl, k1, k2);
+}
+
+/* 符号付き整数を符号なし整数に変換してバッファに記録し、和と最大値を求める SSE4.1版 */
+SRLA_TARGET_SSE41 static void SRLACoder_ConvertToUint32AndSumSSE41(
+    const int32_t *data, uint32_t num_samples, uint32_t *uval_buffer, uint64_t *sum, uint32_t *max_uval)
+{
+    uint32_t smpl = 0, tmp_max, i;
+    uint64_t tmp_sum;
+    const __m128i vzero = _mm_setzero_si128();
+    __m128i vsum = _mm_setzero_si128();
+    __m128i vmax = _mm_setzero_si128();
+    uint64_t lanes[2];
+    uint32_t maxs[4];
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(uval_buffer != NULL);
+    SRLA_ASSERT(sum != NULL);
+    SRLA_ASSERT(max_uval != NULL);
+
+    for (; (smpl + 4) <= num_samples; smpl += 4) {
+        const __m128i vdata = _mm_loadu_si128((const __m128i *)&data[smpl]);
+        /* (x << 1) ^ (x >> 31) */
+        const __m128i vuval = _mm_xor_si128(_mm_slli_epi32(vdata, 1), _mm_srai_epi32(vdata, 31));
+        _mm_storeu_si128((__m128i *)&uval_buffer[smpl], vuval);
+        vmax = _mm_max_epu32(vmax, vuval);
+        /* 和は桁あふれしないよう64bitで累積 */
+        vsum = _mm_add_epi64(vsum, _mm_unpacklo_epi32(vuval, vzero));
+        vsum = _mm_add_epi64(vsum, _mm_unpackhi_epi32(vuval, vzero));
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLACoder_ConvertToUint32AndSum(&data[smpl], num_samples - smpl, &uval_buffer[smpl], &tmp_sum, &tmp_max);
+
+    _mm_storeu_si128((__m128i *)lanes, vsum);
+    tmp_sum += lanes[0] + lanes[1];
+    _mm_storeu_si128((__m128i *)maxs, vmax);
+    for (i = 0; i < 4; i++) {
+        tmp_max = SRLAUTILITY_MAX(tmp_max, maxs[i]);
+    }
+
+    (*sum) = tmp_sum;
+    (*max_uval) = tmp_max;
+}
+
+/* 符号付き整数を符号なし整数に変換してバッファに記録し、和と最大値を求める AVX2版 */
+SRLA_TARGET_AVX2 static void SRLACoder_ConvertToUint32AndSumAVX2(
+    const int32_t *data, uint32_t num_samples, uint32_t *uval_buffer, uint64_t *sum, uint32_t *max_uval)
+{
+    uint32_t smpl = 0, tmp_max, i;
+    uint64_t tmp_sum;
+    __m256i vsum = _mm256_setzero_si256();
+    __m256i vmax = _mm256_setzero_si256();
+    uint64_t lanes[4];
+    uint32_t maxs[4];
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(uval_buffer != NULL);
+    SRLA_ASSERT(sum != NULL);
+    SRLA_ASSERT(max_uval != NULL);
+
+    for (; (smpl + 8) <= num_samples; smpl += 8) {
+        const __m256i vdata = _mm256_loadu_si256((const __m256i *)&data[smpl]);
+        /* (x << 1) ^ (x >> 31) */
+        const __m256i vuval = _mm256_xor_si256(_mm256_slli_epi32(vdata, 1), _mm256_srai_epi32(vdata, 31));
+        _mm256_storeu_si256((__m256i *)&uval_buffer[smpl], vuval);
+        vmax = _mm256_max_epu32(vmax, vuval);
+        /* 和は桁あふれしないよう64bitで累積 */
+        vsum = _mm256_add_epi64(vsum, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(vuval)));
+        vsum = _mm256_add_epi64(vsum, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(vuval, 1)));
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLACoder_ConvertToUint32AndSum(&data[smpl], num_samples - smpl, &uval_buffer[smpl], &tmp_sum, &tmp_max);
+
+    _mm256_storeu_si256((__m256i *)lanes, vsum);
+    tmp_sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_storeu_si128((__m128i *)maxs, _mm_max_epu32(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1)));
+    for (i = 0; i < 4; i++) {
+        tmp_max = SRLAUTILITY_MAX(tmp_max, maxs[i]);
+    }
+
+    (*sum) = tmp_sum;
+    (*max_uval) = tmp_max;
+}
+
+/* 配列に対してRice符号長を計算 AVX-512版 */
+SRLA_TARGET_AVX512 static uint32_t Rice_ComputeCodeLengthAVX512(const uint32_t *data, uint32_t num_samples, uint32_t k)
+{
+    uint32_t smpl = 0, length;
+    const __m128i vk = _mm_cvtsi32_si128((int32_t)k);
+    __m512i vlength = _mm512_setzero_si512();
+
+    SRLA_ASSERT(data != NULL);
+
+    for (; (smpl + 16) <= num_samples; smpl += 16) {
+        const __m512i vdata = _mm512_loadu_si512(&data[smpl]);
+        vlength = _mm512_add_epi32(vlength, _mm512_srl_epi32(vdata, vk));
+    }
+    length = (k + 1) * smpl + (uint32_t)_mm512_reduce_add_epi32(vlength);
+
+    /* 余ったサンプル分の処理 */
+    return length + Rice_ComputeCodeLength(&data[smpl], num_samples - smpl, k);
+}
+
+/* 配列に対して再帰的Rice符号長を計算 AVX-512版 */
+SRLA_TARGET_AVX512 static uint32_t RecursiveRice_ComputeCodeLengthAVX512(const uint32_t *data, uint32_t num_samples, uint32_t k1, uint32_t k2)
+{
+    uint32_t smpl = 0, length;
+    const __m512i vk1pow = _mm512_set1_epi32((int32_t)(1U << k1));
+    const __m128i vk2 = _mm_cvtsi32_si128((int32_t)k2);
+    const __m512i vzero = _mm512_setzero_si512();
+    __m512i vlength = _mm512_setzero_si512();
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT((k2 + 1) == k1);
+
+    /* 1段目を超えた分を2段目のパラメータで割った値の和を求める */
+    for (; (smpl + 16) <= num_samples; smpl += 16) {
+        const __m512i vdata = _mm512_loadu_si512(&data[smpl]);
+        const __m512i vexcess = _mm512_max_epi32(vzero, _mm512_sub_epi32(vdata, vk1pow));
+        vlength = _mm512_add_epi32(vlength, _mm512_srl_epi32(vexcess, vk2));
+    }
+    length = (k1 + 1) * smpl + (uint32_t)_mm512_reduce_add_epi32(vlength);
+
+    /* 余ったサンプル分の処理 */
+    return length + RecursiveRice_ComputeCodeLength(&data[smpl], num_samples - smpl, k1, k2);
+}
+
+/* 符号付き整数を符号なし整数に変換してバッファに記録し、和と最大値を求める AVX-512版 */
+SRLA_TARGET_AVX512 static void SRLACoder_ConvertToUint32AndSumAVX512(
+    const int32_t *data, uint32_t num_samples, uint32_t *uval_buffer, uint64_t *sum, uint32_t *max_uval)
+{
+    uint32_t smpl = 0, tmp_max, vec_max;
+    uint64_t tmp_sum;
+    __m512i vsum = _mm512_setzero_si512();
+    __m512i vmax = _mm512_setzero_si512();
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(uval_buffer != NULL);
+    SRLA_ASSERT(sum != NULL);
+    SRLA_ASSERT(max_uval != NULL);
+
+    for (; (smpl + 16) <= num_samples; smpl += 16) {
+        const __m512i vdata = _mm512_loadu_si512(&data[smpl]);
+        /* (x << 1) ^ (x >> 31) */
+        const __m512i vuval = _mm512_xor_si512(_mm512_slli_epi32(vdata, 1), _mm512_srai_epi32(vdata, 31));
+        _mm512_storeu_si512(&uval_buffer[smpl], vuval);
+        vmax = _mm512_max_epu32(vmax, vuval);
+        /* 和は桁あふれしないよう64bitで累積 */
+        vsum = _mm512_add_epi64(vsum, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(vuval)));
+        vsum = _mm512_add_epi64(vsum, _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(vuval, 1)));
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLACoder_ConvertToUint32AndSum(&data[smpl], num_samples - smpl, &uval_buffer[smpl], &tmp_sum, &tmp_max);
+
+    tmp_sum += (uint64_t)_mm512_reduce_add_epi64(vsum);
+    vec_max = _mm512_reduce_max_epu32(vmax);
+    tmp_max = SRLAUTILITY_MAX(tmp_max, vec_max);
+
+    (*sum) = tmp_sum;
+    (*max_uval) = tmp_max;
+}
+#endif
+
+/* 命令セットごとの符号長計算関数テーブル */
+static const struct SRLACoderFunctions st_coder_functions_scalar = {
+    Rice_ComputeCodeLength, RecursiveRice_ComputeCodeLength, SRLACoder_ConvertToUint32AndSum
+};
+#if defined(SRLA_ENABLE_X86_SIMD)
+static const struct SRLACoderFunctions st_coder_functions_sse41 = {
+    Rice_ComputeCodeLengthSSE41, RecursiveRice_ComputeCodeLengthSSE41, SRLACoder_ConvertToUint32AndSumSSE41
+};
+static const struct SRLACoderFunctions st_coder_functions_avx2 = {
+    Rice_ComputeCodeLengthAVX2, RecursiveRice_ComputeCodeLengthAVX2, SRLACoder_ConvertToUint32AndSumAVX2
+};
+static const struct SRLACoderFunctions st_coder_functions_avx512 = {
+    Rice_ComputeCodeLengthAVX512, RecursiveRice_ComputeCodeLengthAVX512, SRLACoder_ConvertToUint32AndSumAVX512
+};
+#endif
+
+/* 命令セットに対応する符号長計算関数テーブルを取得 */
+static const struct SRLACoderFunctions *SRLACoder_GetFunctions(SRLASIMDInstructionSet instruction_set)
+{
+    switch (instruction_set) {
+#if defined(SRLA_ENABLE_X86_SIMD)
+    case SRLA_SIMD_AVX512:
+        return &st_coder_functions_avx512;
+    case SRLA_SIMD_AVX2:
+        return &st_coder_functions_avx2;
+    case SRLA_SIMD_SSE41:
+        return &st_coder_functions_sse41;
+#endif
+    default:
+        break;
+    }
+
+    return &st_coder_functions_scalar;
+}
+
 static void SRLACoder_SearchBestCodeAndPartition(
     struct SRLACoder *coder, const int32_t *data, uint32_t num_samples,
     SRLACoderCodeType *code_type, uint32_t *best_partition_order, uint32_t *best_code_length)
 {
     uint32_t max_porder, max_num_partitions;
-    uint32_t porder, part, best_porder, min_bits, smpl, max_uval;
+    uint32_t porder, part, best_porder, min_bits, max_uval;
     SRLACoderCodeType tmp_code_type = SRLACODER_CODE_TYPE_INVALID;
 
     /* 最大分割数の決定 */
@@ -370,15 +739,13 @@ static void SRLACoder_SearchBestCodeAndPartition(
         max_uval = 0;
         for (part = 0; part < max_num_partitions; part++) {
             const uint32_t nsmpl = num_samples / max_num_partitions;
-            double part_sum = 0.0;
-            for (smpl = 0; smpl < nsmpl; smpl++) {
-                /* uint32の変換結果をキャッシュ */
-                const uint32_t uval = SRLAUTILITY_SINT32_TO_UINT32(data[part * nsmpl + smpl]);
-                coder->uval_buffer[part * nsmpl + smpl] = uval;
-                part_sum += uval;
-                max_uval = SRLAUTILITY_MAX(max_uval, uval);
-            }
-            coder->part_mean[max_porder][part] = part_sum / nsmpl;
+            uint64_t part_sum;
+            uint32_t part_max;
+            /* uint32の変換結果をキャッシュ */
+            coder->functions->convert_to_uint32_and_sum(
+                &data[part * nsmpl], nsmpl, &coder->uval_buffer[part * nsmpl], &part_sum, &part_max);
+            max_uval = SRLAUTILITY_MAX(max_uval, part_max);
+            coder->part_mean[max_porder][part] = (double)part_sum / nsmpl;
         }
 
         /* より大きい分割の平均は、小さい分割の平均をマージして計算 */
@@ -415,9 +782,7 @@ static void SRLACoder_SearchBestCodeAndPartition(
             uint32_t bits = SRLACODER_LOG2_MAX_NUM_PARTITIONS;
             for (part = 0; part < (1U << porder); part++) {
                 SRLACoder_CalculateOptimalRiceParameter(coder->part_mean[porder][part], &k, NULL);
-                for (smpl = 0; smpl < nsmpl; smpl++) {
-                    bits += Rice_GetCodeLength(k, coder->uval_buffer[part * nsmpl + smpl]);
-                }
+                bits += coder->functions->rice_code_length(&coder->uval_buffer[part * nsmpl], nsmpl, k);
                 if (part == 0) {
                     bits += SRLACODER_RICE_PARAMETER_BITS;
                 } else {
@@ -446,7 +811,7 @@ static void SRLACoder_SearchBestCodeAndPartition(
             uint32_t bits = SRLACODER_LOG2_MAX_NUM_PARTITIONS;
             for (part = 0; part < (1U << porder); part++) {
                 SRLACoder_CalculateOptimalRecursiveRiceParameter(coder->part_mean[porder][part], &k1, &k2, NULL);
-                bits += RecursiveRice_ComputeCodeLength(&coder->uval_buffer[part * nsmpl], nsmpl, k1, k2);
+                bits += coder->functions->recursive_rice_code_length(&coder->uval_buffer[part * nsmpl], nsmpl, k1, k2);
                 if (part == 0) {
                     bits += SRLACODER_RICE_PARAMETER_BITS;
                 } else {
@@ -594,14 +959,109 @@ static void SRLACoder_EncodePartitionedRecursiveRice(struct SRLACoder *coder, st
     }
 }
 
+/* 復号テーブルの作成 */
+void SRLACoder_BuildDecodeTable(struct SRLACoderDecodeTable *table)
+{
+    uint32_t k2, pattern;
+
+    SRLA_ASSERT(table != NULL);
+
+    for (k2 = 0; k2 < SRLACODER_NUM_DECODE_TABLES; k2++) {
+        for (pattern = 0; pattern < (1 << SRLACODER_DECODE_TABLE_BITS); pattern++) {
+            uint32_t pos = 0, num_values = 0;
+            memset(&table->entries[k2][pattern], 0, sizeof(table->entries[k2][pattern]));
+            /* 上位ビットから符号を切り出せる限り復号 */
+            while (num_values < SRLACODER_DECODE_TABLE_MAX_NUM_VALUES) {
+                uint32_t quot = 0, rest_bits, rest, uval;
+                const uint32_t remain = SRLACODER_DECODE_TABLE_BITS - pos;
+                /* 商部（0のラン） */
+                while ((quot < remain) && !((pattern >> (remain - quot - 1)) & 1)) {
+                    quot++;
+                }
+                /* 終端の1と剰余部が参照ビットに収まらない */
+                rest_bits = k2 + !(quot);
+                if ((quot + 1 + rest_bits) > remain) {
+                    break;
+                }
+                /* 剰余部 */
+                rest = (pattern >> (remain - quot - 1 - rest_bits)) & ((1U << rest_bits) - 1);
+                uval = rest | ((quot + !!(quot)) << k2);
+                table->entries[k2][pattern].values[num_values] = (int16_t)SRLAUTILITY_UINT32_TO_SINT32(uval);
+                pos += quot + 1 + rest_bits;
+                num_values++;
+            }
+            table->entries[k2][pattern].num_values = (uint8_t)num_values;
+            table->entries[k2][pattern].num_bits = (uint8_t)pos;
+        }
+    }
+}
+
+/* 表引きによるデータ配列の再帰的Golomb--Rice復号 */
+static void SRLACoder_DecodeRecursiveRiceByTable(
+    const struct SRLACoderDecodeTable *table,
+    struct BitStream *stream, int32_t *data, uint32_t num_samples, const uint32_t k2)
+{
+    uint32_t i, uval;
+
+    SRLA_ASSERT(table != NULL);
+    SRLA_ASSERT(stream != NULL);
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(k2 < SRLACODER_NUM_DECODE_TABLES);
+
+    /* 1エントリ分の値を書き込める間は表引きで復号 */
+    while (num_samples >= SRLACODER_DECODE_TABLE_MAX_NUM_VALUES) {
+        uint32_t window, consumed = 0;
+
+        /* 32bit先読みし、その範囲内で表引きを繰り返す */
+        BitReader_PeekBits(stream, &window, 32);
+        while ((consumed <= (32 - SRLACODER_DECODE_TABLE_BITS))
+                && (num_samples >= SRLACODER_DECODE_TABLE_MAX_NUM_VALUES)) {
+            const uint32_t index
+                = (window >> (32 - SRLACODER_DECODE_TABLE_BITS - consumed)) & ((1U << SRLACODER_DECODE_TABLE_BITS) - 1);
+            const uint32_t num_values = table->entries[k2][index].num_values;
+            if (num_values == 0) {
+                break;
+            }
+            /* 分岐を減らすため常に最大数をコピーし、復号できた数だけ進める */
+            for (i = 0; i < SRLACODER_DECODE_TABLE_MAX_NUM_VALUES; i++) {
+                data[i] = table->entries[k2][index].values[i];
+            }
+            data += num_values;
+            num_samples -= num_values;
+            consumed += table->entries[k2][index].num_bits;
+        }
+        BitReader_SkipBits(stream, consumed);
+
+        /* 参照ビットに収まらない長い符号は1つずつ復号 */
+        if (consumed == 0) {
+            RecursiveRice_GetCode(stream, k2 + 1, k2, &uval);
+            *(data++) = SRLAUTILITY_UINT32_TO_SINT32(uval);
+            num_samples--;
+        }
+    }
+
+    /* 残りのサンプル */
+    while (num_samples--) {
+        RecursiveRice_GetCode(stream, k2 + 1, k2, &uval);
+        *(data++) = SRLAUTILITY_UINT32_TO_SINT32(uval);
+    }
+}
+
 /* データ配列の再帰的Golomb--Rice復号 */
 static void SRLACoder_DecodeRecursiveRice(
+    const struct SRLACoderDecodeTable *table,
     struct BitStream *stream, int32_t *data, uint32_t num_samples, const uint32_t k1, const uint32_t k2)
 {
     SRLA_ASSERT(stream != NULL);
     SRLA_ASSERT(data != NULL);
     SRLA_ASSERT(k1 == (k2 + 1));
 
+    /* 小さいパラメータでは複数の符号を表引きでまとめて復号 */
+    if ((table != NULL) && (k2 < SRLACODER_NUM_DECODE_TABLES)) {
+        SRLACoder_DecodeRecursiveRiceByTable(table, stream, data, num_samples, k2);
+        return;
+    }
+
     /* 特定のk2パラメータのときのデコード処理を定義 */
 #define DEFINE_DECODING_PROCEDURE_CASE(k2_param, stream, data, num_samples)\
     case (k2_param):\
@@ -643,7 +1103,8 @@ static void SRLACoder_DecodeRecursiveRice(
 }
 
 /* 符号付き整数配列の復号 */
-static void SRLACoder_DecodePartitionedRecursiveRice(struct BitStream *stream, int32_t *data, uint32_t num_samples)
+static void SRLACoder_DecodePartitionedRecursiveRice(
+    const struct SRLACoderDecodeTable *table, struct BitStream *stream, int32_t *data, uint32_t num_samples)
 {
     uint32_t smpl, part, nsmpl, best_porder;
 
@@ -688,7 +1149,7 @@ static void SRLACoder_DecodePartitionedRecursiveRice(struct BitStream *stream, i
                 BitReader_GetZeroRunLength(stream, &udiff);
                 k2 = (uint32_t)((int32_t)k2 + SRLAUTILITY_UINT32_TO_SINT32(udiff));
             }
-            SRLACoder_DecodeRecursiveRice(stream, &data[part * nsmpl], nsmpl, k2 + 1, k2);
+            SRLACoder_DecodeRecursiveRice(table, stream, &data[part * nsmpl], nsmpl, k2 + 1, k2);
         }
     }
     break;
@@ -723,10 +1184,11 @@ void SRLACoder_Encode(struct SRLACoder *coder, struct BitStream *stream, const i
 }
 
 /* 符号付き整数配列の復号 */
-void SRLACoder_Decode(struct BitStream *stream, int32_t *data, uint32_t num_samples)
+void SRLACoder_Decode(
+    const struct SRLACoderDecodeTable *table, struct BitStream *stream, int32_t *data, uint32_t num_samples)
 {
-    SRLA_ASSERT((stream != NULL) && (data != NULL));
+    SRLA_ASSERT((table != NULL) && (stream != NULL) && (data != NULL));
     SRLA_ASSERT(num_samples != 0);
 
-    SRLACoder_DecodePartitionedRecursiveRice(stream, data, num_samples);
+    SRLACoder_DecodePartitionedRecursiveRice(table, stream, data, num_samples);
 }
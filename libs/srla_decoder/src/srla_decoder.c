@@ -5,6 +5,8 @@
 #include "srla_lpc_synthesize.h"
 #include "srla_internal.h"
 #include "srla_utility.h"
+#include "srla_thread.h"
+#include "srla_simd.h"
 #include "srla_coder.h"
 #include "byte_array.h"
 #include "bit_stream.h"
@@ -21,6 +23,14 @@
 #define SRLADECODER_CLEAR_STATUS_FLAG(decoder, flag)  ((decoder->status_flags) &= ~(flag))
 #define SRLADECODER_GET_STATUS_FLAG(decoder, flag)    ((decoder->status_flags) & (flag))
 
+/* ブロックヘッダサイズ */
+#define SRLADECODER_BLOCK_HEADER_SIZE 11
+
+/* ストリーミングデコードで扱うブロックの最大サイズ */
+/* 補足）生データブロックのサンプルあたりサイズが32bitを越えないことを想定 */
+#define SRLADECODER_CALCULATE_MAX_BLOCK_SIZE(num_channels, max_num_samples_per_block)\
+    (SRLADECODER_BLOCK_HEADER_SIZE + (int32_t)sizeof(int32_t) * (int32_t)(num_channels) * (int32_t)(max_num_samples_per_block))
+
 /* デコーダハンドル */
 struct SRLADecoder {
     struct SRLAHeader header; /* ヘッダ */
@@ -33,31 +43,83 @@ struct SRLADecoder {
     int32_t **ltp_coef; /* 各チャンネルのLTP係数(int) */
     uint32_t *ltp_period; /* 各チャンネルのLTP周期 */
     uint32_t *ltp_order; /* 各チャンネルのLTP次数 */
-    const struct StaticHuffmanTree *param_tree; /* 係数のハフマン木 */
-    const struct StaticHuffmanTree *sum_param_tree; /* 和を取った係数のハフマン木 */
+    struct StaticHuffmanDecodeTable param_table; /* 係数のハフマン符号復号テーブル */
+    struct StaticHuffmanDecodeTable sum_param_table; /* 和を取った係数のハフマン符号復号テーブル */
+    struct SRLACoderDecodeTable coder_table; /* 残差の復号テーブル */
+    const struct SRLASynthesizeFunctions *synthesize; /* 実行環境に合わせて選択した合成関数 */
     const struct SRLAParameterPreset *parameter_preset; /* パラメータプリセット */
+    uint32_t max_num_threads; /* 最大スレッド数 */
+    struct SRLADecoder **workers; /* 並列処理用のデコーダハンドル（先頭は自分自身） */
+    struct SRLADecoderParallelTask *tasks; /* 並列処理用のタスク */
+    int32_t **buffer; /* インターリーブ出力時の信号バッファ */
+    uint32_t max_num_buffer_samples; /* 信号バッファのチャンネルあたりサンプル数 */
     uint8_t status_flags; /* 内部状態フラグ */
     void *work; /* ワーク領域先頭ポインタ */
 };
 
+/* 並列デコードタスク */
+struct SRLADecoderParallelTask {
+    struct SRLADecoder *decoder; /* 処理を担当するデコーダハンドル */
+    const uint8_t *data; /* 担当区間の先頭ブロック */
+    uint32_t data_size; /* 担当区間のデータサイズ */
+    int32_t *buffer[SRLA_MAX_NUM_CHANNELS]; /* 担当区間の出力先 */
+    uint32_t num_samples; /* 担当区間のサンプル数 */
+    SRLAApiResult result; /* 処理結果 */
+};
+
+/* ストリーミングデコーダハンドル */
+struct SRLAStreamDecoder {
+    struct SRLADecoder *decoder; /* デコーダハンドル */
+    uint8_t *buffer; /* 入力データの再構成バッファ */
+    uint32_t buffer_size; /* 再構成バッファの容量 */
+    uint32_t read_offset; /* 再構成バッファ内の未処理データ先頭位置 */
+    uint32_t write_offset; /* 再構成バッファ内の有効データ終端位置 */
+    uint32_t max_block_size; /* ヘッダから決まるブロックの最大サイズ */
+    int32_t **output; /* デコードサンプルバッファ */
+    uint32_t max_num_channels; /* 最大チャンネル数 */
+    uint32_t max_num_samples_per_block; /* ブロックあたり最大サンプル数 */
+    uint32_t num_decoded_samples; /* デコードした総サンプル数 */
+    SRLAStreamDecoder_OutputCallback output_callback; /* 出力コールバック */
+    void *user_data; /* コールバックに渡すユーザデータ */
+    uint8_t header_decoded; /* ヘッダデコード済み？ */
+    uint8_t resyncing; /* 再同期中？ */
+    uint8_t detect_corruption; /* 再同期が発生した？ */
+    uint8_t started; /* デコード開始済み？ */
+    uint8_t alloced_by_own; /* 領域を自前確保しているか？ */
+    void *work; /* ワーク領域先頭ポインタ */
+};
+
+/* インターリーブ出力先 */
+struct SRLADecoderInterleavedOutput {
+    void *data; /* 出力先（ブロック先頭サンプルの位置） */
+    SRLAPcmFormat format; /* サンプル形式 */
+};
+
 /* 生データブロックデコード */
 static SRLAApiResult SRLADecoder_DecodeRawData(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
-        uint32_t *decode_size);
+        const struct SRLADecoderInterleavedOutput *output, uint32_t *decode_size);
 /* 圧縮データブロックデコード */
 static SRLAApiResult SRLADecoder_DecodeCompressData(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
-        uint32_t *decode_size);
+        const struct SRLADecoderInterleavedOutput *output, uint32_t *decode_size);
 /* 無音データブロックデコード */
 static SRLAApiResult SRLADecoder_DecodeSilentData(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
-        uint32_t *decode_size);
+        const struct SRLADecoderInterleavedOutput *output, uint32_t *decode_size);
+/* 単一データブロックデコード（出力先を指定） */
+static SRLAApiResult SRLADecoder_DecodeBlockCore(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+        const struct SRLADecoderInterleavedOutput *output,
+        uint32_t *decode_size, uint32_t *num_decode_samples);
 
 /* ヘッダデコード */
 SRLAApiResult SRLADecoder_DecodeHeader(
@@ -196,6 +258,11 @@ int32_t SRLADecoder_CalculateWorkSize(const struct SRLADecoderConfig *config)
         return -1;
     }
 
+    /* スレッド数が範囲外 補足）0は1スレッドとして扱う */
+    if (config->max_num_threads > SRLA_MAX_NUM_THREADS) {
+        return -1;
+    }
+
     /* 構造体サイズ（+メモリアラインメント） */
     work_size = sizeof(struct SRLADecoder) + SRLA_MEMORY_ALIGNMENT;
     /* デエンファシスフィルタのサイズ */
@@ -213,6 +280,32 @@ int32_t SRLADecoder_CalculateWorkSize(const struct SRLADecoderConfig *config)
     work_size += (int32_t)(SRLA_MEMORY_ALIGNMENT + sizeof(uint32_t) * config->max_num_channels);
     /* LTP次数 */
     work_size += (int32_t)(SRLA_MEMORY_ALIGNMENT + sizeof(uint32_t) * config->max_num_channels);
+    /* インターリーブ出力時の信号バッファ */
+    if (config->max_num_samples_per_block > 0) {
+        work_size += (int32_t)SRLA_CALCULATE_2DIMARRAY_WORKSIZE(int32_t, config->max_num_channels, config->max_num_samples_per_block);
+    }
+
+    /* 並列処理用領域のサイズ */
+    if (config->max_num_threads > 1) {
+        int32_t worker_size;
+        struct SRLADecoderConfig worker_config = (*config);
+        worker_config.max_num_threads = 1;
+        /* 補足）並列デコードはチャンネル毎の出力のみ対応するため、ワーカーに信号バッファは不要 */
+        worker_config.max_num_samples_per_block = 0;
+        /* ワーカーのデコーダハンドル（先頭は自分自身を使う） */
+        if ((worker_size = SRLADecoder_CalculateWorkSize(&worker_config)) < 0) {
+            return -1;
+        }
+        if ((work_size = SRLAUtility_AddWorkSize(work_size, config->max_num_threads - 1, worker_size)) < 0) {
+            return -1;
+        }
+        /* ハンドルへのポインタ・タスク */
+        if (((work_size = SRLAUtility_AddWorkSize(work_size, 2, SRLA_MEMORY_ALIGNMENT)) < 0)
+                || ((work_size = SRLAUtility_AddWorkSize(work_size, config->max_num_threads,
+                        (int32_t)(sizeof(struct SRLADecoder *) + sizeof(struct SRLADecoderParallelTask)))) < 0)) {
+            return -1;
+        }
+    }
 
     return work_size;
 }
@@ -237,11 +330,17 @@ struct SRLADecoder *SRLADecoder_Create(const struct SRLADecoderConfig *config, v
     /* 引数チェック */
     if ((config == NULL) || (work == NULL)
             || (work_size < SRLADecoder_CalculateWorkSize(config))) {
+        if (tmp_alloc_by_own == 1) {
+            free(work);
+        }
         return NULL;
     }
 
     /* コンフィグチェック */
     if (config->max_num_channels == 0) {
+        if (tmp_alloc_by_own == 1) {
+            free(work);
+        }
         return NULL;
     }
 
@@ -257,6 +356,11 @@ struct SRLADecoder *SRLADecoder_Create(const struct SRLADecoderConfig *config, v
     decoder->work = work;
     decoder->max_num_channels = config->max_num_channels;
     decoder->max_num_parameters = config->max_num_parameters;
+    decoder->max_num_threads = SRLAUTILITY_MAX(config->max_num_threads, 1);
+    decoder->workers = NULL;
+    decoder->tasks = NULL;
+    decoder->buffer = NULL;
+    decoder->max_num_buffer_samples = config->max_num_samples_per_block;
     decoder->status_flags = 0;  /* 状態クリア */
     if (tmp_alloc_by_own == 1) {
         SRLADECODER_SET_STATUS_FLAG(decoder, SRLADECODER_STATUS_FLAG_ALLOCED_BY_OWN);
@@ -292,6 +396,44 @@ struct SRLADecoder *SRLADecoder_Create(const struct SRLADecoderConfig *config, v
     work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
     decoder->ltp_order = (uint32_t *)work_ptr;
     work_ptr += config->max_num_channels * sizeof(uint32_t);
+    /* インターリーブ出力時の信号バッファ */
+    if (config->max_num_samples_per_block > 0) {
+        SRLA_ALLOCATE_2DIMARRAY(decoder->buffer,
+                work_ptr, int32_t, config->max_num_channels, config->max_num_samples_per_block);
+    }
+
+    /* 並列処理用領域 */
+    if (config->max_num_threads > 1) {
+        uint32_t t;
+        int32_t worker_size;
+        struct SRLADecoderConfig worker_config = (*config);
+        worker_config.max_num_threads = 1;
+        worker_config.max_num_samples_per_block = 0;
+        worker_size = SRLADecoder_CalculateWorkSize(&worker_config);
+
+        /* ハンドルへのポインタ */
+        work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+        decoder->workers = (struct SRLADecoder **)work_ptr;
+        work_ptr += sizeof(struct SRLADecoder *) * config->max_num_threads;
+
+        /* タスク */
+        work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+        decoder->tasks = (struct SRLADecoderParallelTask *)work_ptr;
+        work_ptr += sizeof(struct SRLADecoderParallelTask) * config->max_num_threads;
+
+        /* ワーカーのデコーダハンドル作成 先頭は自分自身 */
+        decoder->workers[0] = decoder;
+        for (t = 1; t < config->max_num_threads; t++) {
+            if ((decoder->workers[t] = SRLADecoder_Create(&worker_config, work_ptr, worker_size)) == NULL) {
+                /* 補足）ワーカーは自分のワーク領域内に作成しているため、解放は自前確保した領域のみでよい */
+                if (tmp_alloc_by_own == 1) {
+                    free(work);
+                }
+                return NULL;
+            }
+            work_ptr += worker_size;
+        }
+    }
 
     /* バッファオーバーランチェック */
     /* 補足）既にメモリを破壊している可能性があるので、チェックに失敗したら落とす */
@@ -304,9 +446,15 @@ struct SRLADecoder *SRLADecoder_Create(const struct SRLADecoderConfig *config, v
         }
     }
 
-    /* ハフマン木作成 */
-    decoder->param_tree = SRLA_GetParameterHuffmanTree();
-    decoder->sum_param_tree = SRLA_GetSumParameterHuffmanTree();
+    /* ハフマン符号の復号テーブル作成 */
+    StaticHuffman_BuildDecodeTable(SRLA_GetParameterHuffmanTree(), &decoder->param_table);
+    StaticHuffman_BuildDecodeTable(SRLA_GetSumParameterHuffmanTree(), &decoder->sum_param_table);
+
+    /* 残差の復号テーブル作成 */
+    SRLACoder_BuildDecodeTable(&decoder->coder_table);
+
+    /* 実行環境で使える命令セットの合成関数を選択 */
+    decoder->synthesize = SRLASynthesize_GetFunctions(SRLASIMD_GetInstructionSet());
 
     return decoder;
 }
@@ -315,6 +463,12 @@ struct SRLADecoder *SRLADecoder_Create(const struct SRLADecoderConfig *config, v
 void SRLADecoder_Destroy(struct SRLADecoder *decoder)
 {
     if (decoder != NULL) {
+        if (decoder->workers != NULL) {
+            uint32_t t;
+            for (t = 1; t < decoder->max_num_threads; t++) {
+                SRLADecoder_Destroy(decoder->workers[t]);
+            }
+        }
         if (SRLADECODER_GET_STATUS_FLAG(decoder, SRLADECODER_STATUS_FLAG_ALLOCED_BY_OWN)) {
             free(decoder->work);
         }
@@ -359,12 +513,162 @@ SRLAApiResult SRLADecoder_SetHeader(
     return SRLA_APIRESULT_OK;
 }
 
+/* LR復元したサンプルを計算 */
+#define SRLADECODER_RECONSTRUCT_LR(method, ch0, ch1, lch, rch)\
+    do {\
+        switch (method) {\
+        case SRLA_CH_PROCESS_METHOD_MS:\
+            (lch) = (ch0) - ((ch1) >> 1);\
+            (rch) = (ch1) + (lch);\
+            break;\
+        case SRLA_CH_PROCESS_METHOD_LS:\
+            (lch) = (ch0);\
+            (rch) = (ch1) + (ch0);\
+            break;\
+        case SRLA_CH_PROCESS_METHOD_SR:\
+            (lch) = (ch1) - (ch0);\
+            (rch) = (ch1);\
+            break;\
+        default:\
+            (lch) = (ch0);\
+            (rch) = (ch1);\
+            break;\
+        }\
+    } while (0)
+
+/* マルチチャンネル処理・オフセットの左シフトを戻しながらインターリーブ出力 */
+static void SRLADecoder_OutputInterleaved(
+        int32_t **buffer, uint32_t num_channels, uint32_t num_samples,
+        SRLAChannelProcessMethod ch_process_method, uint32_t lshift,
+        const struct SRLADecoderInterleavedOutput *output)
+{
+    uint32_t ch, smpl;
+    int32_t lch, rch;
+
+    SRLA_ASSERT(buffer != NULL);
+    SRLA_ASSERT(output != NULL);
+    SRLA_ASSERT((ch_process_method == SRLA_CH_PROCESS_METHOD_NONE) || (num_channels >= 2));
+
+    /* 先頭2チャンネルはマルチチャンネル処理を戻して出力、残りはそのまま出力 */
+    switch (output->format) {
+    case SRLA_PCM_FORMAT_INT16:
+    {
+        int16_t *out = (int16_t *)output->data;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            ch = 0;
+            if (ch_process_method != SRLA_CH_PROCESS_METHOD_NONE) {
+                SRLADECODER_RECONSTRUCT_LR(ch_process_method, buffer[0][smpl], buffer[1][smpl], lch, rch);
+                out[0] = (int16_t)(lch << lshift);
+                out[1] = (int16_t)(rch << lshift);
+                ch = 2;
+            }
+            for (; ch < num_channels; ch++) {
+                out[ch] = (int16_t)(buffer[ch][smpl] << lshift);
+            }
+            out += num_channels;
+        }
+    }
+        break;
+    case SRLA_PCM_FORMAT_INT24:
+    {
+        uint8_t *out = (uint8_t *)output->data;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            ch = 0;
+            if (ch_process_method != SRLA_CH_PROCESS_METHOD_NONE) {
+                SRLADECODER_RECONSTRUCT_LR(ch_process_method, buffer[0][smpl], buffer[1][smpl], lch, rch);
+                SRLAUTILITY_PUT_INT24LE(&out[0], lch << lshift);
+                SRLAUTILITY_PUT_INT24LE(&out[3], rch << lshift);
+                ch = 2;
+            }
+            for (; ch < num_channels; ch++) {
+                SRLAUTILITY_PUT_INT24LE(&out[3 * ch], buffer[ch][smpl] << lshift);
+            }
+            out += 3 * num_channels;
+        }
+    }
+        break;
+    case SRLA_PCM_FORMAT_INT32:
+    {
+        int32_t *out = (int32_t *)output->data;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            ch = 0;
+            if (ch_process_method != SRLA_CH_PROCESS_METHOD_NONE) {
+                SRLADECODER_RECONSTRUCT_LR(ch_process_method, buffer[0][smpl], buffer[1][smpl], lch, rch);
+                out[0] = lch << lshift;
+                out[1] = rch << lshift;
+                ch = 2;
+            }
+            for (; ch < num_channels; ch++) {
+                out[ch] = buffer[ch][smpl] << lshift;
+            }
+            out += num_channels;
+        }
+    }
+        break;
+    default:
+        SRLA_ASSERT(0);
+    }
+}
+
+/* デエンファシスを適用しながらオフセットの左シフトを戻してインターリーブ出力
+ * 計算はSRLAPreemphasisFilter_Deemphasisと同一 */
+static void SRLADecoder_DeemphasisInterleaved(
+        struct SRLAPreemphasisFilter *preem, const int32_t *buffer, uint32_t num_samples,
+        uint32_t lshift, uint32_t ch, uint32_t num_channels,
+        const struct SRLADecoderInterleavedOutput *output)
+{
+    uint32_t smpl;
+    int32_t prev;
+    const int32_t c0 = preem[0].coef;
+
+    SRLA_ASSERT(preem != NULL);
+    SRLA_ASSERT(buffer != NULL);
+    SRLA_ASSERT(output != NULL);
+    SRLA_ASSERT(num_samples > 0);
+
+    prev = preem[0].prev;
+    switch (output->format) {
+    case SRLA_PCM_FORMAT_INT16:
+    {
+        int16_t *out = (int16_t *)output->data + ch;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            prev = buffer[smpl] + ((prev * c0) >> SRLA_PREEMPHASIS_COEF_SHIFT);
+            out[smpl * num_channels] = (int16_t)(prev << lshift);
+        }
+    }
+        break;
+    case SRLA_PCM_FORMAT_INT24:
+    {
+        uint8_t *out = (uint8_t *)output->data + 3 * ch;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            prev = buffer[smpl] + ((prev * c0) >> SRLA_PREEMPHASIS_COEF_SHIFT);
+            SRLAUTILITY_PUT_INT24LE(&out[3 * smpl * num_channels], prev << lshift);
+        }
+    }
+        break;
+    case SRLA_PCM_FORMAT_INT32:
+    {
+        int32_t *out = (int32_t *)output->data + ch;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            prev = buffer[smpl] + ((prev * c0) >> SRLA_PREEMPHASIS_COEF_SHIFT);
+            out[smpl * num_channels] = prev << lshift;
+        }
+    }
+        break;
+    default:
+        SRLA_ASSERT(0);
+    }
+
+    /* 次のブロックに引き継ぐ値は入力の末尾 */
+    preem[0].prev = buffer[num_samples - 1];
+}
+
 /* 生データブロックデコード */
 static SRLAApiResult SRLADecoder_DecodeRawData(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
-        uint32_t *decode_size)
+        const struct SRLADecoderInterleavedOutput *output, uint32_t *decode_size)
 {
     uint32_t ch, smpl;
     const struct SRLAHeader *header;
@@ -423,9 +727,25 @@ static SRLAApiResult SRLADecoder_DecodeRawData(
             }
         }
         break;
+    case 32:
+        for (smpl = 0; smpl < num_decode_samples; smpl++) {
+            for (ch = 0; ch < header->num_channels; ch++) {
+                uint32_t buf;
+                ByteArray_GetUint32BE(read_ptr, &buf);
+                buffer[ch][smpl] = SRLAUTILITY_UINT32_TO_SINT32(buf);
+                SRLA_ASSERT((uint32_t)(read_ptr - data) <= data_size);
+            }
+        }
+        break;
     default: SRLA_ASSERT(0);
     }
 
+    /* インターリーブ出力 */
+    if (output != NULL) {
+        SRLADecoder_OutputInterleaved(buffer, header->num_channels, num_decode_samples,
+            SRLA_CH_PROCESS_METHOD_NONE, 0, output);
+    }
+
     /* 読み取りサイズ取得 */
     (*decode_size) = (uint32_t)(read_ptr - data);
 
@@ -437,7 +757,7 @@ static SRLAApiResult SRLADecoder_DecodeCompressData(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
-        uint32_t *decode_size)
+        const struct SRLADecoderInterleavedOutput *output, uint32_t *decode_size)
 {
     uint32_t ch;
     int32_t l;
@@ -472,7 +792,13 @@ static SRLAApiResult SRLADecoder_DecodeCompressData(
         uint32_t uval;
         int32_t head;
         /* プリエンファシス初期前値（全て共通） */
-        BitReader_GetBits(&reader, &uval, header->bits_per_sample + 1U);
+        /* 補足）ビット幅はbits_per_sample + 1 32bitを越える分の上位ビットは読み飛ばす */
+        if (header->bits_per_sample >= 32) {
+            BitReader_GetBits(&reader, &uval, header->bits_per_sample + 1U - 32U);
+            BitReader_GetBits(&reader, &uval, 32);
+        } else {
+            BitReader_GetBits(&reader, &uval, header->bits_per_sample + 1U);
+        }
         head = SRLAUTILITY_UINT32_TO_SINT32(uval);
         for (l = 0; l < SRLA_NUM_PREEMPHASIS_FILTERS; l++) {
             decoder->de_emphasis[ch][l].prev = head;
@@ -495,14 +821,14 @@ static SRLAApiResult SRLADecoder_DecodeCompressData(
         /* 和をとって符号化しているかで場合分け */
         if (!use_sum_coef) {
             for (i = 0; i < decoder->coef_order[ch]; i++) {
-                uval = StaticHuffman_GetCode(decoder->param_tree, &reader);
+                uval = StaticHuffman_GetCodeByTable(&decoder->param_table, &reader);
                 decoder->lpc_coef[ch][i] = SRLAUTILITY_UINT32_TO_SINT32(uval);
             }
         } else {
-            uval = StaticHuffman_GetCode(decoder->param_tree, &reader);
+            uval = StaticHuffman_GetCodeByTable(&decoder->param_table, &reader);
             decoder->lpc_coef[ch][0] = SRLAUTILITY_UINT32_TO_SINT32(uval);
             for (i = 1; i < decoder->coef_order[ch]; i++) {
-                uval = StaticHuffman_GetCode(decoder->sum_param_tree, &reader);
+                uval = StaticHuffman_GetCodeByTable(&decoder->sum_param_table, &reader);
                 decoder->lpc_coef[ch][i] = SRLAUTILITY_UINT32_TO_SINT32(uval);
                 /* 差をとって元に戻す */
                 decoder->lpc_coef[ch][i] -= decoder->lpc_coef[ch][i - 1];
@@ -534,7 +860,7 @@ static SRLAApiResult SRLADecoder_DecodeCompressData(
 
     /* 残差復号 */
     for (ch = 0; ch < header->num_channels; ch++) {
-        SRLACoder_Decode(&reader, buffer[ch], num_decode_samples);
+        SRLACoder_Decode(&decoder->coder_table, &reader, buffer[ch], num_decode_samples);
     }
 
     /* バイト境界に揃える */
@@ -549,15 +875,31 @@ static SRLAApiResult SRLADecoder_DecodeCompressData(
     /* チャンネル毎に合成処理 */
     for (ch = 0; ch < header->num_channels; ch++) {
         /* LPC合成 */
-        SRLALPC_Synthesize(buffer[ch],
+        decoder->synthesize->lpc_synthesize(buffer[ch],
             num_decode_samples, decoder->lpc_coef[ch], decoder->coef_order[ch], decoder->rshifts[ch]);
         /* LTP合成 */
-        SRLALTP_Synthesize(buffer[ch],
+        decoder->synthesize->ltp_synthesize(buffer[ch],
             num_decode_samples, decoder->ltp_coef[ch], decoder->ltp_order[ch],
             decoder->ltp_period[ch], SRLA_LTP_COEFFICIENT_BITWIDTH - 1);
         /* デエンファシス */
-        SRLAPreemphasisFilter_Deemphasis(
-            decoder->de_emphasis[ch], buffer[ch], num_decode_samples);
+        /* 補足）マルチチャンネル処理がなければ、デエンファシスと同時にインターリーブ出力する */
+        if ((output != NULL) && (ch_process_method == SRLA_CH_PROCESS_METHOD_NONE)) {
+            SRLADecoder_DeemphasisInterleaved(decoder->de_emphasis[ch], buffer[ch], num_decode_samples,
+                header->offset_lshift, ch, header->num_channels, output);
+        } else {
+            SRLAPreemphasisFilter_Deemphasis(
+                decoder->de_emphasis[ch], buffer[ch], num_decode_samples);
+        }
+    }
+
+    /* インターリーブ出力: マルチチャンネル処理・左シフトと同時に行う */
+    if (output != NULL) {
+        if (ch_process_method != SRLA_CH_PROCESS_METHOD_NONE) {
+            SRLA_ASSERT(header->num_channels >= 2);
+            SRLADecoder_OutputInterleaved(buffer, header->num_channels, num_decode_samples,
+                ch_process_method, header->offset_lshift, output);
+        }
+        return SRLA_APIRESULT_OK;
     }
 
     /* マルチチャンネル処理 */
@@ -599,7 +941,7 @@ static SRLAApiResult SRLADecoder_DecodeSilentData(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t num_channels, uint32_t num_decode_samples,
-        uint32_t *decode_size)
+        const struct SRLADecoderInterleavedOutput *output, uint32_t *decode_size)
 {
     uint32_t ch;
     const struct SRLAHeader *header;
@@ -621,19 +963,26 @@ static SRLAApiResult SRLADecoder_DecodeSilentData(
     SRLA_ASSERT(num_channels >= header->num_channels);
 
     /* 全て無音で埋める */
-    for (ch = 0; ch < header->num_channels; ch++) {
-        memset(buffer[ch], 0, sizeof(int32_t) * num_decode_samples);
+    if (output != NULL) {
+        /* 補足）いずれの形式も0はバイト列として全て0 */
+        memset(output->data, 0,
+            (SRLAUTILITY_PCM_FORMAT_BITS_PER_SAMPLE(output->format) / 8) * header->num_channels * num_decode_samples);
+    } else {
+        for (ch = 0; ch < header->num_channels; ch++) {
+            memset(buffer[ch], 0, sizeof(int32_t) * num_decode_samples);
+        }
     }
 
     (*decode_size) = 0;
     return SRLA_APIRESULT_OK;
 }
 
-/* 単一データブロックデコード */
-SRLAApiResult SRLADecoder_DecodeBlock(
+/* 単一データブロックデコード（出力先を指定） */
+static SRLAApiResult SRLADecoder_DecodeBlockCore(
         struct SRLADecoder *decoder,
         const uint8_t *data, uint32_t data_size,
         int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+        const struct SRLADecoderInterleavedOutput *output,
         uint32_t *decode_size, uint32_t *num_decode_samples)
 {
     uint8_t buf8;
@@ -707,15 +1056,18 @@ SRLAApiResult SRLADecoder_DecodeBlock(
     switch (block_type) {
     case SRLA_BLOCK_DATA_TYPE_RAWDATA:
         ret = SRLADecoder_DecodeRawData(decoder,
-                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
+                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples,
+                output, &block_data_size);
         break;
     case SRLA_BLOCK_DATA_TYPE_COMPRESSDATA:
         ret = SRLADecoder_DecodeCompressData(decoder,
-                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
+                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples,
+                output, &block_data_size);
         break;
     case SRLA_BLOCK_DATA_TYPE_SILENT:
         ret = SRLADecoder_DecodeSilentData(decoder,
-                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples, &block_data_size);
+                read_ptr, data_size - block_header_size, buffer, header->num_channels, num_block_samples,
+                output, &block_data_size);
         break;
     default:
         return SRLA_APIRESULT_INVALID_FORMAT;
@@ -736,6 +1088,77 @@ SRLAApiResult SRLADecoder_DecodeBlock(
     return SRLA_APIRESULT_OK;
 }
 
+/* 単一データブロックデコード */
+SRLAApiResult SRLADecoder_DecodeBlock(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples,
+        uint32_t *decode_size, uint32_t *num_decode_samples)
+{
+    return SRLADecoder_DecodeBlockCore(decoder,
+            data, data_size, buffer, buffer_num_channels, buffer_num_samples, NULL,
+            decode_size, num_decode_samples);
+}
+
+/* インターリーブ出力の引数チェック */
+static SRLAApiResult SRLADecoder_CheckInterleavedOutput(
+        const struct SRLADecoder *decoder, SRLAPcmFormat format)
+{
+    SRLA_ASSERT(decoder != NULL);
+
+    /* 未知の形式 */
+    if ((format != SRLA_PCM_FORMAT_INT16)
+            && (format != SRLA_PCM_FORMAT_INT24) && (format != SRLA_PCM_FORMAT_INT32)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダがまだセットされていない */
+    if (!SRLADECODER_GET_STATUS_FLAG(decoder, SRLADECODER_STATUS_FLAG_SET_HEADER)) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* 出力形式でサンプルを表現できない */
+    if (decoder->header.bits_per_sample > SRLAUTILITY_PCM_FORMAT_BITS_PER_SAMPLE(format)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 信号バッファがない */
+    if (decoder->buffer == NULL) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* 単一データブロックをインターリーブしてデコード */
+SRLAApiResult SRLADecoder_DecodeBlockInterleaved(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        void *buffer, SRLAPcmFormat format, uint32_t buffer_num_samples,
+        uint32_t *decode_size, uint32_t *num_decode_samples)
+{
+    SRLAApiResult ret;
+    struct SRLADecoderInterleavedOutput output;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL)
+            || (buffer == NULL) || (decode_size == NULL)
+            || (num_decode_samples == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+    if ((ret = SRLADecoder_CheckInterleavedOutput(decoder, format)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* 信号バッファで合成してから出力先に書き込む */
+    output.data = buffer;
+    output.format = format;
+    return SRLADecoder_DecodeBlockCore(decoder,
+            data, data_size, decoder->buffer, decoder->max_num_channels,
+            SRLAUTILITY_MIN(buffer_num_samples, decoder->max_num_buffer_samples), &output,
+            decode_size, num_decode_samples);
+}
+
 /* ヘッダを含めて全ブロックデコード */
 SRLAApiResult SRLADecoder_DecodeWhole(
         struct SRLADecoder *decoder,
@@ -797,3 +1220,748 @@ SRLAApiResult SRLADecoder_DecodeWhole(
     /* 成功終了 */
     return SRLA_APIRESULT_OK;
 }
+
+/* ヘッダを含めて全ブロックをインターリーブしてデコード */
+SRLAApiResult SRLADecoder_DecodeWholeInterleaved(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size,
+        void *buffer, SRLAPcmFormat format, uint32_t buffer_num_samples)
+{
+    SRLAApiResult ret;
+    uint32_t progress, read_offset, read_block_size, num_decode_samples, frame_size;
+    struct SRLAHeader tmp_header;
+    const struct SRLAHeader *header;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL) || (buffer == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダデコードとデコーダへのセット */
+    if ((ret = SRLADecoder_DecodeHeader(data, data_size, &tmp_header))
+            != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+    if ((ret = SRLADecoder_SetHeader(decoder, &tmp_header))
+            != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+    header = &(decoder->header);
+
+    /* 出力形式のチェック */
+    if ((ret = SRLADecoder_CheckInterleavedOutput(decoder, format)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* バッファサイズチェック */
+    if (buffer_num_samples < header->num_samples) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* 全チャンネル1サンプル分のバイト数 */
+    frame_size = (SRLAUTILITY_PCM_FORMAT_BITS_PER_SAMPLE(format) / 8) * header->num_channels;
+
+    progress = 0;
+    read_offset = SRLA_HEADER_SIZE;
+    while ((progress < header->num_samples) && (read_offset < data_size)) {
+        /* ブロックデコード */
+        if ((ret = SRLADecoder_DecodeBlockInterleaved(decoder,
+                        data + read_offset, data_size - read_offset,
+                        (uint8_t *)buffer + (size_t)frame_size * progress, format, buffer_num_samples - progress,
+                        &read_block_size, &num_decode_samples)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+        /* 進捗更新 */
+        read_offset += read_block_size;
+        progress    += num_decode_samples;
+        SRLA_ASSERT(progress <= buffer_num_samples);
+        SRLA_ASSERT(read_offset <= data_size);
+    }
+
+    /* 成功終了 */
+    return SRLA_APIRESULT_OK;
+}
+
+/* 並列デコードタスクの実行 */
+static void SRLADecoder_ExecuteParallelTask(void *arg)
+{
+    struct SRLADecoderParallelTask *task = (struct SRLADecoderParallelTask *)arg;
+    struct SRLADecoder *decoder = task->decoder;
+    uint32_t ch, progress, read_offset, read_block_size, num_decode_samples;
+    int32_t *buffer_ptr[SRLA_MAX_NUM_CHANNELS];
+
+    SRLA_ASSERT(decoder != NULL);
+
+    progress = read_offset = 0;
+    task->result = SRLA_APIRESULT_OK;
+    while ((progress < task->num_samples) && (read_offset < task->data_size)) {
+        /* サンプル書き出し位置のセット */
+        for (ch = 0; ch < decoder->header.num_channels; ch++) {
+            buffer_ptr[ch] = &task->buffer[ch][progress];
+        }
+        /* ブロックデコード */
+        if ((task->result = SRLADecoder_DecodeBlock(decoder,
+                        task->data + read_offset, task->data_size - read_offset,
+                        buffer_ptr, decoder->header.num_channels, task->num_samples - progress,
+                        &read_block_size, &num_decode_samples)) != SRLA_APIRESULT_OK) {
+            return;
+        }
+        /* 進捗更新 */
+        read_offset += read_block_size;
+        progress    += num_decode_samples;
+    }
+}
+
+/* ヘッダを含めて全ブロックを複数スレッドでデコード */
+SRLAApiResult SRLADecoder_DecodeWholeParallel(
+        struct SRLADecoder *decoder, uint32_t num_threads,
+        const uint8_t *data, uint32_t data_size,
+        int32_t **buffer, uint32_t buffer_num_channels, uint32_t buffer_num_samples)
+{
+    SRLAApiResult ret;
+    uint32_t t, ch, num_tasks, progress, read_offset;
+    uint32_t range_offset[SRLA_MAX_NUM_THREADS + 1], range_progress[SRLA_MAX_NUM_THREADS + 1];
+    void *args[SRLA_MAX_NUM_THREADS];
+    struct SRLAHeader tmp_header;
+    const struct SRLAHeader *header;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (num_threads == 0) || (data == NULL) || (buffer == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* スレッド数がハンドルの容量を越えている */
+    if (num_threads > decoder->max_num_threads) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* 単一スレッドの場合は逐次処理 */
+    if (num_threads == 1) {
+        return SRLADecoder_DecodeWhole(decoder,
+            data, data_size, buffer, buffer_num_channels, buffer_num_samples);
+    }
+
+    /* ヘッダデコードとデコーダへのセット */
+    if ((ret = SRLADecoder_DecodeHeader(data, data_size, &tmp_header))
+            != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+    for (t = 0; t < num_threads; t++) {
+        if ((ret = SRLADecoder_SetHeader(decoder->workers[t], &tmp_header))
+                != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+    }
+    header = &(decoder->header);
+
+    /* バッファサイズチェック */
+    if ((buffer_num_channels < header->num_channels)
+            || (buffer_num_samples < header->num_samples)) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* ブロックヘッダを走査し、データサイズが均等になるように区間を分割 */
+    /* 補足）不正なブロックを見つけたら走査を打ち切る。エラーはその区間のデコード時に検出される */
+    num_tasks = 0;
+    progress = 0;
+    read_offset = SRLA_HEADER_SIZE;
+    while ((progress < header->num_samples) && (read_offset < data_size)) {
+        uint16_t sync_code, num_block_samples;
+        uint32_t block_size;
+        const uint8_t *read_pos = data + read_offset;
+
+        /* 区間の先頭を記録 */
+        if ((num_tasks < num_threads)
+                && ((read_offset - SRLA_HEADER_SIZE) >= (uint32_t)(((uint64_t)(data_size - SRLA_HEADER_SIZE) * num_tasks) / num_threads))) {
+            range_offset[num_tasks] = read_offset;
+            range_progress[num_tasks] = progress;
+            num_tasks++;
+        }
+
+        /* ブロックヘッダ読み出し */
+        if ((data_size - read_offset) < SRLADECODER_BLOCK_HEADER_SIZE) {
+            break;
+        }
+        ByteArray_GetUint16BE(read_pos, &sync_code);
+        ByteArray_GetUint32BE(read_pos, &block_size);
+        read_pos += 3; /* チェックサムとブロックデータタイプは読み飛ばす */
+        ByteArray_GetUint16BE(read_pos, &num_block_samples);
+        if ((sync_code != SRLA_BLOCK_SYNC_CODE) || ((block_size + 6) > (data_size - read_offset))) {
+            break;
+        }
+
+        /* 次のブロックへ */
+        read_offset += block_size + 6;
+        progress += num_block_samples;
+    }
+    range_offset[num_tasks] = data_size;
+    range_progress[num_tasks] = header->num_samples;
+
+    /* 各区間をタスクに割り当て */
+    for (t = 0; t < num_tasks; t++) {
+        struct SRLADecoderParallelTask *task = &decoder->tasks[t];
+        if (range_progress[t] > range_progress[t + 1]) {
+            return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+        }
+        task->decoder = decoder->workers[t];
+        task->data = data + range_offset[t];
+        task->data_size = range_offset[t + 1] - range_offset[t];
+        for (ch = 0; ch < header->num_channels; ch++) {
+            task->buffer[ch] = &buffer[ch][range_progress[t]];
+        }
+        task->num_samples = range_progress[t + 1] - range_progress[t];
+        args[t] = task;
+    }
+
+    /* 並列デコード */
+    if ((num_tasks > 0)
+            && (SRLAThread_ExecuteParallel(SRLADecoder_ExecuteParallelTask, args, num_tasks) != SRLA_ERROR_OK)) {
+        return SRLA_APIRESULT_NG;
+    }
+
+    /* 結果確認 */
+    for (t = 0; t < num_tasks; t++) {
+        if (decoder->tasks[t].result != SRLA_APIRESULT_OK) {
+            return decoder->tasks[t].result;
+        }
+    }
+
+    /* 成功終了 */
+    return SRLA_APIRESULT_OK;
+}
+
+/* データ末尾のシークテーブルの取得 */
+static SRLAError SRLADecoder_FindSeekTable(
+        const uint8_t *data, uint32_t data_size, const uint8_t **seek_points, uint32_t *num_points)
+{
+    uint16_t checksum;
+    uint32_t signature, chunk_size, tmp_num_points;
+    const uint8_t *chunk;
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(seek_points != NULL);
+    SRLA_ASSERT(num_points != NULL);
+
+    /* 末尾の固定部すらない */
+    if (data_size < (SRLA_HEADER_SIZE + SRLA_SEEK_TABLE_CHUNK_SIZE(0))) {
+        return SRLA_ERROR_INSUFFICIENT_DATA;
+    }
+
+    /* 固定部の読み出し */
+    checksum = ByteArray_ReadUint16BE(&data[data_size - SRLA_SEEK_TABLE_FOOTER_SIZE]);
+    chunk_size = ByteArray_ReadUint32BE(&data[data_size - 8]);
+    signature = ByteArray_ReadUint32BE(&data[data_size - 4]);
+    if ((signature != SRLA_SEEK_TABLE_SIGNATURE)
+            || (chunk_size < SRLA_SEEK_TABLE_CHUNK_SIZE(0)) || (chunk_size > (data_size - SRLA_HEADER_SIZE))) {
+        return SRLA_ERROR_INVALID_FORMAT;
+    }
+
+    /* シーク点数とチャンクサイズの整合性確認 */
+    chunk = data + data_size - chunk_size;
+    tmp_num_points = ByteArray_ReadUint32BE(chunk);
+    if ((tmp_num_points > ((chunk_size - SRLA_SEEK_TABLE_CHUNK_SIZE(0)) / 8))
+            || (chunk_size != SRLA_SEEK_TABLE_CHUNK_SIZE(tmp_num_points))) {
+        return SRLA_ERROR_INVALID_FORMAT;
+    }
+
+    /* チェックサム確認 */
+    /* 補足）ブロックデータの末尾が偶然識別子と一致した場合をここで弾く */
+    if (SRLAUtility_CalculateFletcher16CheckSum(chunk, chunk_size - SRLA_SEEK_TABLE_FOOTER_SIZE) != checksum) {
+        return SRLA_ERROR_INVALID_FORMAT;
+    }
+
+    (*seek_points) = chunk + 4;
+    (*num_points) = tmp_num_points;
+    return SRLA_ERROR_OK;
+}
+
+/* 指定サンプルを含むブロックの探索 */
+SRLAApiResult SRLADecoder_Seek(
+        struct SRLADecoder *decoder,
+        const uint8_t *data, uint32_t data_size, uint32_t sample_index,
+        uint32_t *block_offset, uint32_t *num_skip_samples)
+{
+    uint32_t offset, progress, end_offset, num_points;
+    const uint8_t *seek_points;
+    const struct SRLAHeader *header;
+
+    /* 引数チェック */
+    if ((decoder == NULL) || (data == NULL)
+            || (block_offset == NULL) || (num_skip_samples == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダがまだセットされていない */
+    if (!SRLADECODER_GET_STATUS_FLAG(decoder, SRLADECODER_STATUS_FLAG_SET_HEADER)) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+    header = &(decoder->header);
+
+    /* 総サンプル数を越えた位置 */
+    if ((header->num_samples != SRLA_NUM_SAMPLES_UNKNOWN) && (sample_index >= header->num_samples)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 既定では先頭ブロックから辿る */
+    offset = SRLA_HEADER_SIZE;
+    progress = 0;
+    end_offset = data_size;
+
+    /* シークテーブルがあれば二分探索で直前のシーク点から辿る */
+    if (SRLADecoder_FindSeekTable(data, data_size, &seek_points, &num_points) == SRLA_ERROR_OK) {
+        end_offset = (uint32_t)(seek_points - data) - 4;
+        if (num_points > 0) {
+            uint32_t low = 0, high = num_points;
+            uint32_t point_offset, point_progress;
+            /* 先頭サンプル位置がsample_index以下となる最後のシーク点を探す */
+            while ((high - low) > 1) {
+                const uint32_t mid = low + (high - low) / 2;
+                if (ByteArray_ReadUint32BE(&seek_points[8 * mid + 4]) <= sample_index) {
+                    low = mid;
+                } else {
+                    high = mid;
+                }
+            }
+            point_offset = ByteArray_ReadUint32BE(&seek_points[8 * low]);
+            point_progress = ByteArray_ReadUint32BE(&seek_points[8 * low + 4]);
+            if ((point_progress <= sample_index)
+                    && (point_offset >= SRLA_HEADER_SIZE) && (point_offset < end_offset)) {
+                offset = point_offset;
+                progress = point_progress;
+            }
+        }
+    }
+
+    /* ブロックヘッダを辿ってsample_indexを含むブロックを探す */
+    while (1) {
+        uint16_t sync_code, num_block_samples;
+        uint32_t block_size;
+        const uint8_t *read_pos = data + offset;
+
+        /* ブロックヘッダ読み出し */
+        if ((offset >= end_offset) || ((end_offset - offset) < SRLADECODER_BLOCK_HEADER_SIZE)) {
+            return SRLA_APIRESULT_INSUFFICIENT_DATA;
+        }
+        ByteArray_GetUint16BE(read_pos, &sync_code);
+        ByteArray_GetUint32BE(read_pos, &block_size);
+        read_pos += 3; /* チェックサムとブロックデータタイプは読み飛ばす */
+        ByteArray_GetUint16BE(read_pos, &num_block_samples);
+        if (sync_code != SRLA_BLOCK_SYNC_CODE) {
+            return SRLA_APIRESULT_INVALID_FORMAT;
+        }
+        if ((block_size + 6) > (end_offset - offset)) {
+            return SRLA_APIRESULT_INSUFFICIENT_DATA;
+        }
+
+        /* 見つかった */
+        if ((sample_index - progress) < num_block_samples) {
+            break;
+        }
+
+        /* 次のブロックへ */
+        offset += block_size + 6;
+        progress += num_block_samples;
+    }
+
+    /* 成功終了 */
+    (*block_offset) = offset;
+    (*num_skip_samples) = sample_index - progress;
+    return SRLA_APIRESULT_OK;
+}
+
+/* ストリーミングデコーダハンドルの作成に必要なワークサイズの計算 */
+int32_t SRLAStreamDecoder_CalculateWorkSize(const struct SRLADecoderConfig *config)
+{
+    int32_t work_size, tmp_work_size;
+    struct SRLADecoderConfig decoder_config;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* コンフィグチェック */
+    if (config->max_num_samples_per_block == 0) {
+        return -1;
+    }
+
+    /* デコーダハンドルのサイズ（コンフィグチェックを含む） */
+    /* 補足）ブロック単位で逐次デコードするため並列処理用の領域は不要
+     * デコードサンプルバッファを別に持つため、デコーダハンドルの信号バッファも不要 */
+    decoder_config = (*config);
+    decoder_config.max_num_threads = 1;
+    decoder_config.max_num_samples_per_block = 0;
+    if ((tmp_work_size = SRLADecoder_CalculateWorkSize(&decoder_config)) < 0) {
+        return -1;
+    }
+
+    /* ハンドル本体のサイズ */
+    work_size = sizeof(struct SRLAStreamDecoder) + SRLA_MEMORY_ALIGNMENT;
+    /* デコーダハンドルのサイズ */
+    work_size += tmp_work_size;
+    /* 再構成バッファのサイズ */
+    work_size += SRLA_MEMORY_ALIGNMENT + SRLAUTILITY_MAX(SRLA_HEADER_SIZE,
+        SRLADECODER_CALCULATE_MAX_BLOCK_SIZE(config->max_num_channels, config->max_num_samples_per_block));
+    /* デコードサンプルバッファのサイズ */
+    work_size += (int32_t)SRLA_CALCULATE_2DIMARRAY_WORKSIZE(int32_t, config->max_num_channels, config->max_num_samples_per_block);
+
+    return work_size;
+}
+
+/* ストリーミングデコーダハンドルの作成 */
+struct SRLAStreamDecoder *SRLAStreamDecoder_Create(const struct SRLADecoderConfig *config, void *work, int32_t work_size)
+{
+    struct SRLAStreamDecoder *stream_decoder;
+    struct SRLADecoderConfig decoder_config;
+    uint8_t tmp_alloc_by_own = 0;
+    uint8_t *work_ptr;
+
+    /* 領域自前確保の場合 */
+    if ((work == NULL) && (work_size == 0)) {
+        if ((work_size = SRLAStreamDecoder_CalculateWorkSize(config)) < 0) {
+            return NULL;
+        }
+        work = malloc((uint32_t)work_size);
+        tmp_alloc_by_own = 1;
+    }
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL)
+            || (work_size < SRLAStreamDecoder_CalculateWorkSize(config))) {
+        if (tmp_alloc_by_own == 1) {
+            free(work);
+        }
+        return NULL;
+    }
+
+    /* ワーク領域先頭ポインタ取得 */
+    work_ptr = (uint8_t *)work;
+
+    /* ハンドル領域確保 */
+    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+    stream_decoder = (struct SRLAStreamDecoder *)work_ptr;
+    work_ptr += sizeof(struct SRLAStreamDecoder);
+
+    /* デコーダハンドルの作成 */
+    decoder_config = (*config);
+    decoder_config.max_num_threads = 1;
+    decoder_config.max_num_samples_per_block = 0;
+    {
+        const int32_t decoder_size = SRLADecoder_CalculateWorkSize(&decoder_config);
+        if ((stream_decoder->decoder = SRLADecoder_Create(&decoder_config, work_ptr, decoder_size)) == NULL) {
+            if (tmp_alloc_by_own == 1) {
+                free(work);
+            }
+            return NULL;
+        }
+        work_ptr += decoder_size;
+    }
+
+    /* 再構成バッファの確保 */
+    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+    stream_decoder->buffer = work_ptr;
+    stream_decoder->buffer_size = (uint32_t)SRLAUTILITY_MAX(SRLA_HEADER_SIZE,
+        SRLADECODER_CALCULATE_MAX_BLOCK_SIZE(config->max_num_channels, config->max_num_samples_per_block));
+    work_ptr += stream_decoder->buffer_size;
+
+    /* デコードサンプルバッファの確保 */
+    SRLA_ALLOCATE_2DIMARRAY(stream_decoder->output,
+        work_ptr, int32_t, config->max_num_channels, config->max_num_samples_per_block);
+
+    /* バッファオーバーランチェック */
+    SRLA_ASSERT((work_ptr - (uint8_t *)work) <= work_size);
+
+    /* メンバの初期化 */
+    stream_decoder->read_offset = 0;
+    stream_decoder->write_offset = 0;
+    stream_decoder->max_block_size = 0;
+    stream_decoder->max_num_channels = config->max_num_channels;
+    stream_decoder->max_num_samples_per_block = config->max_num_samples_per_block;
+    stream_decoder->num_decoded_samples = 0;
+    stream_decoder->output_callback = NULL;
+    stream_decoder->user_data = NULL;
+    stream_decoder->header_decoded = 0;
+    stream_decoder->resyncing = 0;
+    stream_decoder->detect_corruption = 0;
+    stream_decoder->started = 0;
+    stream_decoder->alloced_by_own = tmp_alloc_by_own;
+    stream_decoder->work = work;
+
+    return stream_decoder;
+}
+
+/* ストリーミングデコーダハンドルの破棄 */
+void SRLAStreamDecoder_Destroy(struct SRLAStreamDecoder *stream_decoder)
+{
+    if (stream_decoder != NULL) {
+        SRLADecoder_Destroy(stream_decoder->decoder);
+        if (stream_decoder->alloced_by_own == 1) {
+            free(stream_decoder->work);
+        }
+    }
+}
+
+/* ストリーミングデコードの開始 */
+SRLAApiResult SRLAStreamDecoder_Start(
+        struct SRLAStreamDecoder *stream_decoder,
+        SRLAStreamDecoder_OutputCallback output_callback, void *user_data)
+{
+    /* 引数チェック */
+    if ((stream_decoder == NULL) || (output_callback == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 状態の初期化 */
+    stream_decoder->read_offset = 0;
+    stream_decoder->write_offset = 0;
+    stream_decoder->max_block_size = 0;
+    stream_decoder->num_decoded_samples = 0;
+    stream_decoder->output_callback = output_callback;
+    stream_decoder->user_data = user_data;
+    stream_decoder->header_decoded = 0;
+    stream_decoder->resyncing = 0;
+    stream_decoder->detect_corruption = 0;
+    stream_decoder->started = 1;
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* 未処理データの先頭を読み捨て、次の同期コードの候補位置まで進める */
+static void SRLAStreamDecoder_SkipToNextSyncCode(struct SRLAStreamDecoder *stream_decoder)
+{
+    uint32_t pos;
+    const uint8_t *buffer = stream_decoder->buffer;
+
+    SRLA_ASSERT(stream_decoder->read_offset < stream_decoder->write_offset);
+
+    /* 先頭の1byteは必ず読み捨てる */
+    /* 補足）見つからなかった場合は末尾1byteを残す。次の入力と合わせて同期コードになりうるため */
+    for (pos = stream_decoder->read_offset + 1; (pos + 1) < stream_decoder->write_offset; pos++) {
+        if ((((uint32_t)buffer[pos] << 8) | buffer[pos + 1]) == SRLA_BLOCK_SYNC_CODE) {
+            break;
+        }
+    }
+
+    stream_decoder->read_offset = pos;
+    stream_decoder->resyncing = 1;
+    stream_decoder->detect_corruption = 1;
+}
+
+/* 再構成バッファ内のデータを可能な限りデコード */
+static SRLAApiResult SRLAStreamDecoder_ProcessBufferedData(struct SRLAStreamDecoder *stream_decoder)
+{
+    SRLAApiResult ret;
+    struct SRLADecoder *decoder = stream_decoder->decoder;
+    const struct SRLAHeader *header = &(decoder->header);
+
+    while (stream_decoder->read_offset < stream_decoder->write_offset) {
+        uint16_t sync_code, checksum, num_block_samples;
+        uint32_t block_size, decode_size, num_decode_samples;
+        const uint8_t *read_pos = stream_decoder->buffer + stream_decoder->read_offset;
+        const uint32_t num_remain_bytes = stream_decoder->write_offset - stream_decoder->read_offset;
+
+        /* ヘッダのデコード */
+        if (!stream_decoder->header_decoded) {
+            struct SRLAHeader tmp_header;
+            if (num_remain_bytes < SRLA_HEADER_SIZE) {
+                break;
+            }
+            if ((ret = SRLADecoder_DecodeHeader(read_pos, num_remain_bytes, &tmp_header)) != SRLA_APIRESULT_OK) {
+                return ret;
+            }
+            if ((ret = SRLADecoder_SetHeader(decoder, &tmp_header)) != SRLA_APIRESULT_OK) {
+                return ret;
+            }
+            /* ブロックが再構成バッファに収まらない */
+            if (header->max_num_samples_per_block > stream_decoder->max_num_samples_per_block) {
+                return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+            }
+            stream_decoder->max_block_size = (uint32_t)SRLADECODER_CALCULATE_MAX_BLOCK_SIZE(
+                header->num_channels, header->max_num_samples_per_block);
+            SRLA_ASSERT(stream_decoder->max_block_size <= stream_decoder->buffer_size);
+            stream_decoder->read_offset += SRLA_HEADER_SIZE;
+            stream_decoder->header_decoded = 1;
+            continue;
+        }
+
+        /* 総サンプル数が既知でデコードし終えていれば、以降のデータは読み捨てる */
+        if ((header->num_samples != SRLA_NUM_SAMPLES_UNKNOWN)
+                && (stream_decoder->num_decoded_samples >= header->num_samples)) {
+            stream_decoder->read_offset = stream_decoder->write_offset;
+            break;
+        }
+
+        /* 同期コード */
+        if (num_remain_bytes < 2) {
+            break;
+        }
+        ByteArray_GetUint16BE(read_pos, &sync_code);
+        if (sync_code != SRLA_BLOCK_SYNC_CODE) {
+            SRLAStreamDecoder_SkipToNextSyncCode(stream_decoder);
+            continue;
+        }
+
+        /* ブロックヘッダの読み出し */
+        if (num_remain_bytes < SRLADECODER_BLOCK_HEADER_SIZE) {
+            break;
+        }
+        ByteArray_GetUint32BE(read_pos, &block_size);
+        ByteArray_GetUint16BE(read_pos, &checksum);
+        read_pos += 1; /* ブロックデータタイプは読み飛ばす */
+        ByteArray_GetUint16BE(read_pos, &num_block_samples);
+
+        /* ありえないブロックヘッダは偽の同期コードとして読み捨てる */
+        if ((block_size < (SRLADECODER_BLOCK_HEADER_SIZE - 6))
+                || (block_size > (stream_decoder->max_block_size - 6))
+                || (num_block_samples == 0) || (num_block_samples > header->max_num_samples_per_block)) {
+            SRLAStreamDecoder_SkipToNextSyncCode(stream_decoder);
+            continue;
+        }
+
+        /* ブロック全体が揃うまで待つ */
+        if (num_remain_bytes < (block_size + 6)) {
+            break;
+        }
+
+        /* 再同期中は、偽の同期コードを避けるため設定によらずチェックサムを検査 */
+        read_pos = stream_decoder->buffer + stream_decoder->read_offset;
+        if (stream_decoder->resyncing
+                && (SRLAUtility_CalculateFletcher16CheckSum(read_pos + 8, block_size - 2) != checksum)) {
+            SRLAStreamDecoder_SkipToNextSyncCode(stream_decoder);
+            continue;
+        }
+
+        /* ブロックデコード */
+        ret = SRLADecoder_DecodeBlock(decoder, read_pos, block_size + 6,
+                stream_decoder->output, stream_decoder->max_num_channels, stream_decoder->max_num_samples_per_block,
+                &decode_size, &num_decode_samples);
+        if ((ret == SRLA_APIRESULT_INVALID_FORMAT) || (ret == SRLA_APIRESULT_INSUFFICIENT_DATA)
+                || (ret == SRLA_APIRESULT_DETECT_DATA_CORRUPTION)) {
+            /* 壊れたブロックは読み捨てて再同期 */
+            SRLAStreamDecoder_SkipToNextSyncCode(stream_decoder);
+            continue;
+        } else if (ret != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+
+        /* 総サンプル数を越える分は出力しない */
+        if ((header->num_samples != SRLA_NUM_SAMPLES_UNKNOWN)
+                && (num_decode_samples > (header->num_samples - stream_decoder->num_decoded_samples))) {
+            num_decode_samples = header->num_samples - stream_decoder->num_decoded_samples;
+        }
+
+        /* 出力 */
+        stream_decoder->output_callback((const int32_t *const *)stream_decoder->output,
+                header->num_channels, num_decode_samples, stream_decoder->user_data);
+
+        /* 進捗更新 */
+        stream_decoder->read_offset += block_size + 6;
+        stream_decoder->num_decoded_samples += num_decode_samples;
+        stream_decoder->resyncing = 0;
+    }
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* 任意サイズのデータを入力 */
+SRLAApiResult SRLAStreamDecoder_Push(
+        struct SRLAStreamDecoder *stream_decoder, const uint8_t *data, uint32_t data_size)
+{
+    SRLAApiResult ret;
+    uint32_t progress;
+
+    /* 引数チェック */
+    if ((stream_decoder == NULL) || ((data == NULL) && (data_size > 0))) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 開始されていない */
+    if (stream_decoder->started != 1) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    progress = 0;
+    while (progress < data_size) {
+        uint32_t num_copy_bytes;
+
+        /* 未処理データをバッファ先頭に詰める */
+        if (stream_decoder->read_offset > 0) {
+            memmove(stream_decoder->buffer, stream_decoder->buffer + stream_decoder->read_offset,
+                    stream_decoder->write_offset - stream_decoder->read_offset);
+            stream_decoder->write_offset -= stream_decoder->read_offset;
+            stream_decoder->read_offset = 0;
+        }
+
+        /* バッファに追記 */
+        /* 補足）処理後にバッファが満杯のまま残ることはない（最大ブロックサイズ以上のデータがあれば必ず消費される）*/
+        SRLA_ASSERT(stream_decoder->write_offset < stream_decoder->buffer_size);
+        num_copy_bytes = SRLAUTILITY_MIN(stream_decoder->buffer_size - stream_decoder->write_offset, data_size - progress);
+        memcpy(stream_decoder->buffer + stream_decoder->write_offset, data + progress, num_copy_bytes);
+        stream_decoder->write_offset += num_copy_bytes;
+        progress += num_copy_bytes;
+
+        /* 揃ったデータをデコード */
+        if ((ret = SRLAStreamDecoder_ProcessBufferedData(stream_decoder)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* ストリーミングデコードで取得したヘッダの取得 */
+SRLAApiResult SRLAStreamDecoder_GetHeader(
+        const struct SRLAStreamDecoder *stream_decoder, struct SRLAHeader *header)
+{
+    /* 引数チェック */
+    if ((stream_decoder == NULL) || (header == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダがまだ揃っていない */
+    if (!stream_decoder->header_decoded) {
+        return SRLA_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    (*header) = stream_decoder->decoder->header;
+    return SRLA_APIRESULT_OK;
+}
+
+/* ストリーミングデコードの終了 */
+SRLAApiResult SRLAStreamDecoder_Finish(struct SRLAStreamDecoder *stream_decoder)
+{
+    const struct SRLAHeader *header;
+
+    /* 引数チェック */
+    if (stream_decoder == NULL) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 開始されていない */
+    if (stream_decoder->started != 1) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* 終了 再度SRLAStreamDecoder_Startを呼ぶまで入力を受け付けない */
+    stream_decoder->started = 0;
+
+    /* ヘッダが揃っていない */
+    if (!stream_decoder->header_decoded) {
+        return SRLA_APIRESULT_INSUFFICIENT_DATA;
+    }
+    header = &(stream_decoder->decoder->header);
+
+    /* 途中で再同期が発生した */
+    if (stream_decoder->detect_corruption) {
+        return SRLA_APIRESULT_DETECT_DATA_CORRUPTION;
+    }
+
+    /* 不完全なブロックが残っている・総サンプル数に達していない */
+    if ((stream_decoder->read_offset < stream_decoder->write_offset)
+            || ((header->num_samples != SRLA_NUM_SAMPLES_UNKNOWN)
+                && (stream_decoder->num_decoded_samples < header->num_samples))) {
+        return SRLA_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    return SRLA_APIRESULT_OK;
+}
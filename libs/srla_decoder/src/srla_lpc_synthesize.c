@@ -5,19 +5,11 @@
 #include "srla_utility.h"
 
 /* LPC係数により合成(in-place) */
-#if defined(SRLA_USE_SSE41)
-#ifdef _MSC_VER
-#include <intrin.h>
-#define DECLALIGN(x) __declspec(align(x))
-#else
-#include <x86intrin.h>
-#define DECLALIGN(x) __attribute__((aligned(x)))
-#endif
-void SRLALPC_Synthesize(
+static void SRLALPC_SynthesizeScalar(
     int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, uint32_t coef_rshift)
 {
-    int32_t smpl, ord;
+    uint32_t smpl, ord;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
     int32_t predict;
 
@@ -34,29 +26,80 @@ void SRLALPC_Synthesize(
         data[smpl] += data[smpl - 1];
     }
 
+    for (smpl = 0; smpl < num_samples - coef_order; smpl++) {
+        predict = half;
+        for (ord = 0; ord < coef_order; ord++) {
+            predict += (coef[ord] * data[smpl + ord]);
+        }
+        data[smpl + ord] -= (predict >> coef_rshift);
+    }
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* LPC係数により合成(in-place) SSE4.1版 */
+SRLA_TARGET_SSE41 static void SRLALPC_SynthesizeSSE41(
+    int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order, uint32_t coef_rshift)
+{
+    int32_t smpl, ord;
+    const int32_t order = (int32_t)coef_order;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+
+    /* 予測次数が0の時は何もしない */
+    if (coef_order == 0) {
+        return;
+    }
+
+    for (smpl = 1; smpl < order; smpl++) {
+        data[smpl] += data[smpl - 1];
+    }
+
     if (coef_order >= 4) {
         uint32_t i;
         __m128i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
+        __m128i vhead[3], vprev1, vprev2;
         /* 係数をベクトル化 */
         for (i = 0; i < coef_order; i++) {
             vcoef[i] = _mm_set1_epi32(coef[i]);
         }
-        for (; smpl < num_samples - coef_order - 4; smpl += 4) {
+        /* 末尾3係数を三角行列状に並べたベクトル
+         * 直前の出力を1〜3サンプルずらしたものに掛け、未確定のdata[smpl]以降に当たるレーンは0にしておく */
+        {
+            const int32_t *c = &coef[coef_order - 3];
+            vhead[0] = _mm_setr_epi32(c[0], c[0], c[0], 0);
+            vhead[1] = _mm_setr_epi32(c[1], c[1], 0, 0);
+            vhead[2] = _mm_setr_epi32(c[2], 0, 0, 0);
+        }
+        /* 直前2グループ分の出力（data[smpl - 8] .. data[smpl - 1]）はレジスタに保持し、
+         * storeした直後の領域をメモリから読み直さないようにする */
+        {
+            DECLALIGN(16) int32_t prev[8];
+            for (i = 0; i < 8; i++) {
+                prev[i] = ((smpl + (int32_t)i) >= 8) ? data[smpl + (int32_t)i - 8] : 0;
+            }
+            vprev2 = _mm_load_si128((const __m128i *)&prev[0]);
+            vprev1 = _mm_load_si128((const __m128i *)&prev[4]);
+        }
+        for (; (smpl + 4) <= (int32_t)num_samples; smpl += 4) {
             /* 4サンプル並列に処理
             int32_t predict[4] = { half, half, half, half }
-            for (ord = 0; ord < coef_order - 3; ord++) {
-                predict[0] += (coef[ord] * data[smpl - coef_order + ord + 0]);
-                predict[1] += (coef[ord] * data[smpl - coef_order + ord + 1]);
-                predict[2] += (coef[ord] * data[smpl - coef_order + ord + 2]);
-                predict[3] += (coef[ord] * data[smpl - coef_order + ord + 3]);
+            for (ord = 0; ord < order - 3; ord++) {
+                predict[0] += (coef[ord] * data[smpl - order + ord + 0]);
+                predict[1] += (coef[ord] * data[smpl - order + ord + 1]);
+                predict[2] += (coef[ord] * data[smpl - order + ord + 2]);
+                predict[3] += (coef[ord] * data[smpl - order + ord + 3]);
             }
             */
             DECLALIGN(16) int32_t predict[4];
             __m128i vdata;
             __m128i vpred = _mm_set1_epi32(half);
-            for (ord = 0; ord < (int32_t)coef_order - 3 - 4; ord += 4) {
-                const int32_t *dat = &data[smpl - coef_order + ord];
-                vdata = _mm_load_si128((const __m128i *)&dat[0]);
+            for (ord = 0; (ord + 4) <= (order - 7); ord += 4) {
+                const int32_t *dat = &data[smpl - order + ord];
+                vdata = _mm_loadu_si128((const __m128i *)&dat[0]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 0], vdata));
                 vdata = _mm_loadu_si128((const __m128i *)&dat[1]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 1], vdata));
@@ -65,92 +108,112 @@ void SRLALPC_Synthesize(
                 vdata = _mm_loadu_si128((const __m128i *)&dat[3]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 3], vdata));
             }
-            for (; ord < coef_order - 3; ord++) {
-                vdata = _mm_loadu_si128((const __m128i *)&data[smpl - coef_order + ord]);
+            for (; ord < order - 7; ord++) {
+                vdata = _mm_loadu_si128((const __m128i *)&data[smpl - order + ord]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord], vdata));
             }
-            _mm_store_si128((__m128i *)predict, vpred);
+
+            /* ord = coef_order - 7 .. coef_order - 4 はレジスタ上の出力から切り出す */
+            if (coef_order >= 7) {
+                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[coef_order - 7], _mm_alignr_epi8(vprev1, vprev2, 4)));
+            }
+            if (coef_order >= 6) {
+                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[coef_order - 6], _mm_alignr_epi8(vprev1, vprev2, 8)));
+            }
+            if (coef_order >= 5) {
+                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[coef_order - 5], _mm_alignr_epi8(vprev1, vprev2, 12)));
+            }
+            vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[coef_order - 4], vprev1));
 
             /* ord = coef_order - 3 */
-            /* data[smpl + 0] .. data[smpl + 2]に依存関係があるため処理
-            * TODO: ここもSSEでやり切ってdataに結果を直接storeしたい
-            predict[0] += (coef[ord + 0] * data[smpl - 3 + 0]);
-            predict[0] += (coef[ord + 1] * data[smpl - 3 + 1]);
-            predict[0] += (coef[ord + 2] * data[smpl - 3 + 2]);
-            data[smpl + 0] -= (predict[0] >> coef_rshift);
-            predict[1] += (coef[ord + 0] * data[smpl - 3 + 1]);
-            predict[1] += (coef[ord + 1] * data[smpl - 3 + 2]);
-            predict[1] += (coef[ord + 2] * data[smpl - 3 + 3]);
-            data[smpl + 1] -= (predict[1] >> coef_rshift);
-            predict[2] += (coef[ord + 0] * data[smpl - 3 + 2]);
-            predict[2] += (coef[ord + 1] * data[smpl - 3 + 3]);
-            predict[2] += (coef[ord + 2] * data[smpl - 3 + 4]);
-            data[smpl + 2] -= (predict[2] >> coef_rshift);
-            predict[3] += (coef[ord + 0] * data[smpl - 3 + 3]);
-            predict[3] += (coef[ord + 1] * data[smpl - 3 + 4]);
-            predict[3] += (coef[ord + 2] * data[smpl - 3 + 5]);
-            data[smpl + 3] -= (predict[3] >> coef_rshift);
-            */
-            for (i = 0; i < 4; i++) {
-                predict[i] += (coef[ord + 0] * data[smpl - 3 + i + 0]);
-                predict[i] += (coef[ord + 1] * data[smpl - 3 + i + 1]);
-                predict[i] += (coef[ord + 2] * data[smpl - 3 + i + 2]);
-                data[smpl + i] -= (predict[i] >> coef_rshift);
+            /* data[smpl + 0] .. data[smpl + 2]に依存関係があるため、
+             * 確定済みのサンプルの寄与はベクトルで加え、残りの三角部分はレジスタ上で逐次解いてまとめてstoreする */
+            vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vhead[0], _mm_srli_si128(vprev1, 4)));
+            vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vhead[1], _mm_srli_si128(vprev1, 8)));
+            vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vhead[2], _mm_srli_si128(vprev1, 12)));
+            _mm_store_si128((__m128i *)predict, vpred);
+            {
+                const int32_t *c = &coef[coef_order - 3];
+                const int32_t out0 = data[smpl + 0] - (predict[0] >> coef_rshift);
+                const int32_t out1 = data[smpl + 1] - ((predict[1] + c[2] * out0) >> coef_rshift);
+                const int32_t out2 = data[smpl + 2] - ((predict[2] + c[1] * out0 + c[2] * out1) >> coef_rshift);
+                const int32_t out3 = data[smpl + 3] - ((predict[3] + c[0] * out0 + c[1] * out1 + c[2] * out2) >> coef_rshift);
+                vprev2 = vprev1;
+                vprev1 = _mm_setr_epi32(out0, out1, out2, out3);
+                _mm_storeu_si128((__m128i *)&data[smpl], vprev1);
             }
         }
     }
 
     /* 余ったサンプル分の処理 */
-    for (; smpl < num_samples; smpl++) {
+    for (; smpl < (int32_t)num_samples; smpl++) {
         int32_t predict = half;
-        for (ord = 0; ord < coef_order; ord++) {
-            predict += (coef[ord] * data[smpl - coef_order + ord]);
+        for (ord = 0; ord < order; ord++) {
+            predict += (coef[ord] * data[smpl - order + ord]);
         }
         data[smpl] -= (predict >> coef_rshift);
     }
 }
-#elif defined(SRLA_USE_AVX2)
-#ifdef _MSC_VER
-#include <immintrin.h>
-#define DECLALIGN(x) __declspec(align(x))
-#else
-#include <x86intrin.h>
-#define DECLALIGN(x) __attribute__((aligned(x)))
-#endif
-void SRLALPC_Synthesize(
+
+/* LPC係数により合成(in-place) AVX2版 */
+SRLA_TARGET_AVX2 static void SRLALPC_SynthesizeAVX2(
     int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, uint32_t coef_rshift)
 {
     int32_t smpl, ord;
+    const int32_t order = (int32_t)coef_order;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
 
     /* 引数チェック */
     SRLA_ASSERT(data != NULL);
     SRLA_ASSERT(coef != NULL);
 
-    /* 予測次数が0の時は何もしない */
-    if (coef_order == 0) {
+    /* 8次未満はSSE4.1版で処理 */
+    if (coef_order < 8) {
+        SRLALPC_SynthesizeSSE41(data, num_samples, coef, coef_order, coef_rshift);
         return;
     }
 
-    for (smpl = 1; smpl < coef_order; smpl++) {
+    for (smpl = 1; smpl < order; smpl++) {
         data[smpl] += data[smpl - 1];
     }
 
-    if (coef_order >= 8) {
-        uint32_t i;
+    {
+        uint32_t i, k;
         __m256i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
+        __m256i vhead[7], vheadidx[7], vprev1, vprev2;
         /* 係数をベクトル化 */
         for (i = 0; i < coef_order; i++) {
             vcoef[i] = _mm256_set1_epi32(coef[i]);
         }
-        for (; smpl < num_samples - coef_order - 8; smpl += 8) {
+        /* 末尾7係数を三角行列状に並べたベクトル
+         * 直前の出力を1〜7サンプルずらしたものに掛け、未確定のdata[smpl]以降に当たるレーンは0にしておく */
+        for (k = 0; k < 7; k++) {
+            DECLALIGN(32) int32_t head[8];
+            for (i = 0; i < 8; i++) {
+                head[i] = (i < (7 - k)) ? coef[coef_order - 7 + k] : 0;
+            }
+            vhead[k] = _mm256_load_si256((const __m256i *)head);
+            vheadidx[k] = _mm256_and_si256(
+                    _mm256_add_epi32(_mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8), _mm256_set1_epi32((int32_t)k)), _mm256_set1_epi32(7));
+        }
+        /* 直前2グループ分の出力（data[smpl - 16] .. data[smpl - 1]）はレジスタに保持し、
+         * storeした直後の領域をメモリから読み直さないようにする */
+        {
+            DECLALIGN(32) int32_t prev[16];
+            for (i = 0; i < 16; i++) {
+                prev[i] = ((smpl + (int32_t)i) >= 16) ? data[smpl + (int32_t)i - 16] : 0;
+            }
+            vprev2 = _mm256_load_si256((const __m256i *)&prev[0]);
+            vprev1 = _mm256_load_si256((const __m256i *)&prev[8]);
+        }
+        for (; (smpl + 8) <= (int32_t)num_samples; smpl += 8) {
             /* 8サンプル並列に処理 */
             DECLALIGN(32) int32_t predict[8];
-            __m256i vdata;
+            __m256i vdata, vmid;
             __m256i vpred = _mm256_set1_epi32(half);
-            for (ord = 0; ord < (int32_t)coef_order - 7 - 8; ord += 8) {
-                const int32_t *dat = &data[smpl - coef_order + ord];
+            for (ord = 0; (ord + 8) <= (order - 15); ord += 8) {
+                const int32_t *dat = &data[smpl - order + ord];
                 vdata = _mm256_loadu_si256((const __m256i *)&dat[0]);
                 vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord + 0], vdata));
                 vdata = _mm256_loadu_si256((const __m256i *)&dat[1]);
@@ -168,134 +231,216 @@ void SRLALPC_Synthesize(
                 vdata = _mm256_loadu_si256((const __m256i *)&dat[7]);
                 vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord + 7], vdata));
             }
-            for (; ord < coef_order - 7; ord++) {
-                vdata = _mm256_loadu_si256((const __m256i *)&data[smpl - coef_order + ord]);
+            for (; ord < order - 15; ord++) {
+                vdata = _mm256_loadu_si256((const __m256i *)&data[smpl - order + ord]);
                 vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord], vdata));
             }
-            _mm256_store_si256((__m256i *)predict, vpred);
 
-            /* ord = coef_order - 7 */
-            for (i = 0; i < 8; i++) {
-                predict[i] += (coef[ord + 0] * data[smpl - 7 + i + 0]);
-                predict[i] += (coef[ord + 1] * data[smpl - 7 + i + 1]);
-                predict[i] += (coef[ord + 2] * data[smpl - 7 + i + 2]);
-                predict[i] += (coef[ord + 3] * data[smpl - 7 + i + 3]);
-                predict[i] += (coef[ord + 4] * data[smpl - 7 + i + 4]);
-                predict[i] += (coef[ord + 5] * data[smpl - 7 + i + 5]);
-                predict[i] += (coef[ord + 6] * data[smpl - 7 + i + 6]);
-                data[smpl + i] -= (predict[i] >> coef_rshift);
-            }
-        }
-    } else if (coef_order >= 4) {
-        uint32_t i;
-        __m128i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
-        /* 係数をベクトル化 */
-        for (i = 0; i < coef_order; i++) {
-            vcoef[i] = _mm_set1_epi32(coef[i]);
-        }
-        for (; smpl < num_samples - coef_order - 4; smpl += 4) {
-            /* 4サンプル並列に処理 */
-            DECLALIGN(16) int32_t predict[4];
-            __m128i vdata;
-            __m128i vpred = _mm_set1_epi32(half);
-            for (ord = 0; ord < (int32_t)coef_order - 3 - 4; ord += 4) {
-                const int32_t *dat = &data[smpl - coef_order + ord];
-                vdata = _mm_loadu_si128((const __m128i *)&dat[0]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 0], vdata));
-                vdata = _mm_loadu_si128((const __m128i *)&dat[1]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 1], vdata));
-                vdata = _mm_loadu_si128((const __m128i *)&dat[2]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 2], vdata));
-                vdata = _mm_loadu_si128((const __m128i *)&dat[3]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 3], vdata));
-            }
-            for (; ord < coef_order - 3; ord++) {
-                vdata = _mm_loadu_si128((const __m128i *)&data[smpl - coef_order + ord]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord], vdata));
+            /* ord = coef_order - 15 .. coef_order - 8 はレジスタ上の出力から切り出す */
+            /* vmid = data[smpl - 12] .. data[smpl - 5] */
+            vmid = _mm256_permute2x128_si256(vprev2, vprev1, 0x21);
+#define SRLALPC_ACCUMULATE_TAP(m, vwindow)\
+            if (coef_order >= (m)) {\
+                vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[coef_order - (m)], (vwindow)));\
             }
-            _mm_store_si128((__m128i *)predict, vpred);
+            SRLALPC_ACCUMULATE_TAP(15, _mm256_alignr_epi8(vmid, vprev2, 4));
+            SRLALPC_ACCUMULATE_TAP(14, _mm256_alignr_epi8(vmid, vprev2, 8));
+            SRLALPC_ACCUMULATE_TAP(13, _mm256_alignr_epi8(vmid, vprev2, 12));
+            SRLALPC_ACCUMULATE_TAP(12, vmid);
+            SRLALPC_ACCUMULATE_TAP(11, _mm256_alignr_epi8(vprev1, vmid, 4));
+            SRLALPC_ACCUMULATE_TAP(10, _mm256_alignr_epi8(vprev1, vmid, 8));
+            SRLALPC_ACCUMULATE_TAP( 9, _mm256_alignr_epi8(vprev1, vmid, 12));
+#undef SRLALPC_ACCUMULATE_TAP
+            vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[coef_order - 8], vprev1));
 
-            /* ord = coef_order - 3 */
-            for (i = 0; i < 4; i++) {
-                predict[i] += (coef[ord + 0] * data[smpl - 3 + i + 0]);
-                predict[i] += (coef[ord + 1] * data[smpl - 3 + i + 1]);
-                predict[i] += (coef[ord + 2] * data[smpl - 3 + i + 2]);
-                data[smpl + i] -= (predict[i] >> coef_rshift);
+            /* ord = coef_order - 7 */
+            /* data[smpl + 0] .. data[smpl + 6]に依存関係があるため、
+             * 確定済みのサンプルの寄与はベクトルで加え、残りの三角部分はレジスタ上で逐次解いてまとめてstoreする */
+            for (k = 0; k < 7; k++) {
+                /* data[smpl - 7 + k] .. を先頭に回す（はみ出したレーンは係数0） */
+                vdata = _mm256_permutevar8x32_epi32(vprev1, vheadidx[k]);
+                vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vhead[k], vdata));
+            }
+            _mm256_store_si256((__m256i *)predict, vpred);
+            {
+                const int32_t *c = &coef[coef_order - 7];
+                const int32_t out0 = data[smpl + 0] - (predict[0] >> coef_rshift);
+                const int32_t out1 = data[smpl + 1] - ((predict[1]
+                            + c[6] * out0) >> coef_rshift);
+                const int32_t out2 = data[smpl + 2] - ((predict[2]
+                            + c[5] * out0 + c[6] * out1) >> coef_rshift);
+                const int32_t out3 = data[smpl + 3] - ((predict[3]
+                            + c[4] * out0 + c[5] * out1 + c[6] * out2) >> coef_rshift);
+                const int32_t out4 = data[smpl + 4] - ((predict[4]
+                            + c[3] * out0 + c[4] * out1 + c[5] * out2 + c[6] * out3) >> coef_rshift);
+                const int32_t out5 = data[smpl + 5] - ((predict[5]
+                            + c[2] * out0 + c[3] * out1 + c[4] * out2 + c[5] * out3 + c[6] * out4) >> coef_rshift);
+                const int32_t out6 = data[smpl + 6] - ((predict[6]
+                            + c[1] * out0 + c[2] * out1 + c[3] * out2 + c[4] * out3 + c[5] * out4 + c[6] * out5) >> coef_rshift);
+                const int32_t out7 = data[smpl + 7] - ((predict[7]
+                            + c[0] * out0 + c[1] * out1 + c[2] * out2 + c[3] * out3 + c[4] * out4 + c[5] * out5 + c[6] * out6) >> coef_rshift);
+                vprev2 = vprev1;
+                vprev1 = _mm256_setr_epi32(out0, out1, out2, out3, out4, out5, out6, out7);
+                _mm256_storeu_si256((__m256i *)&data[smpl], vprev1);
             }
         }
     }
 
     /* 余ったサンプル分の処理 */
-    for (; smpl < num_samples; smpl++) {
+    for (; smpl < (int32_t)num_samples; smpl++) {
         int32_t predict = half;
-        for (ord = 0; ord < coef_order; ord++) {
-            predict += (coef[ord] * data[smpl - coef_order + ord]);
+        for (ord = 0; ord < order; ord++) {
+            predict += (coef[ord] * data[smpl - order + ord]);
         }
         data[smpl] -= (predict >> coef_rshift);
     }
 }
-#else
-void SRLALPC_Synthesize(
+
+/* LPC係数により合成(in-place) AVX-512版 */
+SRLA_TARGET_AVX512 static void SRLALPC_SynthesizeAVX512(
     int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, uint32_t coef_rshift)
 {
-    uint32_t smpl, ord;
+    int32_t smpl, ord;
+    const int32_t order = (int32_t)coef_order;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
-    int32_t predict;
 
     /* 引数チェック */
     SRLA_ASSERT(data != NULL);
     SRLA_ASSERT(coef != NULL);
 
-    /* 予測次数が0の時は何もしない */
-    if (coef_order == 0) {
+    /* 16次未満はAVX2版で処理 */
+    if (coef_order < 16) {
+        SRLALPC_SynthesizeAVX2(data, num_samples, coef, coef_order, coef_rshift);
         return;
     }
 
-    for (smpl = 1; smpl < coef_order; smpl++) {
+    for (smpl = 1; smpl < order; smpl++) {
         data[smpl] += data[smpl - 1];
     }
 
-    for (smpl = 0; smpl < num_samples - coef_order; smpl++) {
-        predict = half;
-        for (ord = 0; ord < coef_order; ord++) {
-            predict += (coef[ord] * data[smpl + ord]);
+    {
+        uint32_t i, j;
+        __m512i vcoef[SRLA_MAX_COEFFICIENT_ORDER], vprev1, vprev2;
+        const __m512i vzero = _mm512_setzero_si512();
+        /* 係数をベクトル化 */
+        for (i = 0; i < coef_order; i++) {
+            vcoef[i] = _mm512_set1_epi32(coef[i]);
+        }
+        /* 直前2グループ分の出力（data[smpl - 32] .. data[smpl - 1]）はレジスタに保持し、
+         * storeした直後の領域をメモリから読み直さないようにする */
+        {
+            DECLALIGN(64) int32_t prev[32];
+            for (i = 0; i < 32; i++) {
+                prev[i] = ((smpl + (int32_t)i) >= 32) ? data[smpl + (int32_t)i - 32] : 0;
+            }
+            vprev2 = _mm512_load_si512(&prev[0]);
+            vprev1 = _mm512_load_si512(&prev[16]);
+        }
+        for (; (smpl + 16) <= (int32_t)num_samples; smpl += 16) {
+            /* 16サンプル並列に処理 */
+            DECLALIGN(64) int32_t predict[16];
+            DECLALIGN(64) int32_t out[16];
+            __m512i vpred = _mm512_set1_epi32(half);
+            for (ord = 0; (ord + 4) <= (order - 31); ord += 4) {
+                const int32_t *dat = &data[smpl - order + ord];
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 0], _mm512_loadu_si512(&dat[0])));
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 1], _mm512_loadu_si512(&dat[1])));
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 2], _mm512_loadu_si512(&dat[2])));
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 3], _mm512_loadu_si512(&dat[3])));
+            }
+            for (; ord < order - 31; ord++) {
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord], _mm512_loadu_si512(&data[smpl - order + ord])));
+            }
+
+            /* ord = coef_order - 31 .. coef_order - 1 はレジスタ上の出力から切り出す
+             * valignはレーンをまたいで連結シフトできるため、32サンプル分の窓を直接作れる
+             * coef_order - 15 以降では未確定のdata[smpl]以降に当たるレーンに0が入る */
+#define SRLALPC_ACCUMULATE_TAP(m, vwindow)\
+            if (coef_order >= (m)) {\
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[coef_order - (m)], (vwindow)));\
+            }
+            SRLALPC_ACCUMULATE_TAP(31, _mm512_alignr_epi32(vprev1, vprev2, 1));
+            SRLALPC_ACCUMULATE_TAP(30, _mm512_alignr_epi32(vprev1, vprev2, 2));
+            SRLALPC_ACCUMULATE_TAP(29, _mm512_alignr_epi32(vprev1, vprev2, 3));
+            SRLALPC_ACCUMULATE_TAP(28, _mm512_alignr_epi32(vprev1, vprev2, 4));
+            SRLALPC_ACCUMULATE_TAP(27, _mm512_alignr_epi32(vprev1, vprev2, 5));
+            SRLALPC_ACCUMULATE_TAP(26, _mm512_alignr_epi32(vprev1, vprev2, 6));
+            SRLALPC_ACCUMULATE_TAP(25, _mm512_alignr_epi32(vprev1, vprev2, 7));
+            SRLALPC_ACCUMULATE_TAP(24, _mm512_alignr_epi32(vprev1, vprev2, 8));
+            SRLALPC_ACCUMULATE_TAP(23, _mm512_alignr_epi32(vprev1, vprev2, 9));
+            SRLALPC_ACCUMULATE_TAP(22, _mm512_alignr_epi32(vprev1, vprev2, 10));
+            SRLALPC_ACCUMULATE_TAP(21, _mm512_alignr_epi32(vprev1, vprev2, 11));
+            SRLALPC_ACCUMULATE_TAP(20, _mm512_alignr_epi32(vprev1, vprev2, 12));
+            SRLALPC_ACCUMULATE_TAP(19, _mm512_alignr_epi32(vprev1, vprev2, 13));
+            SRLALPC_ACCUMULATE_TAP(18, _mm512_alignr_epi32(vprev1, vprev2, 14));
+            SRLALPC_ACCUMULATE_TAP(17, _mm512_alignr_epi32(vprev1, vprev2, 15));
+            vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[coef_order - 16], vprev1));
+            SRLALPC_ACCUMULATE_TAP(15, _mm512_alignr_epi32(vzero, vprev1, 1));
+            SRLALPC_ACCUMULATE_TAP(14, _mm512_alignr_epi32(vzero, vprev1, 2));
+            SRLALPC_ACCUMULATE_TAP(13, _mm512_alignr_epi32(vzero, vprev1, 3));
+            SRLALPC_ACCUMULATE_TAP(12, _mm512_alignr_epi32(vzero, vprev1, 4));
+            SRLALPC_ACCUMULATE_TAP(11, _mm512_alignr_epi32(vzero, vprev1, 5));
+            SRLALPC_ACCUMULATE_TAP(10, _mm512_alignr_epi32(vzero, vprev1, 6));
+            SRLALPC_ACCUMULATE_TAP( 9, _mm512_alignr_epi32(vzero, vprev1, 7));
+            SRLALPC_ACCUMULATE_TAP( 8, _mm512_alignr_epi32(vzero, vprev1, 8));
+            SRLALPC_ACCUMULATE_TAP( 7, _mm512_alignr_epi32(vzero, vprev1, 9));
+            SRLALPC_ACCUMULATE_TAP( 6, _mm512_alignr_epi32(vzero, vprev1, 10));
+            SRLALPC_ACCUMULATE_TAP( 5, _mm512_alignr_epi32(vzero, vprev1, 11));
+            SRLALPC_ACCUMULATE_TAP( 4, _mm512_alignr_epi32(vzero, vprev1, 12));
+            SRLALPC_ACCUMULATE_TAP( 3, _mm512_alignr_epi32(vzero, vprev1, 13));
+            SRLALPC_ACCUMULATE_TAP( 2, _mm512_alignr_epi32(vzero, vprev1, 14));
+            SRLALPC_ACCUMULATE_TAP( 1, _mm512_alignr_epi32(vzero, vprev1, 15));
+#undef SRLALPC_ACCUMULATE_TAP
+            _mm512_store_si512(predict, vpred);
+
+            /* data[smpl + 0] .. data[smpl + 14]に依存関係があるため、残りの三角部分はスカラーで逐次解く */
+            for (i = 0; i < 16; i++) {
+                int32_t predict_i = predict[i];
+                for (j = 0; j < i; j++) {
+                    predict_i += coef[coef_order - i + j] * out[j];
+                }
+                out[i] = data[smpl + (int32_t)i] - (predict_i >> coef_rshift);
+            }
+            vprev2 = vprev1;
+            vprev1 = _mm512_load_si512(out);
+            _mm512_storeu_si512(&data[smpl], vprev1);
         }
-        data[smpl + ord] -= (predict >> coef_rshift);
+    }
+
+    /* 余ったサンプル分の処理 */
+    for (; smpl < (int32_t)num_samples; smpl++) {
+        int32_t predict = half;
+        for (ord = 0; ord < order; ord++) {
+            predict += (coef[ord] * data[smpl - order + ord]);
+        }
+        data[smpl] -= (predict >> coef_rshift);
     }
 }
 #endif
 
-void SRLALTP_Synthesize(
-    int32_t *data, uint32_t num_samples,
+/* LTP係数により合成(in-place) smpl以降のサンプルを逐次処理 */
+static void SRLALTP_SynthesizeSequential(
+    int32_t *data, uint32_t smpl, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order,
     uint32_t pitch_period, uint32_t coef_rshift)
 {
-    uint32_t smpl, ord;
+    uint32_t ord;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
     int32_t predict;
     const uint32_t half_order = coef_order >> 1;
     const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order)); /* ピッチ周期+次数/2だけ遅れた信号 */
 
-    /* 引数チェック */
-    SRLA_ASSERT(data != NULL);
-    SRLA_ASSERT(coef != NULL);
-
-    /* 予測次数/周期が0の時は何もしない */
-    if ((coef_order == 0) || (pitch_period == 0)) {
-        return;
-    }
-
     /* よく選ばれる奇数次数の処理についてループ展開しておく */
     switch (coef_order) {
     case 1:
-        for (smpl = pitch_period + half_order + 1; smpl < num_samples; smpl++) {
+        for (; smpl < num_samples; smpl++) {
             predict = half + coef[0] * dalay_data[smpl];
             data[smpl] += (predict >> coef_rshift);
         }
         break;
     case 3:
-        for (smpl = pitch_period + half_order + 1; smpl < num_samples; smpl++) {
+        for (; smpl < num_samples; smpl++) {
             predict = half;
             predict += coef[0] * dalay_data[smpl + 0];
             predict += coef[1] * dalay_data[smpl + 1];
@@ -304,7 +449,7 @@ void SRLALTP_Synthesize(
         }
         break;
     case 5:
-        for (smpl = pitch_period + half_order + 1; smpl < num_samples; smpl++) {
+        for (; smpl < num_samples; smpl++) {
             predict = half;
             predict += coef[0] * dalay_data[smpl + 0];
             predict += coef[1] * dalay_data[smpl + 1];
@@ -315,7 +460,7 @@ void SRLALTP_Synthesize(
         }
         break;
     default:
-        for (smpl = pitch_period + half_order + 1; smpl < num_samples; smpl++) {
+        for (; smpl < num_samples; smpl++) {
             predict = half;
             for (ord = 0; ord < coef_order; ord++) {
                 predict += (coef[ord] * dalay_data[smpl + ord]);
@@ -325,3 +470,211 @@ void SRLALTP_Synthesize(
         break;
     }
 }
+
+/* LTP係数により合成(in-place) */
+static void SRLALTP_SynthesizeScalar(
+    int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order,
+    uint32_t pitch_period, uint32_t coef_rshift)
+{
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+
+    /* 予測次数/周期が0の時は何もしない */
+    if ((coef_order == 0) || (pitch_period == 0)) {
+        return;
+    }
+
+    SRLALTP_SynthesizeSequential(data,
+        pitch_period + (coef_order >> 1) + 1, num_samples, coef, coef_order, pitch_period, coef_rshift);
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* LTP係数により合成(in-place) SSE4.1版 */
+SRLA_TARGET_SSE41 static void SRLALTP_SynthesizeSSE41(
+    int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order,
+    uint32_t pitch_period, uint32_t coef_rshift)
+{
+    uint32_t smpl, ord;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+    const uint32_t half_order = coef_order >> 1;
+    const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order)); /* ピッチ周期+次数/2だけ遅れた信号 */
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+
+    /* 予測次数/周期が0の時は何もしない */
+    if ((coef_order == 0) || (pitch_period == 0)) {
+        return;
+    }
+
+    SRLA_ASSERT(coef_order <= SRLA_MAX_LTP_ORDER);
+
+    smpl = pitch_period + half_order + 1;
+
+    /* 参照する最も新しいサンプルは (pitch_period - half_order) だけ前にあるため、
+     * その距離以下の幅のサンプルは互いに依存せず並列に合成できる */
+    if ((pitch_period - half_order) >= 4) {
+        __m128i vcoef[SRLA_MAX_LTP_ORDER];
+        const __m128i vhalf = _mm_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
+        for (ord = 0; ord < coef_order; ord++) {
+            vcoef[ord] = _mm_set1_epi32(coef[ord]);
+        }
+        for (; (smpl + 4) <= num_samples; smpl += 4) {
+            __m128i vpred = vhalf;
+            for (ord = 0; ord < coef_order; ord++) {
+                const __m128i vdata = _mm_loadu_si128((const __m128i *)&dalay_data[smpl + ord]);
+                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord], vdata));
+            }
+            _mm_storeu_si128((__m128i *)&data[smpl],
+                    _mm_add_epi32(_mm_loadu_si128((const __m128i *)&data[smpl]), _mm_sra_epi32(vpred, vshift)));
+        }
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLALTP_SynthesizeSequential(data, smpl, num_samples, coef, coef_order, pitch_period, coef_rshift);
+}
+
+/* LTP係数により合成(in-place) AVX2版 */
+SRLA_TARGET_AVX2 static void SRLALTP_SynthesizeAVX2(
+    int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order,
+    uint32_t pitch_period, uint32_t coef_rshift)
+{
+    uint32_t smpl, ord;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+    const uint32_t half_order = coef_order >> 1;
+    const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order)); /* ピッチ周期+次数/2だけ遅れた信号 */
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+
+    /* 予測次数/周期が0の時は何もしない */
+    if ((coef_order == 0) || (pitch_period == 0)) {
+        return;
+    }
+
+    SRLA_ASSERT(coef_order <= SRLA_MAX_LTP_ORDER);
+
+    /* 8サンプル並列にできない周期はSSE4.1版で処理 */
+    if ((pitch_period - half_order) < 8) {
+        SRLALTP_SynthesizeSSE41(data, num_samples, coef, coef_order, pitch_period, coef_rshift);
+        return;
+    }
+
+    smpl = pitch_period + half_order + 1;
+
+    {
+        __m256i vcoef[SRLA_MAX_LTP_ORDER];
+        const __m256i vhalf = _mm256_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
+        for (ord = 0; ord < coef_order; ord++) {
+            vcoef[ord] = _mm256_set1_epi32(coef[ord]);
+        }
+        for (; (smpl + 8) <= num_samples; smpl += 8) {
+            __m256i vpred = vhalf;
+            for (ord = 0; ord < coef_order; ord++) {
+                const __m256i vdata = _mm256_loadu_si256((const __m256i *)&dalay_data[smpl + ord]);
+                vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord], vdata));
+            }
+            _mm256_storeu_si256((__m256i *)&data[smpl],
+                    _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)&data[smpl]), _mm256_sra_epi32(vpred, vshift)));
+        }
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLALTP_SynthesizeSequential(data, smpl, num_samples, coef, coef_order, pitch_period, coef_rshift);
+}
+
+/* LTP係数により合成(in-place) AVX-512版 */
+SRLA_TARGET_AVX512 static void SRLALTP_SynthesizeAVX512(
+    int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order,
+    uint32_t pitch_period, uint32_t coef_rshift)
+{
+    uint32_t smpl, ord;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+    const uint32_t half_order = coef_order >> 1;
+    const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order)); /* ピッチ周期+次数/2だけ遅れた信号 */
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+
+    /* 予測次数/周期が0の時は何もしない */
+    if ((coef_order == 0) || (pitch_period == 0)) {
+        return;
+    }
+
+    SRLA_ASSERT(coef_order <= SRLA_MAX_LTP_ORDER);
+
+    /* 16サンプル並列にできない周期はAVX2版で処理 */
+    if ((pitch_period - half_order) < 16) {
+        SRLALTP_SynthesizeAVX2(data, num_samples, coef, coef_order, pitch_period, coef_rshift);
+        return;
+    }
+
+    smpl = pitch_period + half_order + 1;
+
+    {
+        __m512i vcoef[SRLA_MAX_LTP_ORDER];
+        const __m512i vhalf = _mm512_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
+        for (ord = 0; ord < coef_order; ord++) {
+            vcoef[ord] = _mm512_set1_epi32(coef[ord]);
+        }
+        for (; (smpl + 16) <= num_samples; smpl += 16) {
+            __m512i vpred = vhalf;
+            for (ord = 0; ord < coef_order; ord++) {
+                const __m512i vdata = _mm512_loadu_si512(&dalay_data[smpl + ord]);
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord], vdata));
+            }
+            _mm512_storeu_si512(&data[smpl],
+                    _mm512_add_epi32(_mm512_loadu_si512(&data[smpl]), _mm512_sra_epi32(vpred, vshift)));
+        }
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLALTP_SynthesizeSequential(data, smpl, num_samples, coef, coef_order, pitch_period, coef_rshift);
+}
+#endif
+
+/* 命令セットごとの合成関数テーブル */
+static const struct SRLASynthesizeFunctions st_synthesize_functions_scalar = {
+    SRLALPC_SynthesizeScalar, SRLALTP_SynthesizeScalar
+};
+#if defined(SRLA_ENABLE_X86_SIMD)
+static const struct SRLASynthesizeFunctions st_synthesize_functions_sse41 = {
+    SRLALPC_SynthesizeSSE41, SRLALTP_SynthesizeSSE41
+};
+static const struct SRLASynthesizeFunctions st_synthesize_functions_avx2 = {
+    SRLALPC_SynthesizeAVX2, SRLALTP_SynthesizeAVX2
+};
+static const struct SRLASynthesizeFunctions st_synthesize_functions_avx512 = {
+    SRLALPC_SynthesizeAVX512, SRLALTP_SynthesizeAVX512
+};
+#endif
+
+/* 命令セットに対応する合成関数テーブルを取得 */
+const struct SRLASynthesizeFunctions *SRLASynthesize_GetFunctions(SRLASIMDInstructionSet instruction_set)
+{
+    switch (instruction_set) {
+#if defined(SRLA_ENABLE_X86_SIMD)
+    case SRLA_SIMD_AVX512:
+        return &st_synthesize_functions_avx512;
+    case SRLA_SIMD_AVX2:
+        return &st_synthesize_functions_avx2;
+    case SRLA_SIMD_SSE41:
+        return &st_synthesize_functions_sse41;
+#endif
+    default:
+        break;
+    }
+
+    return &st_synthesize_functions_scalar;
+}
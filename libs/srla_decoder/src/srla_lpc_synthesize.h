@@ -2,20 +2,30 @@
 #define SRLA_LPCSYNTHESIZE_H_INCLUDED
 
 #include <stdint.h>
+#include "srla_simd.h"
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/* LPC係数により合成(in-place) */
-void SRLALPC_Synthesize(
+/* LPC係数により合成(in-place)する関数 */
+typedef void (*SRLALPCSynthesizeFunction)(
     int32_t *data, uint32_t num_samples, const int32_t *coef, uint32_t coef_order, uint32_t coef_rshift);
 
-/* LTP係数により合成(in-place) */
-void SRLALTP_Synthesize(
+/* LTP係数により合成(in-place)する関数 */
+typedef void (*SRLALTPSynthesizeFunction)(
     int32_t *data, uint32_t num_samples, const int32_t *coef, uint32_t coef_order,
     uint32_t pitch_period, uint32_t coef_rshift);
 
+/* 合成関数テーブル（命令セットによらず結果は一致する） */
+struct SRLASynthesizeFunctions {
+    SRLALPCSynthesizeFunction lpc_synthesize; /* LPC係数により合成 */
+    SRLALTPSynthesizeFunction ltp_synthesize; /* LTP係数により合成 */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 命令セットに対応する合成関数テーブルを取得 */
+const struct SRLASynthesizeFunctions *SRLASynthesize_GetFunctions(SRLASIMDInstructionSet instruction_set);
+
 #ifdef __cplusplus
 }
 #endif
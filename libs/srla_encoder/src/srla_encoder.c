@@ -7,14 +7,19 @@
 #include "srla_lpc_predict.h"
 #include "srla_internal.h"
 #include "srla_utility.h"
+#include "srla_thread.h"
+#include "srla_simd.h"
 #include "byte_array.h"
 #include "bit_stream.h"
 #include "lpc.h"
 #include "static_huffman.h"
 #include "srla_coder.h"
 
-/* ダイクストラ法使用時の巨大な重み */
-#define SRLAENCODER_DIJKSTRA_BIGWEIGHT (double)(1UL << 24)
+/* 最短経路探索で辺が無いことを表す巨大な重み */
+#define SRLAENCODER_BIGWEIGHT (double)(1UL << 24)
+
+/* 自己相関キャッシュが保持するモーメント数（Welch窓の積が位置の4次式のため5） */
+#define SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS 5
 
 /* ブロック探索に必要なノード数の計算 */
 #define SRLAENCODER_CALCULATE_NUM_NODES(num_samples, delta_num_samples) ((SRLAUTILITY_ROUNDUP(num_samples, delta_num_samples) / (delta_num_samples)) + 1)
@@ -34,6 +39,7 @@ struct SRLAEncoderCoefficient {
 struct SRLAEncoder {
     struct SRLAHeader header; /* ヘッダ */
     struct SRLACoder *coder; /* 符号化ハンドル */
+    const struct SRLAPredictFunctions *predict; /* 実行環境に合わせて選択した予測関数 */
     uint32_t max_num_channels; /* バッファチャンネル数 */
     uint32_t max_num_samples_per_block; /* バッファサンプル数 */
     uint32_t min_num_samples_per_block; /* 最小ブロックサンプル数 */
@@ -43,10 +49,14 @@ struct SRLAEncoder {
     uint32_t max_num_parameters; /* 最大パラメータ数 */
     uint32_t ltp_order; /* LTP次数 */
     uint32_t num_svr_filter_learning_iteration; /* SVR学習繰り返し回数 */
+    uint8_t estimate_partition_cost; /* ブロック分割探索で推定符号長を使うか？ */
+    uint8_t sliding_lookahead; /* 先読み区間をスライドさせてブロック分割を探索するか？ */
+    uint32_t seek_table_interval; /* シークテーブルのシーク点間隔（0:シークテーブルなし） */
     uint8_t set_parameter; /* パラメータセット済み？ */
     struct LPCCalculator *lpcc; /* LPC計算ハンドル */
     struct SRLAPreemphasisFilter **pre_emphasis; /* プリエンファシスフィルタ */
     struct SRLAOptimalBlockPartitionCalculator *obpc; /* 最適ブロック分割計算ハンドル */
+    struct SRLAAutoCorrelationCache *accache; /* ブロック分割探索用の自己相関キャッシュ */
     struct SRLAEncoderCoefficient *coefficient; /* 各チャンネルの係数 */
     struct SRLAEncoderCoefficient ms_coefficient[2]; /* MSチャンネルの係数 */
     int32_t** buffer_int; /* 信号バッファ(int) */
@@ -60,6 +70,58 @@ struct SRLAEncoder {
     struct StaticHuffmanCodes param_codes; /* パラメータ符号化用Huffman符号 */
     struct StaticHuffmanCodes sum_param_codes; /* 和をとったパラメータ符号化用Huffman符号 */
     const struct SRLAParameterPreset *parameter_preset; /* パラメータプリセット */
+    uint32_t max_num_threads; /* 最大スレッド数 */
+    struct SRLAEncoder **workers; /* 並列処理用のエンコーダハンドル（先頭は自分自身） */
+    struct SRLAEncoderParallelTask *tasks; /* 並列処理用のタスク */
+    struct SRLAEncoderPartitionSearchTask *search_tasks; /* ブロック分割探索の並列処理用タスク */
+    uint32_t num_search_threads; /* ブロック分割探索で使用するスレッド数 */
+    uint8_t **worker_buffer; /* 並列処理用の出力バッファ */
+    uint32_t worker_buffer_size; /* 並列処理用の出力バッファサイズ */
+    uint8_t alloced_by_own; /* 領域を自前確保しているか？ */
+    void *work; /* ワーク領域先頭ポインタ */
+};
+
+/* 並列エンコードタスク */
+struct SRLAEncoderParallelTask {
+    struct SRLAEncoder *encoder; /* 処理を担当するエンコーダハンドル */
+    const int32_t *input[SRLA_MAX_NUM_CHANNELS]; /* 入力信号 */
+    uint32_t num_samples; /* 入力サンプル数 */
+    uint8_t *data; /* 出力先 */
+    uint32_t data_size; /* 出力先サイズ */
+    uint32_t output_size; /* 出力サイズ */
+    SRLAApiResult result; /* 処理結果 */
+};
+
+/* ブロック分割探索の並列タスク: 辺のコストを分担して計算 */
+struct SRLAEncoderPartitionSearchTask {
+    struct SRLAEncoder *encoder; /* 処理を担当するエンコーダハンドル */
+    const int32_t *const *input; /* 入力信号 */
+    uint32_t num_lookahead_samples; /* 先読みサンプル数 */
+    uint32_t min_num_block_samples; /* 最小ブロックサンプル数 */
+    uint32_t max_num_block_samples; /* 最大ブロックサンプル数 */
+    uint32_t num_nodes; /* ノード数 */
+    uint32_t num_reuse_nodes; /* 前回の探索結果を再利用する先頭ノード数 */
+    uint32_t start_index; /* 担当する辺の開始インデックス */
+    uint32_t index_stride; /* 担当する辺のインデックス間隔 */
+    const struct SRLAAutoCorrelationCache *cache; /* 自己相関キャッシュ（推定符号長を使わない場合はNULL） */
+    double **edge_cost; /* 結果を書き込む辺のコスト */
+    SRLAError result; /* 処理結果 */
+};
+
+/* ストリーミングエンコーダハンドル */
+struct SRLAStreamEncoder {
+    struct SRLAEncoder *encoder; /* エンコーダハンドル */
+    int32_t **buffer; /* 入力サンプルバッファ */
+    uint32_t max_num_buffer_samples; /* 入力サンプルバッファの容量 */
+    uint32_t num_buffer_samples; /* 入力サンプルバッファの使用サンプル数（エンコードパラメータで決まる） */
+    uint32_t num_buffered_samples; /* バッファされているサンプル数 */
+    uint32_t num_pushed_samples; /* 入力された総サンプル数 */
+    uint32_t num_reuse_nodes; /* 先読み区間のスライドで再利用するノード数 */
+    uint8_t *output; /* 出力データバッファ */
+    uint32_t output_size; /* 出力データバッファサイズ */
+    SRLAStreamEncoder_OutputCallback output_callback; /* 出力コールバック */
+    void *user_data; /* コールバックに渡すユーザデータ */
+    uint8_t started; /* エンコード開始済み？ */
     uint8_t alloced_by_own; /* 領域を自前確保しているか？ */
     void *work; /* ワーク領域先頭ポインタ */
 };
@@ -67,10 +129,29 @@ struct SRLAEncoder {
 /* 最適ブロック分割探索ハンドル */
 struct SRLAOptimalBlockPartitionCalculator {
     uint32_t max_num_nodes; /* ノード数 */
-    double **adjacency_matrix; /* 隣接行列 */
+    uint32_t max_band_width; /* 1つのノードから辺が伸びる最大のノード数 */
+    double **edge_cost; /* 辺のコスト edge_cost[i][k]はノードiからノードi+k+1への辺のコスト */
     double *cost; /* 最小コスト */
     uint32_t *path; /* パス経路 */
-    uint8_t *used_flag; /* 各ノードの使用状態フラグ */
+};
+
+/* ブロック分割探索用の自己相関キャッシュ
+ * 最小ブロックサイズ単位のセグメント毎に自己相関と隣接セグメントとの境界相互相関を保持し、
+ * 候補ブロックの自己相関をセグメントの値の和で求める
+ * Welch窓は位置の2次式なので、ラグ積の位置に関する4次までのモーメントを保持して窓掛け後の自己相関を再構成する */
+struct SRLAAutoCorrelationCache {
+    uint32_t max_num_signals; /* 最大信号数 */
+    uint32_t max_num_segments; /* 最大セグメント数 */
+    uint32_t max_num_samples; /* 最大サンプル数 */
+    uint32_t max_order; /* 最大ラグ */
+    uint32_t num_signals; /* 信号数（マルチチャンネル時はMS信号を含む） */
+    uint32_t num_segments; /* セグメント数 */
+    uint32_t order; /* ラグ */
+    uint32_t segment_length; /* セグメント長 */
+    double **segment_corr; /* セグメント内自己相関のモーメント [信号][(セグメント * (max_order + 1) + ラグ) * モーメント数 + 次数] */
+    double **boundary_corr; /* 次のセグメントとの境界相互相関のモーメント [信号][(セグメント * (max_order + 1) + ラグ) * モーメント数 + 次数] */
+    double *buffer; /* 正規化信号バッファ */
+    int32_t **ms_buffer; /* MS信号バッファ */
 };
 
 /* エンコードパラメータをヘッダに変換 */
@@ -80,6 +161,13 @@ static SRLAError SRLAEncoder_ConvertParameterToHeader(
 /* ブロックデータタイプの判定 */
 static SRLABlockDataType SRLAEncoder_DecideBlockDataType(
         struct SRLAEncoder *encoder, const int32_t *const *input, uint32_t num_samples);
+/* エンコードパラメータをワーカーハンドルに複製 */
+static void SRLAEncoder_CopyParameterToWorker(
+        struct SRLAEncoder *worker, const struct SRLAEncoder *encoder);
+/* 単一データブロックサイズの推定 */
+static SRLAError SRLAEncoder_EstimateBlockSize(
+        struct SRLAEncoder *encoder, const struct SRLAAutoCorrelationCache *cache,
+        uint32_t start_segment, uint32_t end_segment, uint32_t num_samples, double *estimated_size);
 
 /* ヘッダエンコード */
 SRLAApiResult SRLAEncoder_EncodeHeader(
@@ -166,40 +254,54 @@ SRLAApiResult SRLAEncoder_EncodeHeader(
 
 /* 探索ハンドルの作成に必要なワークサイズの計算 */
 static int32_t SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(
-    uint32_t max_num_samples, uint32_t delta_num_samples)
+    uint32_t max_num_samples, uint32_t min_num_block_samples, uint32_t max_num_block_samples)
 {
     int32_t work_size;
-    uint32_t max_num_nodes;
+    uint32_t max_num_nodes, max_band_width;
+
+    /* 引数チェック */
+    if ((min_num_block_samples == 0) || (min_num_block_samples > max_num_block_samples)) {
+        return -1;
+    }
 
     /* 最大ノード数の計算 */
-    max_num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(max_num_samples, delta_num_samples);
+    max_num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(max_num_samples, min_num_block_samples);
+    /* 辺が伸びる最大ノード数の計算 */
+    max_band_width = max_num_block_samples / min_num_block_samples;
+
+    /* 1ノードあたりの辺のコストがint32_tに収まるか */
+    if (max_band_width > (uint32_t)(INT32_MAX / 2 / (int32_t)sizeof(double))) {
+        return -1;
+    }
 
     /* 構造体サイズ */
-    work_size = sizeof(struct SRLAOptimalBlockPartitionCalculator) + SRLA_MEMORY_ALIGNMENT;
+    work_size = sizeof(struct SRLAOptimalBlockPartitionCalculator) + 3 * SRLA_MEMORY_ALIGNMENT;
 
-    /* 隣接行列 */
-    work_size += (int32_t)((sizeof(double *) + (sizeof(double) * max_num_nodes) + SRLA_MEMORY_ALIGNMENT) * max_num_nodes);
-    /* コスト配列 */
-    work_size += (int32_t)(sizeof(double) * max_num_nodes + SRLA_MEMORY_ALIGNMENT);
-    /* 経路情報 */
-    work_size += (int32_t)(sizeof(uint32_t) * max_num_nodes + SRLA_MEMORY_ALIGNMENT);
-    /* ノード使用済みフラグ */
-    work_size += (int32_t)(sizeof(uint8_t) * max_num_nodes + SRLA_MEMORY_ALIGNMENT);
+    /* 辺のコスト */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, max_num_nodes,
+            (int32_t)(sizeof(double *) + (sizeof(double) * max_band_width) + SRLA_MEMORY_ALIGNMENT))) < 0) {
+        return -1;
+    }
+    /* コスト配列・経路情報 */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, max_num_nodes, (int32_t)(sizeof(double) + sizeof(uint32_t)))) < 0) {
+        return -1;
+    }
 
     return work_size;
 }
 
 /* 探索ハンドルの作成 */
 static struct SRLAOptimalBlockPartitionCalculator *SRLAOptimalBlockPartitionCalculator_Create(
-    uint32_t max_num_samples, uint32_t delta_num_samples, void *work, int32_t work_size)
+    uint32_t max_num_samples, uint32_t min_num_block_samples, uint32_t max_num_block_samples,
+    void *work, int32_t work_size)
 {
-    uint32_t tmp_max_num_nodes;
+    uint32_t tmp_max_num_nodes, tmp_max_band_width;
     struct SRLAOptimalBlockPartitionCalculator* obpc;
     uint8_t *work_ptr;
 
     /* 引数チェック */
-    if ((max_num_samples < delta_num_samples) || (work == NULL)
-        || (work_size < SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(max_num_samples, delta_num_samples))) {
+    if ((max_num_samples < min_num_block_samples) || (work == NULL)
+        || (work_size < SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(max_num_samples, min_num_block_samples, max_num_block_samples))) {
         return NULL;
     }
 
@@ -211,17 +313,15 @@ static struct SRLAOptimalBlockPartitionCalculator *SRLAOptimalBlockPartitionCalc
     obpc = (struct SRLAOptimalBlockPartitionCalculator *)work_ptr;
     work_ptr += sizeof(struct SRLAOptimalBlockPartitionCalculator);
 
-    /* 最大ノード数の計算 */
-    tmp_max_num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(max_num_samples, delta_num_samples);
+    /* 最大ノード数・辺が伸びる最大ノード数の計算 */
+    tmp_max_num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(max_num_samples, min_num_block_samples);
+    tmp_max_band_width = max_num_block_samples / min_num_block_samples;
     obpc->max_num_nodes = tmp_max_num_nodes;
-
-    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
-    obpc->adjacency_matrix = (double **)work_ptr;
-    work_ptr += sizeof(struct SRLAOptimalBlockPartitionCalculator);
+    obpc->max_band_width = tmp_max_band_width;
 
     /* 領域確保 */
-    /* 隣接行列 */
-    SRLA_ALLOCATE_2DIMARRAY(obpc->adjacency_matrix, work_ptr, double, tmp_max_num_nodes, tmp_max_num_nodes);
+    /* 辺のコスト */
+    SRLA_ALLOCATE_2DIMARRAY(obpc->edge_cost, work_ptr, double, tmp_max_num_nodes, tmp_max_band_width);
     /* コスト配列 */
     work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
     obpc->cost = (double *)work_ptr;
@@ -230,10 +330,6 @@ static struct SRLAOptimalBlockPartitionCalculator *SRLAOptimalBlockPartitionCalc
     work_ptr = (uint8_t*)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
     obpc->path = (uint32_t*)work_ptr;
     work_ptr += sizeof(uint32_t) * tmp_max_num_nodes;
-    /* ノード使用済みフラグ */
-    work_ptr = (uint8_t*)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
-    obpc->used_flag = (uint8_t*)work_ptr;
-    work_ptr += sizeof(uint8_t) * tmp_max_num_nodes;
 
     return obpc;
 }
@@ -245,57 +341,38 @@ static void SRLAOptimalBlockPartitionCalculator_Destroy(struct SRLAOptimalBlockP
     SRLAUTILITY_UNUSED_ARGUMENT(obpc);
 }
 
-/* ダイクストラ法により最短経路を求める */
-static SRLAError SRLAOptimalBlockPartitionCalculator_ApplyDijkstraMethod(
+/* 最短経路を求める
+ * 辺は前方（インデックスが増える方向）にしか伸びないため、ノードを昇順に1回走査すれば最短経路が確定する */
+static SRLAError SRLAOptimalBlockPartitionCalculator_ComputeShortestPath(
     struct SRLAOptimalBlockPartitionCalculator *obpc,
     uint32_t num_nodes, uint32_t start_node, uint32_t goal_node, double *min_cost)
 {
-    uint32_t i, target;
-    double min;
+    uint32_t i, k;
 
     /* 引数チェック */
-    if (obpc == NULL || (num_nodes > obpc->max_num_nodes)) {
+    if ((obpc == NULL) || (num_nodes > obpc->max_num_nodes)
+        || (start_node > goal_node) || (goal_node >= num_nodes)) {
         return SRLA_ERROR_INVALID_ARGUMENT;
     }
 
-    /* フラグと経路をクリア, 距離は巨大値に設定 */
-    for (i = 0; i < obpc->max_num_nodes; i++) {
-        obpc->used_flag[i] = 0;
+    /* 経路をクリア, 距離は巨大値に設定 */
+    for (i = 0; i < num_nodes; i++) {
         obpc->path[i] = ~0U;
-        obpc->cost[i] = SRLAENCODER_DIJKSTRA_BIGWEIGHT;
+        obpc->cost[i] = SRLAENCODER_BIGWEIGHT;
     }
 
-    /* ダイクストラ法実行 */
+    /* 開始ノードから順に、前方のノードへの距離と経路を更新 */
     obpc->cost[start_node] = 0.0;
-    target = start_node;
-    while (1) {
-        /* まだ未確定のノードから最も距離（重み）が小さいノードを
-        * その地点の最小距離として確定 */
-        min = SRLAENCODER_DIJKSTRA_BIGWEIGHT;
-        for (i = 0; i < num_nodes; i++) {
-            if ((obpc->used_flag[i] == 0) && (min > obpc->cost[i])) {
-                min = obpc->cost[i];
-                target = i;
-            }
-        }
-
-        /* 最短経路が確定 */
-        if (target == goal_node) {
-            break;
-        }
-
-        /* 現在確定したノードから、直接繋がっており、かつ、未確定の
-        * ノードに対して、現在確定したノードを経由した時の距離を計算し、
-        * 今までの距離よりも小さければ距離と経路を修正 */
-        for (i = 0; i < num_nodes; i++) {
-            if (obpc->cost[i] > (obpc->adjacency_matrix[target][i] + obpc->cost[target])) {
-                obpc->cost[i] = obpc->adjacency_matrix[target][i] + obpc->cost[target];
-                obpc->path[i] = target;
+    for (i = start_node; i < goal_node; i++) {
+        const double *edge_cost = obpc->edge_cost[i];
+        const uint32_t band_width = SRLAUTILITY_MIN(obpc->max_band_width, goal_node - i);
+        for (k = 0; k < band_width; k++) {
+            const double cost = obpc->cost[i] + edge_cost[k];
+            if (obpc->cost[i + k + 1] > cost) {
+                obpc->cost[i + k + 1] = cost;
+                obpc->path[i + k + 1] = i;
             }
         }
-
-        /* 現在注目しているノードを確定に変更 */
-        obpc->used_flag[target] = 1;
     }
 
     /* 最小コストのセット */
@@ -306,73 +383,367 @@ static SRLAError SRLAOptimalBlockPartitionCalculator_ApplyDijkstraMethod(
     return SRLA_ERROR_OK;
 }
 
-/* 最適なブロック分割の探索 */
-static SRLAError SRLAEncoder_SearchOptimalBlockPartitions(
-    struct SRLAEncoder *encoder,
-    const int32_t *const *input, uint32_t num_lookahead_samples,
-    uint32_t min_num_block_samples, uint32_t max_num_block_samples,
-    uint32_t *optimal_num_partitions, uint32_t *optimal_block_partition)
+/* 辺のコストを前方にnum_shift_nodesノード分ずらす
+ * 先頭num_shift_nodesノードを確定させた後、重複区間の辺のコストを次の探索で再利用するために使う */
+static SRLAError SRLAOptimalBlockPartitionCalculator_ShiftEdgeCosts(
+    struct SRLAOptimalBlockPartitionCalculator *obpc, uint32_t num_nodes, uint32_t num_shift_nodes)
 {
-    uint32_t i, j, ch;
-    uint32_t num_channels, num_nodes, tmp_optimal_num_partitions, tmp_node;
-    struct SRLAOptimalBlockPartitionCalculator *obpc;
+    uint32_t i;
 
     /* 引数チェック */
-    if ((encoder == NULL) || (input == NULL) || (optimal_num_partitions == NULL)
-        || (optimal_block_partition == NULL)) {
+    if ((obpc == NULL) || (num_nodes > obpc->max_num_nodes) || (num_shift_nodes > num_nodes)) {
         return SRLA_ERROR_INVALID_ARGUMENT;
     }
 
-    /* ブロックサイズのチェック */
-    if (min_num_block_samples > max_num_block_samples) {
-        return SRLA_ERROR_INVALID_ARGUMENT;
+    /* 異なる行同士のコピーなので前から順に詰めてよい */
+    for (i = 0; i < (num_nodes - num_shift_nodes); i++) {
+        memcpy(obpc->edge_cost[i], obpc->edge_cost[i + num_shift_nodes], sizeof(double) * obpc->max_band_width);
     }
 
-    /* オート変数に受ける */
-    obpc = encoder->obpc;
-    num_channels = encoder->header.num_channels;
+    return SRLA_ERROR_OK;
+}
 
-    /* 隣接行列次元（ノード数）の計算 */
-    num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(num_lookahead_samples, min_num_block_samples);
+/* 自己相関キャッシュのワークサイズ計算 */
+static int32_t SRLAAutoCorrelationCache_CalculateWorkSize(
+    uint32_t max_num_channels, uint32_t max_num_samples, uint32_t min_num_block_samples, uint32_t max_order)
+{
+    int32_t work_size;
+    uint32_t max_num_signals, max_num_segments;
+
+    /* 引数チェック */
+    if ((max_num_channels == 0) || (max_num_samples == 0) || (min_num_block_samples == 0)) {
+        return -1;
+    }
+
+    max_num_signals = (max_num_channels >= 2) ? (max_num_channels + 2) : max_num_channels;
+    max_num_segments = SRLAENCODER_CALCULATE_NUM_NODES(max_num_samples, min_num_block_samples) - 1;
+
+    /* 1信号あたりの相関領域・信号バッファがint32_tに収まるか */
+    if ((max_num_segments > (uint32_t)(INT32_MAX / 2 / (int32_t)sizeof(double) / SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS) / (max_order + 1))
+            || (max_num_samples > (uint32_t)(INT32_MAX / 2 / (int32_t)sizeof(double)))) {
+        return -1;
+    }
+
+    work_size = sizeof(struct SRLAAutoCorrelationCache) + SRLA_MEMORY_ALIGNMENT;
+    /* セグメント内自己相関・境界相互相関 */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 2 * max_num_signals,
+            (int32_t)SRLA_CALCULATE_2DIMARRAY_WORKSIZE(double, 1, max_num_segments * (max_order + 1) * SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS))) < 0) {
+        return -1;
+    }
+    /* 正規化信号バッファ */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 1, (int32_t)(SRLA_MEMORY_ALIGNMENT + sizeof(double) * max_num_samples))) < 0) {
+        return -1;
+    }
+    /* MS信号バッファ */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 2,
+            (int32_t)SRLA_CALCULATE_2DIMARRAY_WORKSIZE(int32_t, 1, max_num_samples))) < 0) {
+        return -1;
+    }
+
+    return work_size;
+}
+
+/* 自己相関キャッシュの作成 */
+static struct SRLAAutoCorrelationCache *SRLAAutoCorrelationCache_Create(
+    uint32_t max_num_channels, uint32_t max_num_samples, uint32_t min_num_block_samples, uint32_t max_order,
+    void *work, int32_t work_size)
+{
+    struct SRLAAutoCorrelationCache *cache;
+    uint32_t max_num_signals, max_num_segments;
+    uint8_t *work_ptr = (uint8_t *)work;
+
+    /* 引数チェック */
+    if ((work == NULL)
+        || (work_size < SRLAAutoCorrelationCache_CalculateWorkSize(max_num_channels, max_num_samples, min_num_block_samples, max_order))) {
+        return NULL;
+    }
+
+    max_num_signals = (max_num_channels >= 2) ? (max_num_channels + 2) : max_num_channels;
+    max_num_segments = SRLAENCODER_CALCULATE_NUM_NODES(max_num_samples, min_num_block_samples) - 1;
+
+    /* ハンドル領域確保 */
+    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+    cache = (struct SRLAAutoCorrelationCache *)work_ptr;
+    work_ptr += sizeof(struct SRLAAutoCorrelationCache);
+
+    cache->max_num_signals = max_num_signals;
+    cache->max_num_segments = max_num_segments;
+    cache->max_num_samples = max_num_samples;
+    cache->max_order = max_order;
+    cache->num_signals = 0;
+    cache->num_segments = 0;
+    cache->order = 0;
+    cache->segment_length = 0;
+
+    /* セグメント内自己相関 */
+    SRLA_ALLOCATE_2DIMARRAY(cache->segment_corr, work_ptr, double, max_num_signals, max_num_segments * (max_order + 1) * SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS);
+    /* 境界相互相関 */
+    SRLA_ALLOCATE_2DIMARRAY(cache->boundary_corr, work_ptr, double, max_num_signals, max_num_segments * (max_order + 1) * SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS);
+    /* 正規化信号バッファ */
+    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+    cache->buffer = (double *)work_ptr;
+    work_ptr += sizeof(double) * max_num_samples;
+    /* MS信号バッファ */
+    SRLA_ALLOCATE_2DIMARRAY(cache->ms_buffer, work_ptr, int32_t, 2, max_num_samples);
+
+    return cache;
+}
+
+/* 自己相関キャッシュの破棄 */
+static void SRLAAutoCorrelationCache_Destroy(struct SRLAAutoCorrelationCache *cache)
+{
+    /* 特に何もしない */
+    SRLAUTILITY_UNUSED_ARGUMENT(cache);
+}
+
+/* 1信号分のセグメント内自己相関と境界相互相関のモーメントを計算
+ * ラグlagの積 x[n] x[n - lag] を、セグメント先頭からの位置 n - start をセグメント長で正規化した値の累乗で重み付けして累積する */
+static void SRLAAutoCorrelationCache_ComputeSignal(
+    struct SRLAAutoCorrelationCache *cache, uint32_t signal, uint32_t num_samples, uint32_t segment_length)
+{
+    uint32_t seg, lag, smpl, m;
+    const double *x = cache->buffer;
+    const double inv_length = 1.0 / segment_length;
+
+    for (seg = 0; seg < cache->num_segments; seg++) {
+        const uint32_t start = seg * segment_length;
+        const uint32_t end = SRLAUTILITY_MIN(start + segment_length, num_samples);
+        for (lag = 0; lag <= cache->order; lag++) {
+            const uint32_t index = (seg * (cache->max_order + 1) + lag) * SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS;
+            double *segment_corr = &cache->segment_corr[signal][index];
+            double *boundary_corr = &cache->boundary_corr[signal][index];
+            for (m = 0; m < SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS; m++) {
+                segment_corr[m] = boundary_corr[m] = 0.0;
+            }
+            /* セグメント内で完結する積和 */
+            for (smpl = start + lag; smpl < end; smpl++) {
+                const double pos = (smpl - start) * inv_length;
+                double prod = x[smpl] * x[smpl - lag];
+                for (m = 0; m < SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS; m++) {
+                    segment_corr[m] += prod;
+                    prod *= pos;
+                }
+            }
+            /* 次のセグメントにまたがる積和 */
+            for (smpl = end; smpl < SRLAUTILITY_MIN(end + lag, num_samples); smpl++) {
+                const double pos = (smpl - start) * inv_length;
+                double prod = x[smpl] * x[smpl - lag];
+                for (m = 0; m < SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS; m++) {
+                    boundary_corr[m] += prod;
+                    prod *= pos;
+                }
+            }
+        }
+    }
+}
+
+/* 自己相関キャッシュの構築 */
+static SRLAError SRLAAutoCorrelationCache_Build(
+    struct SRLAAutoCorrelationCache *cache, const int32_t *const *input,
+    uint32_t num_channels, uint32_t num_samples, uint32_t segment_length,
+    uint32_t order, uint32_t bits_per_sample, uint32_t offset_lshift)
+{
+    uint32_t ch, smpl, num_signals, num_segments;
+    double norm_const;
 
-    /* 最大ノード数を超えている */
-    if (num_nodes > obpc->max_num_nodes) {
+    /* 引数チェック */
+    if ((cache == NULL) || (input == NULL) || (segment_length == 0)) {
         return SRLA_ERROR_INVALID_ARGUMENT;
     }
 
-    /* 隣接行列を一旦巨大値で埋める */
-    for (i = 0; i < num_nodes; i++) {
-        for (j = 0; j < num_nodes; j++) {
-            obpc->adjacency_matrix[i][j] = SRLAENCODER_DIJKSTRA_BIGWEIGHT;
+    num_signals = (num_channels >= 2) ? (num_channels + 2) : num_channels;
+    num_segments = SRLAENCODER_CALCULATE_NUM_NODES(num_samples, segment_length) - 1;
+
+    /* サイズチェック 隣接セグメントとの相互相関のみ保持するため、ラグはセグメント長以下とする */
+    if ((num_signals > cache->max_num_signals) || (num_segments > cache->max_num_segments)
+        || (num_samples > cache->max_num_samples) || (order > cache->max_order)
+        || (order > segment_length)) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+
+    cache->num_signals = num_signals;
+    cache->num_segments = num_segments;
+    cache->order = order;
+    cache->segment_length = segment_length;
+
+    norm_const = pow(2.0, -(int32_t)(bits_per_sample - 1));
+
+    /* 各チャンネルの自己相関 */
+    for (ch = 0; ch < num_channels; ch++) {
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            cache->buffer[smpl] = (input[ch][smpl] >> offset_lshift) * norm_const;
+        }
+        SRLAAutoCorrelationCache_ComputeSignal(cache, ch, num_samples, segment_length);
+    }
+
+    /* MS信号の自己相関 */
+    if (num_channels >= 2) {
+        for (ch = 0; ch < 2; ch++) {
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                cache->ms_buffer[ch][smpl] = input[ch][smpl] >> offset_lshift;
+            }
+        }
+        SRLAUtility_LRtoMSConversion(cache->ms_buffer, num_samples);
+        for (ch = 0; ch < 2; ch++) {
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                cache->buffer[smpl] = cache->ms_buffer[ch][smpl] * norm_const;
+            }
+            SRLAAutoCorrelationCache_ComputeSignal(cache, num_channels + ch, num_samples, segment_length);
+        }
+    }
+
+    return SRLA_ERROR_OK;
+}
+
+/* start_segmentからend_segmentの直前までのセグメントを結合したブロックの窓なし自己相関を取得 */
+static double SRLAAutoCorrelationCache_GetRawAutoCorrelation(
+    const struct SRLAAutoCorrelationCache *cache, uint32_t signal,
+    uint32_t start_segment, uint32_t end_segment, uint32_t lag)
+{
+    uint32_t seg;
+    double corr = 0.0;
+
+    SRLA_ASSERT(cache != NULL);
+    SRLA_ASSERT(signal < cache->num_signals);
+    SRLA_ASSERT(end_segment <= cache->num_segments);
+    SRLA_ASSERT(lag <= cache->order);
+
+    /* 0次のモーメントが窓なしの積和 */
+    for (seg = start_segment; seg < end_segment; seg++) {
+        const uint32_t index = (seg * (cache->max_order + 1) + lag) * SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS;
+        corr += cache->segment_corr[signal][index];
+        /* ブロック内にある次のセグメントとの境界 */
+        if ((seg + 1) < end_segment) {
+            corr += cache->boundary_corr[signal][index];
+        }
+    }
+
+    return corr;
+}
+
+/* start_segmentからend_segmentの直前までのセグメントを結合したブロックの0次（窓なし）自己相関を取得 */
+static double SRLAAutoCorrelationCache_GetEnergy(
+    const struct SRLAAutoCorrelationCache *cache, uint32_t signal,
+    uint32_t start_segment, uint32_t end_segment)
+{
+    return SRLAAutoCorrelationCache_GetRawAutoCorrelation(cache, signal, start_segment, end_segment, 0);
+}
+
+/* start_segmentからend_segmentの直前までのセグメントを結合したブロックのWelch窓掛け後の自己相関を取得
+ * 結果は窓の二乗和で正規化し、窓なしの自己相関と同じスケールに揃える */
+static void SRLAAutoCorrelationCache_GetAutoCorrelation(
+    const struct SRLAAutoCorrelationCache *cache, uint32_t signal,
+    uint32_t start_segment, uint32_t end_segment, uint32_t num_samples, double *auto_corr)
+{
+    uint32_t seg, lag, m;
+    double denom, scale;
+    const uint32_t segment_length = cache->segment_length;
+
+    SRLA_ASSERT(cache != NULL);
+    SRLA_ASSERT(auto_corr != NULL);
+    SRLA_ASSERT(signal < cache->num_signals);
+    SRLA_ASSERT(start_segment < end_segment);
+    SRLA_ASSERT(end_segment <= cache->num_segments);
+    SRLA_ASSERT(num_samples >= 3);
+
+    /* 窓 w(u) = 4u(D - u) / D^2, D = num_samples - 1 */
+    denom = num_samples - 1;
+
+    for (lag = 0; lag <= cache->order; lag++) {
+        auto_corr[lag] = 0.0;
+    }
+
+    for (seg = start_segment; seg < end_segment; seg++) {
+        /* セグメント内の正規化位置tに対し、ブロック先頭からの位置は u = offset + segment_length * t */
+        const double alpha = ((seg - start_segment) * segment_length) / denom;
+        const double beta = segment_length / denom;
+        for (lag = 0; lag <= cache->order; lag++) {
+            const uint32_t index = (seg * (cache->max_order + 1) + lag) * SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS;
+            const double *segment_corr = &cache->segment_corr[signal][index];
+            const double *boundary_corr = &cache->boundary_corr[signal][index];
+            const double lag_alpha = alpha - lag / denom;
+            double wcurr[3], wprev[3], poly[SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS];
+            /* w(alpha + beta t) = 4(alpha + beta t) - 4(alpha + beta t)^2 のtに関する係数 */
+            wcurr[0] = 4.0 * alpha * (1.0 - alpha);
+            wcurr[1] = 4.0 * beta * (1.0 - 2.0 * alpha);
+            wcurr[2] = -4.0 * beta * beta;
+            wprev[0] = 4.0 * lag_alpha * (1.0 - lag_alpha);
+            wprev[1] = 4.0 * beta * (1.0 - 2.0 * lag_alpha);
+            wprev[2] = -4.0 * beta * beta;
+            /* 窓の積 w(u) w(u - lag) の係数 */
+            poly[0] = wcurr[0] * wprev[0];
+            poly[1] = wcurr[0] * wprev[1] + wcurr[1] * wprev[0];
+            poly[2] = wcurr[0] * wprev[2] + wcurr[1] * wprev[1] + wcurr[2] * wprev[0];
+            poly[3] = wcurr[1] * wprev[2] + wcurr[2] * wprev[1];
+            poly[4] = wcurr[2] * wprev[2];
+            for (m = 0; m < SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS; m++) {
+                auto_corr[lag] += poly[m] * segment_corr[m];
+            }
+            /* ブロック内にある次のセグメントとの境界 */
+            if ((seg + 1) < end_segment) {
+                for (m = 0; m < SRLAENCODER_NUM_AUTOCORRELATION_MOMENTS; m++) {
+                    auto_corr[lag] += poly[m] * boundary_corr[m];
+                }
+            }
         }
     }
 
-    /* 隣接行列のセット */
-    /* (i,j)要素は、i * delta_num_samples から j * delta_num_samples まで
+    /* 窓の二乗和 sum_{u=0}^{D} w(u)^2 = 8(D - 1/D^3)/15 で正規化 */
+    scale = num_samples / (8.0 * (denom - 1.0 / (denom * denom * denom)) / 15.0);
+    for (lag = 0; lag <= cache->order; lag++) {
+        auto_corr[lag] *= scale;
+    }
+}
+
+/* 辺のコスト（ブロックの符号長）を計算
+ * 計算対象の辺を順に数えたとき、start_indexからindex_stride間隔の辺だけを計算する
+ * 両端がnum_reuse_nodes未満のノードを結ぶ辺は計算済みとしてスキップする */
+static SRLAError SRLAEncoder_ComputeEdgeCosts(
+    struct SRLAEncoder *encoder,
+    const int32_t *const *input, uint32_t num_lookahead_samples,
+    uint32_t min_num_block_samples, uint32_t max_num_block_samples,
+    uint32_t num_nodes, uint32_t num_reuse_nodes, uint32_t start_index, uint32_t index_stride,
+    const struct SRLAAutoCorrelationCache *cache, double **edge_cost)
+{
+    uint32_t i, j, ch, edge_index;
+    const uint32_t num_channels = encoder->header.num_channels;
+    const uint32_t band_width = max_num_block_samples / min_num_block_samples;
+
+    SRLA_ASSERT(index_stride > 0);
+
+    /* (i,j - i - 1)要素は、i * delta_num_samples から j * delta_num_samples まで
     * エンコードした時のコスト（符号長）が入る */
+    /* 最大ブロックサイズを越える辺は計算しない */
+    edge_index = 0;
     for (i = 0; i < num_nodes; i++) {
-        for (j = i + 1; j < num_nodes; j++) {
+        for (j = SRLAUTILITY_MAX(i + 1, num_reuse_nodes); (j < num_nodes) && ((j - i) <= band_width); j++) {
             double code_length;
-            const int32_t *data_ptr[SRLA_MAX_NUM_CHANNELS];
             const uint32_t sample_offset = i * min_num_block_samples;
             uint32_t num_block_samples = (j - i) * min_num_block_samples;
 
-            /* 最大ブロックサイズ以上であれば計算スキップ */
-            if (num_block_samples > max_num_block_samples) {
+            /* 担当外の辺はスキップ */
+            if ((edge_index++ % index_stride) != start_index) {
                 continue;
             }
 
             /* 端点で飛び出る場合があるので調節 */
             num_block_samples = SRLAUTILITY_MIN(num_block_samples, num_lookahead_samples - sample_offset);
 
-            /* データ参照位置を設定 */
-            for (ch = 0; ch < num_channels; ch++) {
-                data_ptr[ch] = &input[ch][sample_offset];
-            }
-
-            {
+            if (cache != NULL) {
+                /* 自己相関キャッシュから推定符号長を計算 */
+                if (SRLAEncoder_EstimateBlockSize(encoder,
+                    cache, i, j, num_block_samples, &code_length) != SRLA_ERROR_OK) {
+                    return SRLA_ERROR_NG;
+                }
+            } else {
                 /* エンコードして長さを計測 */
                 uint32_t encode_len;
+                const int32_t *data_ptr[SRLA_MAX_NUM_CHANNELS];
+
+                /* データ参照位置を設定 */
+                for (ch = 0; ch < num_channels; ch++) {
+                    data_ptr[ch] = &input[ch][sample_offset];
+                }
 
                 if (SRLAEncoder_ComputeBlockSize(encoder,
                     data_ptr, num_block_samples, &encode_len) != SRLA_APIRESULT_OK) {
@@ -380,16 +751,128 @@ static SRLAError SRLAEncoder_SearchOptimalBlockPartitions(
                 }
 
                 code_length = encode_len;
-                /* TODO: 推定長さでも試す */
             }
 
-            /* 隣接行列にセット */
-            obpc->adjacency_matrix[i][j] = code_length;
+            /* 辺のコストにセット */
+            edge_cost[i][j - i - 1] = code_length;
+        }
+    }
+
+    return SRLA_ERROR_OK;
+}
+
+/* ブロック分割探索の並列タスクの実行 */
+static void SRLAEncoder_ExecutePartitionSearchTask(void *arg)
+{
+    struct SRLAEncoderPartitionSearchTask *task = (struct SRLAEncoderPartitionSearchTask *)arg;
+
+    task->result = SRLAEncoder_ComputeEdgeCosts(task->encoder, task->input,
+        task->num_lookahead_samples, task->min_num_block_samples, task->max_num_block_samples,
+        task->num_nodes, task->num_reuse_nodes, task->start_index, task->index_stride, task->cache, task->edge_cost);
+}
+
+/* 最適なブロック分割の探索
+ * 先頭num_reuse_nodesノード間の辺のコストは計算済みのもの（SRLAOptimalBlockPartitionCalculator_ShiftEdgeCostsでずらした値）を使う */
+static SRLAError SRLAEncoder_SearchOptimalBlockPartitions(
+    struct SRLAEncoder *encoder,
+    const int32_t *const *input, uint32_t num_lookahead_samples,
+    uint32_t min_num_block_samples, uint32_t max_num_block_samples, uint32_t num_reuse_nodes,
+    uint32_t *optimal_num_partitions, uint32_t *optimal_block_partition)
+{
+    uint32_t i, k;
+    uint32_t num_nodes, band_width, tmp_optimal_num_partitions, tmp_node;
+    struct SRLAOptimalBlockPartitionCalculator *obpc;
+    const struct SRLAAutoCorrelationCache *cache = NULL;
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL) || (optimal_num_partitions == NULL)
+        || (optimal_block_partition == NULL)) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* ブロックサイズのチェック */
+    if (min_num_block_samples > max_num_block_samples) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* オート変数に受ける */
+    obpc = encoder->obpc;
+
+    /* ノード数・辺が伸びる最大ノード数の計算 */
+    num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(num_lookahead_samples, min_num_block_samples);
+    band_width = max_num_block_samples / min_num_block_samples;
+
+    /* 最大ノード数・最大幅を超えている */
+    if ((num_nodes > obpc->max_num_nodes) || (band_width > obpc->max_band_width)
+        || (num_reuse_nodes > num_nodes)) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* 再利用しない辺のコストを一旦巨大値で埋める */
+    for (i = 0; i < num_nodes; i++) {
+        for (k = 0; k < obpc->max_band_width; k++) {
+            if ((i + k + 1) >= num_reuse_nodes) {
+                obpc->edge_cost[i][k] = SRLAENCODER_BIGWEIGHT;
+            }
+        }
+    }
+
+    /* 推定符号長を使う場合は自己相関キャッシュを構築 */
+    if (encoder->estimate_partition_cost) {
+        const uint32_t order = SRLAUTILITY_MIN(
+            encoder->parameter_preset->max_num_parameters + SRLA_NUM_PREEMPHASIS_FILTERS, encoder->accache->max_order);
+        SRLAError err;
+        if ((err = SRLAAutoCorrelationCache_Build(encoder->accache, input,
+                encoder->header.num_channels, num_lookahead_samples, min_num_block_samples,
+                order, encoder->header.bits_per_sample, encoder->header.offset_lshift)) != SRLA_ERROR_OK) {
+            return err;
+        }
+        cache = encoder->accache;
+    }
+
+    /* 辺のコストのセット */
+    if (encoder->num_search_threads > 1) {
+        /* ワーカーで分担して計算 */
+        uint32_t t;
+        void *args[SRLA_MAX_NUM_THREADS];
+        for (t = 0; t < encoder->num_search_threads; t++) {
+            struct SRLAEncoderPartitionSearchTask *task = &encoder->search_tasks[t];
+            if (t > 0) {
+                SRLAEncoder_CopyParameterToWorker(encoder->workers[t], encoder);
+            }
+            task->encoder = encoder->workers[t];
+            task->input = input;
+            task->num_lookahead_samples = num_lookahead_samples;
+            task->min_num_block_samples = min_num_block_samples;
+            task->max_num_block_samples = max_num_block_samples;
+            task->num_nodes = num_nodes;
+            task->num_reuse_nodes = num_reuse_nodes;
+            task->start_index = t;
+            task->index_stride = encoder->num_search_threads;
+            task->cache = cache;
+            task->edge_cost = obpc->edge_cost;
+            args[t] = task;
+        }
+        if (SRLAThread_ExecuteParallel(SRLAEncoder_ExecutePartitionSearchTask,
+                args, encoder->num_search_threads) != SRLA_ERROR_OK) {
+            return SRLA_ERROR_NG;
+        }
+        for (t = 0; t < encoder->num_search_threads; t++) {
+            if (encoder->search_tasks[t].result != SRLA_ERROR_OK) {
+                return encoder->search_tasks[t].result;
+            }
+        }
+    } else {
+        SRLAError err;
+        if ((err = SRLAEncoder_ComputeEdgeCosts(encoder, input,
+                num_lookahead_samples, min_num_block_samples, max_num_block_samples,
+                num_nodes, num_reuse_nodes, 0, 1, cache, obpc->edge_cost)) != SRLA_ERROR_OK) {
+            return err;
         }
     }
 
-    /* ダイクストラ法を実行 */
-    if (SRLAOptimalBlockPartitionCalculator_ApplyDijkstraMethod(
+    /* 最短経路を計算 */
+    if (SRLAOptimalBlockPartitionCalculator_ComputeShortestPath(
             obpc, num_nodes, 0, num_nodes - 1, NULL) != SRLA_ERROR_OK) {
         return SRLA_ERROR_NG;
     }
@@ -464,6 +947,26 @@ static SRLAError SRLAEncoder_ConvertParameterToHeader(
     return SRLA_ERROR_OK;
 }
 
+/* 並列エンコード時に1スレッドが出力するデータのバッファサイズ計算 オーバーフローする場合は-1を返す */
+/* 補足）圧縮結果が32bit生データの2倍を越えないことを想定。ブロックヘッダは11byte */
+static int32_t SRLAEncoder_CalculateWorkerBufferSize(
+    uint32_t num_channels, uint32_t num_lookahead_samples, uint32_t min_num_samples_per_block)
+{
+    int32_t buffer_size;
+
+    SRLA_ASSERT(min_num_samples_per_block > 0);
+
+    if (num_lookahead_samples > (uint32_t)(INT32_MAX / (2 * sizeof(int32_t)))) {
+        return -1;
+    }
+    if ((buffer_size = SRLAUtility_AddWorkSize(0, num_channels, 2 * (int32_t)sizeof(int32_t) * (int32_t)num_lookahead_samples)) < 0) {
+        return -1;
+    }
+
+    return SRLAUtility_AddWorkSize(buffer_size,
+        SRLAENCODER_CALCULATE_NUM_NODES(num_lookahead_samples, min_num_samples_per_block), 11);
+}
+
 /* エンコーダハンドル作成に必要なワークサイズ計算 */
 int32_t SRLAEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config)
 {
@@ -482,6 +985,11 @@ int32_t SRLAEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config)
         return -1;
     }
 
+    /* スレッド数が範囲外 補足）0は1スレッドとして扱う */
+    if (config->max_num_threads > SRLA_MAX_NUM_THREADS) {
+        return -1;
+    }
+
     /* ブロックサイズはパラメータ数より大きくなるべき */
     if (config->max_num_parameters > config->max_num_samples_per_block) {
         return -1;
@@ -494,6 +1002,10 @@ int32_t SRLAEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config)
     if (config->max_num_lookahead_samples < config->max_num_samples_per_block) {
         return -1;
     }
+    /* 最大先読みサンプル数が大きすぎる（先読み区間分のバッファがint32_tに収まらない） */
+    if (config->max_num_lookahead_samples > (uint32_t)(INT32_MAX / (2 * sizeof(int32_t)))) {
+        return -1;
+    }
 
     /* ハンドル本体のサイズ */
     work_size = sizeof(struct SRLAEncoder) + SRLA_MEMORY_ALIGNMENT;
@@ -517,10 +1029,22 @@ int32_t SRLAEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config)
 
     /* 最適分割探索ハンドルのサイズ */
     if ((tmp_work_size = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(
-            config->max_num_lookahead_samples, config->min_num_samples_per_block)) < 0) {
+            config->max_num_lookahead_samples, config->min_num_samples_per_block, config->max_num_samples_per_block)) < 0) {
+        return -1;
+    }
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 1, tmp_work_size)) < 0) {
+        return -1;
+    }
+
+    /* 自己相関キャッシュのサイズ */
+    if ((tmp_work_size = SRLAAutoCorrelationCache_CalculateWorkSize(
+            config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block,
+            SRLAUTILITY_MIN(config->max_num_parameters, config->min_num_samples_per_block))) < 0) {
+        return -1;
+    }
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 1, tmp_work_size)) < 0) {
         return -1;
     }
-    work_size += tmp_work_size;
 
     /* プリエンファシスフィルタのサイズ */
     work_size += (int32_t)SRLA_CALCULATE_2DIMARRAY_WORKSIZE(struct SRLAPreemphasisFilter, config->max_num_channels, SRLA_NUM_PREEMPHASIS_FILTERS);
@@ -540,7 +1064,48 @@ int32_t SRLAEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config)
     /* LTP計数領域のサイズ */
     work_size += (int32_t)(SRLA_MEMORY_ALIGNMENT + sizeof(double) * SRLA_MAX_LTP_ORDER);
     /* 分割設定記録領域のサイズ */
-    work_size += (int32_t)(SRLAENCODER_CALCULATE_NUM_NODES(config->max_num_samples_per_block, config->min_num_samples_per_block) * sizeof(uint32_t) + SRLA_MEMORY_ALIGNMENT);
+    /* 補足）分割数は先読み区間内の最小ブロック数まで増えうる */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 1, SRLA_MEMORY_ALIGNMENT)) < 0) {
+        return -1;
+    }
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, SRLAENCODER_CALCULATE_NUM_NODES(
+            SRLAUTILITY_MAX(config->max_num_lookahead_samples, config->max_num_samples_per_block),
+            config->min_num_samples_per_block), (int32_t)sizeof(uint32_t))) < 0) {
+        return -1;
+    }
+
+    /* 並列処理用領域のサイズ */
+    /* 補足）先読みサンプル数・チャンネル数・スレッド数が大きいとint32_tを越えうるため、加算ごとに検査する */
+    if (config->max_num_threads > 1) {
+        int32_t worker_buffer_size;
+        struct SRLAEncoderConfig worker_config = (*config);
+        worker_config.max_num_threads = 1;
+        /* ワーカーのエンコーダハンドル（先頭は自分自身を使う） */
+        if ((tmp_work_size = SRLAEncoder_CalculateWorkSize(&worker_config)) < 0) {
+            return -1;
+        }
+        if ((work_size = SRLAUtility_AddWorkSize(work_size, config->max_num_threads - 1, tmp_work_size)) < 0) {
+            return -1;
+        }
+        /* ハンドルへのポインタ・タスク */
+        if ((work_size = SRLAUtility_AddWorkSize(work_size, 3, SRLA_MEMORY_ALIGNMENT)) < 0) {
+            return -1;
+        }
+        if ((work_size = SRLAUtility_AddWorkSize(work_size, config->max_num_threads,
+                (int32_t)(sizeof(struct SRLAEncoder *) + sizeof(struct SRLAEncoderParallelTask) + sizeof(struct SRLAEncoderPartitionSearchTask)))) < 0) {
+            return -1;
+        }
+        /* 出力バッファ */
+        if ((worker_buffer_size = SRLAEncoder_CalculateWorkerBufferSize(
+                config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block)) < 0) {
+            return -1;
+        }
+        if ((worker_buffer_size > (INT32_MAX - (int32_t)sizeof(uint8_t *) - 2 * SRLA_MEMORY_ALIGNMENT))
+                || ((work_size = SRLAUtility_AddWorkSize(work_size, config->max_num_threads,
+                        SRLA_CALCULATE_2DIMARRAY_WORKSIZE(uint8_t, 1, worker_buffer_size))) < 0)) {
+            return -1;
+        }
+    }
 
     return work_size;
 }
@@ -599,6 +1164,9 @@ struct SRLAEncoder* SRLAEncoder_Create(const struct SRLAEncoderConfig *config, v
     encoder->lb_num_samples_per_block = config->min_num_samples_per_block;
     encoder->max_num_lookahead_samples = config->max_num_lookahead_samples;
     encoder->max_num_parameters = config->max_num_parameters;
+    encoder->max_num_threads = SRLAUTILITY_MAX(config->max_num_threads, 1);
+    /* 補足）ブロック分割探索の並列化はSRLAEncoder_EncodeWholeParallelで指示されたときのみ行う */
+    encoder->num_search_threads = 1;
 
     /* LPC計算ハンドルの作成 */
     {
@@ -626,14 +1194,29 @@ struct SRLAEncoder* SRLAEncoder_Create(const struct SRLAEncoderConfig *config, v
     {
         const int32_t obpc_size
             = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(
-            config->max_num_lookahead_samples, config->min_num_samples_per_block);
+            config->max_num_lookahead_samples, config->min_num_samples_per_block, config->max_num_samples_per_block);
         if ((encoder->obpc = SRLAOptimalBlockPartitionCalculator_Create(
-                config->max_num_lookahead_samples, config->min_num_samples_per_block, work_ptr, obpc_size)) == NULL) {
+                config->max_num_lookahead_samples, config->min_num_samples_per_block, config->max_num_samples_per_block,
+                work_ptr, obpc_size)) == NULL) {
             return NULL;
         }
         work_ptr += obpc_size;
     }
 
+    /* 自己相関キャッシュの作成 */
+    {
+        const uint32_t max_order = SRLAUTILITY_MIN(config->max_num_parameters, config->min_num_samples_per_block);
+        const int32_t accache_size
+            = SRLAAutoCorrelationCache_CalculateWorkSize(
+            config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block, max_order);
+        if ((encoder->accache = SRLAAutoCorrelationCache_Create(
+                config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block, max_order,
+                work_ptr, accache_size)) == NULL) {
+            return NULL;
+        }
+        work_ptr += accache_size;
+    }
+
     /* プリエンファシスフィルタの作成 */
     SRLA_ALLOCATE_2DIMARRAY(encoder->pre_emphasis,
         work_ptr, struct SRLAPreemphasisFilter, config->max_num_channels, SRLA_NUM_PREEMPHASIS_FILTERS);
@@ -673,9 +1256,48 @@ struct SRLAEncoder* SRLAEncoder_Create(const struct SRLAEncoderConfig *config, v
     /* 分割設定記録領域 */
     work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
     encoder->partitions_buffer = (uint32_t *)work_ptr;
-    work_ptr += SRLAENCODER_CALCULATE_NUM_NODES(config->max_num_samples_per_block, config->min_num_samples_per_block) * sizeof(uint32_t);
-
-    /* バッファオーバーランチェック */
+    work_ptr += SRLAENCODER_CALCULATE_NUM_NODES(
+        SRLAUTILITY_MAX(config->max_num_lookahead_samples, config->max_num_samples_per_block),
+        config->min_num_samples_per_block) * sizeof(uint32_t);
+
+    /* 並列処理用領域 */
+    if (config->max_num_threads > 1) {
+        uint32_t t;
+        int32_t worker_size;
+        struct SRLAEncoderConfig worker_config = (*config);
+        worker_config.max_num_threads = 1;
+        worker_size = SRLAEncoder_CalculateWorkSize(&worker_config);
+
+        /* ハンドルへのポインタ */
+        work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+        encoder->workers = (struct SRLAEncoder **)work_ptr;
+        work_ptr += sizeof(struct SRLAEncoder *) * config->max_num_threads;
+
+        /* タスク */
+        work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+        encoder->tasks = (struct SRLAEncoderParallelTask *)work_ptr;
+        work_ptr += sizeof(struct SRLAEncoderParallelTask) * config->max_num_threads;
+        work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+        encoder->search_tasks = (struct SRLAEncoderPartitionSearchTask *)work_ptr;
+        work_ptr += sizeof(struct SRLAEncoderPartitionSearchTask) * config->max_num_threads;
+
+        /* 出力バッファ */
+        encoder->worker_buffer_size = (uint32_t)SRLAEncoder_CalculateWorkerBufferSize(
+            config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block);
+        SRLA_ALLOCATE_2DIMARRAY(encoder->worker_buffer,
+            work_ptr, uint8_t, config->max_num_threads, encoder->worker_buffer_size);
+
+        /* ワーカーのエンコーダハンドル作成 先頭は自分自身 */
+        encoder->workers[0] = encoder;
+        for (t = 1; t < config->max_num_threads; t++) {
+            if ((encoder->workers[t] = SRLAEncoder_Create(&worker_config, work_ptr, worker_size)) == NULL) {
+                return NULL;
+            }
+            work_ptr += worker_size;
+        }
+    }
+
+    /* バッファオーバーランチェック */
     /* 補足）既にメモリを破壊している可能性があるので、チェックに失敗したら落とす */
     SRLA_ASSERT((work_ptr - (uint8_t *)work) <= work_size);
 
@@ -690,6 +1312,9 @@ struct SRLAEncoder* SRLAEncoder_Create(const struct SRLAEncoderConfig *config, v
     StaticHuffman_ConvertTreeToCodes(SRLA_GetParameterHuffmanTree(), &encoder->param_codes);
     StaticHuffman_ConvertTreeToCodes(SRLA_GetSumParameterHuffmanTree(), &encoder->sum_param_codes);
 
+    /* 実行環境で使える命令セットの予測関数を選択 */
+    encoder->predict = SRLAPredict_GetFunctions(SRLASIMD_GetInstructionSet());
+
     return encoder;
 }
 
@@ -697,8 +1322,15 @@ struct SRLAEncoder* SRLAEncoder_Create(const struct SRLAEncoderConfig *config, v
 void SRLAEncoder_Destroy(struct SRLAEncoder *encoder)
 {
     if (encoder != NULL) {
+        if (encoder->workers != NULL) {
+            uint32_t t;
+            for (t = 1; t < encoder->max_num_threads; t++) {
+                SRLAEncoder_Destroy(encoder->workers[t]);
+            }
+        }
         SRLACoder_Destroy(encoder->coder);
         SRLAOptimalBlockPartitionCalculator_Destroy(encoder->obpc);
+        SRLAAutoCorrelationCache_Destroy(encoder->accache);
         LPCCalculator_Destroy(encoder->lpcc);
         if (encoder->alloced_by_own == 1) {
             free(encoder->work);
@@ -748,6 +1380,12 @@ SRLAApiResult SRLAEncoder_SetEncodeParameter(
     encoder->ltp_order = parameter->ltp_order;
     /* SVR学習繰り返し回数設定 */
     encoder->num_svr_filter_learning_iteration = parameter->num_svr_filter_learning_iteration;
+    /* ブロック分割探索の符号長推定有無 */
+    encoder->estimate_partition_cost = (parameter->estimate_partition_cost != 0) ? 1 : 0;
+    /* 先読み区間のスライド有無 */
+    encoder->sliding_lookahead = (parameter->sliding_lookahead != 0) ? 1 : 0;
+    /* シークテーブルのシーク点間隔 */
+    encoder->seek_table_interval = parameter->seek_table_interval;
 
     /* ヘッダ設定 */
     encoder->header = tmp_header;
@@ -847,6 +1485,14 @@ static SRLAApiResult SRLAEncoder_EncodeRawData(
                     }
                 }
                 break;
+            case 32:
+                for (smpl = 0; smpl < num_samples; smpl++) {
+                    for (ch = 0; ch < header->num_channels; ch++) {
+                        ByteArray_PutUint32BE(data_ptr, SRLAUTILITY_SINT32_TO_UINT32(input[ch][smpl]));
+                        SRLA_ASSERT((uint32_t)(data_ptr - data) <= data_size);
+                    }
+                }
+                break;
             default:
                 SRLA_ASSERT(0);
     }
@@ -857,6 +1503,58 @@ static SRLAApiResult SRLAEncoder_EncodeRawData(
     return SRLA_APIRESULT_OK;
 }
 
+/* インターリーブ入力から生データブロックエンコード */
+static SRLAApiResult SRLAEncoder_EncodeInterleavedRawData(
+        struct SRLAEncoder *encoder,
+        const void *input, SRLAPcmFormat format, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    uint32_t i, num_values;
+    const struct SRLAHeader *header;
+    uint8_t *data_ptr;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(input != NULL);
+    SRLA_ASSERT(num_samples > 0);
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(data_size > 0);
+    SRLA_ASSERT(output_size != NULL);
+
+    header = &(encoder->header);
+
+    /* 書き込み先のバッファサイズチェック */
+    if (data_size < (header->bits_per_sample * num_samples * header->num_channels) / 8) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* 入力は既にチャンネルインターリーブされているので、先頭から順に出力 */
+    num_values = num_samples * header->num_channels;
+    data_ptr = data;
+    for (i = 0; i < num_values; i++) {
+        int32_t val;
+        switch (format) {
+        case SRLA_PCM_FORMAT_INT16: val = ((const int16_t *)input)[i]; break;
+        case SRLA_PCM_FORMAT_INT24: val = SRLAUTILITY_GET_INT24LE(&((const uint8_t *)input)[3 * i]); break;
+        case SRLA_PCM_FORMAT_INT32: val = ((const int32_t *)input)[i]; break;
+        default: SRLA_ASSERT(0); val = 0;
+        }
+        switch (header->bits_per_sample) {
+        case 8:  ByteArray_PutUint8(data_ptr, SRLAUTILITY_SINT32_TO_UINT32(val)); break;
+        case 16: ByteArray_PutUint16BE(data_ptr, SRLAUTILITY_SINT32_TO_UINT32(val)); break;
+        case 24: ByteArray_PutUint24BE(data_ptr, SRLAUTILITY_SINT32_TO_UINT32(val)); break;
+        case 32: ByteArray_PutUint32BE(data_ptr, SRLAUTILITY_SINT32_TO_UINT32(val)); break;
+        default: SRLA_ASSERT(0);
+        }
+        SRLA_ASSERT((uint32_t)(data_ptr - data) <= data_size);
+    }
+
+    /* 書き込みサイズ取得 */
+    (*output_size) = (uint32_t)(data_ptr - data);
+
+    return SRLA_APIRESULT_OK;
+}
+
 /* Recursive Golomb-Rice符号の平均符号長 */
 static double SRLAEncoder_CalculateRGRMeanCodeLength(double mean_abs_error, uint32_t bps)
 {
@@ -1046,7 +1744,7 @@ static SRLAError SRLAEncoder_ComputeCoefficientsPerChannel(
                 tmp_ltp_coef_int[encoder->ltp_order - p - 1] = tmp;
             }
             /* LTPによる予測 残差を差し替え */
-            SRLALTP_Predict(
+            encoder->predict->ltp_predict(
                 buffer_int, num_samples, tmp_ltp_coef_int, encoder->ltp_order,
                 tmp_ltp_period, residual_int, SRLA_LTP_COEFFICIENT_BITWIDTH - 1);
             memcpy(buffer_int, residual_int, sizeof(int32_t) * num_samples);
@@ -1108,7 +1806,7 @@ static SRLAError SRLAEncoder_ComputeCoefficientsPerChannel(
             }
 
             /* LPC予測 */
-            SRLALPC_Predict(buffer_int,
+            encoder->predict->lpc_predict(buffer_int,
                 num_samples, tmp_lpc_coef_int, tmp_lpc_lpc_coef_order, residual_int, tmp_lpc_coef_rshift);
         } else {
             /* 次数が0の時は計算をスキップし、入力を単純コピー */
@@ -1205,22 +1903,17 @@ static SRLAError SRLAEncoder_ComputeCoefficientsPerChannel(
 }
 
 /* 圧縮データブロックの係数計算 */
-static SRLAApiResult SRLAEncoder_ComputeCoefficients(
-    struct SRLAEncoder *encoder, const int32_t *const *input, uint32_t num_samples,
-    SRLAChannelProcessMethod *ch_process_method, uint32_t *output_bits)
+/* 入力を信号バッファに読み込み */
+static void SRLAEncoder_LoadInput(
+    struct SRLAEncoder *encoder, const int32_t *const *input, uint32_t num_samples)
 {
-    uint32_t ch, tmp_output_bits = 0;
+    uint32_t ch;
     const struct SRLAHeader *header;
-    SRLAChannelProcessMethod tmp_ch_process_method = SRLA_CH_PROCESS_METHOD_INVALID;
-    uint32_t code_length[SRLA_MAX_NUM_CHANNELS] = { 0, };
-    uint32_t ms_code_length[2] = { 0, };
 
     /* 内部関数なので不正な引数はアサートで落とす */
     SRLA_ASSERT(encoder != NULL);
     SRLA_ASSERT(input != NULL);
-    SRLA_ASSERT(num_samples > 0);
-    SRLA_ASSERT(ch_process_method != NULL);
-    SRLA_ASSERT(output_bits != NULL);
+    SRLA_ASSERT(num_samples <= encoder->max_num_samples_per_block);
 
     /* ヘッダ取得 */
     header = &(encoder->header);
@@ -1244,6 +1937,99 @@ static SRLAApiResult SRLAEncoder_ComputeCoefficients(
             }
         }
     }
+}
+
+/* インターリーブ入力をチャンネル毎に分けて信号バッファに読み込み
+ * オフセットされたbit分の除去も同時に行う 入力が全て0のときは1を返す */
+static uint8_t SRLAEncoder_LoadInterleavedInput(
+    struct SRLAEncoder *encoder, const void *input, SRLAPcmFormat format, uint32_t num_samples)
+{
+    uint32_t ch, smpl;
+    uint32_t nonzero = 0;
+    const struct SRLAHeader *header;
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(input != NULL);
+    SRLA_ASSERT(num_samples <= encoder->max_num_samples_per_block);
+
+    /* ヘッダ取得 */
+    header = &(encoder->header);
+
+    switch (format) {
+    case SRLA_PCM_FORMAT_INT16:
+    {
+        const int16_t *in = (const int16_t *)input;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            for (ch = 0; ch < header->num_channels; ch++) {
+                const int32_t val = in[ch];
+                nonzero |= (uint32_t)val;
+                encoder->buffer_int[ch][smpl] = val >> header->offset_lshift;
+            }
+            in += header->num_channels;
+        }
+    }
+        break;
+    case SRLA_PCM_FORMAT_INT24:
+    {
+        const uint8_t *in = (const uint8_t *)input;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            for (ch = 0; ch < header->num_channels; ch++) {
+                const int32_t val = SRLAUTILITY_GET_INT24LE(&in[3 * ch]);
+                nonzero |= (uint32_t)val;
+                encoder->buffer_int[ch][smpl] = val >> header->offset_lshift;
+            }
+            in += 3 * header->num_channels;
+        }
+    }
+        break;
+    case SRLA_PCM_FORMAT_INT32:
+    {
+        const int32_t *in = (const int32_t *)input;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            for (ch = 0; ch < header->num_channels; ch++) {
+                const int32_t val = in[ch];
+                nonzero |= (uint32_t)val;
+                encoder->buffer_int[ch][smpl] = val >> header->offset_lshift;
+            }
+            in += header->num_channels;
+        }
+    }
+        break;
+    default:
+        SRLA_ASSERT(0);
+    }
+
+    /* バッファサイズより小さい入力のときは、末尾を0埋め */
+    if (num_samples < encoder->max_num_samples_per_block) {
+        const uint32_t remain = encoder->max_num_samples_per_block - num_samples;
+        for (ch = 0; ch < header->num_channels; ch++) {
+            memset(&encoder->buffer_int[ch][num_samples], 0, sizeof(int32_t) * remain);
+        }
+    }
+
+    return (nonzero == 0) ? 1 : 0;
+}
+
+/* 信号バッファの入力から係数と符号長を計算 */
+static SRLAApiResult SRLAEncoder_ComputeCoefficients(
+    struct SRLAEncoder *encoder, uint32_t num_samples,
+    SRLAChannelProcessMethod *ch_process_method, uint32_t *output_bits)
+{
+    uint32_t ch, tmp_output_bits = 0;
+    const struct SRLAHeader *header;
+    SRLAChannelProcessMethod tmp_ch_process_method = SRLA_CH_PROCESS_METHOD_INVALID;
+    uint32_t code_length[SRLA_MAX_NUM_CHANNELS] = { 0, };
+    uint32_t ms_code_length[2] = { 0, };
+
+    /* 内部関数なので不正な引数はアサートで落とす */
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(num_samples > 0);
+    SRLA_ASSERT(ch_process_method != NULL);
+    SRLA_ASSERT(output_bits != NULL);
+
+    /* ヘッダ取得 */
+    header = &(encoder->header);
 
     /* MS信号生成・符号長計算 */
     if (header->num_channels >= 2) {
@@ -1335,8 +2121,7 @@ static SRLAApiResult SRLAEncoder_ComputeCoefficients(
 
 /* 圧縮データブロックエンコード */
 static SRLAApiResult SRLAEncoder_EncodeCompressData(
-        struct SRLAEncoder *encoder,
-        const int32_t *const *input, uint32_t num_samples,
+        struct SRLAEncoder *encoder, uint32_t num_samples,
         uint8_t *data, uint32_t data_size, uint32_t *output_size)
 {
     uint32_t ch, tmp_code_length;
@@ -1347,7 +2132,6 @@ static SRLAApiResult SRLAEncoder_EncodeCompressData(
 
     /* 内部関数なので不正な引数はアサートで落とす */
     SRLA_ASSERT(encoder != NULL);
-    SRLA_ASSERT(input != NULL);
     SRLA_ASSERT(num_samples > 0);
     SRLA_ASSERT(data != NULL);
     SRLA_ASSERT(data_size > 0);
@@ -1359,9 +2143,9 @@ static SRLAApiResult SRLAEncoder_EncodeCompressData(
     /* 計算済み係数取得 */
     pcoef = encoder->coefficient;
 
-    /* 係数計算 */
+    /* 係数計算（入力は信号バッファに読み込み済み） */
     if (SRLAEncoder_ComputeCoefficients(encoder,
-        input, num_samples, &ch_process_method, &tmp_code_length) != SRLA_APIRESULT_OK) {
+        num_samples, &ch_process_method, &tmp_code_length) != SRLA_APIRESULT_OK) {
         return SRLA_APIRESULT_NG;
     }
 
@@ -1379,9 +2163,15 @@ static SRLAApiResult SRLAEncoder_EncodeCompressData(
         uint32_t p, uval;
         const struct SRLAPreemphasisFilter *preem = pcoef[ch].pre_emphasis;
         /* プリエンファシスフィルタのバッファ */
+        /* 補足）ビット幅はbits_per_sample + 1 32bitを越える分は上位に0を書き込む */
         uval = SRLAUTILITY_SINT32_TO_UINT32(preem[0].prev);
-        SRLA_ASSERT(uval < (1U << (header->bits_per_sample + 1)));
-        BitWriter_PutBits(&writer, uval, header->bits_per_sample + 1);
+        if (header->bits_per_sample >= 32) {
+            BitWriter_PutBits(&writer, 0, header->bits_per_sample + 1 - 32);
+            BitWriter_PutBits(&writer, uval, 32);
+        } else {
+            SRLA_ASSERT(uval < (1U << (header->bits_per_sample + 1)));
+            BitWriter_PutBits(&writer, uval, header->bits_per_sample + 1);
+        }
         for (p = 0; p < SRLA_NUM_PREEMPHASIS_FILTERS; p++) {
             uval = SRLAUTILITY_SINT32_TO_UINT32(preem[p].coef);
             SRLA_ASSERT(uval < (1U << (SRLA_PREEMPHASIS_COEF_SHIFT + 1)));
@@ -1456,13 +2246,11 @@ static SRLAApiResult SRLAEncoder_EncodeCompressData(
 
 /* 無音データブロックエンコード */
 static SRLAApiResult SRLAEncoder_EncodeSilentData(
-        struct SRLAEncoder *encoder,
-        const int32_t *const *input, uint32_t num_samples,
+        struct SRLAEncoder *encoder, uint32_t num_samples,
         uint8_t *data, uint32_t data_size, uint32_t *output_size)
 {
     /* 内部関数なので不正な引数はアサートで落とす */
     SRLA_ASSERT(encoder != NULL);
-    SRLA_ASSERT(input != NULL);
     SRLA_ASSERT(num_samples > 0);
     SRLA_ASSERT(data != NULL);
     SRLA_ASSERT(data_size > 0);
@@ -1473,6 +2261,166 @@ static SRLAApiResult SRLAEncoder_EncodeSilentData(
     return SRLA_APIRESULT_OK;
 }
 
+/* 1信号の推定符号長計算
+ * LTP・SVRによる係数修正・残差符号化を省略し、Levinson-Durbin法の誤差分散から符号長を見積もる
+ * プリエンファシスはエンコーダと同じく1段のみとし、自己相関の上で適用する（使えるラグが1つ減る） */
+static SRLAError SRLAEncoder_EstimateCodeLengthFromAutoCorrelation(
+    struct SRLAEncoder *encoder,
+    const double *auto_corr, uint32_t order, int32_t preemphasis_coef, uint32_t num_samples, double *code_length)
+{
+    uint32_t p, lag;
+    double len, mabse, minlen;
+    const struct SRLAHeader *header;
+    const struct SRLAParameterPreset *parameter_preset;
+    double filtered_corr[SRLA_MAX_COEFFICIENT_ORDER + 1];
+
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(auto_corr != NULL);
+    SRLA_ASSERT(num_samples > 0);
+    SRLA_ASSERT(code_length != NULL);
+
+    header = &(encoder->header);
+    parameter_preset = encoder->parameter_preset;
+
+    /* プリエンファシス y[n] = x[n] - a x[n-1] 後の自己相関を計算
+     * Ry(k) = (1 + a^2) Rx(k) - a (Rx(k - 1) + Rx(k + 1)) */
+    for (lag = 0; lag <= order; lag++) {
+        filtered_corr[lag] = auto_corr[lag];
+    }
+    if ((preemphasis_coef != 0) && (order > 0)) {
+        const double coef = preemphasis_coef * pow(2.0, -SRLA_PREEMPHASIS_COEF_SHIFT);
+        double prev = filtered_corr[1];
+        order--;
+        for (lag = 0; lag <= order; lag++) {
+            const double curr = filtered_corr[lag];
+            filtered_corr[lag] = (1.0 + coef * coef) * curr - coef * (prev + filtered_corr[lag + 1]);
+            prev = curr;
+        }
+    }
+
+    /* 各次数の誤差分散を計算 */
+    if (LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(encoder->lpcc,
+        filtered_corr, order, encoder->error_vars, SRLA_LPC_RIDGE_REGULARIZATION_PARAMETER) != LPC_APIRESULT_OK) {
+        return SRLA_ERROR_NG;
+    }
+
+    /* 最小推定符号長を与える次数の探索 */
+    minlen = FLT_MAX;
+    for (p = 0; p <= parameter_preset->max_num_parameters; p++) {
+        const double var = encoder->error_vars[SRLAUTILITY_MIN(p, order)] / num_samples;
+        /* Laplace分布の仮定で残差分散から平均絶対値を推定 */
+        mabse = 2.0 * sqrt(SRLAUTILITY_MAX(var, 0.0) / 2.0); /* 符号化で非負整数化するため2倍 */
+        /* 残差符号のサイズ */
+        len = SRLAEncoder_CalculateGeometricDistributionEntropy(mabse, header->bits_per_sample) * num_samples;
+        /* 係数のサイズ */
+        len += SRLA_LPC_COEFFICIENT_BITWIDTH * p;
+        if (minlen > len) {
+            minlen = len;
+        }
+    }
+
+    /* プリエンファシスフィルタのバッファ/係数 */
+    minlen += header->bits_per_sample + 1;
+    minlen += SRLA_NUM_PREEMPHASIS_FILTERS * (SRLA_PREEMPHASIS_COEF_SHIFT + 1);
+    /* LPC係数次数/LPC係数右シフト量/和をとったかのフラグ/LTP有効フラグ */
+    minlen += SRLA_LPC_COEFFICIENT_ORDER_BITWIDTH + SRLA_RSHIFT_LPC_COEFFICIENT_BITWIDTH + 1 + 1;
+
+    (*code_length) = minlen;
+
+    return SRLA_ERROR_OK;
+}
+
+/* 単一データブロックサイズの推定
+ * start_segmentからend_segmentの直前までのセグメントを結合したブロックのサイズを、自己相関キャッシュから推定する */
+static SRLAError SRLAEncoder_EstimateBlockSize(
+    struct SRLAEncoder *encoder, const struct SRLAAutoCorrelationCache *cache,
+    uint32_t start_segment, uint32_t end_segment, uint32_t num_samples, double *estimated_size)
+{
+    uint32_t ch, sig;
+    const struct SRLAHeader *header;
+    SRLAError err;
+    double tmp_bits, raw_bits, scale;
+    double auto_corr[SRLA_MAX_COEFFICIENT_ORDER + 1];
+    double code_length[SRLA_MAX_NUM_CHANNELS + 2] = { 0.0, };
+
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(cache != NULL);
+    SRLA_ASSERT(estimated_size != NULL);
+    SRLA_ASSERT(encoder->set_parameter == 1);
+    SRLA_ASSERT(start_segment < end_segment);
+    SRLA_ASSERT(end_segment <= cache->num_segments);
+
+    header = &(encoder->header);
+
+    /* エンコードサンプル数チェック */
+    if ((num_samples == 0) || (num_samples > header->max_num_samples_per_block)) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* 生データのサイズ */
+    raw_bits = (double)header->bits_per_sample * num_samples * header->num_channels;
+
+    /* LPCの次数以下の場合は生データとする（窓の正規化のため2サンプル以下も除く） */
+    if ((num_samples <= encoder->parameter_preset->max_num_parameters) || (num_samples <= 2)) {
+        (*estimated_size) = 11 + raw_bits / 8;
+        return SRLA_ERROR_OK;
+    }
+
+    /* 各信号の符号長推定 */
+    tmp_bits = 0.0;
+    scale = pow(2.0, 2 * (int32_t)(header->bits_per_sample - 1));
+    for (sig = 0; sig < cache->num_signals; sig++) {
+        int32_t preemphasis_coef = 0;
+        const double energy = SRLAAutoCorrelationCache_GetEnergy(cache, sig, start_segment, end_segment);
+        if (sig < header->num_channels) {
+            tmp_bits += energy;
+        }
+        /* プリエンファシス係数はエンコーダと同じく窓なしの信号から求める
+         * 補足）キャッシュは[-1,1]に正規化した信号の相関なので、整数信号のスケールに戻して閾値を揃える */
+        if (cache->order > 0) {
+            preemphasis_coef = SRLAPreemphasisFilter_CalculateCoefficientFromAutoCorrelation(energy * scale,
+                SRLAAutoCorrelationCache_GetRawAutoCorrelation(cache, sig, start_segment, end_segment, 1) * scale);
+        }
+        SRLAAutoCorrelationCache_GetAutoCorrelation(cache, sig,
+            start_segment, end_segment, num_samples, auto_corr);
+        if ((err = SRLAEncoder_EstimateCodeLengthFromAutoCorrelation(encoder,
+            auto_corr, cache->order, preemphasis_coef, num_samples, &code_length[sig])) != SRLA_ERROR_OK) {
+            return err;
+        }
+    }
+
+    /* 全チャンネルのパワーが0ならば無音 */
+    if (tmp_bits == 0.0) {
+        (*estimated_size) = 11;
+        return SRLA_ERROR_OK;
+    }
+
+    /* LR, MS, LS, SRの中で最も符号長が短いものを選択 */
+    tmp_bits = code_length[0];
+    if (header->num_channels >= 2) {
+        const double *ms_code_length = &code_length[header->num_channels];
+        double min = code_length[0] + code_length[1];
+        min = SRLAUTILITY_MIN(min, ms_code_length[0] + ms_code_length[1]);
+        min = SRLAUTILITY_MIN(min, code_length[0] + ms_code_length[1]);
+        min = SRLAUTILITY_MIN(min, code_length[1] + ms_code_length[1]);
+        tmp_bits = min;
+        for (ch = 2; ch < header->num_channels; ch++) {
+            tmp_bits += code_length[ch];
+        }
+    }
+
+    /* マルチチャンネル処理法のサイズを加える */
+    tmp_bits += 2;
+
+    /* 生データより大きくなる場合は生データとする */
+    tmp_bits = SRLAUTILITY_MIN(tmp_bits, raw_bits);
+
+    /* ブロックヘッダサイズを含めてバイト単位に変換 */
+    (*estimated_size) = 11 + tmp_bits / 8;
+
+    return SRLA_ERROR_OK;
+}
+
 /* 単一データブロックサイズ計算 */
 SRLAApiResult SRLAEncoder_ComputeBlockSize(
     struct SRLAEncoder *encoder, const int32_t *const *input, uint32_t num_samples,
@@ -1518,8 +2466,9 @@ COMPUTE_BLOCK_SIZE_START:
         uint32_t compress_data_size;
         SRLAChannelProcessMethod dummy;
         /* 符号長計算 */
+        SRLAEncoder_LoadInput(encoder, input, num_samples);
         if ((ret = SRLAEncoder_ComputeCoefficients(
-            encoder, input, num_samples, &dummy, &compress_data_size)) != SRLA_APIRESULT_OK) {
+            encoder, num_samples, &dummy, &compress_data_size)) != SRLA_APIRESULT_OK) {
             return ret;
         }
         SRLA_ASSERT(compress_data_size % 8 == 0);
@@ -1545,11 +2494,12 @@ COMPUTE_BLOCK_SIZE_START:
     return SRLA_APIRESULT_OK;
 }
 
-/* 単一データブロックエンコード */
-SRLAApiResult SRLAEncoder_EncodeBlock(
+/* 単一データブロックエンコード
+ * inputがNULLのときはformat形式のインターリーブ入力interleaved_inputをエンコードする */
+static SRLAApiResult SRLAEncoder_EncodeBlockCore(
         struct SRLAEncoder *encoder,
-        const int32_t *const *input, uint32_t num_samples,
-        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+        const int32_t *const *input, const void *interleaved_input, SRLAPcmFormat format,
+        uint32_t num_samples, uint8_t *data, uint32_t data_size, uint32_t *output_size)
 {
     uint8_t *data_ptr;
     const struct SRLAHeader *header;
@@ -1557,11 +2507,12 @@ SRLAApiResult SRLAEncoder_EncodeBlock(
     SRLAApiResult ret;
     uint32_t block_header_size, block_data_size;
 
-    /* 引数チェック */
-    if ((encoder == NULL) || (input == NULL) || (num_samples == 0)
-            || (data == NULL) || (data_size == 0) || (output_size == NULL)) {
-        return SRLA_APIRESULT_INVALID_ARGUMENT;
-    }
+    /* 内部関数なので不正な引数はアサートで落とす */
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT((input != NULL) || (interleaved_input != NULL));
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(output_size != NULL);
+
     header = &(encoder->header);
 
     /* パラメータがセットされてない */
@@ -1575,7 +2526,16 @@ SRLAApiResult SRLAEncoder_EncodeBlock(
     }
 
     /* 圧縮手法の判定 */
-    block_type = SRLAEncoder_DecideBlockDataType(encoder, input, num_samples);
+    if (input != NULL) {
+        block_type = SRLAEncoder_DecideBlockDataType(encoder, input, num_samples);
+    } else if (num_samples <= encoder->parameter_preset->max_num_parameters) {
+        /* LPCの次数以下の場合は生データとする */
+        block_type = SRLA_BLOCK_DATA_TYPE_RAWDATA;
+    } else {
+        /* 信号バッファへの読み込みと同時に無音判定 */
+        block_type = SRLAEncoder_LoadInterleavedInput(encoder, interleaved_input, format, num_samples)
+            ? SRLA_BLOCK_DATA_TYPE_SILENT : SRLA_BLOCK_DATA_TYPE_COMPRESSDATA;
+    }
     SRLA_ASSERT(block_type != SRLA_BLOCK_DATA_TYPE_INVALID);
 
 ENCODING_BLOCK_START:
@@ -1598,11 +2558,20 @@ ENCODING_BLOCK_START:
     /* 手法によりエンコードする関数を呼び分け */
     switch (block_type) {
     case SRLA_BLOCK_DATA_TYPE_RAWDATA:
-        ret = SRLAEncoder_EncodeRawData(encoder, input, num_samples,
-                data_ptr, data_size - block_header_size, &block_data_size);
+        if (input != NULL) {
+            ret = SRLAEncoder_EncodeRawData(encoder, input, num_samples,
+                    data_ptr, data_size - block_header_size, &block_data_size);
+        } else {
+            ret = SRLAEncoder_EncodeInterleavedRawData(encoder, interleaved_input, format, num_samples,
+                    data_ptr, data_size - block_header_size, &block_data_size);
+        }
         break;
     case SRLA_BLOCK_DATA_TYPE_COMPRESSDATA:
-        ret = SRLAEncoder_EncodeCompressData(encoder, input, num_samples,
+        /* インターリーブ入力はブロック種別の判定時に読み込み済み */
+        if (input != NULL) {
+            SRLAEncoder_LoadInput(encoder, input, num_samples);
+        }
+        ret = SRLAEncoder_EncodeCompressData(encoder, num_samples,
                 data_ptr, data_size - block_header_size, &block_data_size);
         /* エンコードの結果データが増加したら生データブロックに切り替え */
         if ((8 * block_data_size) >= (header->bits_per_sample * num_samples * header->num_channels)) {
@@ -1611,7 +2580,7 @@ ENCODING_BLOCK_START:
         }
         break;
     case SRLA_BLOCK_DATA_TYPE_SILENT:
-        ret = SRLAEncoder_EncodeSilentData(encoder, input, num_samples,
+        ret = SRLAEncoder_EncodeSilentData(encoder, num_samples,
                 data_ptr, data_size - block_header_size, &block_data_size);
         break;
     default:
@@ -1642,6 +2611,42 @@ ENCODING_BLOCK_START:
     return SRLA_APIRESULT_OK;
 }
 
+/* 単一データブロックエンコード */
+SRLAApiResult SRLAEncoder_EncodeBlock(
+        struct SRLAEncoder *encoder,
+        const int32_t *const *input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL) || (num_samples == 0)
+            || (data == NULL) || (data_size == 0) || (output_size == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    return SRLAEncoder_EncodeBlockCore(encoder,
+            input, NULL, SRLA_PCM_FORMAT_INT32, num_samples, data, data_size, output_size);
+}
+
+/* インターリーブ入力の単一データブロックエンコード */
+SRLAApiResult SRLAEncoder_EncodeBlockInterleaved(
+        struct SRLAEncoder *encoder,
+        const void *input, SRLAPcmFormat format, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size)
+{
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL) || (num_samples == 0)
+            || (data == NULL) || (data_size == 0) || (output_size == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+    if ((format != SRLA_PCM_FORMAT_INT16)
+            && (format != SRLA_PCM_FORMAT_INT24) && (format != SRLA_PCM_FORMAT_INT32)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    return SRLAEncoder_EncodeBlockCore(encoder,
+            NULL, input, format, num_samples, data, data_size, output_size);
+}
+
 /* 最適なブロック分割探索を含めたエンコード */
 SRLAApiResult SRLAEncoder_EncodeOptimalPartitionedBlock(
     struct SRLAEncoder *encoder,
@@ -1666,7 +2671,7 @@ SRLAApiResult SRLAEncoder_EncodeOptimalPartitionedBlock(
     /* 最適なブロック分割の探索 */
     if (SRLAEncoder_SearchOptimalBlockPartitions(
         encoder, input, num_samples,
-        encoder->min_num_samples_per_block, encoder->max_num_samples_per_block,
+        encoder->min_num_samples_per_block, encoder->header.max_num_samples_per_block, 0,
         &num_partitions, encoder->partitions_buffer) != SRLA_ERROR_OK) {
         return SRLA_APIRESULT_NG;
     }
@@ -1697,46 +2702,343 @@ SRLAApiResult SRLAEncoder_EncodeOptimalPartitionedBlock(
     return SRLA_APIRESULT_OK;
 }
 
-/* ヘッダ含めファイル全体をエンコード */
-SRLAApiResult SRLAEncoder_EncodeWhole(
-    struct SRLAEncoder *encoder,
+/* 最適なブロック分割探索を含めたエンコード（ブロック分割探索のコスト計算を複数スレッドで行う） */
+SRLAApiResult SRLAEncoder_EncodeOptimalPartitionedBlockParallel(
+    struct SRLAEncoder *encoder, uint32_t num_threads,
     const int32_t *const *input, uint32_t num_samples,
-    uint8_t *data, uint32_t data_size, uint32_t *output_size,
-    SRLAEncoder_EncodeBlockCallback encode_callback)
+    uint8_t *data, uint32_t data_size, uint32_t *output_size)
 {
     SRLAApiResult ret;
-    uint32_t progress, ch, write_size, write_offset, num_encode_samples, num_process_samples;
-    uint8_t *data_pos;
-    const int32_t *input_ptr[SRLA_MAX_NUM_CHANNELS];
-    const struct SRLAHeader *header;
-    SRLAApiResult (*encode_function)(
-        struct SRLAEncoder *encoder,
-        const int32_t* const* input, uint32_t num_samples,
-        uint8_t *data, uint32_t data_size, uint32_t *output_size) = NULL;
 
     /* 引数チェック */
-    if ((encoder == NULL) || (input == NULL)
-            || (data == NULL) || (output_size == NULL)) {
+    if ((encoder == NULL) || (input == NULL) || (num_threads == 0)
+        || (data == NULL) || (output_size == NULL)) {
         return SRLA_APIRESULT_INVALID_ARGUMENT;
     }
 
-    /* パラメータがセットされてない */
-    if (encoder->set_parameter != 1) {
-        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    /* スレッド数がハンドルの容量を越えている */
+    if (num_threads > encoder->max_num_threads) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
     }
 
-    /* 書き出し位置を取得 */
-    data_pos = data;
+    encoder->num_search_threads = num_threads;
+    ret = SRLAEncoder_EncodeOptimalPartitionedBlock(encoder,
+        input, num_samples, data, data_size, output_size);
+    encoder->num_search_threads = 1;
 
-    /* ヘッダエンコード */
-    encoder->header.offset_lshift = SRLAUtility_ComputeOffsetLeftShift(input, encoder->header.num_channels, num_samples);
+    return ret;
+}
+
+/* スライドする先読み区間1つ分の最適なブロック分割を探索し、先頭部分をエンコード
+ * 区間の最適分割のうち、区間末尾の最大ブロックサイズ分にかからない先頭部分だけを確定させ、
+ * 残りの重複区間の辺のコストは次の区間の探索で再利用する（num_reuse_nodesを更新）
+ * 最後の区間（is_last_window != 0）は全て確定させる */
+static SRLAApiResult SRLAEncoder_EncodeSlidingWindow(
+    struct SRLAEncoder *encoder,
+    const int32_t *const *input, uint32_t num_window_samples, uint8_t is_last_window,
+    uint32_t *num_reuse_nodes, uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    uint32_t *num_encoded_samples)
+{
+    SRLAApiResult ret;
+    uint32_t ch, part, write_offset;
+    uint32_t num_partitions, num_commit_partitions, num_commit_samples;
+    const int32_t *input_ptr[SRLA_MAX_NUM_CHANNELS];
+    const uint32_t min_num_block_samples = encoder->min_num_samples_per_block;
+    const uint32_t max_num_block_samples = encoder->header.max_num_samples_per_block;
+
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(input != NULL);
+    SRLA_ASSERT(num_reuse_nodes != NULL);
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(output_size != NULL);
+    SRLA_ASSERT(num_encoded_samples != NULL);
+    SRLA_ASSERT(encoder->num_lookahead_samples >= max_num_block_samples);
+    SRLA_ASSERT((encoder->num_lookahead_samples % min_num_block_samples) == 0);
+    SRLA_ASSERT(num_window_samples <= encoder->num_lookahead_samples);
+    SRLA_ASSERT(is_last_window || (num_window_samples == encoder->num_lookahead_samples));
+
+    /* 区間内の最適なブロック分割の探索 */
+    if (SRLAEncoder_SearchOptimalBlockPartitions(encoder,
+        input, num_window_samples, min_num_block_samples, max_num_block_samples, (*num_reuse_nodes),
+        &num_partitions, encoder->partitions_buffer) != SRLA_ERROR_OK) {
+        return SRLA_APIRESULT_NG;
+    }
+    SRLA_ASSERT(num_partitions > 0);
+
+    /* 確定させる分割数の決定 */
+    num_commit_partitions = 1;
+    num_commit_samples = encoder->partitions_buffer[0];
+    while (num_commit_partitions < num_partitions) {
+        const uint32_t next_samples = num_commit_samples + encoder->partitions_buffer[num_commit_partitions];
+        if (!is_last_window && (next_samples > (num_window_samples - max_num_block_samples))) {
+            break;
+        }
+        num_commit_samples = next_samples;
+        num_commit_partitions++;
+    }
+
+    /* 確定した分割に従ってエンコード */
+    for (ch = 0; ch < encoder->header.num_channels; ch++) {
+        input_ptr[ch] = input[ch];
+    }
+    write_offset = 0;
+    for (part = 0; part < num_commit_partitions; part++) {
+        uint32_t tmp_output_size;
+        if ((ret = SRLAEncoder_EncodeBlock(encoder,
+                input_ptr, encoder->partitions_buffer[part], data + write_offset, data_size - write_offset,
+                &tmp_output_size)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+        for (ch = 0; ch < encoder->header.num_channels; ch++) {
+            input_ptr[ch] += encoder->partitions_buffer[part];
+        }
+        write_offset += tmp_output_size;
+        SRLA_ASSERT(write_offset <= data_size);
+    }
+
+    /* 重複区間の辺のコストを前に詰めて次の探索で再利用 */
+    if (!is_last_window) {
+        /* 最後の区間以外は区間長が最小ブロックサイズの倍数なので、確定位置はノード上にある */
+        const uint32_t num_nodes = SRLAENCODER_CALCULATE_NUM_NODES(num_window_samples, min_num_block_samples);
+        const uint32_t num_shift_nodes = num_commit_samples / min_num_block_samples;
+        SRLA_ASSERT((num_commit_samples % min_num_block_samples) == 0);
+        if (SRLAOptimalBlockPartitionCalculator_ShiftEdgeCosts(
+                encoder->obpc, num_nodes, num_shift_nodes) != SRLA_ERROR_OK) {
+            return SRLA_APIRESULT_NG;
+        }
+        (*num_reuse_nodes) = num_nodes - num_shift_nodes;
+    } else {
+        (*num_reuse_nodes) = 0;
+    }
+
+    /* 成功終了 */
+    (*output_size) = write_offset;
+    (*num_encoded_samples) = num_commit_samples;
+    return SRLA_APIRESULT_OK;
+}
+
+/* 先読み区間をスライドさせながら最適なブロック分割でエンコード */
+static SRLAApiResult SRLAEncoder_EncodeSlidingPartitionedBlocks(
+    struct SRLAEncoder *encoder,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    SRLAEncoder_EncodeBlockCallback encode_callback)
+{
+    SRLAApiResult ret;
+    uint32_t ch, progress, write_offset, num_reuse_nodes;
+
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(input != NULL);
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(output_size != NULL);
+
+    progress = write_offset = 0;
+    num_reuse_nodes = 0;
+    while (progress < num_samples) {
+        uint32_t write_size, num_encoded_samples;
+        const int32_t *input_ptr[SRLA_MAX_NUM_CHANNELS];
+        const uint32_t num_window_samples = SRLAUTILITY_MIN(encoder->num_lookahead_samples, num_samples - progress);
+
+        for (ch = 0; ch < encoder->header.num_channels; ch++) {
+            input_ptr[ch] = &input[ch][progress];
+        }
+        if ((ret = SRLAEncoder_EncodeSlidingWindow(encoder,
+                input_ptr, num_window_samples, (num_window_samples == (num_samples - progress)) ? 1 : 0,
+                &num_reuse_nodes, data + write_offset, data_size - write_offset,
+                &write_size, &num_encoded_samples)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+        write_offset += write_size;
+        progress += num_encoded_samples;
+        SRLA_ASSERT(progress <= num_samples);
+
+        /* コールバック関数が登録されていれば実行 */
+        if (encode_callback != NULL) {
+            encode_callback(num_samples, progress, data + write_offset - write_size, write_size);
+        }
+    }
+    SRLA_ASSERT(progress == num_samples);
+
+    /* 成功終了 */
+    (*output_size) = write_offset;
+    return SRLA_APIRESULT_OK;
+}
+
+/* エンコード済みデータのブロックヘッダを辿ってシーク点を数える
+ * seek_points がNULLでなければシーク点（ブロック位置、ブロック先頭サンプル位置）を書き出す */
+static SRLAApiResult SRLAEncoder_ScanSeekPoints(
+    const uint8_t *data, uint32_t encoded_data_size, uint32_t seek_table_interval,
+    uint8_t *seek_points, uint32_t *num_points)
+{
+    uint32_t offset, progress, next_point_progress, tmp_num_points;
+
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(num_points != NULL);
+    SRLA_ASSERT(seek_table_interval > 0);
+
+    tmp_num_points = 0;
+    progress = next_point_progress = 0;
+    offset = SRLA_HEADER_SIZE;
+    while (offset < encoded_data_size) {
+        uint16_t sync_code, num_block_samples;
+        uint32_t block_size;
+        const uint8_t *read_pos = data + offset;
+
+        /* ブロックヘッダ読み出し（ブロックヘッダは11byte） */
+        if ((encoded_data_size - offset) < 11) {
+            return SRLA_APIRESULT_INVALID_FORMAT;
+        }
+        ByteArray_GetUint16BE(read_pos, &sync_code);
+        ByteArray_GetUint32BE(read_pos, &block_size);
+        read_pos += 3; /* チェックサムとブロックデータタイプは読み飛ばす */
+        ByteArray_GetUint16BE(read_pos, &num_block_samples);
+        if ((sync_code != SRLA_BLOCK_SYNC_CODE) || ((block_size + 6) > (encoded_data_size - offset))) {
+            return SRLA_APIRESULT_INVALID_FORMAT;
+        }
+
+        /* 直前のシーク点から間隔以上離れたブロックをシーク点とする */
+        if (progress >= next_point_progress) {
+            if (seek_points != NULL) {
+                ByteArray_PutUint32BE(seek_points, offset);
+                ByteArray_PutUint32BE(seek_points, progress);
+            }
+            tmp_num_points++;
+            next_point_progress = (progress > (0xFFFFFFFFUL - seek_table_interval))
+                ? 0xFFFFFFFFUL : (progress + seek_table_interval);
+        }
+
+        /* 次のブロックへ */
+        offset += block_size + 6;
+        progress += num_block_samples;
+    }
+
+    (*num_points) = tmp_num_points;
+    return SRLA_APIRESULT_OK;
+}
+
+/* シークテーブルの付加 */
+SRLAApiResult SRLAEncoder_AppendSeekTable(
+    uint8_t *data, uint32_t data_size, uint32_t encoded_data_size,
+    uint32_t seek_table_interval, uint32_t *output_size)
+{
+    SRLAApiResult ret;
+    uint32_t num_points, chunk_size;
+    uint8_t *data_pos;
+
+    /* 引数チェック */
+    if ((data == NULL) || (output_size == NULL)
+            || (seek_table_interval == 0) || (encoded_data_size > data_size)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* ヘッダすらない */
+    if (encoded_data_size < SRLA_HEADER_SIZE) {
+        return SRLA_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    /* シーク点数を数えてチャンクサイズを確定 */
+    if ((ret = SRLAEncoder_ScanSeekPoints(data, encoded_data_size, seek_table_interval, NULL, &num_points)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+    chunk_size = SRLA_SEEK_TABLE_CHUNK_SIZE(num_points);
+
+    /* 出力先バッファサイズ不足 */
+    if ((data_size - encoded_data_size) < chunk_size) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* シーク点数・シーク点 */
+    data_pos = data + encoded_data_size;
+    ByteArray_PutUint32BE(data_pos, num_points);
+    ret = SRLAEncoder_ScanSeekPoints(data, encoded_data_size, seek_table_interval, data_pos, &num_points);
+    SRLA_ASSERT(ret == SRLA_APIRESULT_OK);
+    data_pos += 8 * num_points;
+    /* チェックサム（シーク点数・シーク点が対象） */
+    {
+        const uint16_t checksum = SRLAUtility_CalculateFletcher16CheckSum(
+            data + encoded_data_size, (uint32_t)(data_pos - (data + encoded_data_size)));
+        ByteArray_PutUint16BE(data_pos, checksum);
+    }
+    /* チャンクサイズ・識別子 */
+    ByteArray_PutUint32BE(data_pos, chunk_size);
+    ByteArray_PutUint32BE(data_pos, SRLA_SEEK_TABLE_SIGNATURE);
+    SRLA_ASSERT((uint32_t)(data_pos - data) == (encoded_data_size + chunk_size));
+
+    /* 成功終了 */
+    (*output_size) = encoded_data_size + chunk_size;
+    return SRLA_APIRESULT_OK;
+}
+
+/* 総サンプル数と左シフト量をヘッダに設定してエンコード */
+static SRLAApiResult SRLAEncoder_SetupAndEncodeHeader(
+    struct SRLAEncoder *encoder, uint32_t num_samples, uint32_t offset_lshift,
+    uint8_t *data, uint32_t data_size)
+{
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(offset_lshift < 32);
+
+    encoder->header.offset_lshift = (uint8_t)offset_lshift;
     encoder->header.num_samples = num_samples;
-    if ((ret = SRLAEncoder_EncodeHeader(&(encoder->header), data_pos, data_size))
-            != SRLA_APIRESULT_OK) {
+
+    return SRLAEncoder_EncodeHeader(&(encoder->header), data, data_size);
+}
+
+/* ヘッダ含めファイル全体をエンコード */
+SRLAApiResult SRLAEncoder_EncodeWhole(
+    struct SRLAEncoder *encoder,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    SRLAEncoder_EncodeBlockCallback encode_callback)
+{
+    SRLAApiResult ret;
+    uint32_t progress, ch, write_size, write_offset, num_encode_samples, num_process_samples;
+    uint8_t *data_pos;
+    const int32_t *input_ptr[SRLA_MAX_NUM_CHANNELS];
+    const struct SRLAHeader *header;
+    SRLAApiResult (*encode_function)(
+        struct SRLAEncoder *encoder,
+        const int32_t* const* input, uint32_t num_samples,
+        uint8_t *data, uint32_t data_size, uint32_t *output_size) = NULL;
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL)
+            || (data == NULL) || (output_size == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* パラメータがセットされてない */
+    if (encoder->set_parameter != 1) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* 書き出し位置を取得 */
+    data_pos = data;
+
+    /* ヘッダエンコード */
+    if ((ret = SRLAEncoder_SetupAndEncodeHeader(encoder, num_samples,
+            SRLAUtility_ComputeOffsetLeftShift(input, encoder->header.num_channels, num_samples),
+            data_pos, data_size)) != SRLA_APIRESULT_OK) {
         return ret;
     }
     header = &(encoder->header);
 
+    /* 先読み区間をスライドさせる場合 */
+    if (encoder->sliding_lookahead
+        && (encoder->min_num_samples_per_block != encoder->max_num_samples_per_block)) {
+        if ((ret = SRLAEncoder_EncodeSlidingPartitionedBlocks(encoder,
+            input, num_samples, data + SRLA_HEADER_SIZE, data_size - SRLA_HEADER_SIZE, &write_size,
+            encode_callback)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+        write_offset = SRLA_HEADER_SIZE + write_size;
+        /* シークテーブルの付加 */
+        if (encoder->seek_table_interval > 0) {
+            return SRLAEncoder_AppendSeekTable(data, data_size, write_offset, encoder->seek_table_interval, output_size);
+        }
+        (*output_size) = write_offset;
+        return SRLA_APIRESULT_OK;
+    }
+
     /* エンコード関数と進捗サンプル数を決定 */
     if (encoder->min_num_samples_per_block == encoder->max_num_samples_per_block) {
         /* 最適なブロック分割を探索する必要がないため、SRLAEncoder_EncodeBlockを使用 */
@@ -1782,7 +3084,537 @@ SRLAApiResult SRLAEncoder_EncodeWhole(
         }
     }
 
+    /* シークテーブルの付加 */
+    if (encoder->seek_table_interval > 0) {
+        return SRLAEncoder_AppendSeekTable(data, data_size, write_offset, encoder->seek_table_interval, output_size);
+    }
+
     /* 成功終了 */
     (*output_size) = write_offset;
     return SRLA_APIRESULT_OK;
 }
+
+/* エンコードパラメータをワーカーハンドルに複製 */
+static void SRLAEncoder_CopyParameterToWorker(
+    struct SRLAEncoder *worker, const struct SRLAEncoder *encoder)
+{
+    SRLA_ASSERT(worker != NULL);
+    SRLA_ASSERT(encoder != NULL);
+    SRLA_ASSERT(encoder->set_parameter == 1);
+
+    worker->header = encoder->header;
+    worker->min_num_samples_per_block = encoder->min_num_samples_per_block;
+    worker->num_lookahead_samples = encoder->num_lookahead_samples;
+    worker->ltp_order = encoder->ltp_order;
+    worker->num_svr_filter_learning_iteration = encoder->num_svr_filter_learning_iteration;
+    worker->estimate_partition_cost = encoder->estimate_partition_cost;
+    worker->sliding_lookahead = encoder->sliding_lookahead;
+    worker->parameter_preset = encoder->parameter_preset;
+    worker->set_parameter = encoder->set_parameter;
+}
+
+/* 並列エンコードタスクの実行 */
+static void SRLAEncoder_ExecuteParallelTask(void *arg)
+{
+    struct SRLAEncoderParallelTask *task = (struct SRLAEncoderParallelTask *)arg;
+    struct SRLAEncoder *encoder = task->encoder;
+
+    SRLA_ASSERT(encoder != NULL);
+
+    if (encoder->min_num_samples_per_block != encoder->max_num_samples_per_block) {
+        /* 区間内の最適なブロック分割を探索してエンコード */
+        task->result = SRLAEncoder_EncodeOptimalPartitionedBlock(encoder,
+            task->input, task->num_samples, task->data, task->data_size, &task->output_size);
+    } else {
+        /* 固定ブロックサイズ: 区間を先頭からブロック単位でエンコード */
+        uint32_t ch, progress, write_size, num_encode_samples;
+        const int32_t *input_ptr[SRLA_MAX_NUM_CHANNELS];
+
+        progress = 0;
+        task->output_size = 0;
+        task->result = SRLA_APIRESULT_OK;
+        while (progress < task->num_samples) {
+            num_encode_samples
+                = SRLAUTILITY_MIN(encoder->max_num_samples_per_block, task->num_samples - progress);
+            for (ch = 0; ch < encoder->header.num_channels; ch++) {
+                input_ptr[ch] = &task->input[ch][progress];
+            }
+            if ((task->result = SRLAEncoder_EncodeBlock(encoder,
+                input_ptr, num_encode_samples, task->data + task->output_size,
+                task->data_size - task->output_size, &write_size)) != SRLA_APIRESULT_OK) {
+                return;
+            }
+            task->output_size += write_size;
+            progress += num_encode_samples;
+        }
+    }
+}
+
+/* ヘッダ含めファイル全体を複数スレッドでエンコード（本体） */
+static SRLAApiResult SRLAEncoder_EncodeWholeParallelCore(
+    struct SRLAEncoder *encoder, uint32_t num_threads,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    SRLAEncoder_EncodeBlockCallback encode_callback)
+{
+    SRLAApiResult ret;
+    uint32_t t, ch, progress, write_offset, num_tasks, commit_progress;
+    void *args[SRLA_MAX_NUM_THREADS];
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL) || (num_threads == 0)
+            || (data == NULL) || (output_size == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* パラメータがセットされてない */
+    if (encoder->set_parameter != 1) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* スレッド数がハンドルの容量を越えている */
+    if (num_threads > encoder->max_num_threads) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    /* ヘッダエンコード */
+    if ((ret = SRLAEncoder_SetupAndEncodeHeader(encoder, num_samples,
+            SRLAUtility_ComputeOffsetLeftShift(input, encoder->header.num_channels, num_samples),
+            data, data_size)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* ワーカーにパラメータを反映 */
+    for (t = 1; t < num_threads; t++) {
+        SRLAEncoder_CopyParameterToWorker(encoder->workers[t], encoder);
+    }
+
+    /* 進捗状況初期化 */
+    progress = commit_progress = 0;
+    write_offset = SRLA_HEADER_SIZE;
+
+    while (progress < num_samples) {
+        /* 先読みサンプル数単位の区間を各スレッドに割り当て */
+        for (num_tasks = 0; (num_tasks < num_threads) && (progress < num_samples); num_tasks++) {
+            struct SRLAEncoderParallelTask *task = &encoder->tasks[num_tasks];
+            task->encoder = encoder->workers[num_tasks];
+            task->num_samples = SRLAUTILITY_MIN(encoder->num_lookahead_samples, num_samples - progress);
+            for (ch = 0; ch < encoder->header.num_channels; ch++) {
+                task->input[ch] = &input[ch][progress];
+            }
+            task->data = encoder->worker_buffer[num_tasks];
+            task->data_size = encoder->worker_buffer_size;
+            task->output_size = 0;
+            args[num_tasks] = task;
+            progress += task->num_samples;
+        }
+
+        /* 並列エンコード */
+        if (SRLAThread_ExecuteParallel(SRLAEncoder_ExecuteParallelTask, args, num_tasks) != SRLA_ERROR_OK) {
+            return SRLA_APIRESULT_NG;
+        }
+
+        /* 時系列順に結果を連結 */
+        for (t = 0; t < num_tasks; t++) {
+            const struct SRLAEncoderParallelTask *task = &encoder->tasks[t];
+            if (task->result != SRLA_APIRESULT_OK) {
+                return task->result;
+            }
+            if ((write_offset + task->output_size) > data_size) {
+                return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+            }
+            memcpy(&data[write_offset], task->data, task->output_size);
+            write_offset += task->output_size;
+            commit_progress += task->num_samples;
+
+            /* コールバック関数が登録されていれば実行 */
+            if (encode_callback != NULL) {
+                encode_callback(num_samples, commit_progress, &data[write_offset - task->output_size], task->output_size);
+            }
+        }
+    }
+
+    /* シークテーブルの付加 */
+    if (encoder->seek_table_interval > 0) {
+        return SRLAEncoder_AppendSeekTable(data, data_size, write_offset, encoder->seek_table_interval, output_size);
+    }
+
+    /* 成功終了 */
+    (*output_size) = write_offset;
+    return SRLA_APIRESULT_OK;
+}
+
+/* ヘッダ含めファイル全体を複数スレッドでエンコード */
+SRLAApiResult SRLAEncoder_EncodeWholeParallel(
+    struct SRLAEncoder *encoder, uint32_t num_threads,
+    const int32_t *const *input, uint32_t num_samples,
+    uint8_t *data, uint32_t data_size, uint32_t *output_size,
+    SRLAEncoder_EncodeBlockCallback encode_callback)
+{
+    SRLAApiResult ret;
+
+    /* 引数チェック */
+    if ((encoder == NULL) || (input == NULL) || (num_threads == 0)
+            || (data == NULL) || (output_size == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 単一スレッドの場合は逐次処理と同一 */
+    if (num_threads == 1) {
+        return SRLAEncoder_EncodeWhole(encoder,
+            input, num_samples, data, data_size, output_size, encode_callback);
+    }
+
+    /* 先読み区間のスライドは区間を順に処理する必要があるため、ブロック分割探索のみ並列化する */
+    if (encoder->sliding_lookahead) {
+        if (num_threads > encoder->max_num_threads) {
+            return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+        }
+        encoder->num_search_threads = num_threads;
+        ret = SRLAEncoder_EncodeWhole(encoder,
+            input, num_samples, data, data_size, output_size, encode_callback);
+        encoder->num_search_threads = 1;
+        return ret;
+    }
+
+    /* ワーカーは区間単位の並列処理で使うため、ブロック分割探索は単一スレッドで行う */
+    return SRLAEncoder_EncodeWholeParallelCore(encoder, num_threads,
+        input, num_samples, data, data_size, output_size, encode_callback);
+}
+
+/* ストリーミングエンコーダハンドル作成に必要なワークサイズ計算 */
+int32_t SRLAStreamEncoder_CalculateWorkSize(const struct SRLAEncoderConfig *config)
+{
+    int32_t work_size, tmp_work_size, output_size;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* エンコーダハンドルのサイズ（コンフィグチェックを含む） */
+    if ((tmp_work_size = SRLAEncoder_CalculateWorkSize(config)) < 0) {
+        return -1;
+    }
+
+    /* ハンドル本体のサイズ */
+    work_size = sizeof(struct SRLAStreamEncoder) + SRLA_MEMORY_ALIGNMENT;
+    /* エンコーダハンドルのサイズ */
+    work_size += tmp_work_size;
+    /* 出力データバッファのサイズ */
+    if ((output_size = SRLAEncoder_CalculateWorkerBufferSize(
+            config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block)) < 0) {
+        return -1;
+    }
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 1, SRLA_MEMORY_ALIGNMENT)) < 0) {
+        return -1;
+    }
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, 1, output_size)) < 0) {
+        return -1;
+    }
+    /* 入力サンプルバッファのサイズ */
+    if ((work_size = SRLAUtility_AddWorkSize(work_size, config->max_num_channels,
+            (int32_t)SRLA_CALCULATE_2DIMARRAY_WORKSIZE(int32_t, 1, config->max_num_lookahead_samples))) < 0) {
+        return -1;
+    }
+
+    return work_size;
+}
+
+/* ストリーミングエンコーダハンドル作成 */
+struct SRLAStreamEncoder *SRLAStreamEncoder_Create(const struct SRLAEncoderConfig *config, void *work, int32_t work_size)
+{
+    struct SRLAStreamEncoder *stream_encoder;
+    uint8_t tmp_alloc_by_own = 0;
+    uint8_t *work_ptr;
+
+    /* ワーク領域時前確保の場合 */
+    if ((work == NULL) && (work_size == 0)) {
+        if ((work_size = SRLAStreamEncoder_CalculateWorkSize(config)) < 0) {
+            return NULL;
+        }
+        work = malloc((uint32_t)work_size);
+        tmp_alloc_by_own = 1;
+    }
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL)
+        || (work_size < SRLAStreamEncoder_CalculateWorkSize(config))) {
+        if (tmp_alloc_by_own == 1) {
+            free(work);
+        }
+        return NULL;
+    }
+
+    /* ワーク領域先頭ポインタ取得 */
+    work_ptr = (uint8_t *)work;
+
+    /* ハンドル領域確保 */
+    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+    stream_encoder = (struct SRLAStreamEncoder *)work_ptr;
+    work_ptr += sizeof(struct SRLAStreamEncoder);
+
+    /* エンコーダハンドルの作成 */
+    {
+        const int32_t encoder_size = SRLAEncoder_CalculateWorkSize(config);
+        if ((stream_encoder->encoder = SRLAEncoder_Create(config, work_ptr, encoder_size)) == NULL) {
+            if (tmp_alloc_by_own == 1) {
+                free(work);
+            }
+            return NULL;
+        }
+        work_ptr += encoder_size;
+    }
+
+    /* 入力サンプルバッファの確保 */
+    SRLA_ALLOCATE_2DIMARRAY(stream_encoder->buffer,
+        work_ptr, int32_t, config->max_num_channels, config->max_num_lookahead_samples);
+    stream_encoder->max_num_buffer_samples = config->max_num_lookahead_samples;
+
+    /* 出力データバッファの確保 */
+    work_ptr = (uint8_t *)SRLAUTILITY_ROUNDUP((uintptr_t)work_ptr, SRLA_MEMORY_ALIGNMENT);
+    stream_encoder->output = work_ptr;
+    stream_encoder->output_size = (uint32_t)SRLAEncoder_CalculateWorkerBufferSize(
+        config->max_num_channels, config->max_num_lookahead_samples, config->min_num_samples_per_block);
+    work_ptr += stream_encoder->output_size;
+
+    /* バッファオーバーランチェック */
+    SRLA_ASSERT((work_ptr - (uint8_t *)work) <= work_size);
+
+    /* メンバの初期化 */
+    stream_encoder->num_buffer_samples = 0;
+    stream_encoder->num_buffered_samples = 0;
+    stream_encoder->num_pushed_samples = 0;
+    stream_encoder->num_reuse_nodes = 0;
+    stream_encoder->output_callback = NULL;
+    stream_encoder->user_data = NULL;
+    stream_encoder->started = 0;
+    stream_encoder->alloced_by_own = tmp_alloc_by_own;
+    stream_encoder->work = work;
+
+    return stream_encoder;
+}
+
+/* ストリーミングエンコーダハンドルの破棄 */
+void SRLAStreamEncoder_Destroy(struct SRLAStreamEncoder *stream_encoder)
+{
+    if (stream_encoder != NULL) {
+        SRLAEncoder_Destroy(stream_encoder->encoder);
+        if (stream_encoder->alloced_by_own == 1) {
+            free(stream_encoder->work);
+        }
+    }
+}
+
+/* ストリーミングエンコードの開始 */
+SRLAApiResult SRLAStreamEncoder_Start(
+    struct SRLAStreamEncoder *stream_encoder, const struct SRLAEncodeParameter *parameter,
+    uint32_t offset_lshift, SRLAStreamEncoder_OutputCallback output_callback, void *user_data)
+{
+    SRLAApiResult ret;
+    struct SRLAEncoder *encoder;
+
+    /* 引数チェック */
+    if ((stream_encoder == NULL) || (parameter == NULL) || (output_callback == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+    encoder = stream_encoder->encoder;
+
+    /* シークテーブルは出力済みのブロックを辿って作るため、ストリーミングエンコードでは出力できない */
+    if (parameter->seek_table_interval > 0) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* エンコードパラメータの設定 */
+    if ((ret = SRLAEncoder_SetEncodeParameter(encoder, parameter)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* 左シフト量がサンプルのビット数以上 */
+    if (offset_lshift >= encoder->header.bits_per_sample) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 暫定ヘッダの設定と出力 */
+    if ((ret = SRLAEncoder_SetupAndEncodeHeader(encoder, SRLA_NUM_SAMPLES_UNKNOWN, offset_lshift,
+            stream_encoder->output, stream_encoder->output_size)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+    output_callback(stream_encoder->output, SRLA_HEADER_SIZE, user_data);
+
+    /* 状態の初期化 */
+    /* 可変ブロックサイズの場合は先読みサンプル数、固定ブロックサイズの場合は最大ブロックサイズ単位で処理 */
+    stream_encoder->num_buffer_samples
+        = (encoder->min_num_samples_per_block == encoder->header.max_num_samples_per_block)
+        ? encoder->header.max_num_samples_per_block : encoder->num_lookahead_samples;
+    SRLA_ASSERT(stream_encoder->num_buffer_samples <= stream_encoder->max_num_buffer_samples);
+    stream_encoder->num_buffered_samples = 0;
+    stream_encoder->num_pushed_samples = 0;
+    stream_encoder->num_reuse_nodes = 0;
+    stream_encoder->output_callback = output_callback;
+    stream_encoder->user_data = user_data;
+    stream_encoder->started = 1;
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* バッファ先頭からエンコードを1回行い、出力したサンプルをバッファから取り除く
+ * is_last != 0 の場合はバッファの残りが入力の末尾であるとして扱う */
+static SRLAApiResult SRLAStreamEncoder_EncodeBufferedSamples(
+    struct SRLAStreamEncoder *stream_encoder, uint8_t is_last)
+{
+    SRLAApiResult ret;
+    uint32_t ch, write_size, num_encoded_samples;
+    struct SRLAEncoder *encoder = stream_encoder->encoder;
+    const uint32_t num_channels = encoder->header.num_channels;
+    const uint32_t num_window_samples = stream_encoder->num_buffered_samples;
+
+    SRLA_ASSERT(num_window_samples > 0);
+    SRLA_ASSERT(num_window_samples <= stream_encoder->num_buffer_samples);
+    SRLA_ASSERT(is_last || (num_window_samples == stream_encoder->num_buffer_samples));
+
+    if (encoder->min_num_samples_per_block == encoder->header.max_num_samples_per_block) {
+        /* 固定ブロックサイズ: 1ブロックをエンコード */
+        num_encoded_samples = num_window_samples;
+        if ((ret = SRLAEncoder_EncodeBlock(encoder, (const int32_t *const *)stream_encoder->buffer,
+                num_encoded_samples, stream_encoder->output, stream_encoder->output_size, &write_size)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+    } else if (encoder->sliding_lookahead) {
+        /* 先読み区間をスライド: 区間の先頭部分をエンコード */
+        if ((ret = SRLAEncoder_EncodeSlidingWindow(encoder, (const int32_t *const *)stream_encoder->buffer,
+                num_window_samples, is_last, &stream_encoder->num_reuse_nodes,
+                stream_encoder->output, stream_encoder->output_size, &write_size, &num_encoded_samples)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+    } else {
+        /* 先読み区間全体を最適分割してエンコード */
+        num_encoded_samples = num_window_samples;
+        if ((ret = SRLAEncoder_EncodeOptimalPartitionedBlock(encoder, (const int32_t *const *)stream_encoder->buffer,
+                num_encoded_samples, stream_encoder->output, stream_encoder->output_size, &write_size)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* 出力 */
+    stream_encoder->output_callback(stream_encoder->output, write_size, stream_encoder->user_data);
+
+    /* エンコード済みのサンプルをバッファから取り除く */
+    SRLA_ASSERT(num_encoded_samples <= stream_encoder->num_buffered_samples);
+    stream_encoder->num_buffered_samples -= num_encoded_samples;
+    for (ch = 0; ch < num_channels; ch++) {
+        memmove(&stream_encoder->buffer[ch][0], &stream_encoder->buffer[ch][num_encoded_samples],
+            sizeof(int32_t) * stream_encoder->num_buffered_samples);
+    }
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* 任意サンプル数の入力を追加 */
+SRLAApiResult SRLAStreamEncoder_Push(
+    struct SRLAStreamEncoder *stream_encoder, const int32_t *const *input, uint32_t num_samples)
+{
+    SRLAApiResult ret;
+    uint32_t ch, progress;
+    uint32_t num_channels;
+
+    /* 引数チェック */
+    if ((stream_encoder == NULL) || ((input == NULL) && (num_samples > 0))) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 開始されていない */
+    if (stream_encoder->started != 1) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+
+    /* ヘッダに記録できるサンプル数を越える */
+    if (num_samples >= (SRLA_NUM_SAMPLES_UNKNOWN - stream_encoder->num_pushed_samples)) {
+        return SRLA_APIRESULT_INSUFFICIENT_BUFFER;
+    }
+
+    num_channels = stream_encoder->encoder->header.num_channels;
+
+    /* 左シフト量分の下位ビットが0でないサンプルが含まれる */
+    if (stream_encoder->encoder->header.offset_lshift > 0) {
+        uint32_t smpl;
+        uint32_t mask = 0;
+        for (ch = 0; ch < num_channels; ch++) {
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                mask |= (uint32_t)input[ch][smpl];
+            }
+        }
+        if ((mask & ((1UL << stream_encoder->encoder->header.offset_lshift) - 1)) != 0) {
+            return SRLA_APIRESULT_INVALID_FORMAT;
+        }
+    }
+
+    progress = 0;
+    while (progress < num_samples) {
+        uint32_t num_copy_samples;
+
+        /* バッファが満杯で、かつ後続の入力がある場合にエンコード */
+        /* 補足）入力の末尾かどうかはSRLAStreamEncoder_Finishまで分からないため、満杯になった時点ではエンコードしない */
+        if (stream_encoder->num_buffered_samples == stream_encoder->num_buffer_samples) {
+            if ((ret = SRLAStreamEncoder_EncodeBufferedSamples(stream_encoder, 0)) != SRLA_APIRESULT_OK) {
+                return ret;
+            }
+        }
+
+        /* バッファに追記 */
+        num_copy_samples = SRLAUTILITY_MIN(
+            stream_encoder->num_buffer_samples - stream_encoder->num_buffered_samples, num_samples - progress);
+        for (ch = 0; ch < num_channels; ch++) {
+            memcpy(&stream_encoder->buffer[ch][stream_encoder->num_buffered_samples],
+                &input[ch][progress], sizeof(int32_t) * num_copy_samples);
+        }
+        stream_encoder->num_buffered_samples += num_copy_samples;
+        progress += num_copy_samples;
+    }
+
+    stream_encoder->num_pushed_samples += num_samples;
+
+    return SRLA_APIRESULT_OK;
+}
+
+/* ストリーミングエンコードの終了 */
+SRLAApiResult SRLAStreamEncoder_Finish(
+    struct SRLAStreamEncoder *stream_encoder, uint8_t *header_data, uint32_t header_data_size)
+{
+    SRLAApiResult ret;
+    struct SRLAEncoder *encoder;
+
+    /* 引数チェック */
+    if ((stream_encoder == NULL) || (header_data == NULL)) {
+        return SRLA_APIRESULT_INVALID_ARGUMENT;
+    }
+
+    /* 開始されていない */
+    if (stream_encoder->started != 1) {
+        return SRLA_APIRESULT_PARAMETER_NOT_SET;
+    }
+    encoder = stream_encoder->encoder;
+
+    /* 1サンプルも入力されていない */
+    if (stream_encoder->num_pushed_samples == 0) {
+        return SRLA_APIRESULT_INSUFFICIENT_DATA;
+    }
+
+    /* バッファの残りを全てエンコード */
+    while (stream_encoder->num_buffered_samples > 0) {
+        if ((ret = SRLAStreamEncoder_EncodeBufferedSamples(stream_encoder, 1)) != SRLA_APIRESULT_OK) {
+            return ret;
+        }
+    }
+
+    /* 確定ヘッダの書き出し */
+    encoder->header.num_samples = stream_encoder->num_pushed_samples;
+    if ((ret = SRLAEncoder_EncodeHeader(&(encoder->header), header_data, header_data_size)) != SRLA_APIRESULT_OK) {
+        return ret;
+    }
+
+    /* 終了 再度SRLAStreamEncoder_Startを呼ぶまで入力を受け付けない */
+    stream_encoder->started = 0;
+
+    return SRLA_APIRESULT_OK;
+}
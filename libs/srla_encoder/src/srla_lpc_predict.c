@@ -4,19 +4,11 @@
 #include "srla_internal.h"
 
 /* LPC係数により予測/誤差出力 */
-#if defined(SRLA_USE_SSE41)
-#ifdef _MSC_VER
-#include <intrin.h>
-#define DECLALIGN(x) __declspec(align(x))
-#else
-#include <x86intrin.h>
-#define DECLALIGN(x) __attribute__((aligned(x)))
-#endif
-void SRLALPC_Predict(
+static void SRLALPC_PredictScalar(
     const int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, int32_t *residual, uint32_t coef_rshift)
 {
-    int32_t smpl, ord;
+    uint32_t smpl, ord;
     int32_t predict;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
 
@@ -32,28 +24,60 @@ void SRLALPC_Predict(
         residual[smpl] = data[smpl] - data[smpl - 1];
     }
 
+    /* 予測 */
+    for (smpl = 0; smpl < num_samples - coef_order; smpl++) {
+        predict = half;
+        for (ord = 0; ord < coef_order; ord++) {
+            predict += (coef[ord] * data[smpl + ord]);
+        }
+        residual[smpl + ord] += (predict >> coef_rshift);
+    }
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* LPC係数により予測/誤差出力 SSE4.1版 */
+SRLA_TARGET_SSE41 static void SRLALPC_PredictSSE41(
+    const int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order, int32_t *residual, uint32_t coef_rshift)
+{
+    int32_t smpl, ord;
+    const int32_t order = (int32_t)coef_order;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+    SRLA_ASSERT(residual != NULL);
+
+    memcpy(residual, data, sizeof(int32_t) * num_samples);
+
+    /* 先頭係数次数分を前値予測 */
+    for (smpl = 1; smpl < order; smpl++) {
+        residual[smpl] = data[smpl] - data[smpl - 1];
+    }
+
     if (coef_order >= 4) {
-        uint32_t i;
+        int32_t i;
         __m128i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
         /* 係数をベクトル化 */
-        for (i = 0; i < coef_order; i++) {
+        for (i = 0; i < order; i++) {
             vcoef[i] = _mm_set1_epi32(coef[i]);
         }
-        for (; smpl < num_samples - coef_order - 4; smpl += 4) {
+        for (; (smpl + 4) <= (int32_t)num_samples; smpl += 4) {
             /* 4サンプル並列に処理
             int32_t predict[4] = { half, half, half, half }
-            for (ord = 0; ord < coef_order - 3; ord++) {
-                predict[0] += (coef[ord] * data[smpl - coef_order + ord + 0]);
-                predict[1] += (coef[ord] * data[smpl - coef_order + ord + 1]);
-                predict[2] += (coef[ord] * data[smpl - coef_order + ord + 2]);
-                predict[3] += (coef[ord] * data[smpl - coef_order + ord + 3]);
+            for (ord = 0; ord < order - 3; ord++) {
+                predict[0] += (coef[ord] * data[smpl - order + ord + 0]);
+                predict[1] += (coef[ord] * data[smpl - order + ord + 1]);
+                predict[2] += (coef[ord] * data[smpl - order + ord + 2]);
+                predict[3] += (coef[ord] * data[smpl - order + ord + 3]);
             }
             */
             DECLALIGN(16) int32_t predict[4];
             __m128i vdata;
             __m128i vpred = _mm_set1_epi32(half);
-            for (ord = 0; ord < (int32_t)coef_order - 3 - 4; ord += 4) {
-                const int32_t *dat = &data[smpl - coef_order + ord];
+            for (ord = 0; ord < order - 3 - 4; ord += 4) {
+                const int32_t *dat = &data[smpl - order + ord];
                 vdata = _mm_loadu_si128((const __m128i *)&dat[0]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 0], vdata));
                 vdata = _mm_loadu_si128((const __m128i *)&dat[1]);
@@ -63,8 +87,8 @@ void SRLALPC_Predict(
                 vdata = _mm_loadu_si128((const __m128i *)&dat[3]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 3], vdata));
             }
-            for (; ord < coef_order - 3; ord++) {
-                vdata = _mm_loadu_si128((__m128i *)&data[smpl - coef_order + ord]);
+            for (; ord < order - 3; ord++) {
+                vdata = _mm_loadu_si128((__m128i *)&data[smpl - order + ord]);
                 vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord], vdata));
             }
             _mm_store_si128((__m128i *)predict, vpred);
@@ -99,28 +123,22 @@ void SRLALPC_Predict(
     }
 
     /* 余ったサンプル分の処理 */
-    for (; smpl < num_samples; smpl++) {
+    for (; smpl < (int32_t)num_samples; smpl++) {
         int32_t predict = half;
-        for (ord = 0; ord < coef_order; ord++) {
-            predict += (coef[ord] * data[smpl - coef_order + ord]);
+        for (ord = 0; ord < order; ord++) {
+            predict += (coef[ord] * data[smpl - order + ord]);
         }
         residual[smpl] += (predict >> coef_rshift);
     }
 }
-#elif defined(SRLA_USE_AVX2)
-#ifdef _MSC_VER
-#include <immintrin.h>
-#define DECLALIGN(x) __declspec(align(x))
-#else
-#include <x86intrin.h>
-#define DECLALIGN(x) __attribute__((aligned(x)))
-#endif
-void SRLALPC_Predict(
+
+/* LPC係数により予測/誤差出力 AVX2版 */
+SRLA_TARGET_AVX2 static void SRLALPC_PredictAVX2(
     const int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, int32_t *residual, uint32_t coef_rshift)
 {
     int32_t smpl, ord;
-    int32_t predict;
+    const int32_t order = (int32_t)coef_order;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
 
     /* 引数チェック */
@@ -128,27 +146,33 @@ void SRLALPC_Predict(
     SRLA_ASSERT(coef != NULL);
     SRLA_ASSERT(residual != NULL);
 
+    /* 8次未満はSSE4.1版で処理 */
+    if (coef_order < 8) {
+        SRLALPC_PredictSSE41(data, num_samples, coef, coef_order, residual, coef_rshift);
+        return;
+    }
+
     memcpy(residual, data, sizeof(int32_t) * num_samples);
 
     /* 先頭係数次数分を前値予測 */
-    for (smpl = 1; smpl < coef_order; smpl++) {
+    for (smpl = 1; smpl < order; smpl++) {
         residual[smpl] = data[smpl] - data[smpl - 1];
     }
 
-    if (coef_order >= 8) {
-        uint32_t i;
+    {
+        int32_t i;
         __m256i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
         /* 係数をベクトル化 */
-        for (i = 0; i < coef_order; i++) {
+        for (i = 0; i < order; i++) {
             vcoef[i] = _mm256_set1_epi32(coef[i]);
         }
-        for (; smpl < num_samples - coef_order - 8; smpl += 8) {
+        for (; (smpl + 8) <= (int32_t)num_samples; smpl += 8) {
             /* 8サンプル並列に処理 */
             DECLALIGN(32) int32_t predict[8];
             __m256i vdata;
             __m256i vpred = _mm256_set1_epi32(half);
-            for (ord = 0; ord < (int32_t)coef_order - 7 - 8; ord += 8) {
-                const int32_t *dat = &data[smpl - coef_order + ord];
+            for (ord = 0; ord < order - 7 - 8; ord += 8) {
+                const int32_t *dat = &data[smpl - order + ord];
                 vdata = _mm256_loadu_si256((const __m256i *)&dat[0]);
                 vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord + 0], vdata));
                 vdata = _mm256_loadu_si256((const __m256i *)&dat[1]);
@@ -166,8 +190,8 @@ void SRLALPC_Predict(
                 vdata = _mm256_loadu_si256((const __m256i *)&dat[7]);
                 vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord + 7], vdata));
             }
-            for (; ord < coef_order - 7; ord++) {
-                vdata = _mm256_loadu_si256((const __m256i *)&data[smpl - coef_order + ord]);
+            for (; ord < order - 7; ord++) {
+                vdata = _mm256_loadu_si256((const __m256i *)&data[smpl - order + ord]);
                 vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord], vdata));
             }
             _mm256_store_si256((__m256i *)predict, vpred);
@@ -184,42 +208,67 @@ void SRLALPC_Predict(
                 residual[smpl + i] += (predict[i] >> coef_rshift);
             }
         }
-    } else if (coef_order >= 4) {
-        uint32_t i;
-        __m128i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
+    }
+
+    /* 余ったサンプル分の処理 */
+    for (; smpl < (int32_t)num_samples; smpl++) {
+        int32_t predict = half;
+        for (ord = 0; ord < order; ord++) {
+            predict += (coef[ord] * data[smpl - order + ord]);
+        }
+        residual[smpl] += (predict >> coef_rshift);
+    }
+}
+
+/* LPC係数により予測/誤差出力 AVX-512版 */
+SRLA_TARGET_AVX512 static void SRLALPC_PredictAVX512(
+    const int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order, int32_t *residual, uint32_t coef_rshift)
+{
+    uint32_t smpl, ord;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+    SRLA_ASSERT(residual != NULL);
+
+    /* 16次未満はAVX2版で処理 */
+    if (coef_order < 16) {
+        SRLALPC_PredictAVX2(data, num_samples, coef, coef_order, residual, coef_rshift);
+        return;
+    }
+
+    memcpy(residual, data, sizeof(int32_t) * num_samples);
+
+    /* 先頭係数次数分を前値予測 */
+    for (smpl = 1; smpl < coef_order; smpl++) {
+        residual[smpl] = data[smpl] - data[smpl - 1];
+    }
+
+    /* 入力と出力が別バッファのため、末尾の係数まで含めて16サンプル並列に処理できる */
+    {
+        __m512i vcoef[SRLA_MAX_COEFFICIENT_ORDER];
+        const __m512i vhalf = _mm512_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
         /* 係数をベクトル化 */
-        for (i = 0; i < coef_order; i++) {
-            vcoef[i] = _mm_set1_epi32(coef[i]);
+        for (ord = 0; ord < coef_order; ord++) {
+            vcoef[ord] = _mm512_set1_epi32(coef[ord]);
         }
-        for (; smpl < num_samples - coef_order - 4; smpl += 4) {
-            /* 4サンプル並列に処理 */
-            DECLALIGN(16) int32_t predict[4];
-            __m128i vdata;
-            __m128i vpred = _mm_set1_epi32(half);
-            for (ord = 0; ord < (int32_t)coef_order - 3 - 4; ord += 4) {
-                const int32_t *dat = &data[smpl - coef_order + ord];
-                vdata = _mm_loadu_si128((const __m128i *)&dat[0]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 0], vdata));
-                vdata = _mm_loadu_si128((const __m128i *)&dat[1]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 1], vdata));
-                vdata = _mm_loadu_si128((const __m128i *)&dat[2]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 2], vdata));
-                vdata = _mm_loadu_si128((const __m128i *)&dat[3]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord + 3], vdata));
+        for (; (smpl + 16) <= num_samples; smpl += 16) {
+            const int32_t *dat = &data[smpl - coef_order];
+            __m512i vpred = vhalf;
+            for (ord = 0; (ord + 4) <= coef_order; ord += 4) {
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 0], _mm512_loadu_si512(&dat[ord + 0])));
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 1], _mm512_loadu_si512(&dat[ord + 1])));
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 2], _mm512_loadu_si512(&dat[ord + 2])));
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord + 3], _mm512_loadu_si512(&dat[ord + 3])));
             }
-            for (; ord < coef_order - 3; ord++) {
-                vdata = _mm_loadu_si128((const __m128i *)&data[smpl - coef_order + ord]);
-                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord], vdata));
-            }
-            _mm_store_si128((__m128i *)predict, vpred);
-
-            /* ord = coef_order - 3 */
-            for (i = 0; i < 4; i++) {
-                predict[i] += (coef[ord + 0] * data[smpl - 3 + i + 0]);
-                predict[i] += (coef[ord + 1] * data[smpl - 3 + i + 1]);
-                predict[i] += (coef[ord + 2] * data[smpl - 3 + i + 2]);
-                residual[smpl + i] += (predict[i] >> coef_rshift);
+            for (; ord < coef_order; ord++) {
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord], _mm512_loadu_si512(&dat[ord])));
             }
+            _mm512_storeu_si512(&residual[smpl],
+                    _mm512_add_epi32(_mm512_loadu_si512(&data[smpl]), _mm512_sra_epi32(vpred, vshift)));
         }
     }
 
@@ -232,45 +281,146 @@ void SRLALPC_Predict(
         residual[smpl] += (predict >> coef_rshift);
     }
 }
-#else
-void SRLALPC_Predict(
+#endif
+
+/* LTP係数により予測/誤差出力 smpl以降のサンプルを逐次処理 */
+static void SRLALTP_PredictSequential(
+    const int32_t *data, uint32_t smpl, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order, uint32_t pitch_period,
+    int32_t *residual, uint32_t coef_rshift)
+{
+    uint32_t ord;
+    int32_t predict;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+    const uint32_t half_order = coef_order >> 1;
+    const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order));
+
+    for (; smpl < num_samples; smpl++) {
+        predict = half;
+        for (ord = 0; ord < coef_order; ord++) {
+            predict += (coef[ord] * dalay_data[smpl + ord]);
+        }
+        residual[smpl] -= (predict >> coef_rshift);
+    }
+}
+
+/* LTP係数により予測/誤差出力 */
+static void SRLALTP_PredictScalar(
     const int32_t *data, uint32_t num_samples,
-    const int32_t *coef, uint32_t coef_order, int32_t *residual, uint32_t coef_rshift)
+    const int32_t *coef, uint32_t coef_order, uint32_t pitch_period,
+    int32_t *residual, uint32_t coef_rshift)
+{
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+    SRLA_ASSERT(residual != NULL);
+    SRLA_ASSERT((coef_order % 2) == 1);
+    SRLA_ASSERT(coef_order <= SRLA_MAX_LTP_ORDER);
+
+    memcpy(residual, data, sizeof(int32_t) * num_samples);
+
+    SRLALTP_PredictSequential(data,
+        pitch_period + (coef_order >> 1) + 1, num_samples, coef, coef_order, pitch_period, residual, coef_rshift);
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* LTP係数により予測/誤差出力 SSE4.1版 */
+SRLA_TARGET_SSE41 static void SRLALTP_PredictSSE41(
+    const int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order, uint32_t pitch_period,
+    int32_t *residual, uint32_t coef_rshift)
 {
     uint32_t smpl, ord;
-    int32_t predict;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+    const uint32_t half_order = coef_order >> 1;
+    const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order));
 
     /* 引数チェック */
     SRLA_ASSERT(data != NULL);
     SRLA_ASSERT(coef != NULL);
     SRLA_ASSERT(residual != NULL);
+    SRLA_ASSERT((coef_order % 2) == 1);
+    SRLA_ASSERT(coef_order <= SRLA_MAX_LTP_ORDER);
 
     memcpy(residual, data, sizeof(int32_t) * num_samples);
 
-    /* 先頭係数次数分を前値予測 */
-    for (smpl = 1; smpl < coef_order; smpl++) {
-        residual[smpl] = data[smpl] - data[smpl - 1];
+    smpl = pitch_period + half_order + 1;
+
+    /* 入力と出力が別バッファのため全サンプル独立に並列処理できる */
+    if (coef_order > 0) {
+        __m128i vcoef[SRLA_MAX_LTP_ORDER];
+        const __m128i vhalf = _mm_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
+        for (ord = 0; ord < coef_order; ord++) {
+            vcoef[ord] = _mm_set1_epi32(coef[ord]);
+        }
+        for (; (smpl + 4) <= num_samples; smpl += 4) {
+            __m128i vpred = vhalf;
+            for (ord = 0; ord < coef_order; ord++) {
+                const __m128i vdata = _mm_loadu_si128((const __m128i *)&dalay_data[smpl + ord]);
+                vpred = _mm_add_epi32(vpred, _mm_mullo_epi32(vcoef[ord], vdata));
+            }
+            _mm_storeu_si128((__m128i *)&residual[smpl],
+                    _mm_sub_epi32(_mm_loadu_si128((const __m128i *)&data[smpl]), _mm_sra_epi32(vpred, vshift)));
+        }
     }
 
-    /* 予測 */
-    for (smpl = 0; smpl < num_samples - coef_order; smpl++) {
-        predict = half;
+    /* 余ったサンプル分の処理 */
+    SRLALTP_PredictSequential(data, smpl, num_samples, coef, coef_order, pitch_period, residual, coef_rshift);
+}
+
+/* LTP係数により予測/誤差出力 AVX2版 */
+SRLA_TARGET_AVX2 static void SRLALTP_PredictAVX2(
+    const int32_t *data, uint32_t num_samples,
+    const int32_t *coef, uint32_t coef_order, uint32_t pitch_period,
+    int32_t *residual, uint32_t coef_rshift)
+{
+    uint32_t smpl, ord;
+    const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
+    const uint32_t half_order = coef_order >> 1;
+    const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order));
+
+    /* 引数チェック */
+    SRLA_ASSERT(data != NULL);
+    SRLA_ASSERT(coef != NULL);
+    SRLA_ASSERT(residual != NULL);
+    SRLA_ASSERT((coef_order % 2) == 1);
+    SRLA_ASSERT(coef_order <= SRLA_MAX_LTP_ORDER);
+
+    memcpy(residual, data, sizeof(int32_t) * num_samples);
+
+    smpl = pitch_period + half_order + 1;
+
+    /* 入力と出力が別バッファのため全サンプル独立に並列処理できる */
+    if (coef_order > 0) {
+        __m256i vcoef[SRLA_MAX_LTP_ORDER];
+        const __m256i vhalf = _mm256_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
         for (ord = 0; ord < coef_order; ord++) {
-            predict += (coef[ord] * data[smpl + ord]);
+            vcoef[ord] = _mm256_set1_epi32(coef[ord]);
+        }
+        for (; (smpl + 8) <= num_samples; smpl += 8) {
+            __m256i vpred = vhalf;
+            for (ord = 0; ord < coef_order; ord++) {
+                const __m256i vdata = _mm256_loadu_si256((const __m256i *)&dalay_data[smpl + ord]);
+                vpred = _mm256_add_epi32(vpred, _mm256_mullo_epi32(vcoef[ord], vdata));
+            }
+            _mm256_storeu_si256((__m256i *)&residual[smpl],
+                    _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)&data[smpl]), _mm256_sra_epi32(vpred, vshift)));
         }
-        residual[smpl + ord] += (predict >> coef_rshift);
     }
+
+    /* 余ったサンプル分の処理 */
+    SRLALTP_PredictSequential(data, smpl, num_samples, coef, coef_order, pitch_period, residual, coef_rshift);
 }
-#endif
 
-void SRLALTP_Predict(
+/* LTP係数により予測/誤差出力 AVX-512版 */
+SRLA_TARGET_AVX512 static void SRLALTP_PredictAVX512(
     const int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, uint32_t pitch_period,
     int32_t *residual, uint32_t coef_rshift)
 {
     uint32_t smpl, ord;
-    int32_t predict;
     const int32_t half = 1 << (coef_rshift - 1); /* 固定小数の0.5 */
     const uint32_t half_order = coef_order >> 1;
     const int32_t *dalay_data = (const int32_t *)(data - (int32_t)(pitch_period + half_order));
@@ -284,11 +434,63 @@ void SRLALTP_Predict(
 
     memcpy(residual, data, sizeof(int32_t) * num_samples);
 
-    for (smpl = pitch_period + half_order + 1; smpl < num_samples; smpl++) {
-        predict = half;
+    smpl = pitch_period + half_order + 1;
+
+    /* 入力と出力が別バッファのため全サンプル独立に並列処理できる */
+    if (coef_order > 0) {
+        __m512i vcoef[SRLA_MAX_LTP_ORDER];
+        const __m512i vhalf = _mm512_set1_epi32(half);
+        const __m128i vshift = _mm_cvtsi32_si128((int32_t)coef_rshift);
         for (ord = 0; ord < coef_order; ord++) {
-            predict += (coef[ord] * dalay_data[smpl + ord]);
+            vcoef[ord] = _mm512_set1_epi32(coef[ord]);
         }
-        residual[smpl] -= (predict >> coef_rshift);
+        for (; (smpl + 16) <= num_samples; smpl += 16) {
+            __m512i vpred = vhalf;
+            for (ord = 0; ord < coef_order; ord++) {
+                const __m512i vdata = _mm512_loadu_si512(&dalay_data[smpl + ord]);
+                vpred = _mm512_add_epi32(vpred, _mm512_mullo_epi32(vcoef[ord], vdata));
+            }
+            _mm512_storeu_si512(&residual[smpl],
+                    _mm512_sub_epi32(_mm512_loadu_si512(&data[smpl]), _mm512_sra_epi32(vpred, vshift)));
+        }
+    }
+
+    /* 余ったサンプル分の処理 */
+    SRLALTP_PredictSequential(data, smpl, num_samples, coef, coef_order, pitch_period, residual, coef_rshift);
+}
+#endif
+
+/* 命令セットごとの予測関数テーブル */
+static const struct SRLAPredictFunctions st_predict_functions_scalar = {
+    SRLALPC_PredictScalar, SRLALTP_PredictScalar
+};
+#if defined(SRLA_ENABLE_X86_SIMD)
+static const struct SRLAPredictFunctions st_predict_functions_sse41 = {
+    SRLALPC_PredictSSE41, SRLALTP_PredictSSE41
+};
+static const struct SRLAPredictFunctions st_predict_functions_avx2 = {
+    SRLALPC_PredictAVX2, SRLALTP_PredictAVX2
+};
+static const struct SRLAPredictFunctions st_predict_functions_avx512 = {
+    SRLALPC_PredictAVX512, SRLALTP_PredictAVX512
+};
+#endif
+
+/* 命令セットに対応する予測関数テーブルを取得 */
+const struct SRLAPredictFunctions *SRLAPredict_GetFunctions(SRLASIMDInstructionSet instruction_set)
+{
+    switch (instruction_set) {
+#if defined(SRLA_ENABLE_X86_SIMD)
+    case SRLA_SIMD_AVX512:
+        return &st_predict_functions_avx512;
+    case SRLA_SIMD_AVX2:
+        return &st_predict_functions_avx2;
+    case SRLA_SIMD_SSE41:
+        return &st_predict_functions_sse41;
+#endif
+    default:
+        break;
     }
+
+    return &st_predict_functions_scalar;
 }
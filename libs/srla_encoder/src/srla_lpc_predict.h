@@ -2,22 +2,32 @@
 #define SRLA_LPCPREDICTOR_H_INCLUDED
 
 #include <stdint.h>
+#include "srla_simd.h"
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/* LPC係数により予測/誤差出力 */
-void SRLALPC_Predict(
+/* LPC係数により予測/誤差出力する関数 */
+typedef void (*SRLALPCPredictFunction)(
     const int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, int32_t *residual, uint32_t coef_rshift);
 
-/* LTP係数により予測/誤差出力 */
-void SRLALTP_Predict(
+/* LTP係数により予測/誤差出力する関数 */
+typedef void (*SRLALTPPredictFunction)(
     const int32_t *data, uint32_t num_samples,
     const int32_t *coef, uint32_t coef_order, uint32_t pitch_period,
     int32_t *residual, uint32_t coef_rshift);
 
+/* 予測関数テーブル（命令セットによらず結果は一致する） */
+struct SRLAPredictFunctions {
+    SRLALPCPredictFunction lpc_predict; /* LPC係数により予測/誤差出力 */
+    SRLALTPPredictFunction ltp_predict; /* LTP係数により予測/誤差出力 */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 命令セットに対応する予測関数テーブルを取得 */
+const struct SRLAPredictFunctions *SRLAPredict_GetFunctions(SRLASIMDInstructionSet instruction_set);
+
 #ifdef __cplusplus
 }
 #endif
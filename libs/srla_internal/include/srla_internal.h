@@ -9,6 +9,12 @@
 #define SRLA_MEMORY_ALIGNMENT 16
 /* ブロック先頭の同期コード */
 #define SRLA_BLOCK_SYNC_CODE 0xFFFF
+/* シークテーブルの識別子（'S','E','E','K'） チャンク末尾に置く */
+#define SRLA_SEEK_TABLE_SIGNATURE 0x5345454BUL
+/* シークテーブル末尾の固定部サイズ（チェックサム2byte+チャンクサイズ4byte+識別子4byte） */
+#define SRLA_SEEK_TABLE_FOOTER_SIZE 10
+/* シークテーブルのチャンクサイズ（シーク点数4byte+シーク点あたり8byte+固定部） */
+#define SRLA_SEEK_TABLE_CHUNK_SIZE(num_points) (4 + 8 * (num_points) + SRLA_SEEK_TABLE_FOOTER_SIZE)
 
 /* 内部エンコードパラメータ */
 /* プリエンファシスの係数シフト量 */
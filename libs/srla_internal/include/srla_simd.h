@@ -0,0 +1,58 @@
+#ifndef SRLASIMD_H_INCLUDED
+#define SRLASIMD_H_INCLUDED
+
+#include "srla_stdint.h"
+
+/* x86系ではSIMD命令セットごとの実装を並べてコンパイルし、ハンドル作成時に実行環境に合わせて選択する
+ * SRLA_DISABLE_SIMDを定義するとスカラー実装のみを使用する */
+#if !defined(SRLA_DISABLE_SIMD) \
+    && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+#define SRLA_ENABLE_X86_SIMD
+#endif
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#define DECLALIGN(x) __declspec(align(x))
+/* MSVCはコンパイルオプションによらず組み込み関数を使用できる */
+#define SRLA_TARGET_SSE41
+#define SRLA_TARGET_AVX2
+#define SRLA_TARGET_AVX512
+#else
+#include <x86intrin.h>
+#define DECLALIGN(x) __attribute__((aligned(x)))
+/* 関数単位で命令セットを指定し、ビルド全体には-mavx2等を付けずに済ませる */
+#define SRLA_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SRLA_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define SRLA_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+/* 実行時に選択するSIMD命令セット（上位の命令セットは下位を包含する） */
+typedef enum SRLASIMDInstructionSetTag {
+    SRLA_SIMD_NONE = 0, /* SIMD命令を使わない */
+    SRLA_SIMD_SSE41, /* SSE4.1 */
+    SRLA_SIMD_AVX2, /* AVX2（FMAを含む） */
+    SRLA_SIMD_AVX512 /* AVX-512F */
+} SRLASIMDInstructionSet;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 実行環境（CPUとOS）で使用できる最上位のSIMD命令セットを判定 */
+SRLASIMDInstructionSet SRLASIMD_DetectInstructionSet(void);
+
+/* 命令セット名から命令セットを取得 名前が不正な場合は0を返す */
+int32_t SRLASIMD_ParseInstructionSetName(const char *name, SRLASIMDInstructionSet *instruction_set);
+
+/* ハンドルで使用するSIMD命令セットを取得
+ * 環境変数SRLA_SIMD（none, sse41, avx2, avx512）で上限を指定できる（テスト用） */
+SRLASIMDInstructionSet SRLASIMD_GetInstructionSet(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRLASIMD_H_INCLUDED */
@@ -0,0 +1,23 @@
+#ifndef SRLATHREAD_H_INCLUDED
+#define SRLATHREAD_H_INCLUDED
+
+#include "srla_stdint.h"
+#include "srla_internal.h"
+
+/* スレッドで実行する関数 */
+typedef void (*SRLAThreadFunction)(void *arg);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 関数を複数スレッドで並列実行し、全スレッドの終了を待つ
+ * args[i]をi番目のスレッドの引数として渡す。args[0]は呼び出しスレッド自身で実行する */
+SRLAError SRLAThread_ExecuteParallel(
+    SRLAThreadFunction function, void *const *args, uint32_t num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRLATHREAD_H_INCLUDED */
@@ -33,6 +33,21 @@
 #define SRLAUTILITY_UINT32_TO_SINT32(uint) ((int32_t)((uint) >> 1) ^ -(int32_t)((uint) & 1))
 /* 絶対値の取得 */
 #define SRLAUTILITY_ABS(val)               (((val) > 0) ? (val) : -(val))
+/* 3バイト詰め（リトルエンディアン）の24bit整数の取得 */
+#define SRLAUTILITY_GET_INT24LE(ptr)\
+    ((int32_t)SRLAUTILITY_SHIFT_RIGHT_ARITHMETIC((int32_t)(((uint32_t)(ptr)[0] << 8)\
+        | ((uint32_t)(ptr)[1] << 16) | ((uint32_t)(ptr)[2] << 24)), 8))
+/* 3バイト詰め（リトルエンディアン）で24bit整数を書き込み */
+#define SRLAUTILITY_PUT_INT24LE(ptr, val)\
+    do {\
+        const uint32_t __uval = (uint32_t)((int32_t)(val));\
+        (ptr)[0] = (uint8_t)((__uval >>  0) & 0xFFU);\
+        (ptr)[1] = (uint8_t)((__uval >>  8) & 0xFFU);\
+        (ptr)[2] = (uint8_t)((__uval >> 16) & 0xFFU);\
+    } while (0)
+/* インターリーブPCM形式のサンプルあたりビット数 */
+#define SRLAUTILITY_PCM_FORMAT_BITS_PER_SAMPLE(format)\
+    (((format) == SRLA_PCM_FORMAT_INT16) ? 16U : (((format) == SRLA_PCM_FORMAT_INT24) ? 24U : 32U))
 
 /* NLZ（最上位ビットから1に当たるまでのビット数）の計算 */
 #if defined(__GNUC__)
@@ -113,6 +128,9 @@ uint32_t SRLAUtility_NLZSoft(uint32_t val);
 /* 2の冪乗に切り上げる */
 uint32_t SRLAUtility_RoundUp2PoweredSoft(uint32_t val);
 
+/* ワークサイズにnum_elements個のelement_sizeの領域を加算 オーバーフローする場合は-1を返す */
+int32_t SRLAUtility_AddWorkSize(int32_t work_size, uint32_t num_elements, int32_t element_size);
+
 /* LR -> MS (in-place) */
 void SRLAUtility_LRtoMSConversion(int32_t **buffer, uint32_t num_samples);
 
@@ -142,6 +160,9 @@ void SRLAPreemphasisFilter_Initialize(struct SRLAPreemphasisFilter *preem);
 void SRLAPreemphasisFilter_CalculateCoefficient(
     struct SRLAPreemphasisFilter *preem, const int32_t *data, uint32_t num_samples);
 
+/* 窓なしの自己相関（ラグ0, 1）から固定小数化したプリエンファシスフィルタの係数を計算 */
+int32_t SRLAPreemphasisFilter_CalculateCoefficientFromAutoCorrelation(double r0, double r1);
+
 /* 多段プリエンファシスの係数計算 */
 void SRLAPreemphasisFilter_CalculateMultiStageCoefficients(
     struct SRLAPreemphasisFilter *preem, uint32_t num_preem, const int32_t *buffer, uint32_t num_samples);
@@ -0,0 +1,132 @@
+#if defined(_MSC_VER)
+/* getenvの非推奨警告を抑制 */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include "srla_simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(SRLA_ENABLE_X86_SIMD) && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+/* 命令セット名の対応表 */
+static const struct {
+    const char *name;
+    SRLASIMDInstructionSet instruction_set;
+} st_instruction_set_names[] = {
+    { "none",   SRLA_SIMD_NONE   },
+    { "sse41",  SRLA_SIMD_SSE41  },
+    { "avx2",   SRLA_SIMD_AVX2   },
+    { "avx512", SRLA_SIMD_AVX512 },
+};
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* CPUID命令の実行 regs[0..3]にEAX,EBX,ECX,EDXを格納 */
+static void SRLASIMD_CPUID(uint32_t leaf, uint32_t subleaf, uint32_t *regs)
+{
+#if defined(_MSC_VER)
+    int tmp[4];
+    __cpuidex(tmp, (int)leaf, (int)subleaf);
+    regs[0] = (uint32_t)tmp[0]; regs[1] = (uint32_t)tmp[1];
+    regs[2] = (uint32_t)tmp[2]; regs[3] = (uint32_t)tmp[3];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    __cpuid_count(leaf, subleaf, eax, ebx, ecx, edx);
+    regs[0] = eax; regs[1] = ebx; regs[2] = ecx; regs[3] = edx;
+#endif
+}
+
+/* XCR0（OSが退避/復帰するレジスタ状態）の取得 */
+static uint32_t SRLASIMD_GetXCR0(void)
+{
+#if defined(_MSC_VER)
+    return (uint32_t)_xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return eax;
+#endif
+}
+#endif
+
+/* 実行環境（CPUとOS）で使用できる最上位のSIMD命令セットを判定 */
+SRLASIMDInstructionSet SRLASIMD_DetectInstructionSet(void)
+{
+#if defined(SRLA_ENABLE_X86_SIMD)
+    uint32_t regs[4], max_leaf, xcr0;
+
+    SRLASIMD_CPUID(0, 0, regs);
+    max_leaf = regs[0];
+    if (max_leaf < 1) {
+        return SRLA_SIMD_NONE;
+    }
+
+    /* SSE4.1: CPUID.1:ECX[19] */
+    SRLASIMD_CPUID(1, 0, regs);
+    if (!(regs[2] & (1UL << 19))) {
+        return SRLA_SIMD_NONE;
+    }
+
+    /* AVX系はOSがYMM/ZMMレジスタを退避するか（OSXSAVE, XCR0）も確認する
+     * FMA: CPUID.1:ECX[12] はAVX2とあわせて要求する */
+    if (!(regs[2] & (1UL << 27)) || !(regs[2] & (1UL << 28))
+            || !(regs[2] & (1UL << 12)) || (max_leaf < 7)) {
+        return SRLA_SIMD_SSE41;
+    }
+    xcr0 = SRLASIMD_GetXCR0();
+    if ((xcr0 & 0x6) != 0x6) {
+        return SRLA_SIMD_SSE41;
+    }
+
+    /* AVX2: CPUID.(7,0):EBX[5] */
+    SRLASIMD_CPUID(7, 0, regs);
+    if (!(regs[1] & (1UL << 5))) {
+        return SRLA_SIMD_SSE41;
+    }
+
+    /* AVX-512F: CPUID.(7,0):EBX[16]、XCR0のopmask/ZMM状態 */
+    if (!(regs[1] & (1UL << 16)) || ((xcr0 & 0xE0) != 0xE0)) {
+        return SRLA_SIMD_AVX2;
+    }
+
+    return SRLA_SIMD_AVX512;
+#else
+    return SRLA_SIMD_NONE;
+#endif
+}
+
+/* 命令セット名から命令セットを取得 名前が不正な場合は0を返す */
+int32_t SRLASIMD_ParseInstructionSetName(const char *name, SRLASIMDInstructionSet *instruction_set)
+{
+    uint32_t i;
+
+    if ((name == NULL) || (instruction_set == NULL)) {
+        return 0;
+    }
+
+    for (i = 0; i < sizeof(st_instruction_set_names) / sizeof(st_instruction_set_names[0]); i++) {
+        if (strcmp(name, st_instruction_set_names[i].name) == 0) {
+            (*instruction_set) = st_instruction_set_names[i].instruction_set;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/* ハンドルで使用するSIMD命令セットを取得 */
+SRLASIMDInstructionSet SRLASIMD_GetInstructionSet(void)
+{
+    const SRLASIMDInstructionSet detected = SRLASIMD_DetectInstructionSet();
+    SRLASIMDInstructionSet request;
+
+    /* 環境変数による指定は上限として扱い、実行環境で使えない命令セットは選ばない */
+    if (SRLASIMD_ParseInstructionSetName(getenv("SRLA_SIMD"), &request) && (request < detected)) {
+        return request;
+    }
+
+    return detected;
+}
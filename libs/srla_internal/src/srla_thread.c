@@ -0,0 +1,99 @@
+#include "srla_thread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* スレッド起動時に渡す関数と引数の組 */
+struct SRLAThreadTask {
+    SRLAThreadFunction function; /* 実行する関数 */
+    void *arg; /* 関数に渡す引数 */
+};
+
+/* 環境依存のスレッドハンドル */
+#if defined(_WIN32)
+typedef HANDLE SRLAThreadHandle;
+#else
+typedef pthread_t SRLAThreadHandle;
+#endif
+
+/* スレッドのエントリ関数 */
+#if defined(_WIN32)
+static DWORD WINAPI SRLAThread_Entry(LPVOID arg)
+{
+    struct SRLAThreadTask *task = (struct SRLAThreadTask *)arg;
+    task->function(task->arg);
+    return 0;
+}
+#else
+static void *SRLAThread_Entry(void *arg)
+{
+    struct SRLAThreadTask *task = (struct SRLAThreadTask *)arg;
+    task->function(task->arg);
+    return NULL;
+}
+#endif
+
+/* スレッドの起動 成功時は1を返す */
+static int SRLAThread_Start(SRLAThreadHandle *handle, struct SRLAThreadTask *task)
+{
+#if defined(_WIN32)
+    (*handle) = CreateThread(NULL, 0, SRLAThread_Entry, task, 0, NULL);
+    return ((*handle) != NULL) ? 1 : 0;
+#else
+    return (pthread_create(handle, NULL, SRLAThread_Entry, task) == 0) ? 1 : 0;
+#endif
+}
+
+/* スレッドの終了待ち */
+static void SRLAThread_Join(SRLAThreadHandle handle)
+{
+#if defined(_WIN32)
+    WaitForSingleObject(handle, INFINITE);
+    CloseHandle(handle);
+#else
+    pthread_join(handle, NULL);
+#endif
+}
+
+/* 関数を複数スレッドで並列実行し、全スレッドの終了を待つ */
+SRLAError SRLAThread_ExecuteParallel(
+    SRLAThreadFunction function, void *const *args, uint32_t num_threads)
+{
+    uint32_t i;
+    SRLAThreadHandle handles[SRLA_MAX_NUM_THREADS];
+    struct SRLAThreadTask tasks[SRLA_MAX_NUM_THREADS];
+    uint8_t started[SRLA_MAX_NUM_THREADS];
+
+    /* 引数チェック */
+    if ((function == NULL) || (args == NULL)) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+    if ((num_threads == 0) || (num_threads > SRLA_MAX_NUM_THREADS)) {
+        return SRLA_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* 2番目以降の処理をスレッドに割り当てて起動 */
+    for (i = 1; i < num_threads; i++) {
+        tasks[i].function = function;
+        tasks[i].arg = args[i];
+        started[i] = (uint8_t)SRLAThread_Start(&handles[i], &tasks[i]);
+    }
+
+    /* 先頭の処理は呼び出しスレッドで実行 */
+    function(args[0]);
+
+    /* 終了待ち */
+    for (i = 1; i < num_threads; i++) {
+        if (started[i]) {
+            SRLAThread_Join(handles[i]);
+        } else {
+            /* スレッドを起動できなかった処理はここで実行 */
+            function(args[i]);
+        }
+    }
+
+    return SRLA_ERROR_OK;
+}
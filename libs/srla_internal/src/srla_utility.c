@@ -87,6 +87,19 @@ uint32_t SRLAUtility_RoundUp2PoweredSoft(uint32_t val)
     return val + 1;
 }
 
+/* ワークサイズにnum_elements個のelement_sizeの領域を加算 オーバーフローする場合は-1を返す */
+int32_t SRLAUtility_AddWorkSize(int32_t work_size, uint32_t num_elements, int32_t element_size)
+{
+    SRLA_ASSERT(work_size >= 0);
+    SRLA_ASSERT(element_size >= 0);
+
+    if ((element_size > 0) && (num_elements > (uint32_t)((INT32_MAX - work_size) / element_size))) {
+        return -1;
+    }
+
+    return work_size + (int32_t)num_elements * element_size;
+}
+
 /* LR -> MS (in-place) */
 void SRLAUtility_LRtoMSConversion(int32_t **buffer, uint32_t num_samples)
 {
@@ -217,7 +230,6 @@ void SRLAPreemphasisFilter_CalculateCoefficient(
     uint32_t i;
     double r0, r1;
     double curr, succ;
-    double double_coef;
 
     SRLA_ASSERT(preem != NULL);
     SRLA_ASSERT(data != NULL);
@@ -240,20 +252,25 @@ void SRLAPreemphasisFilter_CalculateCoefficient(
     r0 += curr * curr;
     SRLA_ASSERT(r0 >= r1);
 
+    preem->coef = SRLAPreemphasisFilter_CalculateCoefficientFromAutoCorrelation(r0, r1);
+}
+
+/* 窓なしの自己相関（ラグ0, 1）から固定小数化したプリエンファシスフィルタの係数を計算 */
+int32_t SRLAPreemphasisFilter_CalculateCoefficientFromAutoCorrelation(double r0, double r1)
+{
+    int32_t coef;
+
     /* 分散が小さい場合は0を設定 */
     if (r0 < 1e-6) {
-        preem->coef = 0;
-        return;
+        return 0;
     }
 
     /* 係数計算・固定小数化 */
-    {
-        const double double_coef = r1 / r0;
-        int32_t coef = (int32_t)SRLAUtility_Round(double_coef * pow(2.0f, SRLA_PREEMPHASIS_COEF_SHIFT));
-        /* 丸め込み */
-        coef = SRLAUTILITY_INNER_VALUE(coef, -(1 << SRLA_PREEMPHASIS_COEF_SHIFT), (1 << SRLA_PREEMPHASIS_COEF_SHIFT) - 1);
-        preem->coef = coef;
-    }
+    coef = (int32_t)SRLAUtility_Round((r1 / r0) * pow(2.0f, SRLA_PREEMPHASIS_COEF_SHIFT));
+    /* 丸め込み */
+    coef = SRLAUTILITY_INNER_VALUE(coef, -(1 << SRLA_PREEMPHASIS_COEF_SHIFT), (1 << SRLA_PREEMPHASIS_COEF_SHIFT) - 1);
+
+    return coef;
 }
 
 /* 多段プリエンファシスの係数計算 */
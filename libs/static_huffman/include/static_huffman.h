@@ -6,6 +6,10 @@
 
 /* 符号化するシンボルの最大数 */
 #define STATICHUFFMAN_MAX_NUM_SYMBOLS 256
+/* 復号テーブルの1段目で一度に参照するビット数 */
+#define STATICHUFFMAN_DECODE_TABLE_BITS 10
+/* 復号テーブルの2段目以降（内部ノード毎のテーブル）で一度に参照するビット数 */
+#define STATICHUFFMAN_DECODE_SUBTABLE_BITS 4
 
 /* ハフマン木 */
 struct StaticHuffmanTree {
@@ -26,6 +30,16 @@ struct StaticHuffmanCodes {
     } codes[STATICHUFFMAN_MAX_NUM_SYMBOLS];  /* 各シンボルの符号              */
 };
 
+/* ハフマン符号の復号テーブル */
+struct StaticHuffmanDecodeTable {
+    uint32_t num_symbols;                       /* 符号化シンボル数 */
+    struct {
+        uint16_t node;                          /* 参照ビットを辿った先のノード（シンボル数未満なら復号したシンボル） */
+        uint8_t bit_count;                      /* 辿ったビット数 */
+    } entries[1 << STATICHUFFMAN_DECODE_TABLE_BITS], /* 根から辿る1段目テーブル */
+      sub_entries[STATICHUFFMAN_MAX_NUM_SYMBOLS - 1][1 << STATICHUFFMAN_DECODE_SUBTABLE_BITS]; /* 内部ノードから辿る2段目以降のテーブル */
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -46,6 +60,15 @@ void StaticHuffman_PutCode(
 uint32_t StaticHuffman_GetCode(
         const struct StaticHuffmanTree *tree, struct BitStream *stream);
 
+/* ハフマン木から復号テーブルを作成 */
+void StaticHuffman_BuildDecodeTable(
+        const struct StaticHuffmanTree *tree, struct StaticHuffmanDecodeTable *table);
+
+/* 復号テーブルを使用したハフマン符号の取得
+ * StaticHuffman_GetCodeと同じ結果を複数ビット単位の表引きで得る */
+uint32_t StaticHuffman_GetCodeByTable(
+        const struct StaticHuffmanDecodeTable *table, struct BitStream *stream);
+
 #ifdef __cplusplus
 }
 #endif
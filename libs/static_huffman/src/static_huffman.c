@@ -163,3 +163,78 @@ uint32_t StaticHuffman_GetCode(
 
     return node;
 }
+
+/* 復号テーブルのエントリ作成: nodeから始めてnbitsのビット列patternを葉に達するまで辿る */
+static void StaticHuffman_TraceTree(
+    const struct StaticHuffmanTree *tree, uint32_t node, uint32_t pattern, uint32_t nbits,
+    uint16_t *end_node, uint8_t *bit_count)
+{
+    uint32_t count = 0;
+
+    assert(tree != NULL);
+    assert((end_node != NULL) && (bit_count != NULL));
+
+    while ((node >= tree->num_symbols) && (count < nbits)) {
+        const uint32_t bit = (pattern >> (nbits - count - 1)) & 1;
+        node = (bit == 0) ? tree->nodes[node].node_0 : tree->nodes[node].node_1;
+        count++;
+    }
+
+    (*end_node) = (uint16_t)node;
+    (*bit_count) = (uint8_t)count;
+}
+
+/* ハフマン木から復号テーブルを作成 */
+void StaticHuffman_BuildDecodeTable(
+    const struct StaticHuffmanTree *tree, struct StaticHuffmanDecodeTable *table)
+{
+    uint32_t node, pattern;
+
+    assert((tree != NULL) && (table != NULL));
+    assert(tree->num_symbols <= STATICHUFFMAN_MAX_NUM_SYMBOLS);
+
+    table->num_symbols = tree->num_symbols;
+
+    /* 根から全てのビットパターンを辿る */
+    for (pattern = 0; pattern < (1 << STATICHUFFMAN_DECODE_TABLE_BITS); pattern++) {
+        StaticHuffman_TraceTree(tree, tree->root_node, pattern, STATICHUFFMAN_DECODE_TABLE_BITS,
+            &table->entries[pattern].node, &table->entries[pattern].bit_count);
+    }
+
+    /* 1段目で葉に達しない長い符号のため、各内部ノードから辿る */
+    /* 内部ノードのインデックスはシンボル数から根までの範囲 */
+    for (node = tree->num_symbols; node <= tree->root_node; node++) {
+        for (pattern = 0; pattern < (1 << STATICHUFFMAN_DECODE_SUBTABLE_BITS); pattern++) {
+            StaticHuffman_TraceTree(tree, node, pattern, STATICHUFFMAN_DECODE_SUBTABLE_BITS,
+                &table->sub_entries[node - tree->num_symbols][pattern].node,
+                &table->sub_entries[node - tree->num_symbols][pattern].bit_count);
+        }
+    }
+}
+
+/* 復号テーブルを使用したハフマン符号の取得 */
+uint32_t StaticHuffman_GetCodeByTable(
+    const struct StaticHuffmanDecodeTable *table, struct BitStream *stream)
+{
+    uint32_t node, bits;
+
+    assert(table != NULL);
+    assert(stream != NULL);
+
+    /* 1段目: 大部分の符号はここで確定する */
+    BitReader_PeekBits(stream, &bits, STATICHUFFMAN_DECODE_TABLE_BITS);
+    node = table->entries[bits].node;
+    BitReader_SkipBits(stream, table->entries[bits].bit_count);
+
+    /* 長い符号は到達した内部ノードから表引きを続ける */
+    while (node >= table->num_symbols) {
+        const uint32_t index = node - table->num_symbols;
+        BitReader_PeekBits(stream, &bits, STATICHUFFMAN_DECODE_SUBTABLE_BITS);
+        node = table->sub_entries[index][bits].node;
+        BitReader_SkipBits(stream, table->sub_entries[index][bits].bit_count);
+    }
+
+    assert(node < table->num_symbols);
+
+    return node;
+}
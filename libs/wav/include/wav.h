@@ -56,6 +56,14 @@ struct WAVFile {
 /* アクセサ */
 #define WAVFile_PCM(wavfile, samp, ch)  (wavfile->data[(ch)][(samp)])
 
+/* ストリーミング読み込みハンドル
+ * ファイル全体を読み込まず、要求されたサンプル数ずつPCMを取り出す */
+struct WAVStreamReader;
+
+/* ストリーミング書き出しハンドル
+ * チャンネル毎の配列を受け取るたびにインターリーブして書き出す */
+struct WAVStreamWriter;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -77,6 +85,43 @@ WAVApiResult WAV_WriteToFile(
 WAVApiResult WAV_GetWAVFormatFromFile(
         const char* filename, struct WAVFormat* format);
 
+/* ストリーミング読み込みハンドルの作成
+ * ヘッダを解釈し、PCMデータの先頭に位置づけた状態で返す 失敗時はNULLを返す
+ * max_num_samples_per_readは1回の読み込みで要求できる最大サンプル数
+ * RF64形式（ds64チャンク）にも対応するが、サンプル数は32bitに収まる必要がある */
+struct WAVStreamReader* WAVStreamReader_Open(
+        const char* filename, uint32_t max_num_samples_per_read);
+
+/* ストリーミング読み込みハンドルの破棄 */
+void WAVStreamReader_Close(struct WAVStreamReader* reader);
+
+/* フォーマットの取得 */
+WAVApiResult WAVStreamReader_GetFormat(
+        const struct WAVStreamReader* reader, struct WAVFormat* format);
+
+/* 現在位置から最大num_samplesサンプルを読み込み、チャンネル毎の配列bufferに書き出す
+ * num_read_samplesには実際に読み込んだサンプル数を返す（末尾では要求より少なくなり、終端に達していれば0） */
+WAVApiResult WAVStreamReader_Read(
+        struct WAVStreamReader* reader, WAVPcmData** buffer, uint32_t num_samples, uint32_t* num_read_samples);
+
+/* 読み込み位置をサンプル単位で移動 */
+WAVApiResult WAVStreamReader_Seek(
+        struct WAVStreamReader* reader, uint32_t sample_offset);
+
+/* ストリーミング書き出しハンドルの作成
+ * formatに従ってヘッダを書き出した状態で返す 失敗時はNULLを返す
+ * max_num_samples_per_writeは1回の書き出しで渡せる最大サンプル数 */
+struct WAVStreamWriter* WAVStreamWriter_Open(
+        const char* filename, const struct WAVFormat* format, uint32_t max_num_samples_per_write);
+
+/* ストリーミング書き出しハンドルの破棄
+ * 書き出したサンプル数がformatのサンプル数と異なる場合はヘッダを書き直してから閉じる */
+WAVApiResult WAVStreamWriter_Close(struct WAVStreamWriter* writer);
+
+/* チャンネル毎の配列bufferからnum_samplesサンプルを書き出し */
+WAVApiResult WAVStreamWriter_Write(
+        struct WAVStreamWriter* writer, const WAVPcmData* const* buffer, uint32_t num_samples);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,10 @@
+/* 64bitオフセットのfseekoを使うためにPOSIXの機能を有効化 */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include "wav.h"
+#include "srla_simd.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,6 +22,19 @@
 /* a,bの内の小さい値を取得 */
 #define WAV_Min(a, b) (((a) < (b)) ? (a) : (b))
 
+/* PCM変換で一度に処理するサンプル値の数（全チャンネル合計） */
+#define WAV_CONVERT_UNIT_SIZE 1024
+
+/* PCMデータ書き出しの1回あたりのバイト数 */
+#define WAV_PCM_WRITE_BUFFER_SIZE (1024 * 1024)
+
+/* 64bitオフセットでのシーク（2GBを越えるファイルに対応するため） */
+#if defined(_WIN32)
+#define WAV_FSeek64(fp, offset, wherefrom) _fseeki64((fp), (__int64)(offset), (wherefrom))
+#else
+#define WAV_FSeek64(fp, offset, wherefrom) fseeko((fp), (off_t)(offset), (wherefrom))
+#endif
+
 /* 内部エラー型 */
 typedef enum {
     WAV_ERROR_OK = 0,             /* OK */
@@ -39,10 +58,25 @@ struct WAVBitBuffer {
     int32_t byte_pos; /* バイト列読み込み位置 */
 };
 
+/* PCM変換関数 */
+struct WAVConvertFunctions {
+    /* インターリーブされたPCMバイト列を32bit整数列に変換 */
+    void (*bytes_to_int32)(
+        const uint8_t *data, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, int32_t *output);
+    /* 32bit整数列をインターリーブされたPCMバイト列に変換 */
+    void (*int32_to_bytes)(
+        const int32_t *input, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data);
+    /* ステレオのインターリーブ列をチャンネル毎に分配 */
+    void (*deinterleave_stereo)(const int32_t *values, uint32_t num_values, int32_t *lch, int32_t *rch);
+    /* チャンネル毎の配列をステレオのインターリーブ列にまとめる */
+    void (*interleave_stereo)(const int32_t *lch, const int32_t *rch, uint32_t num_values, int32_t *values);
+};
+
 /* パーサ */
 struct WAVParser {
     FILE *fp;       /* 読み込みファイルポインタ */
     struct WAVBitBuffer buffer;   /* ビットバッファ */
+    const struct WAVConvertFunctions *convert; /* 実行環境に合わせて選択したPCM変換関数 */
 };
 
 /* ライタ */
@@ -51,6 +85,34 @@ struct WAVWriter {
     uint32_t bit_buffer;         /* 出力途中のビット */
     uint32_t bit_count;          /* 出力カウント     */
     struct WAVBitBuffer buffer;   /* ビットバッファ */
+    const struct WAVConvertFunctions *convert; /* 実行環境に合わせて選択したPCM変換関数 */
+};
+
+/* ストリーミング読み込みハンドル */
+struct WAVStreamReader {
+    FILE *fp; /* 読み込みファイルポインタ */
+    struct WAVFormat format; /* フォーマット */
+    uint64_t data_offset; /* PCMデータ先頭のファイル内位置 */
+    uint32_t bytes_per_sample; /* サンプルあたりバイト数 */
+    uint32_t block_align; /* 全チャンネル1サンプル分のバイト数 */
+    uint8_t big_endian; /* PCMがビッグエンディアンで格納されているか？ */
+    uint32_t position; /* 次に読み込むサンプル位置 */
+    uint32_t max_num_samples_per_read; /* 1回の読み込みで要求できる最大サンプル数 */
+    uint8_t *buffer; /* 読み込みバッファ */
+    const struct WAVConvertFunctions *convert; /* 実行環境に合わせて選択したPCM変換関数 */
+};
+
+/* ストリーミング書き出しハンドル */
+struct WAVStreamWriter {
+    FILE *fp; /* 書き込みファイルポインタ */
+    struct WAVFormat format; /* フォーマット */
+    uint32_t bytes_per_sample; /* サンプルあたりバイト数 */
+    uint32_t block_align; /* 全チャンネル1サンプル分のバイト数 */
+    uint8_t big_endian; /* PCMをビッグエンディアンで格納するか？ */
+    uint32_t num_written_samples; /* 書き出したサンプル数 */
+    uint32_t max_num_samples_per_write; /* 1回の書き出しで渡せる最大サンプル数 */
+    uint8_t *buffer; /* 書き出しバッファ */
+    const struct WAVConvertFunctions *convert; /* 実行環境に合わせて選択したPCM変換関数 */
 };
 
 /* パーサの初期化 */
@@ -60,7 +122,7 @@ static void WAVParser_Finalize(struct WAVParser* parser);
 /* n_bit 取得し、結果を右詰めする */
 static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uint64_t* bitsbuf);
 /* シーク（fseek準拠） */
-static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t wherefrom);
+static WAVError WAVParser_Seek(struct WAVParser* parser, int64_t offset, int32_t wherefrom);
 /* ファイル種別の判定 */
 static WAVFileType WAVParser_IdentifyFileType(struct WAVParser *parser);
 /* ライタの初期化 */
@@ -115,6 +177,15 @@ static WAVError WAVParser_GetWAVPcmData(
 /* AIFFファイルのPCMデータを読み取り */
 static WAVError WAVParser_GetAIFFPcmData(
     struct WAVParser *parser, struct WAVFile *wavfile);
+/* バイト境界からバイト列をまとめて取得 */
+static WAVError WAVParser_GetBytes(
+    struct WAVParser *parser, uint8_t *data, uint32_t size);
+/* PCMデータをまとめて読み取り */
+static WAVError WAVParser_GetPcmData(
+    struct WAVParser *parser, struct WAVFile *wavfile, uint8_t big_endian);
+/* PCMデータをまとめて出力 */
+static WAVError WAVWriter_PutPcmData(
+    struct WAVWriter *writer, const struct WAVFile *wavfile, uint8_t big_endian);
 
 /* 8bitPCM形式を32bit形式に変換 */
 static int32_t WAV_Convert8bitPCMto32bitPCM(int32_t in_8bitpcm);
@@ -126,6 +197,24 @@ static int32_t WAV_Convert24bitPCMto32bitPCM(int32_t in_24bitpcm);
 static int32_t WAV_Convert32bitPCMto32bitPCM(int32_t in_32bitpcm);
 /* 32bitPCM形式を32bit形式に変換 */
 static int32_t WAV_Convert32bitPCMto32bitPCM(int32_t in_32bitpcm);
+/* インターリーブされたPCMバイト列を32bit整数列に変換 */
+static void WAV_ConvertBytesToInt32(
+    const uint8_t *data, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, int32_t *output);
+/* 命令セットに対応するPCM変換関数を取得 */
+static const struct WAVConvertFunctions *WAV_GetConvertFunctions(SRLASIMDInstructionSet instruction_set);
+/* インターリーブされたPCMバイト列をチャンネル毎の32bit整数配列に変換 */
+static void WAV_ConvertInterleavedPCMToPlanar(
+    const struct WAVConvertFunctions *functions,
+    const uint8_t *data, uint32_t num_samples, uint32_t num_channels, uint32_t bytes_per_sample,
+    uint8_t big_endian, WAVPcmData **buffer, uint32_t buffer_offset);
+/* 32bit整数列をインターリーブされたPCMバイト列に変換 */
+static void WAV_ConvertInt32ToBytes(
+    const int32_t *input, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data);
+/* チャンネル毎の32bit整数配列をインターリーブされたPCMバイト列に変換 */
+static void WAV_ConvertPlanarToInterleavedPCM(
+    const struct WAVConvertFunctions *functions,
+    const WAVPcmData *const *buffer, uint32_t buffer_offset, uint32_t num_samples, uint32_t num_channels,
+    uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data);
 
 /* AIFFのサンプリングレートを取得 */
 static WAVError WAV_ParseAIFFSamplingRate(const uint8_t *data, size_t data_size, double *sampling_rate);
@@ -264,7 +353,7 @@ static WAVError WAVParser_GetWAVFormat(
                 return WAV_ERROR_IO;
             }
             fprintf(stderr, "WARNING: skiping chunk:%s size:%d \n", string_buf, (int32_t)bitsbuf);
-            WAVParser_Seek(parser, (int32_t)bitsbuf, SEEK_CUR);
+            WAVParser_Seek(parser, (int64_t)bitsbuf, SEEK_CUR);
         }
     }
 
@@ -423,7 +512,7 @@ static WAVError WAVParser_GetAIFFFormat(
             if (WAVParser_GetBigEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) {
                 return WAV_ERROR_IO;
             }
-            WAVParser_Seek(parser, (int32_t)bitsbuf, SEEK_CUR);
+            WAVParser_Seek(parser, (int64_t)bitsbuf, SEEK_CUR);
         } else {
             /* 他のチャンクはサイズだけ取得してシークにより読み飛ばす */
             if (WAVParser_GetBigEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) {
@@ -434,7 +523,7 @@ static WAVError WAVParser_GetAIFFFormat(
                 bitsbuf += 1;
             }
             fprintf(stderr, "WARNING: skiping chunk:%s size:%d \n", string_buf, (int32_t)bitsbuf);
-            WAVParser_Seek(parser, (int32_t)bitsbuf, SEEK_CUR);
+            WAVParser_Seek(parser, (int64_t)bitsbuf, SEEK_CUR);
         }
     }
 
@@ -479,9 +568,7 @@ static WAVError WAVParser_GetAIFFFormat(
 static WAVError WAVParser_GetWAVPcmData(
     struct WAVParser *parser, struct WAVFile *wavfile)
 {
-    uint32_t ch, sample, bytes_per_sample;
     uint64_t bitsbuf;
-    int32_t(*convert_to_sint32_func)(int32_t);
 
     /* 引数チェック */
     if ((parser == NULL) || (wavfile == NULL)) {
@@ -517,51 +604,19 @@ static WAVError WAVParser_GetWAVPcmData(
             if (WAVParser_GetLittleEndianBytes(parser, 4, &bitsbuf) != WAV_ERROR_OK) {
                 return WAV_ERROR_IO;
             }
-            WAVParser_Seek(parser, (int32_t)bitsbuf, SEEK_CUR);
+            WAVParser_Seek(parser, (int64_t)bitsbuf, SEEK_CUR);
         }
     }
 
-    /* ビット深度に合わせてPCMデータの変換関数を決定 */
-    switch (wavfile->format.bits_per_sample) {
-    case 8:
-        convert_to_sint32_func = WAV_Convert8bitPCMto32bitPCM;
-        break;
-    case 16:
-        convert_to_sint32_func = WAV_Convert16bitPCMto32bitPCM;
-        break;
-    case 24:
-        convert_to_sint32_func = WAV_Convert24bitPCMto32bitPCM;
-        break;
-    case 32:
-        convert_to_sint32_func = WAV_Convert32bitPCMto32bitPCM;
-        break;
-    default:
-        /* fprintf(stderr, "Unsupported bits per sample format(=%d). \n", wavfile->format.bits_per_sample); */
-        return WAV_ERROR_INVALID_FORMAT;
-    }
-
     /* データ読み取り */
-    bytes_per_sample = wavfile->format.bits_per_sample / 8;
-    for (sample = 0; sample < wavfile->format.num_samples; sample++) {
-        for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-            if (WAVParser_GetLittleEndianBytes(parser, bytes_per_sample, &bitsbuf) != WAV_ERROR_OK) {
-                return WAV_ERROR_IO;
-            }
-            /* 32bit整数形式に変形してデータにセット */
-            wavfile->data[ch][sample] = convert_to_sint32_func((int32_t)(bitsbuf));
-        }
-    }
-
-    return WAV_ERROR_OK;
+    return WAVParser_GetPcmData(parser, wavfile, 0);
 }
 
 /* AIFFファイルのPCMデータを読み取り */
 static WAVError WAVParser_GetAIFFPcmData(
         struct WAVParser* parser, struct WAVFile* wavfile)
 {
-    uint32_t ch, sample, bytes_per_sample;
     uint64_t bitsbuf;
-    int32_t (*convert_to_sint32_func)(int32_t);
 
     /* 引数チェック */
     if ((parser == NULL) || (wavfile == NULL)) {
@@ -609,42 +664,12 @@ static WAVError WAVParser_GetAIFFPcmData(
             if (bitsbuf & 1) {
                 bitsbuf += 1;
             }
-            WAVParser_Seek(parser, (int32_t)bitsbuf, SEEK_CUR);
+            WAVParser_Seek(parser, (int64_t)bitsbuf, SEEK_CUR);
         }
     }
 
-    /* ビット深度に合わせてPCMデータの変換関数を決定 */
-    switch (wavfile->format.bits_per_sample) {
-    case 8:
-        convert_to_sint32_func = WAV_Convert8bitPCMto32bitPCM;
-        break;
-    case 16:
-        convert_to_sint32_func = WAV_Convert16bitPCMto32bitPCM;
-        break;
-    case 24:
-        convert_to_sint32_func = WAV_Convert24bitPCMto32bitPCM;
-        break;
-    case 32:
-        convert_to_sint32_func = WAV_Convert32bitPCMto32bitPCM;
-        break;
-    default:
-        /* fprintf(stderr, "Unsupported bits per sample format(=%d). \n", wavfile->format.bits_per_sample); */
-        return WAV_ERROR_INVALID_FORMAT;
-    }
-
     /* データ読み取り */
-    bytes_per_sample = wavfile->format.bits_per_sample / 8;
-    for (sample = 0; sample < wavfile->format.num_samples; sample++) {
-        for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-            if (WAVParser_GetBigEndianBytes(parser, bytes_per_sample, &bitsbuf) != WAV_ERROR_OK) {
-                return WAV_ERROR_IO;
-            }
-            /* 32bit整数形式に変形してデータにセット */
-            wavfile->data[ch][sample] = convert_to_sint32_func((int32_t)(bitsbuf));
-        }
-    }
-
-    return WAV_ERROR_OK;
+    return WAVParser_GetPcmData(parser, wavfile, 1);
 }
 
 /* ファイルからWAVファイルフォーマットだけ読み取り */
@@ -837,178 +862,1079 @@ EXIT_FAILURE_WITH_DATA_RELEASE:
     return NULL;
 }
 
-/* 8bitPCM形式を32bit形式に変換 */
-static int32_t WAV_Convert8bitPCMto32bitPCM(int32_t in_8bitpcm)
+/* バイト列から値を取得 */
+static uint64_t WAV_GetEndianValue(const uint8_t *data, uint32_t nbytes, uint8_t big_endian)
 {
-    /* 無音に相当する128を引く */
-    return (in_8bitpcm - 128);
-}
+    uint32_t i_byte;
+    uint64_t ret = 0;
 
-/* 16bitPCM形式を32bit形式に変換 */
-static int32_t WAV_Convert16bitPCMto32bitPCM(int32_t in_16bitpcm)
-{
-    /* 一旦32bit幅にしてから算術右シフトで符号をつける */
-    return (in_16bitpcm << 16) >> 16;
-}
+    assert(nbytes <= 8);
 
-/* 24bitPCM形式を32bit形式に変換 */
-static int32_t WAV_Convert24bitPCMto32bitPCM(int32_t in_24bitpcm)
-{
-    /* 一旦32bit幅にしてから算術右シフトで符号をつける */
-    return (in_24bitpcm << 8) >> 8;
-}
+    for (i_byte = 0; i_byte < nbytes; i_byte++) {
+        if (big_endian) {
+            ret = (ret << 8) | data[i_byte];
+        } else {
+            ret |= (uint64_t)data[i_byte] << (8 * i_byte);
+        }
+    }
 
-/* 32bitPCM形式を32bit形式に変換 */
-static int32_t WAV_Convert32bitPCMto32bitPCM(int32_t in_32bitpcm)
-{
-    /* 何もしない */
-    return in_32bitpcm;
+    return ret;
 }
 
-/* パーサの初期化 */
-static void WAVParser_Initialize(struct WAVParser* parser, FILE* fp)
+/* チャンクヘッダ（IDとサイズ）を読み込み */
+static WAVError WAVStreamReader_GetChunkHeader(
+    FILE *fp, uint8_t big_endian, char *chunk_id, uint64_t *chunk_size)
 {
-    parser->fp = fp;
-    memset(&parser->buffer, 0, sizeof(struct WAVBitBuffer));
-    parser->buffer.byte_pos = -1;
-}
+    uint8_t buf[8];
 
-/* パーサの使用終了 */
-static void WAVParser_Finalize(struct WAVParser* parser)
-{
-    parser->fp = NULL;
-    memset(&parser->buffer, 0, sizeof(struct WAVBitBuffer));
-    parser->buffer.byte_pos = -1;
+    assert((fp != NULL) && (chunk_id != NULL) && (chunk_size != NULL));
+
+    if (fread(buf, sizeof(uint8_t), 8, fp) != 8) {
+        return WAV_ERROR_IO;
+    }
+    memcpy(chunk_id, buf, 4);
+    (*chunk_size) = WAV_GetEndianValue(&buf[4], 4, big_endian);
+
+    return WAV_ERROR_OK;
 }
 
-/* n_bit 取得し、結果を右詰めする */
-static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uint64_t* bitsbuf)
+/* WAV（RF64を含む）のヘッダを解釈し、PCMデータの位置とバイト数を取得 */
+static WAVError WAVStreamReader_ParseWAVHeader(
+    struct WAVStreamReader *reader, uint8_t is_rf64, uint64_t *data_size)
 {
-    uint64_t tmp;
-    struct WAVBitBuffer *buf = &(parser->buffer);
+    uint64_t pos, chunk_size, ds64_data_size = 0;
+    uint8_t fmt_chunk_exist = 0;
 
-    /* 引数チェック */
-    if ((parser == NULL) || (bitsbuf == NULL) || (n_bits > 64)) {
-        return WAV_ERROR_INVALID_PARAMETER;
-    }
+    assert((reader != NULL) && (data_size != NULL));
 
-    /* 初回読み込み */
-    if (buf->byte_pos == -1) {
-        if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+    /* RIFFヘッダの直後からチャンクを辿る */
+    pos = 12;
+    while (1) {
+        char chunk_id[4];
+        if (WAV_FSeek64(reader->fp, pos, SEEK_SET) != 0) {
             return WAV_ERROR_IO;
         }
-        buf->byte_pos   = 0;
-        buf->bit_count  = 8;
-    }
-
-    /* 最上位ビットからデータを埋めていく
-    * 初回ループではtmpの上位ビットにセット
-    * 2回目以降は8bit単位で入力しtmpにセット */
-    tmp = 0;
-    while (n_bits > buf->bit_count) {
-        /* 上位bitから埋めていく */
-        n_bits  -= buf->bit_count;
-        tmp     |= (uint64_t)WAV_GetLowerBits(buf->bit_count, buf->bytes[buf->byte_pos]) << n_bits;
-
-        /* 1バイト読み進める */
-        buf->byte_pos++;
-        buf->bit_count   = 8;
+        if (WAVStreamReader_GetChunkHeader(reader->fp, 0, chunk_id, &chunk_size) != WAV_ERROR_OK) {
+            return WAV_ERROR_IO;
+        }
+        pos += 8;
 
-        /* バッファが一杯ならば、再度読み込み */
-        if (buf->byte_pos == WAVBITBUFFER_BUFFER_SIZE) {
-            if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+        if (memcmp(chunk_id, "ds64", 4) == 0) {
+            /* RF64のサイズ情報 RIFFサイズ, dataチャンクサイズ, サンプル数（各64bit）の順 */
+            uint8_t buf[24];
+            if (!is_rf64 || (chunk_size < 24)) {
+                return WAV_ERROR_INVALID_FORMAT;
+            }
+            if (fread(buf, sizeof(uint8_t), 24, reader->fp) != 24) {
                 return WAV_ERROR_IO;
             }
-            buf->byte_pos = 0;
+            ds64_data_size = WAV_GetEndianValue(&buf[8], 8, 0);
+        } else if (memcmp(chunk_id, "fmt ", 4) == 0) {
+            /* サイズフィールドの位置から既存のパーサで解釈 */
+            struct WAVParser parser;
+            WAVError err;
+            if (WAV_FSeek64(reader->fp, pos - 4, SEEK_SET) != 0) {
+                return WAV_ERROR_IO;
+            }
+            WAVParser_Initialize(&parser, reader->fp);
+            err = WAVParser_ParseWAVFormat(&parser, &reader->format);
+            WAVParser_Finalize(&parser);
+            if (err != WAV_ERROR_OK) {
+                return err;
+            }
+            fmt_chunk_exist = 1;
+        } else if (memcmp(chunk_id, "data", 4) == 0) {
+            if (!fmt_chunk_exist) {
+                return WAV_ERROR_INVALID_FORMAT;
+            }
+            /* RF64ではサイズが32bitに収まらないときds64チャンクの値を使う */
+            if (is_rf64 && (chunk_size == 0xFFFFFFFFUL)) {
+                chunk_size = ds64_data_size;
+            }
+            reader->data_offset = pos;
+            (*data_size) = chunk_size;
+            return WAV_ERROR_OK;
         }
-    }
-
-    /* 端数ビットの処理
-    * 残ったビット分をtmpの最上位ビットにセット */
-    buf->bit_count -= n_bits;
-    tmp            |= (uint64_t)WAV_GetLowerBits(n_bits, (uint32_t)(buf->bytes[buf->byte_pos] >> buf->bit_count));
 
-    *bitsbuf = tmp;
-    return WAV_ERROR_OK;
+        /* 次のチャンクへ（チャンクは偶数バイト境界に揃えられる） */
+        pos += chunk_size + (chunk_size & 1);
+    }
 }
 
-/* シーク（fseek準拠） */
-static WAVError WAVParser_Seek(struct WAVParser* parser, int32_t offset, int32_t wherefrom)
+/* AIFFのヘッダを解釈し、PCMデータの位置とバイト数を取得 */
+static WAVError WAVStreamReader_ParseAIFFHeader(
+    struct WAVStreamReader *reader, uint64_t *data_size)
 {
-    assert(parser != NULL);
+    uint64_t pos, chunk_size;
+    struct WAVParser parser;
+    WAVError err;
 
-    /* バッファに取り込んだ分先読みしているので戻す */
-    if ((wherefrom == SEEK_CUR) && (parser->buffer.byte_pos != -1)) {
-        offset -= (WAVBITBUFFER_BUFFER_SIZE - (parser->buffer.byte_pos + 1));
+    assert((reader != NULL) && (data_size != NULL));
+
+    /* フォーマットは既存のパーサで解釈 */
+    if (WAV_FSeek64(reader->fp, 0, SEEK_SET) != 0) {
+        return WAV_ERROR_IO;
+    }
+    WAVParser_Initialize(&parser, reader->fp);
+    err = WAVParser_GetAIFFFormat(&parser, &reader->format);
+    WAVParser_Finalize(&parser);
+    if (err != WAV_ERROR_OK) {
+        return err;
     }
 
-    /* 移動 */
-    fseek(parser->fp, offset, wherefrom);
+    /* FORMヘッダの直後からSSNDチャンクを探す */
+    pos = 12;
+    while (1) {
+        char chunk_id[4];
+        if (WAV_FSeek64(reader->fp, pos, SEEK_SET) != 0) {
+            return WAV_ERROR_IO;
+        }
+        if (WAVStreamReader_GetChunkHeader(reader->fp, 1, chunk_id, &chunk_size) != WAV_ERROR_OK) {
+            return WAV_ERROR_IO;
+        }
+        pos += 8;
 
-    /* バッファをクリア */
-    parser->buffer.byte_pos = -1;
+        if (memcmp(chunk_id, "SSND", 4) == 0) {
+            /* オフセットバイトとブロックサイズ */
+            uint8_t buf[8];
+            uint64_t offset_size;
+            if (fread(buf, sizeof(uint8_t), 8, reader->fp) != 8) {
+                return WAV_ERROR_IO;
+            }
+            offset_size = WAV_GetEndianValue(&buf[0], 4, 1);
+            if (chunk_size < (8 + offset_size)) {
+                return WAV_ERROR_INVALID_FORMAT;
+            }
+            reader->data_offset = pos + 8 + offset_size;
+            (*data_size) = chunk_size - 8 - offset_size;
+            return WAV_ERROR_OK;
+        }
 
-    return WAV_ERROR_OK;
+        /* 次のチャンクへ（奇数サイズのチャンクは偶数に） */
+        pos += chunk_size + (chunk_size & 1);
+    }
 }
 
-/* ファイル種別の判定 */
-static WAVFileType WAVParser_IdentifyFileType(struct WAVParser *parser)
+/* ストリーミング読み込みハンドルの作成 */
+struct WAVStreamReader* WAVStreamReader_Open(
+        const char* filename, uint32_t max_num_samples_per_read)
 {
-    assert(parser != NULL);
+    struct WAVStreamReader *reader;
+    uint8_t riff_header[12];
+    uint64_t data_size, num_samples;
+    WAVError err;
 
-    /* WAVファイルだと思って判定 */
-    WAVParser_Seek(parser, 0, SEEK_SET);
-    do {
-        uint64_t tmp;
+    /* 引数チェック */
+    if ((filename == NULL) || (max_num_samples_per_read == 0)) {
+        return NULL;
+    }
 
-        /* ヘッダ 'R', 'I', 'F', 'F' をチェック */
-        if (WAVParser_CheckSignatureString(parser, "RIFF", 4) != WAV_ERROR_OK) {
-            break;
-        }
+    /* ハンドル作成 */
+    if ((reader = (struct WAVStreamReader *)malloc(sizeof(struct WAVStreamReader))) == NULL) {
+        return NULL;
+    }
+    memset(reader, 0, sizeof(struct WAVStreamReader));
+    reader->format.file_format = WAV_FILEFORMAT_INVALID;
+    reader->max_num_samples_per_read = max_num_samples_per_read;
+    reader->convert = WAV_GetConvertFunctions(SRLASIMD_GetInstructionSet());
 
-        /* ファイルサイズ-8（読み飛ばし） */
-        if (WAVParser_GetLittleEndianBytes(parser, 4, &tmp) != WAV_ERROR_OK) {
-            break;
-        }
+    /* ファイルを開く */
+    if ((reader->fp = fopen(filename, "rb")) == NULL) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
 
-        /* ヘッダ 'W', 'A', 'V', 'E' をチェック */
-        if (WAVParser_CheckSignatureString(parser, "WAVE", 4) != WAV_ERROR_OK) {
-            break;
+    /* ファイル種別を判定してヘッダを解釈 */
+    if (fread(riff_header, sizeof(uint8_t), 12, reader->fp) != 12) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    if (((memcmp(&riff_header[0], "RIFF", 4) == 0) || (memcmp(&riff_header[0], "RF64", 4) == 0))
+            && (memcmp(&riff_header[8], "WAVE", 4) == 0)) {
+        reader->big_endian = 0;
+        err = WAVStreamReader_ParseWAVHeader(reader, (memcmp(&riff_header[0], "RF64", 4) == 0), &data_size);
+    } else if ((memcmp(&riff_header[0], "FORM", 4) == 0) && (memcmp(&riff_header[8], "AIFF", 4) == 0)) {
+        reader->big_endian = 1;
+        err = WAVStreamReader_ParseAIFFHeader(reader, &data_size);
+    } else {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    if (err != WAV_ERROR_OK) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+
+    /* 対応しているビット深度か確認 */
+    switch (reader->format.bits_per_sample) {
+    case 8: case 16: case 24: case 32:
+        break;
+    default:
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    if (reader->format.num_channels == 0) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    reader->bytes_per_sample = reader->format.bits_per_sample / 8;
+    reader->block_align = reader->bytes_per_sample * reader->format.num_channels;
+
+    /* サンプル数: 波形データバイト数から算出 */
+    num_samples = data_size / reader->block_align;
+    if (reader->big_endian) {
+        /* AIFFはCOMMチャンクのサンプル数を使う データが足りない場合はエラー */
+        if (reader->format.num_samples > num_samples) {
+            goto EXIT_FAILURE_WITH_DATA_RELEASE;
+        }
+    } else {
+        /* 32bitに収まらないサンプル数は扱えない */
+        if (num_samples > 0xFFFFFFFFUL) {
+            goto EXIT_FAILURE_WITH_DATA_RELEASE;
         }
+        reader->format.num_samples = (uint32_t)num_samples;
+    }
 
-        return WAV_FILETYPE_WAV;
-    } while (0);
+    /* 読み込みバッファの確保 */
+    if (((uint64_t)reader->block_align * max_num_samples_per_read) > (uint64_t)((size_t)-1)) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    if ((reader->buffer = (uint8_t *)malloc((size_t)reader->block_align * max_num_samples_per_read)) == NULL) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
 
-    /* AIFFファイルだと思って判定 */
-    WAVParser_Seek(parser, 0, SEEK_SET);
-    do {
-        uint64_t tmp;
+    /* PCMデータ先頭に位置づける */
+    if (WAVStreamReader_Seek(reader, 0) != WAV_APIRESULT_OK) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
 
-        /* ヘッダ 'F', 'O', 'R', 'M' をチェック */
-        if (WAVParser_CheckSignatureString(parser, "FORM", 4) != WAV_ERROR_OK) {
-            break;
-        }
+    return reader;
 
-        /* ファイルサイズ-8（読み飛ばし） */
-        if (WAVParser_GetLittleEndianBytes(parser, 4, &tmp) != WAV_ERROR_OK) {
-            break;
-        }
+EXIT_FAILURE_WITH_DATA_RELEASE:
+    WAVStreamReader_Close(reader);
+    return NULL;
+}
 
-        /* ヘッダ 'A', 'I', 'F', 'F' をチェック */
-        if (WAVParser_CheckSignatureString(parser, "AIFF", 4) != WAV_ERROR_OK) {
-            break;
+/* ストリーミング読み込みハンドルの破棄 */
+void WAVStreamReader_Close(struct WAVStreamReader* reader)
+{
+    if (reader != NULL) {
+        if (reader->fp != NULL) {
+            fclose(reader->fp);
+        }
+        if (reader->buffer != NULL) {
+            free(reader->buffer);
         }
+        free(reader);
+    }
+}
 
-        return WAV_FILETYPE_AIFF;
-    } while (0);
+/* フォーマットの取得 */
+WAVApiResult WAVStreamReader_GetFormat(
+        const struct WAVStreamReader* reader, struct WAVFormat* format)
+{
+    /* 引数チェック */
+    if ((reader == NULL) || (format == NULL)) {
+        return WAV_APIRESULT_INVALID_PARAMETER;
+    }
 
-    return WAV_FILETYPE_INVALID;
+    (*format) = reader->format;
+
+    return WAV_APIRESULT_OK;
 }
 
-/* WAVファイルハンドルを破棄 */
-void WAV_Destroy(struct WAVFile* wavfile)
+/* 現在位置から最大num_samplesサンプルを読み込み */
+WAVApiResult WAVStreamReader_Read(
+        struct WAVStreamReader* reader, WAVPcmData** buffer, uint32_t num_samples, uint32_t* num_read_samples)
 {
-    uint32_t ch;
+    uint32_t num_read;
+
+    /* 引数チェック */
+    if ((reader == NULL) || (buffer == NULL) || (num_read_samples == NULL)
+            || (num_samples > reader->max_num_samples_per_read)) {
+        return WAV_APIRESULT_INVALID_PARAMETER;
+    }
+
+    /* 末尾を越えないサンプル数だけまとめて読み込み */
+    num_read = WAV_Min(num_samples, reader->format.num_samples - reader->position);
+    if (fread(reader->buffer, reader->block_align, num_read, reader->fp) != num_read) {
+        return WAV_APIRESULT_IOERROR;
+    }
+
+    /* 32bit整数形式に変形してチャンネル毎にセット */
+    WAV_ConvertInterleavedPCMToPlanar(reader->convert, reader->buffer, num_read, reader->format.num_channels,
+        reader->bytes_per_sample, reader->big_endian, buffer, 0);
+
+    reader->position += num_read;
+    (*num_read_samples) = num_read;
+
+    return WAV_APIRESULT_OK;
+}
+
+/* 読み込み位置をサンプル単位で移動 */
+WAVApiResult WAVStreamReader_Seek(
+        struct WAVStreamReader* reader, uint32_t sample_offset)
+{
+    /* 引数チェック */
+    if ((reader == NULL) || (sample_offset > reader->format.num_samples)) {
+        return WAV_APIRESULT_INVALID_PARAMETER;
+    }
+
+    if (WAV_FSeek64(reader->fp, reader->data_offset + (uint64_t)sample_offset * reader->block_align, SEEK_SET) != 0) {
+        return WAV_APIRESULT_IOERROR;
+    }
+    reader->position = sample_offset;
+
+    return WAV_APIRESULT_OK;
+}
+
+/* 8bitPCM形式を32bit形式に変換 */
+static int32_t WAV_Convert8bitPCMto32bitPCM(int32_t in_8bitpcm)
+{
+    /* 無音に相当する128を引く */
+    return (in_8bitpcm - 128);
+}
+
+/* 16bitPCM形式を32bit形式に変換 */
+static int32_t WAV_Convert16bitPCMto32bitPCM(int32_t in_16bitpcm)
+{
+    /* 一旦32bit幅にしてから算術右シフトで符号をつける */
+    return (in_16bitpcm << 16) >> 16;
+}
+
+/* 24bitPCM形式を32bit形式に変換 */
+static int32_t WAV_Convert24bitPCMto32bitPCM(int32_t in_24bitpcm)
+{
+    /* 一旦32bit幅にしてから算術右シフトで符号をつける */
+    return (in_24bitpcm << 8) >> 8;
+}
+
+/* 32bitPCM形式を32bit形式に変換 */
+static int32_t WAV_Convert32bitPCMto32bitPCM(int32_t in_32bitpcm)
+{
+    /* 何もしない */
+    return in_32bitpcm;
+}
+
+/* インターリーブされたPCMバイト列を32bit整数列に変換 */
+static void WAV_ConvertBytesToInt32(
+    const uint8_t *data, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, int32_t *output)
+{
+    uint32_t i;
+
+    assert(data != NULL);
+    assert(output != NULL);
+
+    switch (bytes_per_sample) {
+    case 1:
+        for (i = 0; i < num_values; i++) {
+            output[i] = WAV_Convert8bitPCMto32bitPCM(data[i]);
+        }
+        break;
+    case 2:
+        if (big_endian) {
+            for (i = 0; i < num_values; i++) {
+                const uint32_t bits = ((uint32_t)data[2 * i] << 8) | data[2 * i + 1];
+                output[i] = WAV_Convert16bitPCMto32bitPCM((int32_t)bits);
+            }
+        } else {
+            for (i = 0; i < num_values; i++) {
+                const uint32_t bits = ((uint32_t)data[2 * i + 1] << 8) | data[2 * i];
+                output[i] = WAV_Convert16bitPCMto32bitPCM((int32_t)bits);
+            }
+        }
+        break;
+    case 3:
+        if (big_endian) {
+            for (i = 0; i < num_values; i++) {
+                const uint32_t bits = ((uint32_t)data[3 * i] << 16) | ((uint32_t)data[3 * i + 1] << 8) | data[3 * i + 2];
+                output[i] = WAV_Convert24bitPCMto32bitPCM((int32_t)bits);
+            }
+        } else {
+            for (i = 0; i < num_values; i++) {
+                const uint32_t bits = ((uint32_t)data[3 * i + 2] << 16) | ((uint32_t)data[3 * i + 1] << 8) | data[3 * i];
+                output[i] = WAV_Convert24bitPCMto32bitPCM((int32_t)bits);
+            }
+        }
+        break;
+    case 4:
+        if (big_endian) {
+            for (i = 0; i < num_values; i++) {
+                const uint32_t bits = ((uint32_t)data[4 * i] << 24) | ((uint32_t)data[4 * i + 1] << 16)
+                    | ((uint32_t)data[4 * i + 2] << 8) | data[4 * i + 3];
+                output[i] = WAV_Convert32bitPCMto32bitPCM((int32_t)bits);
+            }
+        } else {
+            for (i = 0; i < num_values; i++) {
+                const uint32_t bits = ((uint32_t)data[4 * i + 3] << 24) | ((uint32_t)data[4 * i + 2] << 16)
+                    | ((uint32_t)data[4 * i + 1] << 8) | data[4 * i];
+                output[i] = WAV_Convert32bitPCMto32bitPCM((int32_t)bits);
+            }
+        }
+        break;
+    default:
+        assert(0);
+    }
+}
+
+/* 32bit整数列をインターリーブされたPCMバイト列に変換 */
+static void WAV_ConvertInt32ToBytes(
+    const int32_t *input, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data)
+{
+    uint32_t i;
+
+    assert(input != NULL);
+    assert(data != NULL);
+
+    switch (bytes_per_sample) {
+    case 1:
+        for (i = 0; i < num_values; i++) {
+            data[i] = (uint8_t)((input[i] + 128) & 0xFF);
+        }
+        break;
+    case 2:
+        if (big_endian) {
+            for (i = 0; i < num_values; i++) {
+                data[2 * i + 0] = (uint8_t)((input[i] >> 8) & 0xFF);
+                data[2 * i + 1] = (uint8_t)((input[i] >> 0) & 0xFF);
+            }
+        } else {
+            for (i = 0; i < num_values; i++) {
+                data[2 * i + 0] = (uint8_t)((input[i] >> 0) & 0xFF);
+                data[2 * i + 1] = (uint8_t)((input[i] >> 8) & 0xFF);
+            }
+        }
+        break;
+    case 3:
+        if (big_endian) {
+            for (i = 0; i < num_values; i++) {
+                data[3 * i + 0] = (uint8_t)((input[i] >> 16) & 0xFF);
+                data[3 * i + 1] = (uint8_t)((input[i] >>  8) & 0xFF);
+                data[3 * i + 2] = (uint8_t)((input[i] >>  0) & 0xFF);
+            }
+        } else {
+            for (i = 0; i < num_values; i++) {
+                data[3 * i + 0] = (uint8_t)((input[i] >>  0) & 0xFF);
+                data[3 * i + 1] = (uint8_t)((input[i] >>  8) & 0xFF);
+                data[3 * i + 2] = (uint8_t)((input[i] >> 16) & 0xFF);
+            }
+        }
+        break;
+    case 4:
+        if (big_endian) {
+            for (i = 0; i < num_values; i++) {
+                data[4 * i + 0] = (uint8_t)((input[i] >> 24) & 0xFF);
+                data[4 * i + 1] = (uint8_t)((input[i] >> 16) & 0xFF);
+                data[4 * i + 2] = (uint8_t)((input[i] >>  8) & 0xFF);
+                data[4 * i + 3] = (uint8_t)((input[i] >>  0) & 0xFF);
+            }
+        } else {
+            for (i = 0; i < num_values; i++) {
+                data[4 * i + 0] = (uint8_t)((input[i] >>  0) & 0xFF);
+                data[4 * i + 1] = (uint8_t)((input[i] >>  8) & 0xFF);
+                data[4 * i + 2] = (uint8_t)((input[i] >> 16) & 0xFF);
+                data[4 * i + 3] = (uint8_t)((input[i] >> 24) & 0xFF);
+            }
+        }
+        break;
+    default:
+        assert(0);
+    }
+}
+
+/* ステレオのインターリーブ列をチャンネル毎に分配 */
+static void WAV_DeinterleaveStereo(const int32_t *values, uint32_t num_values, int32_t *lch, int32_t *rch)
+{
+    uint32_t i;
+
+    assert(values != NULL);
+    assert((lch != NULL) && (rch != NULL));
+
+    for (i = 0; i < num_values; i += 2) {
+        lch[i / 2] = values[i + 0];
+        rch[i / 2] = values[i + 1];
+    }
+}
+
+/* チャンネル毎の配列をステレオのインターリーブ列にまとめる */
+static void WAV_InterleaveStereo(const int32_t *lch, const int32_t *rch, uint32_t num_values, int32_t *values)
+{
+    uint32_t i;
+
+    assert((lch != NULL) && (rch != NULL));
+    assert(values != NULL);
+
+    for (i = 0; i < num_values; i += 2) {
+        values[i + 0] = lch[i / 2];
+        values[i + 1] = rch[i / 2];
+    }
+}
+
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* インターリーブされたPCMバイト列を32bit整数列に変換（SSE4.1） */
+static SRLA_TARGET_SSE41 void WAV_ConvertBytesToInt32SSE41(
+    const uint8_t *data, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, int32_t *output)
+{
+    uint32_t i = 0;
+
+    assert(data != NULL);
+    assert(output != NULL);
+
+    switch (bytes_per_sample) {
+    case 1:
+        {
+            const __m128i voffset = _mm_set1_epi32(128);
+            for (; (i + 16) <= num_values; i += 16) {
+                const __m128i v = _mm_loadu_si128((const __m128i *)&data[i]);
+                _mm_storeu_si128((__m128i *)&output[i +  0], _mm_sub_epi32(_mm_cvtepu8_epi32(v), voffset));
+                _mm_storeu_si128((__m128i *)&output[i +  4], _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)), voffset));
+                _mm_storeu_si128((__m128i *)&output[i +  8], _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 8)), voffset));
+                _mm_storeu_si128((__m128i *)&output[i + 12], _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 12)), voffset));
+            }
+        }
+        break;
+    case 2:
+        {
+            /* ビッグエンディアンの場合は各サンプル内のバイトを入れ替える */
+            const __m128i vswap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+            for (; (i + 8) <= num_values; i += 8) {
+                __m128i v = _mm_loadu_si128((const __m128i *)&data[2 * i]);
+                if (big_endian) {
+                    v = _mm_shuffle_epi8(v, vswap);
+                }
+                _mm_storeu_si128((__m128i *)&output[i + 0], _mm_cvtepi16_epi32(v));
+                _mm_storeu_si128((__m128i *)&output[i + 4], _mm_cvtepi16_epi32(_mm_srli_si128(v, 8)));
+            }
+        }
+        break;
+    case 3:
+        {
+            /* 3バイトを32bitレーンの上位に詰めてから算術右シフトで符号拡張 */
+            const __m128i vshuffle = big_endian
+                ? _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9)
+                : _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            /* 補足）16byteロードが範囲を越えないよう、末尾の2サンプル分は残す */
+            for (; (i + 6) <= num_values; i += 4) {
+                const __m128i v = _mm_loadu_si128((const __m128i *)&data[3 * i]);
+                _mm_storeu_si128((__m128i *)&output[i], _mm_srai_epi32(_mm_shuffle_epi8(v, vshuffle), 8));
+            }
+        }
+        break;
+    case 4:
+        {
+            const __m128i vswap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            for (; (i + 4) <= num_values; i += 4) {
+                __m128i v = _mm_loadu_si128((const __m128i *)&data[4 * i]);
+                if (big_endian) {
+                    v = _mm_shuffle_epi8(v, vswap);
+                }
+                _mm_storeu_si128((__m128i *)&output[i], v);
+            }
+        }
+        break;
+    default:
+        assert(0);
+    }
+
+    /* 端数はスカラー実装で処理 */
+    WAV_ConvertBytesToInt32(&data[bytes_per_sample * i], num_values - i, bytes_per_sample, big_endian, &output[i]);
+}
+
+/* 32bit整数列をインターリーブされたPCMバイト列に変換（SSE4.1） */
+static SRLA_TARGET_SSE41 void WAV_ConvertInt32ToBytesSSE41(
+    const int32_t *input, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data)
+{
+    uint32_t i = 0;
+
+    assert(input != NULL);
+    assert(data != NULL);
+
+    switch (bytes_per_sample) {
+    case 1:
+        {
+            /* 無音を128にずらし、下位8bitを取り出して詰める */
+            const __m128i voffset = _mm_set1_epi32(128);
+            const __m128i vmask = _mm_set1_epi32(0xFF);
+            for (; (i + 16) <= num_values; i += 16) {
+                const __m128i v0 = _mm_and_si128(_mm_add_epi32(_mm_loadu_si128((const __m128i *)&input[i +  0]), voffset), vmask);
+                const __m128i v1 = _mm_and_si128(_mm_add_epi32(_mm_loadu_si128((const __m128i *)&input[i +  4]), voffset), vmask);
+                const __m128i v2 = _mm_and_si128(_mm_add_epi32(_mm_loadu_si128((const __m128i *)&input[i +  8]), voffset), vmask);
+                const __m128i v3 = _mm_and_si128(_mm_add_epi32(_mm_loadu_si128((const __m128i *)&input[i + 12]), voffset), vmask);
+                _mm_storeu_si128((__m128i *)&data[i],
+                    _mm_packus_epi16(_mm_packus_epi32(v0, v1), _mm_packus_epi32(v2, v3)));
+            }
+        }
+        break;
+    case 2:
+        {
+            /* 各サンプルの下位2バイトを取り出して詰める */
+            const __m128i vshuffle = big_endian
+                ? _mm_setr_epi8(1, 0, 5, 4, 9, 8, 13, 12, -1, -1, -1, -1, -1, -1, -1, -1)
+                : _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+            for (; (i + 8) <= num_values; i += 8) {
+                const __m128i v0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&input[i + 0]), vshuffle);
+                const __m128i v1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&input[i + 4]), vshuffle);
+                _mm_storeu_si128((__m128i *)&data[2 * i], _mm_unpacklo_epi64(v0, v1));
+            }
+        }
+        break;
+    case 3:
+        {
+            /* 各サンプルの下位3バイトを取り出して先頭12バイトに詰める */
+            const __m128i vshuffle = big_endian
+                ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            /* 補足）16byteストアは4バイトはみ出すため、後続のサンプルで上書きされる範囲に限る */
+            for (; (i + 6) <= num_values; i += 4) {
+                const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)&input[i]), vshuffle);
+                _mm_storeu_si128((__m128i *)&data[3 * i], v);
+            }
+        }
+        break;
+    case 4:
+        {
+            const __m128i vswap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            for (; (i + 4) <= num_values; i += 4) {
+                __m128i v = _mm_loadu_si128((const __m128i *)&input[i]);
+                if (big_endian) {
+                    v = _mm_shuffle_epi8(v, vswap);
+                }
+                _mm_storeu_si128((__m128i *)&data[4 * i], v);
+            }
+        }
+        break;
+    default:
+        assert(0);
+    }
+
+    /* 端数はスカラー実装で処理 */
+    WAV_ConvertInt32ToBytes(&input[i], num_values - i, bytes_per_sample, big_endian, &data[bytes_per_sample * i]);
+}
+
+/* ステレオのインターリーブ列をチャンネル毎に分配（SSE4.1） */
+static SRLA_TARGET_SSE41 void WAV_DeinterleaveStereoSSE41(
+    const int32_t *values, uint32_t num_values, int32_t *lch, int32_t *rch)
+{
+    uint32_t i = 0;
+
+    assert(values != NULL);
+    assert((lch != NULL) && (rch != NULL));
+
+    for (; (i + 8) <= num_values; i += 8) {
+        /* L0 R0 L1 R1 | L2 R2 L3 R3 -> L0 L1 R0 R1 | L2 L3 R2 R3 */
+        const __m128i v0 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&values[i + 0]), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m128i v1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&values[i + 4]), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128((__m128i *)&lch[i / 2], _mm_unpacklo_epi64(v0, v1));
+        _mm_storeu_si128((__m128i *)&rch[i / 2], _mm_unpackhi_epi64(v0, v1));
+    }
+
+    WAV_DeinterleaveStereo(&values[i], num_values - i, &lch[i / 2], &rch[i / 2]);
+}
+
+/* チャンネル毎の配列をステレオのインターリーブ列にまとめる（SSE4.1） */
+static SRLA_TARGET_SSE41 void WAV_InterleaveStereoSSE41(
+    const int32_t *lch, const int32_t *rch, uint32_t num_values, int32_t *values)
+{
+    uint32_t i = 0;
+
+    assert((lch != NULL) && (rch != NULL));
+    assert(values != NULL);
+
+    for (; (i + 8) <= num_values; i += 8) {
+        const __m128i vl = _mm_loadu_si128((const __m128i *)&lch[i / 2]);
+        const __m128i vr = _mm_loadu_si128((const __m128i *)&rch[i / 2]);
+        _mm_storeu_si128((__m128i *)&values[i + 0], _mm_unpacklo_epi32(vl, vr));
+        _mm_storeu_si128((__m128i *)&values[i + 4], _mm_unpackhi_epi32(vl, vr));
+    }
+
+    WAV_InterleaveStereo(&lch[i / 2], &rch[i / 2], num_values - i, &values[i]);
+}
+
+/* インターリーブされたPCMバイト列を32bit整数列に変換（AVX2） */
+static SRLA_TARGET_AVX2 void WAV_ConvertBytesToInt32AVX2(
+    const uint8_t *data, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, int32_t *output)
+{
+    uint32_t i = 0;
+
+    assert(data != NULL);
+    assert(output != NULL);
+
+    switch (bytes_per_sample) {
+    case 1:
+        {
+            const __m256i voffset = _mm256_set1_epi32(128);
+            for (; (i + 8) <= num_values; i += 8) {
+                const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&data[i]));
+                _mm256_storeu_si256((__m256i *)&output[i], _mm256_sub_epi32(v, voffset));
+            }
+        }
+        break;
+    case 2:
+        {
+            /* ビッグエンディアンの場合は各サンプル内のバイトを入れ替える */
+            const __m128i vswap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+            for (; (i + 8) <= num_values; i += 8) {
+                __m128i v = _mm_loadu_si128((const __m128i *)&data[2 * i]);
+                if (big_endian) {
+                    v = _mm_shuffle_epi8(v, vswap);
+                }
+                _mm256_storeu_si256((__m256i *)&output[i], _mm256_cvtepi16_epi32(v));
+            }
+        }
+        break;
+    case 3:
+        {
+            /* 3バイトを32bitレーンの上位に詰めてから算術右シフトで符号拡張 */
+            const __m128i vshuffle = big_endian
+                ? _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9)
+                : _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            const __m256i vshuffle256 = _mm256_inserti128_si256(_mm256_castsi128_si256(vshuffle), vshuffle, 1);
+            /* 補足）16byteロードが範囲を越えないよう、末尾の2サンプル分は残す */
+            for (; (i + 10) <= num_values; i += 8) {
+                const __m256i v = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)&data[3 * i])),
+                    _mm_loadu_si128((const __m128i *)&data[3 * i + 12]), 1);
+                _mm256_storeu_si256((__m256i *)&output[i], _mm256_srai_epi32(_mm256_shuffle_epi8(v, vshuffle256), 8));
+            }
+        }
+        break;
+    case 4:
+        {
+            const __m256i vswap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            for (; (i + 8) <= num_values; i += 8) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)&data[4 * i]);
+                if (big_endian) {
+                    v = _mm256_shuffle_epi8(v, vswap);
+                }
+                _mm256_storeu_si256((__m256i *)&output[i], v);
+            }
+        }
+        break;
+    default:
+        assert(0);
+    }
+
+    /* 端数はSSE4.1実装で処理 */
+    WAV_ConvertBytesToInt32SSE41(&data[bytes_per_sample * i], num_values - i, bytes_per_sample, big_endian, &output[i]);
+}
+
+/* 32bit整数列をインターリーブされたPCMバイト列に変換（AVX2） */
+static SRLA_TARGET_AVX2 void WAV_ConvertInt32ToBytesAVX2(
+    const int32_t *input, uint32_t num_values, uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data)
+{
+    uint32_t i = 0;
+
+    assert(input != NULL);
+    assert(data != NULL);
+
+    switch (bytes_per_sample) {
+    case 1: case 2:
+        /* 出力が16バイトに満たないためSSE4.1実装に任せる */
+        break;
+    case 3:
+        {
+            /* 各サンプルの下位3バイトを取り出して各128bitレーンの先頭12バイトに詰める */
+            const __m128i vshuffle = big_endian
+                ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            const __m256i vshuffle256 = _mm256_inserti128_si256(_mm256_castsi128_si256(vshuffle), vshuffle, 1);
+            /* 補足）16byteストアは4バイトはみ出すため、後続のサンプルで上書きされる範囲に限る */
+            for (; (i + 10) <= num_values; i += 8) {
+                const __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)&input[i]), vshuffle256);
+                _mm_storeu_si128((__m128i *)&data[3 * i], _mm256_castsi256_si128(v));
+                _mm_storeu_si128((__m128i *)&data[3 * i + 12], _mm256_extracti128_si256(v, 1));
+            }
+        }
+        break;
+    case 4:
+        {
+            const __m256i vswap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            for (; (i + 8) <= num_values; i += 8) {
+                __m256i v = _mm256_loadu_si256((const __m256i *)&input[i]);
+                if (big_endian) {
+                    v = _mm256_shuffle_epi8(v, vswap);
+                }
+                _mm256_storeu_si256((__m256i *)&data[4 * i], v);
+            }
+        }
+        break;
+    default:
+        assert(0);
+    }
+
+    /* 端数はSSE4.1実装で処理 */
+    WAV_ConvertInt32ToBytesSSE41(&input[i], num_values - i, bytes_per_sample, big_endian, &data[bytes_per_sample * i]);
+}
+#endif /* defined(SRLA_ENABLE_X86_SIMD) */
+
+/* スカラー実装 */
+static const struct WAVConvertFunctions st_convert_functions_scalar = {
+    WAV_ConvertBytesToInt32, WAV_ConvertInt32ToBytes, WAV_DeinterleaveStereo, WAV_InterleaveStereo
+};
+#if defined(SRLA_ENABLE_X86_SIMD)
+/* SSE4.1実装 */
+static const struct WAVConvertFunctions st_convert_functions_sse41 = {
+    WAV_ConvertBytesToInt32SSE41, WAV_ConvertInt32ToBytesSSE41, WAV_DeinterleaveStereoSSE41, WAV_InterleaveStereoSSE41
+};
+/* AVX2実装 補足）ステレオの並べ替えは128bit幅で十分なためSSE4.1実装を使う */
+static const struct WAVConvertFunctions st_convert_functions_avx2 = {
+    WAV_ConvertBytesToInt32AVX2, WAV_ConvertInt32ToBytesAVX2, WAV_DeinterleaveStereoSSE41, WAV_InterleaveStereoSSE41
+};
+#endif
+
+/* 命令セットに対応するPCM変換関数を取得 */
+static const struct WAVConvertFunctions *WAV_GetConvertFunctions(SRLASIMDInstructionSet instruction_set)
+{
+    switch (instruction_set) {
+#if defined(SRLA_ENABLE_X86_SIMD)
+    case SRLA_SIMD_AVX512: /* AVX-512向けの実装はないためAVX2実装を使う */
+    case SRLA_SIMD_AVX2:
+        return &st_convert_functions_avx2;
+    case SRLA_SIMD_SSE41:
+        return &st_convert_functions_sse41;
+#endif
+    default:
+        break;
+    }
+
+    return &st_convert_functions_scalar;
+}
+
+/* インターリーブされたPCMバイト列をチャンネル毎の32bit整数配列に変換 */
+static void WAV_ConvertInterleavedPCMToPlanar(
+    const struct WAVConvertFunctions *functions,
+    const uint8_t *data, uint32_t num_samples, uint32_t num_channels, uint32_t bytes_per_sample,
+    uint8_t big_endian, WAVPcmData **buffer, uint32_t buffer_offset)
+{
+    int32_t values[WAV_CONVERT_UNIT_SIZE];
+    uint32_t i, ch, smpl, num_values;
+    uint64_t progress;
+    const uint64_t total_num_values = (uint64_t)num_samples * num_channels;
+    /* 一度に変換する数は可能な限りチャンネル数の倍数にする */
+    const uint32_t unit_size = (num_channels <= WAV_CONVERT_UNIT_SIZE)
+        ? ((WAV_CONVERT_UNIT_SIZE / num_channels) * num_channels) : WAV_CONVERT_UNIT_SIZE;
+
+    assert(functions != NULL);
+    assert(data != NULL);
+    assert(buffer != NULL);
+    assert(num_channels > 0);
+
+    ch = 0;
+    smpl = buffer_offset;
+    for (progress = 0; progress < total_num_values; progress += num_values) {
+        num_values = (uint32_t)WAV_Min(unit_size, total_num_values - progress);
+
+        /* 先にまとめて32bit整数に変換 */
+        functions->bytes_to_int32(&data[progress * bytes_per_sample], num_values, bytes_per_sample, big_endian, values);
+
+        /* チャンネル毎に分配 */
+        if (num_channels == 1) {
+            memcpy(&buffer[0][smpl], values, sizeof(int32_t) * num_values);
+            smpl += num_values;
+        } else if (num_channels == 2) {
+            functions->deinterleave_stereo(values, num_values, &buffer[0][smpl], &buffer[1][smpl]);
+            smpl += num_values / 2;
+        } else {
+            for (i = 0; i < num_values; i++) {
+                buffer[ch][smpl] = values[i];
+                if (++ch == num_channels) {
+                    ch = 0;
+                    smpl++;
+                }
+            }
+        }
+    }
+}
+
+/* チャンネル毎の32bit整数配列をインターリーブされたPCMバイト列に変換 */
+static void WAV_ConvertPlanarToInterleavedPCM(
+    const struct WAVConvertFunctions *functions,
+    const WAVPcmData *const *buffer, uint32_t buffer_offset, uint32_t num_samples, uint32_t num_channels,
+    uint32_t bytes_per_sample, uint8_t big_endian, uint8_t *data)
+{
+    int32_t values[WAV_CONVERT_UNIT_SIZE];
+    uint32_t i, ch, smpl, num_values;
+    uint64_t progress;
+    const uint64_t total_num_values = (uint64_t)num_samples * num_channels;
+    /* 一度に変換する数は可能な限りチャンネル数の倍数にする */
+    const uint32_t unit_size = (num_channels <= WAV_CONVERT_UNIT_SIZE)
+        ? ((WAV_CONVERT_UNIT_SIZE / num_channels) * num_channels) : WAV_CONVERT_UNIT_SIZE;
+
+    assert(functions != NULL);
+    assert(buffer != NULL);
+    assert(data != NULL);
+    assert(num_channels > 0);
+
+    ch = 0;
+    smpl = buffer_offset;
+    for (progress = 0; progress < total_num_values; progress += num_values) {
+        num_values = (uint32_t)WAV_Min(unit_size, total_num_values - progress);
+
+        /* チャンネルをインターリーブ */
+        if (num_channels == 1) {
+            memcpy(values, &buffer[0][smpl], sizeof(int32_t) * num_values);
+            smpl += num_values;
+        } else if (num_channels == 2) {
+            functions->interleave_stereo(&buffer[0][smpl], &buffer[1][smpl], num_values, values);
+            smpl += num_values / 2;
+        } else {
+            for (i = 0; i < num_values; i++) {
+                values[i] = buffer[ch][smpl];
+                if (++ch == num_channels) {
+                    ch = 0;
+                    smpl++;
+                }
+            }
+        }
+
+        /* まとめてバイト列に変換 */
+        functions->int32_to_bytes(values, num_values, bytes_per_sample, big_endian, &data[progress * bytes_per_sample]);
+    }
+}
+
+/* パーサの初期化 */
+static void WAVParser_Initialize(struct WAVParser* parser, FILE* fp)
+{
+    parser->fp = fp;
+    memset(&parser->buffer, 0, sizeof(struct WAVBitBuffer));
+    parser->buffer.byte_pos = -1;
+    parser->convert = WAV_GetConvertFunctions(SRLASIMD_GetInstructionSet());
+}
+
+/* パーサの使用終了 */
+static void WAVParser_Finalize(struct WAVParser* parser)
+{
+    parser->fp = NULL;
+    memset(&parser->buffer, 0, sizeof(struct WAVBitBuffer));
+    parser->buffer.byte_pos = -1;
+}
+
+/* n_bit 取得し、結果を右詰めする */
+static WAVError WAVParser_GetBits(struct WAVParser* parser, uint32_t n_bits, uint64_t* bitsbuf)
+{
+    uint64_t tmp;
+    struct WAVBitBuffer *buf = &(parser->buffer);
+
+    /* 引数チェック */
+    if ((parser == NULL) || (bitsbuf == NULL) || (n_bits > 64)) {
+        return WAV_ERROR_INVALID_PARAMETER;
+    }
+
+    /* 初回読み込み */
+    if (buf->byte_pos == -1) {
+        if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+            return WAV_ERROR_IO;
+        }
+        buf->byte_pos   = 0;
+        buf->bit_count  = 8;
+    }
+
+    /* 最上位ビットからデータを埋めていく
+    * 初回ループではtmpの上位ビットにセット
+    * 2回目以降は8bit単位で入力しtmpにセット */
+    tmp = 0;
+    while (n_bits > buf->bit_count) {
+        /* 上位bitから埋めていく */
+        n_bits  -= buf->bit_count;
+        tmp     |= (uint64_t)WAV_GetLowerBits(buf->bit_count, buf->bytes[buf->byte_pos]) << n_bits;
+
+        /* 1バイト読み進める */
+        buf->byte_pos++;
+        buf->bit_count   = 8;
+
+        /* バッファが一杯ならば、再度読み込み */
+        if (buf->byte_pos == WAVBITBUFFER_BUFFER_SIZE) {
+            if (fread(buf->bytes, sizeof(uint8_t), WAVBITBUFFER_BUFFER_SIZE, parser->fp) == 0) {
+                return WAV_ERROR_IO;
+            }
+            buf->byte_pos = 0;
+        }
+    }
+
+    /* 端数ビットの処理
+    * 残ったビット分をtmpの最上位ビットにセット */
+    buf->bit_count -= n_bits;
+    tmp            |= (uint64_t)WAV_GetLowerBits(n_bits, (uint32_t)(buf->bytes[buf->byte_pos] >> buf->bit_count));
+
+    *bitsbuf = tmp;
+    return WAV_ERROR_OK;
+}
+
+/* シーク（fseek準拠） */
+static WAVError WAVParser_Seek(struct WAVParser* parser, int64_t offset, int32_t wherefrom)
+{
+    assert(parser != NULL);
+
+    /* バッファに取り込んだ分先読みしているので戻す */
+    if ((wherefrom == SEEK_CUR) && (parser->buffer.byte_pos != -1)) {
+        offset -= (WAVBITBUFFER_BUFFER_SIZE - (parser->buffer.byte_pos + 1));
+    }
+
+    /* 移動 */
+    WAV_FSeek64(parser->fp, offset, wherefrom);
+
+    /* バッファをクリア */
+    parser->buffer.byte_pos = -1;
+
+    return WAV_ERROR_OK;
+}
+
+/* ファイル種別の判定 */
+static WAVFileType WAVParser_IdentifyFileType(struct WAVParser *parser)
+{
+    assert(parser != NULL);
+
+    /* WAVファイルだと思って判定 */
+    WAVParser_Seek(parser, 0, SEEK_SET);
+    do {
+        uint64_t tmp;
+
+        /* ヘッダ 'R', 'I', 'F', 'F' をチェック */
+        if (WAVParser_CheckSignatureString(parser, "RIFF", 4) != WAV_ERROR_OK) {
+            break;
+        }
+
+        /* ファイルサイズ-8（読み飛ばし） */
+        if (WAVParser_GetLittleEndianBytes(parser, 4, &tmp) != WAV_ERROR_OK) {
+            break;
+        }
+
+        /* ヘッダ 'W', 'A', 'V', 'E' をチェック */
+        if (WAVParser_CheckSignatureString(parser, "WAVE", 4) != WAV_ERROR_OK) {
+            break;
+        }
+
+        return WAV_FILETYPE_WAV;
+    } while (0);
+
+    /* AIFFファイルだと思って判定 */
+    WAVParser_Seek(parser, 0, SEEK_SET);
+    do {
+        uint64_t tmp;
+
+        /* ヘッダ 'F', 'O', 'R', 'M' をチェック */
+        if (WAVParser_CheckSignatureString(parser, "FORM", 4) != WAV_ERROR_OK) {
+            break;
+        }
+
+        /* ファイルサイズ-8（読み飛ばし） */
+        if (WAVParser_GetLittleEndianBytes(parser, 4, &tmp) != WAV_ERROR_OK) {
+            break;
+        }
+
+        /* ヘッダ 'A', 'I', 'F', 'F' をチェック */
+        if (WAVParser_CheckSignatureString(parser, "AIFF", 4) != WAV_ERROR_OK) {
+            break;
+        }
+
+        return WAV_FILETYPE_AIFF;
+    } while (0);
+
+    return WAV_FILETYPE_INVALID;
+}
+
+/* WAVファイルハンドルを破棄 */
+void WAV_Destroy(struct WAVFile* wavfile)
+{
+    uint32_t ch;
 
     /* NULLチェックして解放 */
 #define NULLCHECK_AND_FREE(ptr) { \
@@ -1161,164 +2087,63 @@ static WAVError WAVWriter_PutWAVHeader(
     return WAV_ERROR_OK;
 }
 
-/* リトルエンディアンで書き出し
-* 注意）dataはスワップされる可能性がある */
-static size_t WAVWriter_FWriteLittleEndian(
-        void *data, size_t size, size_t ndata, FILE *fp)
+/* WAVファイルのPCMデータ出力 */
+static WAVError WAVWriter_PutWAVPcmData(
+        struct WAVWriter* writer, const struct WAVFile* wavfile)
 {
-    const int x = 1;
-    uint8_t *buffer;
-    uint32_t i;
+    /* リトルエンディアンで出力 */
+    return WAVWriter_PutPcmData(writer, wavfile, 0);
+}
 
-    /* リトルエンディアン環境ではそのままfwrite */
-    if ((size == 1) || (*((char *)&x) == 1)) {
-        return fwrite(data, size, ndata, fp);
-    }
+/* PCMデータをまとめて出力 */
+static WAVError WAVWriter_PutPcmData(
+    struct WAVWriter *writer, const struct WAVFile *wavfile, uint8_t big_endian)
+{
+    uint32_t bytes_per_sample, block_align, num_unit_samples, progress;
+    uint8_t *data;
 
-    /* ビッグエンディアン環境では並び替えてから書き込む */
-    buffer = (uint8_t *)data;
+    assert((writer != NULL) && (wavfile != NULL));
 
-    switch (size) {
-    case 2:
-        for (i = 0; i < ndata; i++) {
-            uint8_t a = buffer[2 * i];
-            buffer[2 * i + 0] = buffer[2 * i + 1];
-            buffer[2 * i + 1] = a;
-        }
-        break;
-    case 3:
-        for (i = 0; i < ndata; i++) {
-            uint8_t a = buffer[3 * i];
-            buffer[3 * i + 0] = buffer[3 * i + 2];
-            buffer[3 * i + 2] = a;
-        }
-        break;
-    case 4:
-        for (i = 0; i < ndata; i++) {
-            uint8_t a = buffer[4 * i];
-            uint8_t b = buffer[4 * i + 1];
-            buffer[4 * i + 0] = buffer[4 * i + 3];
-            buffer[4 * i + 1] = buffer[4 * i + 2];
-            buffer[4 * i + 2] = b;
-            buffer[4 * i + 3] = a;
-        }
+    /* 対応しているビット深度か確認 */
+    switch (wavfile->format.bits_per_sample) {
+    case 8: case 16: case 24: case 32:
         break;
     default:
-        return 0;
+        /* fprintf(stderr, "Unsupported bits per smpl format(=%d). \n", wavfile->format.bits_per_smpl); */
+        return WAV_ERROR_INVALID_FORMAT;
+    }
+    if (wavfile->format.num_channels == 0) {
+        return WAV_ERROR_INVALID_FORMAT;
     }
-
-    return fwrite(data, size, ndata, fp);
-}
-
-/* WAVファイルのPCMデータ出力 */
-static WAVError WAVWriter_PutWAVPcmData(
-        struct WAVWriter* writer, const struct WAVFile* wavfile)
-{
-    uint32_t ch, smpl, progress;
 
     /* バッファは空に */
-    WAVWriter_Flush(writer);
+    if (WAVWriter_Flush(writer) != WAV_ERROR_OK) {
+        return WAV_ERROR_IO;
+    }
+
+    /* 大きめの単位で変換してまとめて書き出す */
+    bytes_per_sample = wavfile->format.bits_per_sample / 8;
+    block_align = bytes_per_sample * wavfile->format.num_channels;
+    num_unit_samples = WAV_PCM_WRITE_BUFFER_SIZE / block_align;
+    if (num_unit_samples == 0) {
+        num_unit_samples = 1;
+    }
+    if ((data = (uint8_t *)malloc((size_t)block_align * num_unit_samples)) == NULL) {
+        return WAV_ERROR_NG;
+    }
 
     /* チャンネルインターリーブしながら書き出し */
-    switch (wavfile->format.bits_per_sample) {
-    case 8:
-        {
-            uint8_t *buffer;
-            const uint32_t num_output_smpls_per_buffer = WAVBITBUFFER_BUFFER_SIZE / (sizeof(uint8_t) * wavfile->format.num_channels);
-            progress = 0;
-            while (progress < wavfile->format.num_samples) {
-                const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-                const uint32_t num_output_smpls = num_process_smpls * wavfile->format.num_channels;
-                buffer = (uint8_t *)writer->buffer.bytes;
-                for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                        (*buffer++) = (uint8_t)((WAVFile_PCM(wavfile, progress + smpl, ch) + 128) & 0xFF);
-                    }
-                }
-                if (WAVWriter_FWriteLittleEndian(writer->buffer.bytes,
-                            sizeof(uint8_t), num_output_smpls, writer->fp) < num_output_smpls) {
-                    return WAV_ERROR_IO;
-                }
-                progress += num_process_smpls;
-            }
-        }
-        break;
-    case 16:
-        {
-            int16_t *buffer;
-            const uint32_t num_output_smpls_per_buffer = (uint32_t)(WAVBITBUFFER_BUFFER_SIZE / (sizeof(int16_t) * wavfile->format.num_channels));
-            progress = 0;
-            while (progress < wavfile->format.num_samples) {
-                const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-                const uint32_t num_output_smpls = num_process_smpls * wavfile->format.num_channels;
-                buffer = (int16_t *)writer->buffer.bytes;
-                for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                        (*buffer++) = (int16_t)(WAVFile_PCM(wavfile, progress + smpl, ch) & 0xFFFF);
-                    }
-                }
-                if (WAVWriter_FWriteLittleEndian(writer->buffer.bytes,
-                            sizeof(int16_t), num_output_smpls, writer->fp) < num_output_smpls) {
-                    return WAV_ERROR_IO;
-                }
-                progress += num_process_smpls;
-            }
-        }
-        break;
-    case 24:
-        {
-            uint8_t *buffer;
-            const size_t int24_size = 3 * sizeof(uint8_t);
-            const uint32_t num_output_smpls_per_buffer = (uint32_t)(WAVBITBUFFER_BUFFER_SIZE / (int24_size * wavfile->format.num_channels));
-            progress = 0;
-            while (progress < wavfile->format.num_samples) {
-                const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-                const uint32_t num_output_smpls = num_process_smpls * wavfile->format.num_channels;
-                const size_t output_size = num_output_smpls * int24_size;
-                buffer = (uint8_t *)writer->buffer.bytes;
-                for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                        const int32_t pcm = WAVFile_PCM(wavfile, progress + smpl, ch);
-                        (*buffer++) = (uint8_t)((pcm >>  0) & 0xFF);
-                        (*buffer++) = (uint8_t)((pcm >>  8) & 0xFF);
-                        (*buffer++) = (uint8_t)((pcm >> 16) & 0xFF);
-                    }
-                }
-                if (WAVWriter_FWriteLittleEndian(writer->buffer.bytes,
-                            sizeof(uint8_t), output_size, writer->fp) < output_size) {
-                    return WAV_ERROR_IO;
-                }
-                progress += num_process_smpls;
-            }
-        }
-        break;
-    case 32:
-        {
-            int32_t *buffer;
-            const uint32_t num_output_smpls_per_buffer = (uint32_t)(WAVBITBUFFER_BUFFER_SIZE / (sizeof(int32_t) * wavfile->format.num_channels));
-            progress = 0;
-            while (progress < wavfile->format.num_samples) {
-                const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-                const uint32_t num_output_smpls = num_process_smpls * wavfile->format.num_channels;
-                buffer = (int32_t *)writer->buffer.bytes;
-                for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                        (*buffer++) = WAVFile_PCM(wavfile, progress + smpl, ch);
-                    }
-                }
-                if (WAVWriter_FWriteLittleEndian(writer->buffer.bytes,
-                            sizeof(int32_t), num_output_smpls, writer->fp) < num_output_smpls) {
-                    return WAV_ERROR_IO;
-                }
-                progress += num_process_smpls;
-            }
+    for (progress = 0; progress < wavfile->format.num_samples; progress += num_unit_samples) {
+        const uint32_t num_process_smpls = WAV_Min(num_unit_samples, wavfile->format.num_samples - progress);
+        WAV_ConvertPlanarToInterleavedPCM(writer->convert, (const WAVPcmData *const *)wavfile->data, progress, num_process_smpls,
+            wavfile->format.num_channels, bytes_per_sample, big_endian, data);
+        if (fwrite(data, block_align, num_process_smpls, writer->fp) < num_process_smpls) {
+            free(data);
+            return WAV_ERROR_IO;
         }
-        break;
-    default:
-        /* fprintf(stderr, "Unsupported bits per smpl format(=%d). \n", wavfile->format.bits_per_smpl); */
-        return WAV_ERROR_INVALID_FORMAT;
     }
 
+    free(data);
     return WAV_ERROR_OK;
 }
 
@@ -1466,115 +2291,8 @@ static WAVError WAVWriter_PutAIFFHeader(
 static WAVError WAVWriter_PutAIFFPcmData(
     struct WAVWriter *writer, const struct WAVFile *wavfile)
 {
-    uint32_t ch, smpl, progress;
-
-    /* バッファは空に */
-    WAVWriter_Flush(writer);
-
-    /* チャンネルインターリーブしながらビッグエンディアンで書き出し */
-    switch (wavfile->format.bits_per_sample) {
-    case 8:
-    {
-        uint8_t *buffer;
-        const uint32_t num_output_smpls_per_buffer = WAVBITBUFFER_BUFFER_SIZE / (sizeof(uint8_t) * wavfile->format.num_channels);
-        progress = 0;
-        while (progress < wavfile->format.num_samples) {
-            const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-            const size_t output_size = num_process_smpls * wavfile->format.num_channels * sizeof(uint8_t);
-            buffer = (uint8_t *)writer->buffer.bytes;
-            for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                    (*buffer++) = (uint8_t)((WAVFile_PCM(wavfile, progress + smpl, ch) + 128) & 0xFF);
-                }
-            }
-            if (fwrite(writer->buffer.bytes,
-                sizeof(uint8_t), output_size, writer->fp) < output_size) {
-                return WAV_ERROR_IO;
-            }
-            progress += num_process_smpls;
-        }
-    }
-    break;
-    case 16:
-    {
-        const uint32_t num_output_smpls_per_buffer = (uint32_t)(WAVBITBUFFER_BUFFER_SIZE / (sizeof(int16_t) * wavfile->format.num_channels));
-        progress = 0;
-        while (progress < wavfile->format.num_samples) {
-            const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-            const size_t output_size = num_process_smpls * wavfile->format.num_channels * sizeof(int16_t);
-            uint8_t *buffer = (uint8_t *)writer->buffer.bytes;
-            for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                    const int32_t pcm = WAVFile_PCM(wavfile, progress + smpl, ch);
-                    (*buffer++) = (uint8_t)((pcm >> 8) & 0xFF);
-                    (*buffer++) = (uint8_t)((pcm >> 0) & 0xFF);
-                }
-            }
-            if (fwrite(writer->buffer.bytes,
-                sizeof(uint8_t), output_size, writer->fp) < output_size) {
-                return WAV_ERROR_IO;
-            }
-            progress += num_process_smpls;
-        }
-    }
-    break;
-    case 24:
-    {
-        const size_t int24_size = 3 * sizeof(uint8_t);
-        const uint32_t num_output_smpls_per_buffer = (uint32_t)(WAVBITBUFFER_BUFFER_SIZE / (int24_size * wavfile->format.num_channels));
-        progress = 0;
-        while (progress < wavfile->format.num_samples) {
-            const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-            const uint32_t num_output_smpls = num_process_smpls * wavfile->format.num_channels;
-            const size_t output_size = num_output_smpls * int24_size;
-            uint8_t *buffer = (uint8_t *)writer->buffer.bytes;
-            for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                    const int32_t pcm = WAVFile_PCM(wavfile, progress + smpl, ch);
-                    (*buffer++) = (uint8_t)((pcm >> 16) & 0xFF);
-                    (*buffer++) = (uint8_t)((pcm >>  8) & 0xFF);
-                    (*buffer++) = (uint8_t)((pcm >>  0) & 0xFF);
-                }
-            }
-            if (fwrite(writer->buffer.bytes,
-                sizeof(uint8_t), output_size, writer->fp) < output_size) {
-                return WAV_ERROR_IO;
-            }
-            progress += num_process_smpls;
-        }
-    }
-    break;
-    case 32:
-    {
-        const uint32_t num_output_smpls_per_buffer = (uint32_t)(WAVBITBUFFER_BUFFER_SIZE / (sizeof(int32_t) * wavfile->format.num_channels));
-        progress = 0;
-        while (progress < wavfile->format.num_samples) {
-            const uint32_t num_process_smpls = WAV_Min(num_output_smpls_per_buffer, wavfile->format.num_samples - progress);
-            const size_t output_size = num_process_smpls * wavfile->format.num_channels * sizeof(int32_t);
-            uint8_t *buffer = (uint8_t *)writer->buffer.bytes;
-            for (smpl = 0; smpl < num_process_smpls; smpl++) {
-                for (ch = 0; ch < wavfile->format.num_channels; ch++) {
-                    const int32_t pcm = WAVFile_PCM(wavfile, progress + smpl, ch);
-                    (*buffer++) = (uint8_t)((pcm >> 24) & 0xFF);
-                    (*buffer++) = (uint8_t)((pcm >> 16) & 0xFF);
-                    (*buffer++) = (uint8_t)((pcm >>  8) & 0xFF);
-                    (*buffer++) = (uint8_t)((pcm >>  0) & 0xFF);
-                }
-            }
-            if (fwrite(writer->buffer.bytes,
-                sizeof(uint8_t), output_size, writer->fp) < output_size) {
-                return WAV_ERROR_IO;
-            }
-            progress += num_process_smpls;
-        }
-    }
-    break;
-    default:
-        /* fprintf(stderr, "Unsupported bits per smpl format(=%d). \n", wavfile->format.bits_per_smpl); */
-        return WAV_ERROR_INVALID_FORMAT;
-    }
-
-    return WAV_ERROR_OK;
+    /* ビッグエンディアンで出力 */
+    return WAVWriter_PutPcmData(writer, wavfile, 1);
 }
 
 /* ファイル書き出し */
@@ -1635,6 +2353,147 @@ WAVApiResult WAV_WriteToFile(
     return WAV_APIRESULT_OK;
 }
 
+/* ヘッダを書き出し */
+static WAVError WAVStreamWriter_PutHeader(struct WAVStreamWriter *writer)
+{
+    struct WAVWriter header_writer;
+    WAVError err;
+
+    assert(writer != NULL);
+
+    WAVWriter_Initialize(&header_writer, writer->fp);
+    if (writer->big_endian) {
+        err = WAVWriter_PutAIFFHeader(&header_writer, &writer->format);
+    } else {
+        err = WAVWriter_PutWAVHeader(&header_writer, &writer->format);
+    }
+    if (err == WAV_ERROR_OK) {
+        err = WAVWriter_Flush(&header_writer);
+    }
+    WAVWriter_Finalize(&header_writer);
+
+    return err;
+}
+
+/* ストリーミング書き出しハンドルの作成 */
+struct WAVStreamWriter* WAVStreamWriter_Open(
+        const char* filename, const struct WAVFormat* format, uint32_t max_num_samples_per_write)
+{
+    struct WAVStreamWriter *writer;
+
+    /* 引数チェック */
+    if ((filename == NULL) || (format == NULL) || (max_num_samples_per_write == 0)) {
+        return NULL;
+    }
+
+    /* 対応しているフォーマットか確認 */
+    if ((format->file_format != WAV_FILEFORMAT_PCMWAVEFORMAT)
+            && (format->file_format != WAV_FILEFORMAT_WAVEFORMATEXTENSIBLE)
+            && (format->file_format != WAV_FILEFORMAT_AIFF)) {
+        return NULL;
+    }
+    switch (format->bits_per_sample) {
+    case 8: case 16: case 24: case 32:
+        break;
+    default:
+        return NULL;
+    }
+    if (format->num_channels == 0) {
+        return NULL;
+    }
+
+    /* ハンドル作成 */
+    if ((writer = (struct WAVStreamWriter *)malloc(sizeof(struct WAVStreamWriter))) == NULL) {
+        return NULL;
+    }
+    memset(writer, 0, sizeof(struct WAVStreamWriter));
+    writer->format = (*format);
+    writer->bytes_per_sample = format->bits_per_sample / 8;
+    writer->block_align = writer->bytes_per_sample * format->num_channels;
+    writer->big_endian = (format->file_format == WAV_FILEFORMAT_AIFF) ? 1 : 0;
+    writer->max_num_samples_per_write = max_num_samples_per_write;
+    writer->convert = WAV_GetConvertFunctions(SRLASIMD_GetInstructionSet());
+
+    /* 書き出しバッファの確保 */
+    if (((uint64_t)writer->block_align * max_num_samples_per_write) > (uint64_t)((size_t)-1)) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    if ((writer->buffer = (uint8_t *)malloc((size_t)writer->block_align * max_num_samples_per_write)) == NULL) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+
+    /* ファイルを開いてヘッダを書き出し */
+    if ((writer->fp = fopen(filename, "wb")) == NULL) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+    if (WAVStreamWriter_PutHeader(writer) != WAV_ERROR_OK) {
+        goto EXIT_FAILURE_WITH_DATA_RELEASE;
+    }
+
+    return writer;
+
+EXIT_FAILURE_WITH_DATA_RELEASE:
+    WAVStreamWriter_Close(writer);
+    return NULL;
+}
+
+/* ストリーミング書き出しハンドルの破棄 */
+WAVApiResult WAVStreamWriter_Close(struct WAVStreamWriter* writer)
+{
+    WAVApiResult ret = WAV_APIRESULT_OK;
+
+    if (writer == NULL) {
+        return WAV_APIRESULT_INVALID_PARAMETER;
+    }
+
+    if (writer->fp != NULL) {
+        /* 書き出したサンプル数がヘッダと異なる場合はヘッダを書き直す */
+        /* 補足）ヘッダ長はサンプル数によらないため、先頭から上書きできる */
+        if (writer->num_written_samples != writer->format.num_samples) {
+            writer->format.num_samples = writer->num_written_samples;
+            if ((fseek(writer->fp, 0, SEEK_SET) != 0)
+                    || (WAVStreamWriter_PutHeader(writer) != WAV_ERROR_OK)) {
+                ret = WAV_APIRESULT_IOERROR;
+            }
+        }
+        if (fclose(writer->fp) != 0) {
+            ret = WAV_APIRESULT_IOERROR;
+        }
+    }
+    if (writer->buffer != NULL) {
+        free(writer->buffer);
+    }
+    free(writer);
+
+    return ret;
+}
+
+/* チャンネル毎の配列bufferからnum_samplesサンプルを書き出し */
+WAVApiResult WAVStreamWriter_Write(
+        struct WAVStreamWriter* writer, const WAVPcmData* const* buffer, uint32_t num_samples)
+{
+    /* 引数チェック */
+    if ((writer == NULL) || (buffer == NULL)
+            || (num_samples > writer->max_num_samples_per_write)) {
+        return WAV_APIRESULT_INVALID_PARAMETER;
+    }
+
+    /* ヘッダに記録できるサンプル数を越える */
+    if (num_samples > (0xFFFFFFFFUL - writer->num_written_samples)) {
+        return WAV_APIRESULT_INVALID_PARAMETER;
+    }
+
+    /* インターリーブしてまとめて書き出し */
+    WAV_ConvertPlanarToInterleavedPCM(writer->convert, buffer, 0, num_samples, writer->format.num_channels,
+        writer->bytes_per_sample, writer->big_endian, writer->buffer);
+    if (fwrite(writer->buffer, writer->block_align, num_samples, writer->fp) < num_samples) {
+        return WAV_APIRESULT_IOERROR;
+    }
+    writer->num_written_samples += num_samples;
+
+    return WAV_APIRESULT_OK;
+}
+
 /* ライタの初期化 */
 static void WAVWriter_Initialize(struct WAVWriter* writer, FILE* fp)
 {
@@ -1643,6 +2502,7 @@ static void WAVWriter_Initialize(struct WAVWriter* writer, FILE* fp)
     writer->bit_buffer = 0;
     memset(&writer->buffer, 0, sizeof(struct WAVBitBuffer));
     writer->buffer.byte_pos = 0;
+    writer->convert = WAV_GetConvertFunctions(SRLASIMD_GetInstructionSet());
 }
 
 /* ライタの終了 */
@@ -1806,6 +2666,94 @@ static WAVError WAVParser_GetBigEndianBytes(
     return WAV_ERROR_OK;
 }
 
+/* バイト境界からバイト列をまとめて取得 */
+static WAVError WAVParser_GetBytes(
+    struct WAVParser *parser, uint8_t *data, uint32_t size)
+{
+    uint32_t progress = 0;
+    struct WAVBitBuffer *buf = &(parser->buffer);
+
+    assert((parser != NULL) && (data != NULL));
+
+    /* バッファに取り込み済みの分を先にコピー */
+    if (buf->byte_pos != -1) {
+        uint32_t next_pos;
+        /* バイト境界にない */
+        if ((buf->bit_count != 0) && (buf->bit_count != 8)) {
+            return WAV_ERROR_INVALID_PARAMETER;
+        }
+        /* 補足）bit_countが0のときはbyte_posのバイトを読み終えている */
+        next_pos = (uint32_t)buf->byte_pos + ((buf->bit_count == 0) ? 1 : 0);
+        progress = WAV_Min(size, WAVBITBUFFER_BUFFER_SIZE - next_pos);
+        memcpy(data, &buf->bytes[next_pos], progress);
+        next_pos += progress;
+        if (next_pos < WAVBITBUFFER_BUFFER_SIZE) {
+            buf->byte_pos = (int32_t)next_pos;
+            buf->bit_count = 8;
+        } else {
+            /* 使い切ったので次回は読み込みから */
+            buf->byte_pos = -1;
+        }
+    }
+
+    /* 残りはファイルから直接読み込み */
+    if (progress < size) {
+        if (fread(&data[progress], sizeof(uint8_t), size - progress, parser->fp) != (size - progress)) {
+            return WAV_ERROR_IO;
+        }
+        buf->byte_pos = -1;
+    }
+
+    return WAV_ERROR_OK;
+}
+
+/* PCMデータをまとめて読み取り */
+static WAVError WAVParser_GetPcmData(
+    struct WAVParser *parser, struct WAVFile *wavfile, uint8_t big_endian)
+{
+    uint32_t bytes_per_sample, block_align, num_unit_samples, progress;
+    uint8_t *data;
+
+    assert((parser != NULL) && (wavfile != NULL));
+
+    /* 対応しているビット深度か確認 */
+    switch (wavfile->format.bits_per_sample) {
+    case 8: case 16: case 24: case 32:
+        break;
+    default:
+        /* fprintf(stderr, "Unsupported bits per sample format(=%d). \n", wavfile->format.bits_per_sample); */
+        return WAV_ERROR_INVALID_FORMAT;
+    }
+    if (wavfile->format.num_channels == 0) {
+        return WAV_ERROR_INVALID_FORMAT;
+    }
+
+    /* バッファサイズ程度ずつ読み込む */
+    bytes_per_sample = wavfile->format.bits_per_sample / 8;
+    block_align = bytes_per_sample * wavfile->format.num_channels;
+    num_unit_samples = WAVBITBUFFER_BUFFER_SIZE / block_align;
+    if (num_unit_samples == 0) {
+        num_unit_samples = 1;
+    }
+    if ((data = (uint8_t *)malloc((size_t)block_align * num_unit_samples)) == NULL) {
+        return WAV_ERROR_NG;
+    }
+
+    /* 読み込んだ分をまとめて32bit整数形式に変換 */
+    for (progress = 0; progress < wavfile->format.num_samples; progress += num_unit_samples) {
+        const uint32_t num_read_samples = WAV_Min(num_unit_samples, wavfile->format.num_samples - progress);
+        if (WAVParser_GetBytes(parser, data, block_align * num_read_samples) != WAV_ERROR_OK) {
+            free(data);
+            return WAV_ERROR_IO;
+        }
+        WAV_ConvertInterleavedPCMToPlanar(parser->convert, data, num_read_samples, wavfile->format.num_channels,
+            bytes_per_sample, big_endian, wavfile->data, progress);
+    }
+
+    free(data);
+    return WAV_ERROR_OK;
+}
+
 /* パーサを使用して文字列取得 */
 static WAVError WAVParser_GetString(
         struct WAVParser* parser, char* string_buffer, uint32_t string_length)
@@ -116,9 +116,10 @@ TEST(BitStreamTest, PutGetTest)
         BitReader_Open(&strm, memory_image, sizeof(memory_image));
         BitReader_GetBits(&strm, &bits, 8);
         EXPECT_EQ(0xC0, bits);
-        EXPECT_EQ(24, strm.bit_count);
-        EXPECT_EQ(0xC0000000, strm.bit_buffer);
-        EXPECT_EQ(&memory_image[4], strm.memory_p);
+        /* 補充は7バイト単位 */
+        EXPECT_EQ(48, strm.bit_count);
+        EXPECT_EQ((uint64_t)0xC0 << 48, strm.bit_buffer);
+        EXPECT_EQ(&memory_image[7], strm.memory_p);
         BitStream_Flush(&strm);
         EXPECT_EQ(0, strm.bit_count);
         EXPECT_EQ(0, strm.bit_buffer);
@@ -226,3 +227,101 @@ TEST(BitStreamTest, GetZeroRunLengthTest)
         BitStream_Close(&strm);
     }
 }
+
+/* バイト列の先頭からposビット目以降のnbitsを取得（終端以降は0） */
+static uint32_t BitStreamTest_ExtractBits(const uint8_t *data, uint32_t size, uint32_t pos, uint32_t nbits)
+{
+    uint32_t i, val = 0;
+    for (i = 0; i < nbits; i++) {
+        const uint32_t byte_pos = (pos + i) / 8;
+        const uint32_t bit = (byte_pos < size) ? ((data[byte_pos] >> (7 - ((pos + i) % 8))) & 1) : 0;
+        val = (val << 1) | bit;
+    }
+    return val;
+}
+
+/* 先読みと読み飛ばしのテスト */
+TEST(BitStreamTest, PeekSkipTest)
+{
+    /* 先読み・読み飛ばし・通常の読み込みを混ぜても位置がずれないか */
+    {
+        struct BitStream strm;
+        uint8_t data[256];
+        uint32_t i, nbits, pos, val;
+
+        for (i = 0; i < sizeof(data); i++) {
+            data[i] = (uint8_t)(i * 37 + 11);
+        }
+
+        for (nbits = 1; nbits <= 32; nbits++) {
+            BitReader_Open(&strm, data, sizeof(data));
+            pos = 0;
+            for (i = 0; i < 32; i++) {
+                const uint32_t skip = i % (nbits + 1);
+                BitReader_PeekBits(&strm, &val, nbits);
+                EXPECT_EQ(BitStreamTest_ExtractBits(data, sizeof(data), pos, nbits), val);
+                BitReader_SkipBits(&strm, skip);
+                pos += skip;
+                BitReader_GetBits(&strm, &val, 5);
+                EXPECT_EQ(BitStreamTest_ExtractBits(data, sizeof(data), pos, 5), val);
+                pos += 5;
+            }
+            BitStream_Close(&strm);
+        }
+    }
+
+    /* 終端付近の先読みは0で埋められ、終端を越えて読み込まない */
+    {
+        struct BitStream strm;
+        uint8_t data[3] = { 0xA5, 0x3C, 0xFF };
+        uint32_t val;
+
+        BitReader_Open(&strm, data, 2);
+        BitReader_PeekBits(&strm, &val, 32);
+        EXPECT_EQ(0xA53C0000U, val);
+        BitReader_PeekBits(&strm, &val, 24);
+        EXPECT_EQ(0xA53C00U, val);
+        BitReader_SkipBits(&strm, 12);
+        BitReader_PeekBits(&strm, &val, 8);
+        EXPECT_EQ(0xC0U, val);
+        BitReader_SkipBits(&strm, 4);
+        BitReader_PeekBits(&strm, &val, 1);
+        EXPECT_EQ(0U, val);
+        BitStream_Close(&strm);
+    }
+}
+
+/* 終端付近の読み込みテスト */
+TEST(BitStreamTest, ReadNearTailTest)
+{
+    /* 様々なサイズの領域を最後のビットまで読み切れるか */
+    {
+        struct BitStream strm;
+        uint8_t data[32];
+        uint32_t size, i, val, run, pos;
+
+        for (size = 1; size <= sizeof(data); size++) {
+            /* 終端を越えて読んだら分かるよう、領域外は全て1にしておく */
+            memset(data, 0xFF, sizeof(data));
+            for (i = 0; i < size; i++) {
+                data[i] = (uint8_t)((i * 73 + size) & 0xF7);
+            }
+
+            /* 3ビットずつ読む */
+            BitReader_Open(&strm, data, size);
+            for (pos = 0; (pos + 3) <= (8 * size); pos += 3) {
+                BitReader_GetBits(&strm, &val, 3);
+                EXPECT_EQ(BitStreamTest_ExtractBits(data, size, pos, 3), val);
+            }
+            BitStream_Close(&strm);
+
+            /* 最後のバイトに1を立ててラン長で読み切る */
+            memset(data, 0, size);
+            data[size - 1] = 1;
+            BitReader_Open(&strm, data, size);
+            BitReader_GetZeroRunLength(&strm, &run);
+            EXPECT_EQ(8 * size - 1, run);
+            BitStream_Close(&strm);
+        }
+    }
+}
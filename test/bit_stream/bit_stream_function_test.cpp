@@ -10,6 +10,8 @@
 #undef BitWriter_PutZeroRun
 #undef BitReader_GetBits
 #undef BitReader_GetZeroRunLength
+#undef BitReader_PeekBits
+#undef BitReader_SkipBits
 #undef BitStream_Flush
 
 /* マクロの代わりに関数宣言 */
@@ -23,13 +25,14 @@ void BitWriter_PutBits(struct BitStream *stream, uint32_t val, uint32_t nbits);
 void BitWriter_PutZeroRun(struct BitStream *stream, uint32_t runlength);
 void BitReader_GetBits(struct BitStream *stream, uint32_t *val, uint32_t nbits);
 void BitReader_GetZeroRunLength(struct BitStream *stream, uint32_t *runlength);
+void BitReader_PeekBits(struct BitStream *stream, uint32_t *val, uint32_t nbits);
+void BitReader_SkipBits(struct BitStream *stream, uint32_t nbits);
 void BitStream_Flush(struct BitStream *stream);
 }
 
 /* 多重定義防止 */
 #define BitStream_NLZSoft BitStream_NLZSoftTestDummy
 #define g_bitstream_lower_bits_mask g_bitstream_lower_bits_mask_test_dummy
-#define g_bitstream_zerobit_runlength_table g_bitstream_zerobit_runlength_table_test_dummy
 
 /* テスト対象のモジュール */
 extern "C" {
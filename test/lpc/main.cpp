@@ -266,6 +266,137 @@ TEST(LPCCalculatorTest, CalculateLPCCoefficientsTest)
     }
 }
 
+/* 自己相関からの誤差分散計算テスト */
+TEST(LPCCalculatorTest, CalculateErrorVariancesFromAutoCorrelationTest)
+{
+    /* 信号から直接求めた結果と一致するか */
+    /* 補足）FFTによる自己相関計算が巡回しないよう、サンプル数は2の冪から外す。
+     * また、FFTによる自己相関はスケールが異なるため0次の分散との比で比較する */
+    {
+#define NUM_SAMPLES 1500
+#define MAX_ORDER 16
+        struct LPCCalculator *lpcc;
+        struct LPCCalculatorConfig config;
+        double *data, **coefs;
+        double auto_corr[MAX_ORDER + 1];
+        double ref_error_vars[MAX_ORDER + 1], test_error_vars[MAX_ORDER + 1];
+        uint32_t smpl, ord;
+
+        data = (double *)malloc(sizeof(double) * NUM_SAMPLES);
+        coefs = (double **)malloc(sizeof(double *) * MAX_ORDER);
+        for (ord = 0; ord < MAX_ORDER; ord++) {
+            coefs[ord] = (double *)malloc(sizeof(double) * MAX_ORDER);
+        }
+
+        config.max_num_samples = 2048;
+        config.max_order = MAX_ORDER;
+        lpcc = LPCCalculator_Create(&config, NULL, 0);
+        ASSERT_TRUE(lpcc != NULL);
+
+        LPCCalculatorTest_GenerateSin(data, NUM_SAMPLES, 37);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            data[smpl] = 0.5 * data[smpl] + 0.01 * ((double)rand() / RAND_MAX - 0.5);
+        }
+
+        /* 矩形窓で直接計算 */
+        ASSERT_EQ(LPC_APIRESULT_OK, LPCCalculator_CalculateMultipleLPCCoefficients(lpcc,
+            data, NUM_SAMPLES, coefs, ref_error_vars, MAX_ORDER, LPC_WINDOWTYPE_RECTANGULAR, 0.0));
+
+        /* 自己相関から計算 */
+        ASSERT_EQ(LPC_ERROR_OK, LPC_CalculateAutoCorrelation(data, NUM_SAMPLES, auto_corr, MAX_ORDER + 1));
+        ASSERT_EQ(LPC_APIRESULT_OK, LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(lpcc,
+            auto_corr, MAX_ORDER, test_error_vars, 0.0));
+        for (ord = 0; ord <= MAX_ORDER; ord++) {
+            EXPECT_NEAR(ref_error_vars[ord] / ref_error_vars[0], test_error_vars[ord] / test_error_vars[0], 1e-6);
+        }
+
+        /* 0次 */
+        ASSERT_EQ(LPC_APIRESULT_OK, LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(lpcc,
+            auto_corr, 0, test_error_vars, 0.0));
+        EXPECT_EQ(auto_corr[0], test_error_vars[0]);
+
+        /* 不正な引数 */
+        EXPECT_EQ(LPC_APIRESULT_INVALID_ARGUMENT, LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(NULL,
+            auto_corr, MAX_ORDER, test_error_vars, 0.0));
+        EXPECT_EQ(LPC_APIRESULT_INVALID_ARGUMENT, LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(lpcc,
+            NULL, MAX_ORDER, test_error_vars, 0.0));
+        EXPECT_EQ(LPC_APIRESULT_INVALID_ARGUMENT, LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(lpcc,
+            auto_corr, MAX_ORDER, NULL, 0.0));
+        EXPECT_EQ(LPC_APIRESULT_EXCEED_MAX_ORDER, LPCCalculator_CalculateErrorVariancesFromAutoCorrelation(lpcc,
+            auto_corr, MAX_ORDER + 1, test_error_vars, 0.0));
+
+        LPCCalculator_Destroy(lpcc);
+        for (ord = 0; ord < MAX_ORDER; ord++) {
+            free(coefs[ord]);
+        }
+        free(coefs);
+        free(data);
+#undef MAX_ORDER
+#undef NUM_SAMPLES
+    }
+}
+
+/* 窓関数適用・自己相関計算のSIMD実装テスト */
+TEST(LPCCalculatorTest, WindowAndAutoCorrelationFunctionsTest)
+{
+#define MAX_NUM_SAMPLES 1031
+#define MAX_ORDER 40
+    uint32_t i, j, smpl, lag;
+    int32_t set;
+    const int32_t max_set = SRLASIMD_DetectInstructionSet();
+    const struct LPCFunctions *scalar = LPC_GetFunctions(SRLA_SIMD_NONE);
+    static double data[MAX_NUM_SAMPLES], ref_output[MAX_NUM_SAMPLES], test_output[MAX_NUM_SAMPLES];
+    double ref_auto_corr[MAX_ORDER], test_auto_corr[MAX_ORDER];
+    const uint32_t test_num_samples[] = { 8, 9, 15, 16, 17, 100, 255, 1024, MAX_NUM_SAMPLES };
+    const uint32_t test_orders[] = { 1, 2, 3, 4, 5, 8, 9, 13, 17, 33, MAX_ORDER };
+    const LPCWindowType test_windows[] = { LPC_WINDOWTYPE_RECTANGULAR, LPC_WINDOWTYPE_SIN, LPC_WINDOWTYPE_WELCH };
+
+    srand(0);
+    for (smpl = 0; smpl < MAX_NUM_SAMPLES; smpl++) {
+        data[smpl] = (double)rand() / RAND_MAX - 0.5;
+    }
+
+    for (set = SRLA_SIMD_NONE; set <= max_set; set++) {
+        const struct LPCFunctions *functions = LPC_GetFunctions((SRLASIMDInstructionSet)set);
+        for (i = 0; i < sizeof(test_num_samples) / sizeof(test_num_samples[0]); i++) {
+            const uint32_t num_samples = test_num_samples[i];
+            for (j = 0; j < sizeof(test_windows) / sizeof(test_windows[0]); j++) {
+                uint32_t k;
+                /* 窓を掛けた結果は完全に一致するか */
+                ASSERT_EQ(LPC_ERROR_OK, scalar->apply_window(test_windows[j], data, num_samples, ref_output));
+                ASSERT_EQ(LPC_ERROR_OK, functions->apply_window(test_windows[j], data, num_samples, test_output));
+                EXPECT_EQ(0, memcmp(ref_output, test_output, sizeof(double) * num_samples));
+
+                for (k = 0; k < sizeof(test_orders) / sizeof(test_orders[0]); k++) {
+                    const uint32_t order = test_orders[k];
+                    if (order > num_samples) {
+                        continue;
+                    }
+                    /* 自己相関はスカラー版と完全に一致するか */
+                    ASSERT_EQ(LPC_ERROR_OK, scalar->calculate_windowed_auto_correlation(test_windows[j],
+                        data, num_samples, ref_output, ref_auto_corr, order));
+                    memset(test_output, 0, sizeof(double) * num_samples);
+                    ASSERT_EQ(LPC_ERROR_OK, functions->calculate_windowed_auto_correlation(test_windows[j],
+                        data, num_samples, test_output, test_auto_corr, order));
+                    EXPECT_EQ(0, memcmp(ref_output, test_output, sizeof(double) * num_samples));
+                    EXPECT_EQ(0, memcmp(ref_auto_corr, test_auto_corr, sizeof(double) * order));
+                    ASSERT_EQ(LPC_ERROR_OK, scalar->calculate_auto_correlation(ref_output, num_samples, ref_auto_corr, order));
+                    ASSERT_EQ(LPC_ERROR_OK, functions->calculate_auto_correlation(ref_output, num_samples, test_auto_corr, order));
+                    EXPECT_EQ(0, memcmp(ref_auto_corr, test_auto_corr, sizeof(double) * order));
+                    /* 窓の適用と自己相関計算を分けた結果とは加算順序による誤差を除いて一致するか */
+                    ASSERT_EQ(LPC_ERROR_OK, functions->calculate_windowed_auto_correlation(test_windows[j],
+                        data, num_samples, test_output, test_auto_corr, order));
+                    for (lag = 0; lag < order; lag++) {
+                        EXPECT_NEAR(ref_auto_corr[lag], test_auto_corr[lag], 1e-12 * ref_auto_corr[0]);
+                    }
+                }
+            }
+        }
+    }
+#undef MAX_ORDER
+#undef MAX_NUM_SAMPLES
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+/* テスト対象のモジュール */
+extern "C" {
+#include "../../libs/mapped_file/src/mapped_file.c"
+}
+
+/* テスト用のファイルを作成 */
+static void MappedFileTest_CreateFile(const char *filename, const uint8_t *data, uint32_t data_size)
+{
+    FILE *fp;
+    ASSERT_TRUE((fp = fopen(filename, "wb")) != NULL);
+    ASSERT_EQ(data_size, fwrite(data, sizeof(uint8_t), data_size, fp));
+    fclose(fp);
+}
+
+/* オープンクローズテスト */
+TEST(MappedFileTest, OpenCloseTest)
+{
+    /* 失敗ケース */
+    {
+        EXPECT_TRUE(MappedFile_Open(NULL, MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL) == NULL);
+        EXPECT_TRUE(MappedFile_Open("file_does_not_exist.bin", MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL) == NULL);
+        EXPECT_TRUE(MappedFile_GetData(NULL) == NULL);
+        EXPECT_EQ(0, MappedFile_GetSize(NULL));
+        MappedFile_Close(NULL);
+    }
+
+    /* 書き込んだ内容を読めるか */
+    {
+#define TEST_FILE_SIZE (3 * 4096 + 123)
+        const char test_filename[] = "mapped_file_test.bin";
+        uint8_t data[TEST_FILE_SIZE];
+        uint32_t i, pattern;
+        struct MappedFile *file;
+
+        for (i = 0; i < TEST_FILE_SIZE; i++) {
+            data[i] = (uint8_t)(i * 7 + 3);
+        }
+        MappedFileTest_CreateFile(test_filename, data, TEST_FILE_SIZE);
+
+        for (pattern = 0; pattern < 2; pattern++) {
+            file = MappedFile_Open(test_filename, (MappedFileAccessPattern)pattern);
+            ASSERT_TRUE(file != NULL);
+            EXPECT_EQ(TEST_FILE_SIZE, MappedFile_GetSize(file));
+            EXPECT_EQ(0, memcmp(data, MappedFile_GetData(file), TEST_FILE_SIZE));
+            MappedFile_Close(file);
+        }
+
+        /* マップできない場合の読み込みでも同じ内容になるか */
+        file = (struct MappedFile *)malloc(sizeof(struct MappedFile));
+        file->size = TEST_FILE_SIZE;
+        ASSERT_EQ(1, MappedFile_ReadWhole(file, test_filename));
+        EXPECT_EQ(0, file->mapped);
+        EXPECT_EQ(0, memcmp(data, MappedFile_GetData(file), TEST_FILE_SIZE));
+        MappedFile_Close(file);
+
+        remove(test_filename);
+#undef TEST_FILE_SIZE
+    }
+
+    /* 空ファイル */
+    {
+        const char test_filename[] = "mapped_file_test_empty.bin";
+        struct MappedFile *file;
+
+        MappedFileTest_CreateFile(test_filename, NULL, 0);
+        file = MappedFile_Open(test_filename, MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL);
+        ASSERT_TRUE(file != NULL);
+        EXPECT_EQ(0, MappedFile_GetSize(file));
+        EXPECT_TRUE(MappedFile_GetData(file) != NULL);
+        MappedFile_Close(file);
+
+        remove(test_filename);
+    }
+}
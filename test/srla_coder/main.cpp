@@ -309,6 +309,255 @@ TEST(SRLACoderTest, RecursiveRiceTest)
     }
 }
 
+/* Riceパラメータ計算テスト */
+TEST(SRLACoderTest, CalculateOptimalRiceParameterTest)
+{
+    uint32_t i, k, is_ok = 1;
+
+    /* 閾値表によるパラメータが解析式によるパラメータと一致するか */
+    srand(0);
+    for (i = 0; i < 100000; i++) {
+        int32_t ref;
+        const double mean = ((double)rand() / RAND_MAX) * pow(2.0, (rand() % 40) - 10);
+        const double rho = 1.0 / (1.0 + mean);
+        SRLACoder_CalculateOptimalRiceParameter(mean, &k, NULL);
+        ref = (int32_t)SRLAUtility_Round(SRLAUtility_Log2(log(0.5127629514437670454896078808815218508243560791015625) / log(1.0 - rho)));
+        if ((int32_t)k != SRLAUTILITY_MAX(0, SRLAUTILITY_MIN(ref, 31))) {
+            printf("mean:%f actual:%d != ref:%d \n", mean, k, ref);
+            is_ok = 0;
+            break;
+        }
+    }
+    EXPECT_EQ(1, is_ok);
+
+    /* 平均0はパラメータ0 */
+    SRLACoder_CalculateOptimalRiceParameter(0.0, &k, NULL);
+    EXPECT_EQ(0, k);
+}
+
+/* 符号長計算テスト */
+TEST(SRLACoderTest, ComputeCodeLengthTest)
+{
+#define TEST_MAX_NUM_SAMPLES (257)
+    uint32_t i, num_samples, k, max_uval, ref_max;
+    int32_t set;
+    const int32_t max_set = SRLASIMD_DetectInstructionSet();
+    uint64_t sum, ref_sum;
+    int32_t data[TEST_MAX_NUM_SAMPLES];
+    uint32_t uval[TEST_MAX_NUM_SAMPLES];
+    const uint32_t test_num_samples[] = { 1, 3, 4, 8, 13, 64, TEST_MAX_NUM_SAMPLES };
+    const int32_t test_amplitudes[] = { 1, 100, 40000, INT32_MAX };
+
+    srand(0);
+    for (i = 0; i < sizeof(test_num_samples) / sizeof(test_num_samples[0]); i++) {
+        uint32_t amp, smpl;
+        num_samples = test_num_samples[i];
+        for (amp = 0; amp < sizeof(test_amplitudes) / sizeof(test_amplitudes[0]); amp++) {
+            for (smpl = 0; smpl < num_samples; smpl++) {
+                data[smpl] = (int32_t)(((int64_t)rand() * rand()) % test_amplitudes[amp]);
+                if (rand() % 2) {
+                    data[smpl] = -data[smpl] - 1;
+                }
+            }
+
+            /* 実行環境で使える全ての命令セットの実装で一致するか */
+            for (set = SRLA_SIMD_NONE; set <= max_set; set++) {
+                const struct SRLACoderFunctions *functions = SRLACoder_GetFunctions((SRLASIMDInstructionSet)set);
+
+                /* 変換と和・最大値 */
+                functions->convert_to_uint32_and_sum(data, num_samples, uval, &sum, &max_uval);
+                ref_sum = 0; ref_max = 0;
+                for (smpl = 0; smpl < num_samples; smpl++) {
+                    const uint32_t ref = SRLAUTILITY_SINT32_TO_UINT32(data[smpl]);
+                    EXPECT_EQ(ref, uval[smpl]);
+                    ref_sum += ref;
+                    ref_max = SRLAUTILITY_MAX(ref_max, ref);
+                }
+                EXPECT_EQ(ref_sum, sum);
+                EXPECT_EQ(ref_max, max_uval);
+
+                /* 符号長が逐次計算と一致するか */
+                for (k = 0; k < 20; k++) {
+                    uint32_t ref_length = 0;
+                    for (smpl = 0; smpl < num_samples; smpl++) {
+                        ref_length += 1 + k + (uval[smpl] >> k);
+                    }
+                    EXPECT_EQ(ref_length, functions->rice_code_length(uval, num_samples, k));
+                    ref_length = 0;
+                    for (smpl = 0; smpl < num_samples; smpl++) {
+                        ref_length += (k + 2) + (SRLAUTILITY_MAX(0, (int32_t)uval[smpl] - (int32_t)(2U << k)) >> k);
+                    }
+                    EXPECT_EQ(ref_length, functions->recursive_rice_code_length(uval, num_samples, k + 1, k));
+                }
+            }
+        }
+    }
+#undef TEST_MAX_NUM_SAMPLES
+}
+
+/* 復号テーブルによる復号テスト */
+TEST(SRLACoderTest, DecodeByTableTest)
+{
+    /* テーブルの各エントリが逐次復号と一致するか */
+    {
+        uint32_t k2, pattern, i, uval, rest;
+        int is_ok = 1;
+        struct SRLACoderDecodeTable *table
+            = (struct SRLACoderDecodeTable *)malloc(sizeof(struct SRLACoderDecodeTable));
+
+        SRLACoder_BuildDecodeTable(table);
+        for (k2 = 0; k2 < SRLACODER_NUM_DECODE_TABLES; k2++) {
+            for (pattern = 0; pattern < (1 << SRLACODER_DECODE_TABLE_BITS); pattern++) {
+                /* 参照ビットの後ろは1で埋めて、後続の符号が短く切れないようにする */
+                uint8_t data[8] = { 0, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+                struct BitStream strm;
+                data[0] = (uint8_t)(pattern >> 2);
+                data[1] = (uint8_t)((pattern << 6) | 0x3F);
+                BitReader_Open(&strm, data, sizeof(data));
+                for (i = 0; i < table->entries[k2][pattern].num_values; i++) {
+                    RecursiveRice_GetCode(&strm, k2 + 1, k2, &uval);
+                    if (SRLAUTILITY_UINT32_TO_SINT32(uval) != table->entries[k2][pattern].values[i]) {
+                        is_ok = 0;
+                    }
+                }
+                /* 消費ビット数の一致確認 */
+                BitReader_PeekBits(&strm, &rest, 32);
+                if (rest != (uint32_t)(((((uint64_t)data[0] << 8) | data[1]) << 48 | 0xFFFFFFFFFFFFULL)
+                            << table->entries[k2][pattern].num_bits >> 32)) {
+                    is_ok = 0;
+                }
+                BitStream_Close(&strm);
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        free(table);
+    }
+
+    /* 符号化したデータを表引きで復号できるか */
+    {
+#define TEST_MAX_NUM_SAMPLES (4096 + 3)
+        uint32_t i, num_samples, pattern;
+        int32_t *input, *output;
+        uint8_t *buffer;
+        struct SRLACoder *coder;
+        struct SRLACoderDecodeTable *table;
+        struct BitStream strm;
+        const uint32_t test_num_samples[] = { 1, 4, 5, 7, 64, 1000, TEST_MAX_NUM_SAMPLES };
+        /* 振幅: 小さいパラメータ（表引き）から大きいパラメータ（逐次）まで */
+        const int32_t test_amplitudes[] = { 0, 1, 2, 5, 12, 30, 100, 3000, 1 << 20 };
+
+        input = (int32_t *)malloc(sizeof(int32_t) * TEST_MAX_NUM_SAMPLES);
+        output = (int32_t *)malloc(sizeof(int32_t) * TEST_MAX_NUM_SAMPLES);
+        buffer = (uint8_t *)malloc(sizeof(int32_t) * 2 * TEST_MAX_NUM_SAMPLES);
+        table = (struct SRLACoderDecodeTable *)malloc(sizeof(struct SRLACoderDecodeTable));
+        coder = SRLACoder_Create(TEST_MAX_NUM_SAMPLES, NULL, 0);
+        ASSERT_TRUE(coder != NULL);
+        SRLACoder_BuildDecodeTable(table);
+
+        srand(0);
+        for (i = 0; i < sizeof(test_num_samples) / sizeof(test_num_samples[0]); i++) {
+            num_samples = test_num_samples[i];
+            for (pattern = 0; pattern < sizeof(test_amplitudes) / sizeof(test_amplitudes[0]); pattern++) {
+                uint32_t smpl;
+                const int32_t amp = test_amplitudes[pattern];
+                for (smpl = 0; smpl < num_samples; smpl++) {
+                    input[smpl] = (amp == 0) ? 0 : ((rand() % (2 * amp + 1)) - amp);
+                    /* 時々大きな値を混ぜて長い符号を作る */
+                    if ((rand() % 97) == 0) {
+                        input[smpl] = (rand() % 2) ? 40000 : -40000;
+                    }
+                }
+
+                BitWriter_Open(&strm, buffer, sizeof(int32_t) * 2 * TEST_MAX_NUM_SAMPLES);
+                SRLACoder_Encode(coder, &strm, input, num_samples);
+                BitStream_Flush(&strm);
+                BitStream_Close(&strm);
+
+                memset(output, 0xCD, sizeof(int32_t) * TEST_MAX_NUM_SAMPLES);
+                BitReader_Open(&strm, buffer, sizeof(int32_t) * 2 * TEST_MAX_NUM_SAMPLES);
+                SRLACoder_Decode(table, &strm, output, num_samples);
+                BitStream_Close(&strm);
+
+                EXPECT_EQ(0, memcmp(input, output, sizeof(int32_t) * num_samples));
+            }
+        }
+
+        SRLACoder_Destroy(coder);
+        free(table);
+        free(buffer);
+        free(output);
+        free(input);
+#undef TEST_MAX_NUM_SAMPLES
+    }
+}
+
+/* 32bit全域の値の符号化テスト */
+TEST(SRLACoderTest, EncodeDecodeFullRangeTest)
+{
+    /* 平均が大きくても1段目のパラメータが32bitに収まるか */
+    {
+        uint32_t k1, k2;
+        SRLACoder_CalculateOptimalRecursiveRiceParameter((double)UINT32_MAX, &k1, &k2, NULL);
+        EXPECT_EQ(k2 + 1, k1);
+        EXPECT_TRUE(k1 < 32);
+    }
+
+    /* 32bit全域に渡る値を含むデータを符号化・復号できるか */
+    {
+#define TEST_NUM_SAMPLES 4096
+        uint32_t smpl, pattern;
+        int32_t *input, *output;
+        uint8_t *buffer;
+        struct SRLACoder *coder;
+        struct SRLACoderDecodeTable *table;
+        struct BitStream strm;
+        /* 大きな値が続く区間の長さ（分割を細かくすると区間単位で最大のパラメータが選ばれる） */
+        const uint32_t test_burst_lengths[] = { 4, 64, TEST_NUM_SAMPLES };
+
+        input = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+        output = (int32_t *)malloc(sizeof(int32_t) * TEST_NUM_SAMPLES);
+        buffer = (uint8_t *)malloc(sizeof(int32_t) * 2 * TEST_NUM_SAMPLES);
+        table = (struct SRLACoderDecodeTable *)malloc(sizeof(struct SRLACoderDecodeTable));
+        coder = SRLACoder_Create(TEST_NUM_SAMPLES, NULL, 0);
+        ASSERT_TRUE(coder != NULL);
+        SRLACoder_BuildDecodeTable(table);
+
+        srand(0);
+        for (pattern = 0; pattern < sizeof(test_burst_lengths) / sizeof(test_burst_lengths[0]); pattern++) {
+            const uint32_t burst_length = test_burst_lengths[pattern];
+            for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                if ((smpl % 256) < burst_length) {
+                    /* 絶対値が2^30以上の値 */
+                    const int32_t val = (int32_t)((1U << 30) | (((uint32_t)rand() << 16) ^ (uint32_t)rand()));
+                    input[smpl] = (rand() % 2) ? val : (-val - 1);
+                } else {
+                    input[smpl] = (rand() % 7) - 3;
+                }
+            }
+
+            BitWriter_Open(&strm, buffer, sizeof(int32_t) * 2 * TEST_NUM_SAMPLES);
+            SRLACoder_Encode(coder, &strm, input, TEST_NUM_SAMPLES);
+            BitStream_Flush(&strm);
+            BitStream_Close(&strm);
+
+            memset(output, 0xCD, sizeof(int32_t) * TEST_NUM_SAMPLES);
+            BitReader_Open(&strm, buffer, sizeof(int32_t) * 2 * TEST_NUM_SAMPLES);
+            SRLACoder_Decode(table, &strm, output, TEST_NUM_SAMPLES);
+            BitStream_Close(&strm);
+
+            EXPECT_EQ(0, memcmp(input, output, sizeof(int32_t) * TEST_NUM_SAMPLES));
+        }
+
+        SRLACoder_Destroy(coder);
+        free(table);
+        free(buffer);
+        free(output);
+        free(input);
+#undef TEST_NUM_SAMPLES
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
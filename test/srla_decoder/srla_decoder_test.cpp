@@ -1,3 +1,4 @@
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -37,6 +38,9 @@ extern "C" {
         param__p->num_lookahead_samples     = 4096;\
         param__p->ltp_order                 = 1;\
         param__p->preset                    = 0;\
+        param__p->estimate_partition_cost   = 0;\
+        param__p->sliding_lookahead         = 0;\
+        param__p->seek_table_interval       = 0;\
     } while (0);
 
 /* 有効なコンフィグをセット */
@@ -48,6 +52,7 @@ extern "C" {
         config__p->max_num_samples_per_block = 4096;\
         config__p->max_num_lookahead_samples = 4096;\
         config__p->max_num_parameters        = 32;\
+        config__p->max_num_threads           = 1;\
     } while (0);
 
 /* 有効なデコーダコンフィグをセット */
@@ -57,6 +62,8 @@ extern "C" {
         config__p->max_num_channels   = 8;\
         config__p->max_num_parameters = 32;\
         config__p->check_checksum     = 1;\
+        config__p->max_num_threads    = 1;\
+        config__p->max_num_samples_per_block = 4096;\
     } while (0);
 
 /* ヘッダデコードテスト */
@@ -199,6 +206,31 @@ TEST(SRLADecoderTest, CreateDestroyHandleTest)
         SRLADecoder_SetValidConfig(&config);
         config.max_num_channels = 0;
         EXPECT_TRUE(SRLADecoder_CalculateWorkSize(&config) < 0);
+
+        /* ワークサイズがint32_tに収まらない */
+        SRLADecoder_SetValidConfig(&config);
+        config.max_num_parameters = 1UL << 20;
+        EXPECT_TRUE(SRLADecoder_CalculateWorkSize(&config) > 0);
+        config.max_num_threads = SRLA_MAX_NUM_THREADS;
+        EXPECT_TRUE(SRLADecoder_CalculateWorkSize(&config) < 0);
+        EXPECT_TRUE(SRLADecoder_Create(&config, NULL, 0) == NULL);
+    }
+
+    /* スレッド数0は1スレッドとして扱う */
+    {
+        int32_t work_size;
+        struct SRLADecoder *decoder;
+        struct SRLADecoderConfig config;
+
+        SRLADecoder_SetValidConfig(&config);
+        work_size = SRLADecoder_CalculateWorkSize(&config);
+        config.max_num_threads = 0;
+        EXPECT_EQ(work_size, SRLADecoder_CalculateWorkSize(&config));
+
+        decoder = SRLADecoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        EXPECT_EQ(1, decoder->max_num_threads);
+        SRLADecoder_Destroy(decoder);
     }
 
     /* ワーク領域渡しによるハンドル作成（成功例） */
@@ -524,3 +556,565 @@ TEST(SRLADecoderTest, DecodeBlockTest)
         SRLAEncoder_Destroy(encoder);
     }
 }
+
+/* 並列デコードテスト */
+TEST(SRLADecoderTest, DecodeWholeParallelTest)
+{
+    /* 逐次デコードと結果が一致するか */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES 40000
+        struct SRLAEncoder *encoder;
+        struct SRLADecoder *decoder;
+        struct SRLAEncoderConfig encoder_config;
+        struct SRLADecoderConfig decoder_config;
+        struct SRLAEncodeParameter parameter;
+        uint8_t *data;
+        int32_t *input[NUM_CHANNELS];
+        int32_t *output[NUM_CHANNELS];
+        uint32_t ch, smpl, sufficient_size, output_size, num_threads;
+
+        SRLAEncoder_SetValidConfig(&encoder_config);
+        SRLADecoder_SetValidConfig(&decoder_config);
+        decoder_config.max_num_threads = 4;
+        SRLAEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = NUM_CHANNELS;
+        parameter.max_num_samples_per_block = 4096;
+        parameter.ltp_order = 0;
+        parameter.preset = 2;
+
+        /* 十分なデータサイズ */
+        sufficient_size = SRLA_HEADER_SIZE + 2 * NUM_CHANNELS * NUM_SAMPLES * sizeof(int32_t);
+
+        /* データ領域確保・正弦波と乱数の混合信号を生成 */
+        data = (uint8_t *)malloc(sufficient_size);
+        srand(0);
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            output[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                input[ch][smpl] = (int32_t)(8000.0 * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+            }
+        }
+
+        /* エンコーダデコーダ作成 */
+        encoder = SRLAEncoder_Create(&encoder_config, NULL, 0);
+        decoder = SRLADecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        ASSERT_TRUE(decoder != NULL);
+
+        /* エンコード */
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, sufficient_size, &output_size, 0));
+
+        /* スレッド数を変えてデコード */
+        for (num_threads = 1; num_threads <= decoder_config.max_num_threads; num_threads++) {
+            for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                memset(output[ch], 0, sizeof(int32_t) * NUM_SAMPLES);
+            }
+            EXPECT_EQ(SRLA_APIRESULT_OK,
+                SRLADecoder_DecodeWholeParallel(decoder, num_threads,
+                    data, output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+            for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * NUM_SAMPLES));
+            }
+        }
+
+        /* 不正な引数 */
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeParallel(NULL, 2, data, output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeParallel(decoder, 0, data, output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeParallel(decoder, 2, NULL, output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeParallel(decoder, 2, data, output_size, NULL, NUM_CHANNELS, NUM_SAMPLES));
+
+        /* スレッド数・バッファ不足 */
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLADecoder_DecodeWholeParallel(decoder, decoder_config.max_num_threads + 1,
+                data, output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLADecoder_DecodeWholeParallel(decoder, 2, data, output_size, output, NUM_CHANNELS, NUM_SAMPLES - 1));
+
+        /* 末尾ブロックの破損を検知 */
+        data[output_size - 1] ^= 0xEF;
+        EXPECT_EQ(SRLA_APIRESULT_DETECT_DATA_CORRUPTION,
+            SRLADecoder_DecodeWholeParallel(decoder, 2, data, output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+
+        /* 領域の開放 */
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            free(output[ch]);
+            free(input[ch]);
+        }
+        free(data);
+        SRLADecoder_Destroy(decoder);
+        SRLAEncoder_Destroy(encoder);
+#undef NUM_SAMPLES
+#undef NUM_CHANNELS
+    }
+}
+
+/* インターリーブ出力のデコードテスト */
+TEST(SRLADecoderTest, DecodeInterleavedTest)
+{
+    /* チャンネル毎のデコードと結果が一致するか */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES 20000
+        struct SRLAEncoder *encoder;
+        struct SRLADecoder *decoder;
+        struct SRLAEncoderConfig encoder_config;
+        struct SRLADecoderConfig decoder_config;
+        struct SRLAEncodeParameter parameter;
+        uint8_t *data, *interleaved;
+        int32_t *input[NUM_CHANNELS];
+        uint32_t ch, smpl, sufficient_size, output_size, bits_no, format_no, lshift;
+        static const uint16_t bits_per_sample[] = { 16, 24 };
+        static const SRLAPcmFormat formats[] = { SRLA_PCM_FORMAT_INT16, SRLA_PCM_FORMAT_INT24, SRLA_PCM_FORMAT_INT32 };
+
+        SRLAEncoder_SetValidConfig(&encoder_config);
+        SRLADecoder_SetValidConfig(&decoder_config);
+
+        sufficient_size = SRLA_HEADER_SIZE + 2 * NUM_CHANNELS * NUM_SAMPLES * sizeof(int32_t);
+        data = (uint8_t *)malloc(sufficient_size);
+        interleaved = (uint8_t *)malloc(sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES);
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        }
+
+        encoder = SRLAEncoder_Create(&encoder_config, NULL, 0);
+        decoder = SRLADecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        ASSERT_TRUE(decoder != NULL);
+
+        for (bits_no = 0; bits_no < sizeof(bits_per_sample) / sizeof(bits_per_sample[0]); bits_no++) {
+            /* 下位ビットが0の信号も確認 */
+            for (lshift = 0; lshift <= 2; lshift += 2) {
+                const int32_t amplitude = (1 << (bits_per_sample[bits_no] - 2));
+                SRLAEncoder_SetValidEncodeParameter(&parameter);
+                parameter.num_channels = NUM_CHANNELS;
+                parameter.bits_per_sample = bits_per_sample[bits_no];
+                parameter.max_num_samples_per_block = 4096;
+                parameter.preset = 2;
+
+                /* 正弦波と乱数の混合信号（末尾に無音区間） */
+                srand(0);
+                for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                        int32_t val = 0;
+                        if (smpl < (NUM_SAMPLES - 5000)) {
+                            val = (int32_t)(amplitude * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+                        }
+                        input[ch][smpl] = (int32_t)((uint32_t)(val >> lshift) << lshift);
+                    }
+                }
+
+                ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+                ASSERT_EQ(SRLA_APIRESULT_OK,
+                    SRLAEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, sufficient_size, &output_size, 0));
+
+                for (format_no = 0; format_no < sizeof(formats) / sizeof(formats[0]); format_no++) {
+                    const uint32_t format_bits = SRLAUTILITY_PCM_FORMAT_BITS_PER_SAMPLE(formats[format_no]);
+
+                    /* 形式のビット幅が足りないときは失敗 */
+                    if (format_bits < bits_per_sample[bits_no]) {
+                        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+                            SRLADecoder_DecodeWholeInterleaved(decoder, data, output_size,
+                                interleaved, formats[format_no], NUM_SAMPLES));
+                        continue;
+                    }
+
+                    memset(interleaved, 0xCD, sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES);
+                    ASSERT_EQ(SRLA_APIRESULT_OK,
+                        SRLADecoder_DecodeWholeInterleaved(decoder, data, output_size,
+                            interleaved, formats[format_no], NUM_SAMPLES));
+
+                    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                            const uint32_t pos = NUM_CHANNELS * smpl + ch;
+                            int32_t val;
+                            switch (formats[format_no]) {
+                            case SRLA_PCM_FORMAT_INT16: val = ((int16_t *)interleaved)[pos]; break;
+                            case SRLA_PCM_FORMAT_INT24: val = SRLAUTILITY_GET_INT24LE(&interleaved[3 * pos]); break;
+                            default:                    val = ((int32_t *)interleaved)[pos]; break;
+                            }
+                            ASSERT_EQ(input[ch][smpl], val);
+                        }
+                    }
+                }
+            }
+        }
+
+        /* 不正な引数 */
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeInterleaved(NULL, data, output_size, interleaved, SRLA_PCM_FORMAT_INT32, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeInterleaved(decoder, NULL, output_size, interleaved, SRLA_PCM_FORMAT_INT32, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeInterleaved(decoder, data, output_size, NULL, SRLA_PCM_FORMAT_INT32, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLADecoder_DecodeWholeInterleaved(decoder, data, output_size, interleaved, (SRLAPcmFormat)3, NUM_SAMPLES));
+        /* 出力サンプル数不足 */
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLADecoder_DecodeWholeInterleaved(decoder, data, output_size, interleaved, SRLA_PCM_FORMAT_INT32, NUM_SAMPLES - 1));
+
+        SRLADecoder_Destroy(decoder);
+
+        /* 作業バッファを確保していないハンドルではデコードできない */
+        decoder_config.max_num_samples_per_block = 0;
+        decoder = SRLADecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(decoder != NULL);
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLADecoder_DecodeWholeInterleaved(decoder, data, output_size, interleaved, SRLA_PCM_FORMAT_INT32, NUM_SAMPLES));
+
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            free(input[ch]);
+        }
+        free(data);
+        free(interleaved);
+        SRLADecoder_Destroy(decoder);
+        SRLAEncoder_Destroy(encoder);
+#undef NUM_SAMPLES
+#undef NUM_CHANNELS
+    }
+}
+
+/* ストリーミングデコードの出力先 */
+struct SRLAStreamDecoderTestOutput {
+    int32_t *buffer[SRLA_MAX_NUM_CHANNELS];
+    uint32_t buffer_num_samples;
+    uint32_t num_samples;
+    uint32_t num_callbacks;
+};
+
+/* ストリーミングデコードの出力コールバック */
+static void SRLAStreamDecoderTest_OutputCallback(
+    const int32_t *const *samples, uint32_t num_channels, uint32_t num_samples, void *user_data)
+{
+    uint32_t ch;
+    struct SRLAStreamDecoderTestOutput *output = (struct SRLAStreamDecoderTestOutput *)user_data;
+    ASSERT_TRUE((output->num_samples + num_samples) <= output->buffer_num_samples);
+    for (ch = 0; ch < num_channels; ch++) {
+        memcpy(&output->buffer[ch][output->num_samples], samples[ch], sizeof(int32_t) * num_samples);
+    }
+    output->num_samples += num_samples;
+    output->num_callbacks++;
+}
+
+/* ストリーミングデコードテスト */
+TEST(SRLADecoderTest, StreamDecoderTest)
+{
+    /* ハンドル作成失敗 */
+    {
+        struct SRLADecoderConfig config;
+
+        SRLADecoder_SetValidConfig(&config);
+        config.max_num_samples_per_block = 0;
+        EXPECT_TRUE(SRLAStreamDecoder_CalculateWorkSize(&config) < 0);
+        EXPECT_TRUE(SRLAStreamDecoder_Create(&config, NULL, 0) == NULL);
+        EXPECT_TRUE(SRLAStreamDecoder_CalculateWorkSize(NULL) < 0);
+    }
+
+    /* 任意サイズに分割した入力でも一括デコードと結果が一致するか */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES 40000
+        struct SRLAEncoder *encoder;
+        struct SRLAStreamDecoder *stream_decoder;
+        struct SRLAEncoderConfig encoder_config;
+        struct SRLADecoderConfig decoder_config;
+        struct SRLAEncodeParameter parameter;
+        struct SRLAHeader header;
+        struct SRLAStreamDecoderTestOutput output;
+        uint8_t *data, *gap_data;
+        int32_t *input[NUM_CHANNELS];
+        uint32_t ch, smpl, sufficient_size, output_size, progress, trial, prefix, suffix;
+
+        SRLAEncoder_SetValidConfig(&encoder_config);
+        SRLADecoder_SetValidConfig(&decoder_config);
+        SRLAEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = NUM_CHANNELS;
+        parameter.max_num_samples_per_block = 4096;
+        parameter.ltp_order = 0;
+        parameter.preset = 2;
+
+        /* 十分なデータサイズ */
+        sufficient_size = SRLA_HEADER_SIZE + 2 * NUM_CHANNELS * NUM_SAMPLES * sizeof(int32_t);
+
+        /* データ領域確保・正弦波と乱数の混合信号を生成 */
+        data = (uint8_t *)malloc(sufficient_size);
+        gap_data = (uint8_t *)malloc(sufficient_size);
+        srand(0);
+        output.buffer_num_samples = NUM_SAMPLES;
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            output.buffer[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                input[ch][smpl] = (int32_t)(8000.0 * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+            }
+        }
+
+        /* エンコーダ・ストリーミングデコーダ作成 */
+        encoder = SRLAEncoder_Create(&encoder_config, NULL, 0);
+        stream_decoder = SRLAStreamDecoder_Create(&decoder_config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        ASSERT_TRUE(stream_decoder != NULL);
+
+        /* エンコード */
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, sufficient_size, &output_size, 0));
+
+        /* 開始前の入力・不正な引数 */
+        EXPECT_EQ(SRLA_APIRESULT_PARAMETER_NOT_SET, SRLAStreamDecoder_Push(stream_decoder, data, output_size));
+        EXPECT_EQ(SRLA_APIRESULT_PARAMETER_NOT_SET, SRLAStreamDecoder_Finish(stream_decoder));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT, SRLAStreamDecoder_Start(NULL, SRLAStreamDecoderTest_OutputCallback, &output));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT, SRLAStreamDecoder_Start(stream_decoder, NULL, &output));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT, SRLAStreamDecoder_Push(NULL, data, output_size));
+
+        /* 1byteずつ・ランダムなサイズ・一括で入力 */
+        for (trial = 0; trial < 3; trial++) {
+            output.num_samples = output.num_callbacks = 0;
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Start(stream_decoder, SRLAStreamDecoderTest_OutputCallback, &output));
+            EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_DATA, SRLAStreamDecoder_GetHeader(stream_decoder, &header));
+            progress = 0;
+            while (progress < output_size) {
+                uint32_t push_size;
+                switch (trial) {
+                case 0:  push_size = 1; break;
+                case 1:  push_size = 1 + (uint32_t)rand() % 5000; break;
+                default: push_size = output_size; break;
+                }
+                push_size = SRLAUTILITY_MIN(push_size, output_size - progress);
+                ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Push(stream_decoder, &data[progress], push_size));
+                progress += push_size;
+            }
+            EXPECT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_GetHeader(stream_decoder, &header));
+            EXPECT_EQ(NUM_SAMPLES, header.num_samples);
+            EXPECT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Finish(stream_decoder));
+            EXPECT_EQ(NUM_SAMPLES, output.num_samples);
+            EXPECT_EQ((NUM_SAMPLES + parameter.max_num_samples_per_block - 1) / parameter.max_num_samples_per_block, output.num_callbacks);
+            for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                EXPECT_EQ(0, memcmp(input[ch], output.buffer[ch], sizeof(int32_t) * NUM_SAMPLES));
+            }
+        }
+
+        /* 総サンプル数が未知のヘッダでもデコードできるか */
+        ByteArray_WriteUint32BE(&data[14], SRLA_NUM_SAMPLES_UNKNOWN);
+        output.num_samples = output.num_callbacks = 0;
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Start(stream_decoder, SRLAStreamDecoderTest_OutputCallback, &output));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Push(stream_decoder, data, output_size));
+        EXPECT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Finish(stream_decoder));
+        EXPECT_EQ(NUM_SAMPLES, output.num_samples);
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            EXPECT_EQ(0, memcmp(input[ch], output.buffer[ch], sizeof(int32_t) * NUM_SAMPLES));
+        }
+
+        /* 末尾が欠けている */
+        output.num_samples = output.num_callbacks = 0;
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Start(stream_decoder, SRLAStreamDecoderTest_OutputCallback, &output));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Push(stream_decoder, data, output_size - 1));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_DATA, SRLAStreamDecoder_Finish(stream_decoder));
+        EXPECT_TRUE(output.num_samples < NUM_SAMPLES);
+
+        /* 途中のデータが欠落しても再同期して後続のブロックをデコードできるか */
+        {
+            const uint32_t gap_offset = output_size / 3, gap_size = output_size / 5;
+            memcpy(gap_data, data, gap_offset);
+            memcpy(&gap_data[gap_offset], &data[gap_offset + gap_size], output_size - gap_offset - gap_size);
+            output.num_samples = output.num_callbacks = 0;
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Start(stream_decoder, SRLAStreamDecoderTest_OutputCallback, &output));
+            progress = 0;
+            while (progress < (output_size - gap_size)) {
+                uint32_t push_size = 1 + (uint32_t)rand() % 3000;
+                push_size = SRLAUTILITY_MIN(push_size, output_size - gap_size - progress);
+                ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamDecoder_Push(stream_decoder, &gap_data[progress], push_size));
+                progress += push_size;
+            }
+            EXPECT_EQ(SRLA_APIRESULT_DETECT_DATA_CORRUPTION, SRLAStreamDecoder_Finish(stream_decoder));
+            ASSERT_TRUE(output.num_samples < NUM_SAMPLES);
+            /* 出力は入力の先頭部分と末尾部分の連結になっている */
+            for (prefix = 0; prefix < output.num_samples; prefix++) {
+                if (output.buffer[0][prefix] != input[0][prefix]) {
+                    break;
+                }
+            }
+            suffix = output.num_samples - prefix;
+            EXPECT_TRUE(prefix > 0);
+            EXPECT_TRUE(suffix > 0);
+            for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                EXPECT_EQ(0, memcmp(input[ch], output.buffer[ch], sizeof(int32_t) * prefix));
+                EXPECT_EQ(0, memcmp(&input[ch][NUM_SAMPLES - suffix], &output.buffer[ch][prefix], sizeof(int32_t) * suffix));
+            }
+        }
+
+        /* 領域の開放 */
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            free(output.buffer[ch]);
+            free(input[ch]);
+        }
+        free(gap_data);
+        free(data);
+        SRLAStreamDecoder_Destroy(stream_decoder);
+        SRLAEncoder_Destroy(encoder);
+#undef NUM_SAMPLES
+#undef NUM_CHANNELS
+    }
+}
+
+/* シークテスト */
+TEST(SRLADecoderTest, SeekTest)
+{
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES 40000
+    struct SRLAEncoder *encoder;
+    struct SRLADecoder *decoder;
+    struct SRLAEncoderConfig encoder_config;
+    struct SRLADecoderConfig decoder_config;
+    struct SRLAEncodeParameter parameter;
+    struct SRLAHeader header;
+    uint8_t *data, *table_data;
+    int32_t *input[NUM_CHANNELS];
+    int32_t *output[NUM_CHANNELS];
+    uint32_t ch, smpl, sufficient_size, output_size, table_output_size, trial;
+    uint32_t block_offset, num_skip_samples, table_block_offset, table_num_skip_samples;
+    uint32_t decode_size, num_decode_samples;
+
+    SRLAEncoder_SetValidConfig(&encoder_config);
+    SRLADecoder_SetValidConfig(&decoder_config);
+    decoder_config.max_num_threads = 4;
+    SRLAEncoder_SetValidEncodeParameter(&parameter);
+    parameter.num_channels = NUM_CHANNELS;
+    parameter.max_num_samples_per_block = 4096;
+    parameter.ltp_order = 0;
+    parameter.preset = 2;
+
+    /* 十分なデータサイズ */
+    sufficient_size = SRLA_HEADER_SIZE + 2 * NUM_CHANNELS * NUM_SAMPLES * sizeof(int32_t);
+
+    /* データ領域確保・正弦波と乱数の混合信号を生成 */
+    data = (uint8_t *)malloc(sufficient_size);
+    table_data = (uint8_t *)malloc(sufficient_size);
+    srand(0);
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+        input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        output[ch] = (int32_t *)malloc(sizeof(int32_t) * 2 * NUM_SAMPLES);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            input[ch][smpl] = (int32_t)(8000.0 * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+        }
+    }
+
+    /* エンコーダデコーダ作成 */
+    encoder = SRLAEncoder_Create(&encoder_config, NULL, 0);
+    decoder = SRLADecoder_Create(&decoder_config, NULL, 0);
+    ASSERT_TRUE(encoder != NULL);
+    ASSERT_TRUE(decoder != NULL);
+
+    /* シークテーブルなし・ありでエンコード */
+    ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+    ASSERT_EQ(SRLA_APIRESULT_OK,
+        SRLAEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, sufficient_size, &output_size, 0));
+    parameter.seek_table_interval = 8192;
+    ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+    ASSERT_EQ(SRLA_APIRESULT_OK,
+        SRLAEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, table_data, sufficient_size, &table_output_size, 0));
+
+    /* シークテーブルはブロック列の末尾に付加される */
+    ASSERT_TRUE(table_output_size > output_size);
+    EXPECT_EQ(0, memcmp(data, table_data, output_size));
+
+    /* シークテーブルがあっても一括デコードできる */
+    EXPECT_EQ(SRLA_APIRESULT_OK,
+        SRLADecoder_DecodeWhole(decoder, table_data, table_output_size, output, NUM_CHANNELS, NUM_SAMPLES));
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+        EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * NUM_SAMPLES));
+    }
+
+    /* シークテーブルがあっても並列デコードできる（バッファがサンプル数より大きい場合も末尾のシークテーブルを読まない） */
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+        memset(output[ch], 0, sizeof(int32_t) * 2 * NUM_SAMPLES);
+    }
+    EXPECT_EQ(SRLA_APIRESULT_OK,
+        SRLADecoder_DecodeWholeParallel(decoder, decoder_config.max_num_threads,
+            table_data, table_output_size, output, NUM_CHANNELS, 2 * NUM_SAMPLES));
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+        EXPECT_EQ(0, memcmp(input[ch], output[ch], sizeof(int32_t) * NUM_SAMPLES));
+    }
+
+    /* シークテーブルを正しく取得できるか */
+    {
+        const uint8_t *seek_points;
+        uint32_t num_points;
+        EXPECT_EQ(SRLA_ERROR_OK, SRLADecoder_FindSeekTable(table_data, table_output_size, &seek_points, &num_points));
+        EXPECT_TRUE(num_points > 1);
+        EXPECT_TRUE(num_points <= ((NUM_SAMPLES + parameter.seek_table_interval - 1) / parameter.seek_table_interval));
+        EXPECT_EQ(table_output_size - output_size, SRLA_SEEK_TABLE_CHUNK_SIZE(num_points));
+        EXPECT_EQ(SRLA_HEADER_SIZE, ByteArray_ReadUint32BE(&seek_points[0]));
+        EXPECT_EQ(0, ByteArray_ReadUint32BE(&seek_points[4]));
+        EXPECT_NE(SRLA_ERROR_OK, SRLADecoder_FindSeekTable(data, output_size, &seek_points, &num_points));
+    }
+
+    /* ヘッダ未セット・不正な引数 */
+    EXPECT_EQ(SRLA_APIRESULT_OK, SRLADecoder_DecodeHeader(data, output_size, &header));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLADecoder_Seek(NULL, data, output_size, 0, &block_offset, &num_skip_samples));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLADecoder_Seek(decoder, NULL, output_size, 0, &block_offset, &num_skip_samples));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLADecoder_Seek(decoder, data, output_size, 0, NULL, &num_skip_samples));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLADecoder_Seek(decoder, data, output_size, 0, &block_offset, NULL));
+    EXPECT_EQ(SRLA_APIRESULT_OK, SRLADecoder_SetHeader(decoder, &header));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLADecoder_Seek(decoder, data, output_size, NUM_SAMPLES, &block_offset, &num_skip_samples));
+
+    /* ランダムな位置にシークしてデコード */
+    for (trial = 0; trial < 200; trial++) {
+        const uint32_t sample_index = (trial == 0) ? 0 : ((trial == 1) ? (NUM_SAMPLES - 1) : ((uint32_t)rand() % NUM_SAMPLES));
+
+        /* シークテーブルなし・ありで同じ位置を指す */
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLADecoder_Seek(decoder, data, output_size, sample_index, &block_offset, &num_skip_samples));
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLADecoder_Seek(decoder, table_data, table_output_size, sample_index, &table_block_offset, &table_num_skip_samples));
+        EXPECT_EQ(block_offset, table_block_offset);
+        EXPECT_EQ(num_skip_samples, table_num_skip_samples);
+
+        /* シーク位置のブロックをデコードし、読み捨て後の先頭が指定サンプルと一致 */
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLADecoder_DecodeBlock(decoder, &table_data[table_block_offset], table_output_size - table_block_offset,
+                output, NUM_CHANNELS, NUM_SAMPLES, &decode_size, &num_decode_samples));
+        ASSERT_TRUE(table_num_skip_samples < num_decode_samples);
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            EXPECT_EQ(0, memcmp(&input[ch][sample_index], &output[ch][table_num_skip_samples],
+                sizeof(int32_t) * (num_decode_samples - table_num_skip_samples)));
+        }
+    }
+
+    /* シークテーブルが壊れていたら先頭から辿る */
+    table_data[table_output_size - SRLA_SEEK_TABLE_FOOTER_SIZE - 1] ^= 0xEF;
+    EXPECT_EQ(SRLA_APIRESULT_OK,
+        SRLADecoder_Seek(decoder, data, output_size, NUM_SAMPLES - 1, &block_offset, &num_skip_samples));
+    EXPECT_EQ(SRLA_APIRESULT_OK,
+        SRLADecoder_Seek(decoder, table_data, table_output_size, NUM_SAMPLES - 1, &table_block_offset, &table_num_skip_samples));
+    EXPECT_EQ(block_offset, table_block_offset);
+    EXPECT_EQ(num_skip_samples, table_num_skip_samples);
+
+    /* 途中で途切れたデータ */
+    EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_DATA,
+        SRLADecoder_Seek(decoder, data, output_size / 2, NUM_SAMPLES - 1, &block_offset, &num_skip_samples));
+
+    /* 領域の開放 */
+    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+        free(output[ch]);
+        free(input[ch]);
+    }
+    free(table_data);
+    free(data);
+    SRLADecoder_Destroy(decoder);
+    SRLAEncoder_Destroy(encoder);
+#undef NUM_SAMPLES
+#undef NUM_CHANNELS
+}
@@ -2,3 +2,148 @@
 extern "C" {
 #include "../../libs/srla_decoder/src/srla_lpc_synthesize.c"
 }
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+/* LPC合成テスト */
+TEST(SRLALPCSynthesizeTest, LPCSynthesizeTest)
+{
+#define TEST_MAX_NUM_SAMPLES 600
+    uint32_t i, order, smpl, ord;
+    int32_t set;
+    const int32_t max_set = SRLASIMD_DetectInstructionSet();
+    int32_t data[TEST_MAX_NUM_SAMPLES], answer[TEST_MAX_NUM_SAMPLES], coef[SRLA_MAX_COEFFICIENT_ORDER];
+    const uint32_t rshift = 8;
+    const uint32_t test_orders[] = {
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+        23, 24, 25, 31, 32, 33, 64, 100, SRLA_MAX_COEFFICIENT_ORDER };
+
+    srand(0);
+    for (i = 0; i < sizeof(test_orders) / sizeof(test_orders[0]); i++) {
+        uint32_t num_samples;
+        order = test_orders[i];
+        /* 係数の絶対値和を抑えて発散しないようにする */
+        for (ord = 0; ord < order; ord++) {
+            const int32_t range = SRLAUTILITY_MAX(1, (1 << rshift) / (int32_t)order);
+            coef[ord] = (rand() % (2 * range + 1)) - range;
+        }
+        for (smpl = 0; smpl < TEST_MAX_NUM_SAMPLES; smpl++) {
+            data[smpl] = (rand() % (1 << 12)) - (1 << 11);
+        }
+
+        /* 様々な長さで逐次合成と比較 */
+        for (num_samples = order + 1; num_samples <= TEST_MAX_NUM_SAMPLES; num_samples += 37) {
+            int32_t work[TEST_MAX_NUM_SAMPLES];
+
+            memcpy(answer, data, sizeof(int32_t) * num_samples);
+            for (smpl = 1; smpl < order; smpl++) {
+                answer[smpl] += answer[smpl - 1];
+            }
+            for (smpl = 0; smpl < num_samples - order; smpl++) {
+                int32_t predict = 1 << (rshift - 1);
+                for (ord = 0; ord < order; ord++) {
+                    predict += coef[ord] * answer[smpl + ord];
+                }
+                answer[smpl + order] -= (predict >> rshift);
+            }
+
+            /* 実行環境で使える全ての命令セットの実装で一致するか */
+            for (set = SRLA_SIMD_NONE; set <= max_set; set++) {
+                memcpy(work, data, sizeof(int32_t) * num_samples);
+                SRLASynthesize_GetFunctions((SRLASIMDInstructionSet)set)->lpc_synthesize(
+                        work, num_samples, coef, order, rshift);
+                EXPECT_EQ(0, memcmp(answer, work, sizeof(int32_t) * num_samples));
+            }
+        }
+    }
+#undef TEST_MAX_NUM_SAMPLES
+}
+
+/* LTP合成テスト */
+TEST(SRLALPCSynthesizeTest, LTPSynthesizeTest)
+{
+#define TEST_NUM_SAMPLES 257
+    uint32_t i, order, period, smpl, ord;
+    int32_t set;
+    const int32_t max_set = SRLASIMD_DetectInstructionSet();
+    int32_t data[TEST_NUM_SAMPLES], answer[TEST_NUM_SAMPLES], coef[SRLA_MAX_LTP_ORDER];
+    const uint32_t rshift = SRLA_LTP_COEFFICIENT_BITWIDTH - 1;
+
+    srand(0);
+    for (order = 1; order <= SRLA_MAX_LTP_ORDER; order += 2) {
+        /* 最短周期付近はベクトル幅より近いサンプルを参照する */
+        for (period = SRLA_LTP_MIN_PERIOD; period <= SRLA_LTP_MIN_PERIOD + 20; period++) {
+            const uint32_t half_order = order >> 1;
+            for (ord = 0; ord < order; ord++) {
+                coef[ord] = (rand() % (1 << SRLA_LTP_COEFFICIENT_BITWIDTH)) - (1 << rshift);
+            }
+            for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+                data[smpl] = (rand() % (1 << 16)) - (1 << 15);
+            }
+
+            /* 逐次合成による参照結果 */
+            memcpy(answer, data, sizeof(int32_t) * TEST_NUM_SAMPLES);
+            for (smpl = period + half_order + 1; smpl < TEST_NUM_SAMPLES; smpl++) {
+                int32_t predict = 1 << (rshift - 1);
+                for (ord = 0; ord < order; ord++) {
+                    predict += coef[ord] * answer[smpl - period - half_order + ord];
+                }
+                answer[smpl] += (predict >> rshift);
+            }
+
+            /* 様々な長さで一致確認 */
+            for (i = 0; i < 3; i++) {
+                int32_t work[TEST_NUM_SAMPLES];
+                const uint32_t num_samples = TEST_NUM_SAMPLES - 5 * i;
+                for (set = SRLA_SIMD_NONE; set <= max_set; set++) {
+                    memcpy(work, data, sizeof(int32_t) * num_samples);
+                    SRLASynthesize_GetFunctions((SRLASIMDInstructionSet)set)->ltp_synthesize(
+                            work, num_samples, coef, order, period, rshift);
+                    EXPECT_EQ(0, memcmp(answer, work, sizeof(int32_t) * num_samples));
+                }
+            }
+        }
+    }
+#undef TEST_NUM_SAMPLES
+}
+
+/* 高次・長ブロックでSIMD実装がスカラー実装と一致するかのテスト */
+TEST(SRLALPCSynthesizeTest, SIMDConsistencyTest)
+{
+#define TEST_NUM_SAMPLES 4099
+    uint32_t i, smpl, ord;
+    int32_t set;
+    const int32_t max_set = SRLASIMD_DetectInstructionSet();
+    const struct SRLASynthesizeFunctions *scalar = SRLASynthesize_GetFunctions(SRLA_SIMD_NONE);
+    static int32_t data[TEST_NUM_SAMPLES], answer[TEST_NUM_SAMPLES], work[TEST_NUM_SAMPLES];
+    int32_t coef[SRLA_MAX_COEFFICIENT_ORDER];
+    const uint32_t rshift = 8;
+    const uint32_t test_orders[] = {
+        16, 31, 47, 48, 49, 63, 64, 65, 127, 128, 200, SRLA_MAX_COEFFICIENT_ORDER };
+
+    srand(0);
+    for (i = 0; i < sizeof(test_orders) / sizeof(test_orders[0]); i++) {
+        const uint32_t order = test_orders[i];
+        /* 係数の絶対値和を抑えて発散しないようにする */
+        for (ord = 0; ord < order; ord++) {
+            const int32_t range = SRLAUTILITY_MAX(1, (1 << rshift) / (int32_t)order);
+            coef[ord] = (rand() % (2 * range + 1)) - range;
+        }
+        for (smpl = 0; smpl < TEST_NUM_SAMPLES; smpl++) {
+            data[smpl] = (rand() % (1 << 12)) - (1 << 11);
+        }
+
+        memcpy(answer, data, sizeof(int32_t) * TEST_NUM_SAMPLES);
+        scalar->lpc_synthesize(answer, TEST_NUM_SAMPLES, coef, order, rshift);
+        for (set = SRLA_SIMD_NONE + 1; set <= max_set; set++) {
+            memcpy(work, data, sizeof(int32_t) * TEST_NUM_SAMPLES);
+            SRLASynthesize_GetFunctions((SRLASIMDInstructionSet)set)->lpc_synthesize(
+                    work, TEST_NUM_SAMPLES, coef, order, rshift);
+            EXPECT_EQ(0, memcmp(answer, work, sizeof(int32_t) * TEST_NUM_SAMPLES));
+        }
+    }
+#undef TEST_NUM_SAMPLES
+}
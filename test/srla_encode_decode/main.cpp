@@ -46,6 +46,8 @@ static void SRLAEncodeDecodeTest_GenerateNyquistOsc(double **data, uint32_t num_
 static void SRLAEncodeDecodeTest_GenerateGaussNoise(double **data, uint32_t num_channels, uint32_t num_samples);
 /* 先頭部分で微小なインパルスの生成 */
 static void SRLAEncodeDecodeTest_GenerateMiniImpulse(double** data, uint32_t num_channels, uint32_t num_samples);
+/* 矩形波の生成 */
+static void SRLAEncodeDecodeTest_GenerateSquareWave(double **data, uint32_t num_channels, uint32_t num_samples);
 
 /* 無音の生成 */
 static void SRLAEncodeDecodeTest_GenerateSilence(
@@ -164,7 +166,7 @@ static void SRLAEncodeDecodeTest_GenerateNyquistOsc(
 
     for (ch = 0; ch < num_channels; ch++) {
         for (smpl = 0; smpl < num_samples; smpl++) {
-            data[ch][smpl] = (smpl % 2 == 0) ? 1.0f : -1.0f;
+            data[ch][smpl] = (smpl % 2 == 0) ? 1.0 : -1.0;
         }
     }
 }
@@ -207,6 +209,21 @@ static void SRLAEncodeDecodeTest_GenerateMiniImpulse(
     }
 }
 
+/* 矩形波の生成 */
+static void SRLAEncodeDecodeTest_GenerateSquareWave(
+        double **data, uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t smpl, ch;
+
+    assert(data != NULL);
+
+    for (ch = 0; ch < num_channels; ch++) {
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            data[ch][smpl] = (((smpl / 50) % 2) == 0) ? 1.0 : -1.0;
+        }
+    }
+}
+
 /* double入力データの固定小数化 */
 static void SRLAEncodeDecodeTest_InputDoubleToInputFixedFloat(
         const struct SRLAEncodeParameter *param, uint32_t offset_lshift,
@@ -220,12 +237,10 @@ static void SRLAEncodeDecodeTest_InputDoubleToInputFixedFloat(
         for (smpl = 0; smpl < num_samples; smpl++) {
             assert(fabs(input_double[ch][smpl]) <= 1.0f);
             /* まずはビット幅のデータを作る */
-            input_int32[ch][smpl]
-                = (int32_t)SRLAUtility_Round(input_double[ch][smpl] * pow(2, param->bits_per_sample - 1));
-            /* クリップ */
-            if (input_int32[ch][smpl] >= (1L << (param->bits_per_sample - 1))) {
-                input_int32[ch][smpl] = (1L << (param->bits_per_sample - 1)) - 1;
-            }
+            /* 補足）32bitでもオーバーフローしないようdoubleのままクリップしてから整数化 */
+            const double max_val = pow(2, param->bits_per_sample - 1);
+            const double val = SRLAUtility_Round(input_double[ch][smpl] * max_val);
+            input_int32[ch][smpl] = (int32_t)((val >= max_val) ? (max_val - 1.0) : val);
             /* 左シフト量だけ下位ビットのデータを消す */
             input_int32[ch][smpl] &= ~((1UL << offset_lshift) - 1);
         }
@@ -243,6 +258,8 @@ static int32_t SRLAEncodeDecodeTest_ExecuteTestCase(const struct EncodeDecodeTes
     int32_t **input;
     uint8_t *data;
     int32_t **output;
+    int32_t *interleaved_output;
+    SRLAPcmFormat format;
     SRLAApiResult api_ret;
 
     struct SRLAEncoderConfig encoder_config;
@@ -267,9 +284,12 @@ static int32_t SRLAEncodeDecodeTest_ExecuteTestCase(const struct EncodeDecodeTes
     encoder_config.max_num_samples_per_block = test_case->encode_parameter.max_num_samples_per_block;
     encoder_config.max_num_lookahead_samples = test_case->encode_parameter.num_lookahead_samples;
     encoder_config.max_num_parameters        = preset->max_num_parameters;
+    encoder_config.max_num_threads           = 1;
     decoder_config.max_num_channels          = num_channels;
+    decoder_config.max_num_samples_per_block = test_case->encode_parameter.max_num_samples_per_block;
     decoder_config.max_num_parameters        = preset->max_num_parameters;
     decoder_config.check_checksum            = 1;
+    decoder_config.max_num_threads           = 1;
 
     /* 一時領域の割り当て */
     input_double  = (double **)malloc(sizeof(double*) * num_channels);
@@ -281,6 +301,7 @@ static int32_t SRLAEncodeDecodeTest_ExecuteTestCase(const struct EncodeDecodeTes
         input[ch]         = (int32_t *)malloc(sizeof(int32_t) * num_samples);
         output[ch]        = (int32_t *)malloc(sizeof(int32_t) * num_samples);
     }
+    interleaved_output = (int32_t *)malloc(sizeof(int32_t) * num_channels * num_samples);
 
     /* エンコード・デコードハンドル作成 */
     encoder = SRLAEncoder_Create(&encoder_config, NULL, 0);
@@ -361,6 +382,75 @@ static int32_t SRLAEncodeDecodeTest_ExecuteTestCase(const struct EncodeDecodeTes
         }
     }
 
+    /* インターリーブデコード（ビット深度に合う最小の形式で出力） */
+    switch (test_case->encode_parameter.bits_per_sample) {
+    case 8: case 16: format = SRLA_PCM_FORMAT_INT16; break;
+    case 24:         format = SRLA_PCM_FORMAT_INT24; break;
+    default:         format = SRLA_PCM_FORMAT_INT32; break;
+    }
+    if ((api_ret = SRLADecoder_DecodeWholeInterleaved(decoder,
+        data, output_size, interleaved_output, format, num_samples)) != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Interleaved decode failed! ret:%d \n", api_ret);
+        ret = 9;
+        goto EXIT;
+    }
+
+    /* 一致確認 */
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        for (ch = 0; ch < num_channels; ch++) {
+            const uint32_t pos = num_channels * smpl + ch;
+            int32_t val;
+            switch (format) {
+            case SRLA_PCM_FORMAT_INT16: val = ((int16_t *)interleaved_output)[pos]; break;
+            case SRLA_PCM_FORMAT_INT24: val = SRLAUTILITY_GET_INT24LE(&((uint8_t *)interleaved_output)[3 * pos]); break;
+            default:                    val = interleaved_output[pos]; break;
+            }
+            if (input[ch][smpl] != val) {
+                printf("%5d %12d vs %12d \n", smpl, input[ch][smpl], val);
+                ret = 10;
+                goto EXIT;
+            }
+        }
+    }
+
+    /* インターリーブ入力でブロック毎にエンコードし、デコード結果の一致を確認 */
+    {
+        uint32_t progress = 0, write_offset;
+        const uint32_t block_size = test_case->encode_parameter.max_num_samples_per_block;
+        int32_t *interleaved_input = interleaved_output;
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            for (ch = 0; ch < num_channels; ch++) {
+                interleaved_input[num_channels * smpl + ch] = input[ch][smpl];
+            }
+        }
+        /* ヘッダはEncodeWholeの出力を流用 */
+        write_offset = SRLA_HEADER_SIZE;
+        while (progress < num_samples) {
+            const uint32_t num_encode_samples = SRLAUTILITY_MIN(block_size, num_samples - progress);
+            uint32_t block_size_byte;
+            if ((api_ret = SRLAEncoder_EncodeBlockInterleaved(encoder,
+                &interleaved_input[num_channels * progress], SRLA_PCM_FORMAT_INT32, num_encode_samples,
+                &data[write_offset], data_size - write_offset, &block_size_byte)) != SRLA_APIRESULT_OK) {
+                fprintf(stderr, "Interleaved encode failed! ret:%d \n", api_ret);
+                ret = 11;
+                goto EXIT;
+            }
+            write_offset += block_size_byte;
+            progress += num_encode_samples;
+        }
+        if ((api_ret = SRLADecoder_DecodeWhole(decoder, data, write_offset, output, num_channels, num_samples)) != SRLA_APIRESULT_OK) {
+            fprintf(stderr, "Decode failed! ret:%d \n", api_ret);
+            ret = 12;
+            goto EXIT;
+        }
+        for (ch = 0; ch < num_channels; ch++) {
+            if (memcmp(input[ch], output[ch], sizeof(int32_t) * num_samples) != 0) {
+                ret = 13;
+                goto EXIT;
+            }
+        }
+    }
+
     /* ここまで来れば成功 */
     ret = 0;
 
@@ -375,6 +465,7 @@ EXIT:
         free(input[ch]);
         free(output[ch]);
     }
+    free(interleaved_output);
     free(input_double);
     free(input);
     free(output);
@@ -761,6 +852,40 @@ TEST(SRLAEncodeDecodeTest, EncodeDecodeCheckTest)
         { { 8,  8, 8000, 512, 1024, 1536, SRLA_MAX_LTP_ORDER, SRLA_NUM_PARAMETER_PRESETS - 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateMiniImpulse },
         { { 8, 16, 8000, 512, 1024, 1536, SRLA_MAX_LTP_ORDER, SRLA_NUM_PARAMETER_PRESETS - 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateMiniImpulse },
         { { 8, 24, 8000, 512, 1024, 1536, SRLA_MAX_LTP_ORDER, SRLA_NUM_PARAMETER_PRESETS - 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateMiniImpulse },
+
+        /* 推定符号長による可変ブロック分割探索の部 */
+        { { 1, 16, 8000, 256, 1024, 2048, 0, 0, 0, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSilence },
+        { { 2, 16, 8000, 256, 1024, 2048, 0, 0, 0, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSinWave },
+        { { 2, 16, 8000, 256, 1024, 2048, 0, 0, 2, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateChirp },
+        { { 2, 24, 8000, 256, 1024, 2048, 0, 0, 2, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateWhiteNoise },
+        { { 8, 16, 8000, 256, 1024, 2048, 0, 0, SRLA_NUM_PARAMETER_PRESETS - 1, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateGaussNoise },
+        { { 2, 16, 8000, 256, 1024, 2048, 0, 0, SRLA_NUM_PARAMETER_PRESETS - 1, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateMiniImpulse },
+
+        /* 先読み区間をスライドさせる可変ブロック分割探索の部 */
+        { { 1, 16, 8000, 256, 1024, 2048, 0, 0, 0, 0, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSilence },
+        { { 2, 16, 8000, 256, 1024, 2048, 0, 0, 0, 0, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSinWave },
+        { { 2, 16, 8000, 256, 1024, 1024, 0, 0, 2, 0, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateChirp },
+        { { 2, 24, 8000, 256, 1024, 4096, 0, 0, 2, 0, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateWhiteNoise },
+        { { 8, 16, 8000, 256, 1024, 2048, 0, 0, SRLA_NUM_PARAMETER_PRESETS - 1, 1, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateGaussNoise },
+        { { 2, 16, 8000, 256, 1024, 2048, 0, 0, SRLA_NUM_PARAMETER_PRESETS - 1, 1, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateMiniImpulse },
+
+        /* 32bit PCMの部 */
+        { { 1, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSilence },
+        { { 1, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSinWave },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSinWave },
+        { { 2, 32, 8000, 512, 1024, 1536, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateWhiteNoise },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateNegativeConstant },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateMiniImpulse },
+        { { 2, 32, 8000, 512, 1024, 2048, SRLA_MAX_LTP_ORDER, SRLA_NUM_PARAMETER_PRESETS - 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSinWave },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 8, 8500, SRLAEncodeDecodeTest_GenerateSinWave },
+        /* フルスケールでチャンネル間の差分が32bitを越える信号 */
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateChirp },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSinChSignFlippedWave },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateNyquistOsc },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0, SRLA_NUM_PARAMETER_PRESETS - 1, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateChirp },
+        { { 1, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSquareWave },
+        { { 2, 32, 8000, 512, 1024, 2048, 0, 0 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSquareWave },
+        { { 2, 32, 8000, 512, 1024, 4096, 0, 0, SRLA_NUM_PARAMETER_PRESETS - 1, 1 }, 0, 8500, SRLAEncodeDecodeTest_GenerateSquareWave },
     };
 
     /* テストケース数 */
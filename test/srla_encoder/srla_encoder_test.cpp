@@ -35,6 +35,9 @@ extern "C" {
         param__p->num_lookahead_samples     = 4096;\
         param__p->ltp_order                 = 1;\
         param__p->preset                    = 0;\
+        param__p->estimate_partition_cost   = 0;\
+        param__p->sliding_lookahead         = 0;\
+        param__p->seek_table_interval       = 0;\
     } while (0);
 
 /* 有効なコンフィグをセット */
@@ -46,6 +49,7 @@ extern "C" {
         config__p->max_num_samples_per_block = 4096;\
         config__p->max_num_lookahead_samples = 4096;\
         config__p->max_num_parameters        = 32;\
+        config__p->max_num_threads           = 1;\
     } while (0);
 
 /* ヘッダエンコードテスト */
@@ -138,6 +142,64 @@ TEST(SRLAEncoderTest, CreateDestroyHandleTest)
         SRLAEncoder_SetValidConfig(&config);
         config.max_num_samples_per_block = 0;
         EXPECT_TRUE(SRLAEncoder_CalculateWorkSize(&config) < 0);
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_threads = SRLA_MAX_NUM_THREADS + 1;
+        EXPECT_TRUE(SRLAEncoder_CalculateWorkSize(&config) < 0);
+
+        /* ワークサイズがint32_tに収まらない */
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_lookahead_samples = 1UL << 20;
+        EXPECT_TRUE(SRLAEncoder_CalculateWorkSize(&config) > 0);
+        config.max_num_threads = SRLA_MAX_NUM_THREADS;
+        EXPECT_TRUE(SRLAEncoder_CalculateWorkSize(&config) < 0);
+        EXPECT_TRUE(SRLAStreamEncoder_CalculateWorkSize(&config) < 0);
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_lookahead_samples = 1UL << 30;
+        EXPECT_TRUE(SRLAEncoder_CalculateWorkSize(&config) < 0);
+        EXPECT_TRUE(SRLAStreamEncoder_CalculateWorkSize(&config) < 0);
+    }
+
+    /* スレッド数0は1スレッドとして扱う */
+    {
+        struct SRLAEncoder *encoder;
+        struct SRLAEncoderConfig config;
+        int32_t work_size;
+
+        SRLAEncoder_SetValidConfig(&config);
+        work_size = SRLAEncoder_CalculateWorkSize(&config);
+        config.max_num_threads = 0;
+        EXPECT_EQ(work_size, SRLAEncoder_CalculateWorkSize(&config));
+
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        EXPECT_EQ(1, encoder->max_num_threads);
+        EXPECT_TRUE(encoder->workers == NULL);
+        SRLAEncoder_Destroy(encoder);
+    }
+
+    /* 複数スレッド対応ハンドルの作成 */
+    {
+        struct SRLAEncoder *encoder;
+        struct SRLAEncoderConfig config;
+        uint32_t t;
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_threads = 4;
+
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        EXPECT_EQ(4, encoder->max_num_threads);
+        ASSERT_TRUE(encoder->workers != NULL);
+        EXPECT_TRUE(encoder->workers[0] == encoder);
+        for (t = 1; t < config.max_num_threads; t++) {
+            EXPECT_TRUE(encoder->workers[t] != NULL);
+            EXPECT_TRUE(encoder->workers[t] != encoder);
+            EXPECT_EQ(0, encoder->workers[t]->alloced_by_own);
+        }
+
+        SRLAEncoder_Destroy(encoder);
     }
 
     /* ワーク領域渡しによるハンドル作成（成功例） */
@@ -587,37 +649,253 @@ TEST(SRLAEncoderTest, EncodeBlockTest)
     }
 }
 
-/* ダイクストラ法テスト */
-TEST(SRLAEncoderTest, DijkstraTest)
+/* 並列エンコードテスト */
+TEST(SRLAEncoderTest, EncodeWholeParallelTest)
+{
+    /* 逐次エンコードとバイナリ一致するか */
+    {
+#define NUM_SAMPLES 40000
+        struct SRLAEncoder *encoder, *single_encoder;
+        struct SRLAEncoderConfig config, single_config;
+        struct SRLAEncodeParameter parameter;
+        int32_t *input[SRLA_MAX_NUM_CHANNELS];
+        uint8_t *serial_data, *parallel_data;
+        uint32_t ch, smpl, sufficient_size, serial_size, parallel_size, test_no, num_threads;
+        static const uint32_t min_num_samples_per_block[] = { 4096, 1024 };
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_threads = 4;
+        config.max_num_channels = 2;
+
+        /* 十分なデータサイズ */
+        sufficient_size = SRLA_HEADER_SIZE + 2 * config.max_num_channels * NUM_SAMPLES * sizeof(int32_t);
+        serial_data = (uint8_t *)malloc(sufficient_size);
+        parallel_data = (uint8_t *)malloc(sufficient_size);
+
+        /* 正弦波と乱数の混合信号 */
+        srand(0);
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                input[ch][smpl] = (int32_t)(8000.0 * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+            }
+        }
+
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        single_config = config;
+        single_config.max_num_threads = 1;
+        single_encoder = SRLAEncoder_Create(&single_config, NULL, 0);
+        ASSERT_TRUE(single_encoder != NULL);
+
+        /* 固定ブロックサイズ・可変ブロックサイズそれぞれで確認 */
+        for (test_no = 0; test_no < sizeof(min_num_samples_per_block) / sizeof(min_num_samples_per_block[0]); test_no++) {
+            SRLAEncoder_SetValidEncodeParameter(&parameter);
+            parameter.num_channels = (uint16_t)config.max_num_channels;
+            parameter.min_num_samples_per_block = min_num_samples_per_block[test_no];
+            parameter.max_num_samples_per_block = 4096;
+            parameter.num_lookahead_samples = 4096;
+            parameter.ltp_order = 0;
+            parameter.preset = 2;
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(single_encoder, &parameter));
+
+            /* 単一スレッドのハンドルで逐次エンコード */
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAEncoder_EncodeWhole(single_encoder,
+                    input, NUM_SAMPLES, serial_data, sufficient_size, &serial_size, NULL));
+
+            /* 複数スレッド対応ハンドルでも、EncodeWholeでは並列化しない */
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAEncoder_EncodeWhole(encoder,
+                    input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+            EXPECT_EQ(1, encoder->num_search_threads);
+            EXPECT_EQ(serial_size, parallel_size);
+            EXPECT_EQ(0, memcmp(serial_data, parallel_data, serial_size));
+
+            for (num_threads = 1; num_threads <= config.max_num_threads; num_threads++) {
+                ASSERT_EQ(SRLA_APIRESULT_OK,
+                    SRLAEncoder_EncodeWholeParallel(encoder, num_threads,
+                        input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+                EXPECT_EQ(serial_size, parallel_size);
+                EXPECT_EQ(0, memcmp(serial_data, parallel_data, serial_size));
+            }
+        }
+
+        /* 失敗ケース */
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeWholeParallel(NULL, 2,
+                input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeWholeParallel(encoder, 0,
+                input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLAEncoder_EncodeWholeParallel(encoder, config.max_num_threads + 1,
+                input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLAEncoder_EncodeWholeParallel(encoder, 2,
+                input, NUM_SAMPLES, parallel_data, serial_size / 2, &parallel_size, NULL));
+
+        /* 先読み区間をスライドさせる場合（ブロック分割探索のみ並列化） */
+        SRLAEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = (uint16_t)config.max_num_channels;
+        parameter.min_num_samples_per_block = 1024;
+        parameter.max_num_samples_per_block = 4096;
+        parameter.num_lookahead_samples = 4096;
+        parameter.ltp_order = 0;
+        parameter.preset = 2;
+        parameter.sliding_lookahead = 1;
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(single_encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAEncoder_EncodeWhole(single_encoder,
+                input, NUM_SAMPLES, serial_data, sufficient_size, &serial_size, NULL));
+        for (num_threads = 2; num_threads <= config.max_num_threads; num_threads++) {
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAEncoder_EncodeWholeParallel(encoder, num_threads,
+                    input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+            EXPECT_EQ(1, encoder->num_search_threads);
+            EXPECT_EQ(serial_size, parallel_size);
+            EXPECT_EQ(0, memcmp(serial_data, parallel_data, serial_size));
+        }
+
+        /* 単一区間のエンコードでブロック分割探索のコスト計算を並列化 */
+        parameter.sliding_lookahead = 0;
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(single_encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAEncoder_EncodeOptimalPartitionedBlock(single_encoder,
+                input, parameter.num_lookahead_samples, serial_data, sufficient_size, &serial_size));
+        for (num_threads = 1; num_threads <= config.max_num_threads; num_threads++) {
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAEncoder_EncodeOptimalPartitionedBlockParallel(encoder, num_threads,
+                    input, parameter.num_lookahead_samples, parallel_data, sufficient_size, &parallel_size));
+            EXPECT_EQ(1, encoder->num_search_threads);
+            EXPECT_EQ(serial_size, parallel_size);
+            EXPECT_EQ(0, memcmp(serial_data, parallel_data, serial_size));
+        }
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeOptimalPartitionedBlockParallel(encoder, 0,
+                input, parameter.num_lookahead_samples, parallel_data, sufficient_size, &parallel_size));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLAEncoder_EncodeOptimalPartitionedBlockParallel(encoder, config.max_num_threads + 1,
+                input, parameter.num_lookahead_samples, parallel_data, sufficient_size, &parallel_size));
+
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            free(input[ch]);
+        }
+        free(serial_data);
+        free(parallel_data);
+        SRLAEncoder_Destroy(encoder);
+        SRLAEncoder_Destroy(single_encoder);
+#undef NUM_SAMPLES
+    }
+
+    /* 先読みサンプル数が最大ブロックサイズより大きく、過渡的な入力で細かく分割される場合 */
+    {
+#define NUM_SAMPLES 20000
+        struct SRLAEncoder *encoder, *single_encoder;
+        struct SRLAEncoderConfig config, single_config;
+        struct SRLAEncodeParameter parameter;
+        int32_t *input[SRLA_MAX_NUM_CHANNELS];
+        uint8_t *serial_data, *parallel_data;
+        uint32_t ch, smpl, sufficient_size, serial_size, parallel_size, num_threads;
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_threads = 4;
+        config.max_num_channels = 2;
+        config.min_num_samples_per_block = 256;
+        config.max_num_samples_per_block = 1024;
+        config.max_num_lookahead_samples = 8192;
+
+        /* 十分なデータサイズ */
+        sufficient_size = SRLA_HEADER_SIZE + 2 * config.max_num_channels * NUM_SAMPLES * sizeof(int32_t);
+        serial_data = (uint8_t *)malloc(sufficient_size);
+        parallel_data = (uint8_t *)malloc(sufficient_size);
+
+        /* 減衰する雑音バーストと小振幅の正弦波が交互に現れる信号 */
+        srand(0);
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                if (((smpl / 300) % 3) == 0) {
+                    input[ch][smpl] = (int32_t)(20000.0 * exp(-(double)(smpl % 300) / 30.0) * ((double)rand() / RAND_MAX - 0.5));
+                } else {
+                    input[ch][smpl] = (int32_t)(200.0 * sin(0.05 * (ch + 1) * smpl));
+                }
+            }
+        }
+
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        single_config = config;
+        single_config.max_num_threads = 1;
+        single_encoder = SRLAEncoder_Create(&single_config, NULL, 0);
+        ASSERT_TRUE(single_encoder != NULL);
+
+        SRLAEncoder_SetValidEncodeParameter(&parameter);
+        parameter.num_channels = (uint16_t)config.max_num_channels;
+        parameter.min_num_samples_per_block = config.min_num_samples_per_block;
+        parameter.max_num_samples_per_block = config.max_num_samples_per_block;
+        parameter.num_lookahead_samples = config.max_num_lookahead_samples;
+        parameter.ltp_order = 0;
+        parameter.preset = 2;
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(single_encoder, &parameter));
+
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAEncoder_EncodeWhole(single_encoder,
+                input, NUM_SAMPLES, serial_data, sufficient_size, &serial_size, NULL));
+        for (num_threads = 2; num_threads <= config.max_num_threads; num_threads++) {
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAEncoder_EncodeWholeParallel(encoder, num_threads,
+                    input, NUM_SAMPLES, parallel_data, sufficient_size, &parallel_size, NULL));
+            EXPECT_EQ(serial_size, parallel_size);
+            EXPECT_EQ(0, memcmp(serial_data, parallel_data, serial_size));
+        }
+
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            free(input[ch]);
+        }
+        free(serial_data);
+        free(parallel_data);
+        SRLAEncoder_Destroy(encoder);
+        SRLAEncoder_Destroy(single_encoder);
+#undef NUM_SAMPLES
+    }
+}
+
+/* 最短経路探索テスト */
+TEST(SRLAEncoderTest, ShortestPathTest)
 {
     /* 隣接行列の重み */
-    struct DijkstraTestCaseAdjacencyMatrixWeight {
+    struct ShortestPathTestCaseEdgeWeight {
         uint32_t i;
         uint32_t j;
         double weight;
     };
 
-    /* ダイクストラ法のテストケース */
-    struct DijkstraTestCase {
+    /* 最短経路探索のテストケース */
+    struct ShortestPathTestCase {
         uint32_t num_nodes;
         uint32_t start_node;
         uint32_t goal_node;
         double min_cost;
         uint32_t num_weights;
-        const DijkstraTestCaseAdjacencyMatrixWeight *weight;
+        const ShortestPathTestCaseEdgeWeight *weight;
         uint32_t len_answer_route_path;
         const uint32_t *answer_route_path;
     };
 
     /* テストケース0の重み */
-    static const DijkstraTestCaseAdjacencyMatrixWeight test_case0_weight[] = {
+    static const ShortestPathTestCaseEdgeWeight test_case0_weight[] = {
         { 0, 1, 114514 }
     };
     /* テストケース0の回答経路 */
     static const uint32_t test_case0_answer_route[] = { 0, 1 };
 
     /* テストケース1の重み */
-    static const DijkstraTestCaseAdjacencyMatrixWeight test_case1_weight[] = {
+    static const ShortestPathTestCaseEdgeWeight test_case1_weight[] = {
         { 0, 1, 30 }, { 0, 3, 10 }, { 0, 2, 15 },
         { 1, 3, 25 }, { 1, 4, 60 },
         { 2, 3, 40 }, { 2, 5, 20 },
@@ -629,7 +907,7 @@ TEST(SRLAEncoderTest, DijkstraTest)
     static const uint32_t test_case1_answer_route[] = { 0, 3, 6 };
 
     /* テストケース2の重み */
-    static const DijkstraTestCaseAdjacencyMatrixWeight test_case2_weight[] = {
+    static const ShortestPathTestCaseEdgeWeight test_case2_weight[] = {
         {  0,  1,  15 }, {  0,  2,  58 }, {  0,  3,  79 }, {  0,  4,   1 }, {  0,  5,  44 },
         {  0,  6,  78 }, {  0,  7,  61 }, {  0,  8,  90 }, {  0,  9,  95 },
         {  1,  2,  53 }, {  1,  3,  78 }, {  1,  4,  49 }, {  1,  5,  72 }, {  1,  6,  50 },
@@ -679,8 +957,8 @@ TEST(SRLAEncoderTest, DijkstraTest)
     /* テストケース2の回答経路 */
     static const uint32_t test_case2_answer_route[] = { 0, 4, 5, 10, 15, 20, 24, 25, 29 };
 
-    /* ダイクストラ法のテストケース */
-    static const DijkstraTestCase test_cases[] = {
+    /* 最短経路探索のテストケース */
+    static const ShortestPathTestCase test_cases[] = {
         /* テストケース0（コーナーケース）:
         * ノード数2, 最小コスト: 114514, 経路 0 -> 1 */
         {
@@ -718,10 +996,10 @@ TEST(SRLAEncoderTest, DijkstraTest)
             test_case2_answer_route
         }
     };
-    /* ダイクストラ法のテストケース数 */
+    /* 最短経路探索のテストケース数 */
     const uint32_t num_test_case = sizeof(test_cases) / sizeof(test_cases[0]);
 
-    /* ダイクストラ法の実行テスト */
+    /* 最短経路探索の実行テスト */
     {
         struct SRLAOptimalBlockPartitionCalculator *obpc;
         uint32_t test_no, i, j, node, is_ok;
@@ -729,32 +1007,33 @@ TEST(SRLAEncoderTest, DijkstraTest)
 
         /* 全テストケースに対してテスト */
         for (test_no = 0; test_no < num_test_case; test_no++) {
-            const DijkstraTestCase *p_test = &test_cases[test_no];
+            const ShortestPathTestCase *p_test = &test_cases[test_no];
             int32_t work_size;
             void *work;
 
-            /* ノード数num_nodesでハンドルを作成 */
-            work_size = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(p_test->num_nodes, 1);
+            /* ノード数num_nodesで、任意のノード間に辺を張れるハンドルを作成 */
+            work_size = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(p_test->num_nodes, 1, p_test->num_nodes);
             ASSERT_TRUE(work_size > 0);
             work = malloc(work_size);
 
-            obpc = SRLAOptimalBlockPartitionCalculator_Create(p_test->num_nodes, 1, work, work_size);
+            obpc = SRLAOptimalBlockPartitionCalculator_Create(p_test->num_nodes, 1, p_test->num_nodes, work, work_size);
             ASSERT_TRUE(obpc != NULL);
 
-            /* 隣接行列をセット */
+            /* 辺のコストをセット */
             for (i = 0; i < obpc->max_num_nodes; i++) {
-                for (j = 0; j < obpc->max_num_nodes; j++) {
-                    obpc->adjacency_matrix[i][j] = SRLAENCODER_DIJKSTRA_BIGWEIGHT;
+                for (j = 0; j < obpc->max_band_width; j++) {
+                    obpc->edge_cost[i][j] = SRLAENCODER_BIGWEIGHT;
                 }
             }
             for (i = 0; i < p_test->num_weights; i++) {
-                const DijkstraTestCaseAdjacencyMatrixWeight *p = &p_test->weight[i];
-                obpc->adjacency_matrix[p->i][p->j] = p->weight;
+                const ShortestPathTestCaseEdgeWeight *p = &p_test->weight[i];
+                ASSERT_TRUE(p->i < p->j);
+                obpc->edge_cost[p->i][p->j - p->i - 1] = p->weight;
             }
 
-            /* ダイクストラ法実行 */
+            /* 最短経路探索実行 */
             ASSERT_EQ(
-                SRLAOptimalBlockPartitionCalculator_ApplyDijkstraMethod(obpc,
+                SRLAOptimalBlockPartitionCalculator_ComputeShortestPath(obpc,
                     p_test->num_nodes, p_test->start_node, p_test->goal_node, &cost),
                 SRLA_ERROR_OK);
 
@@ -778,4 +1057,616 @@ TEST(SRLAEncoderTest, DijkstraTest)
             free(work);
         }
     }
+
+    /* ワークサイズは先読みサンプル数に対して線形に増加 */
+    {
+        const int32_t size1 = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(1 << 16, 256, 4096);
+        const int32_t size2 = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(1 << 20, 256, 4096);
+        ASSERT_TRUE(size1 > 0);
+        ASSERT_TRUE(size2 > 0);
+        EXPECT_TRUE(size2 < 17 * size1);
+    }
+
+    /* 不正な引数 */
+    EXPECT_TRUE(SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(1024, 0, 256) < 0);
+    EXPECT_TRUE(SRLAOptimalBlockPartitionCalculator_CalculateWorkSize(1024, 512, 256) < 0);
+}
+
+/* 自己相関キャッシュのテスト */
+TEST(SRLAEncoderTest, AutoCorrelationCacheTest)
+{
+    /* 窓掛け自己相関を直接計算した結果と一致するか */
+    {
+#define NUM_CHANNELS 2
+#define NUM_SAMPLES 1024
+#define SEGMENT_LENGTH 64
+#define ORDER 8
+        uint32_t ch, smpl, sig, start, end, lag;
+        int32_t *input[NUM_CHANNELS], *ms[2];
+        double *signal;
+        void *work;
+        int32_t work_size;
+        struct SRLAAutoCorrelationCache *cache;
+
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        }
+        for (ch = 0; ch < 2; ch++) {
+            ms[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        }
+        signal = (double *)malloc(sizeof(double) * NUM_SAMPLES);
+
+        /* 相関を持つ信号を生成 */
+        srand(0);
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            double prev = 0.0;
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                prev = 0.9 * prev + ((double)rand() / RAND_MAX - 0.5) * 4096.0;
+                input[ch][smpl] = (int32_t)prev;
+            }
+        }
+        for (ch = 0; ch < 2; ch++) {
+            memcpy(ms[ch], input[ch], sizeof(int32_t) * NUM_SAMPLES);
+        }
+        SRLAUtility_LRtoMSConversion(ms, NUM_SAMPLES);
+
+        work_size = SRLAAutoCorrelationCache_CalculateWorkSize(NUM_CHANNELS, NUM_SAMPLES, SEGMENT_LENGTH, ORDER);
+        ASSERT_TRUE(work_size > 0);
+        work = malloc(work_size);
+        cache = SRLAAutoCorrelationCache_Create(NUM_CHANNELS, NUM_SAMPLES, SEGMENT_LENGTH, ORDER, work, work_size);
+        ASSERT_TRUE(cache != NULL);
+
+        ASSERT_EQ(SRLA_ERROR_OK,
+            SRLAAutoCorrelationCache_Build(cache, input, NUM_CHANNELS, NUM_SAMPLES, SEGMENT_LENGTH, ORDER, 16, 0));
+        EXPECT_EQ(NUM_CHANNELS + 2, cache->num_signals);
+        EXPECT_EQ(NUM_SAMPLES / SEGMENT_LENGTH, cache->num_segments);
+
+        for (sig = 0; sig < cache->num_signals; sig++) {
+            const int32_t *src = (sig < NUM_CHANNELS) ? input[sig] : ms[sig - NUM_CHANNELS];
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                signal[smpl] = src[smpl] * pow(2.0, -15);
+            }
+            for (start = 0; start < cache->num_segments; start++) {
+                for (end = start + 1; end <= cache->num_segments; end++) {
+                    const uint32_t num_samples = (end - start) * SEGMENT_LENGTH;
+                    const double *x = &signal[start * SEGMENT_LENGTH];
+                    const double denom = num_samples - 1;
+                    double auto_corr[ORDER + 1], energy, sqsum;
+
+                    /* 窓の二乗和 */
+                    sqsum = 0.0;
+                    for (smpl = 0; smpl < num_samples; smpl++) {
+                        const double w = 4.0 * smpl * (denom - smpl) / (denom * denom);
+                        sqsum += w * w;
+                    }
+
+                    SRLAAutoCorrelationCache_GetAutoCorrelation(cache, sig, start, end, num_samples, auto_corr);
+                    for (lag = 0; lag <= ORDER; lag++) {
+                        double answer = 0.0;
+                        for (smpl = lag; smpl < num_samples; smpl++) {
+                            const double w0 = 4.0 * smpl * (denom - smpl) / (denom * denom);
+                            const double w1 = 4.0 * (smpl - lag) * (denom - smpl + lag) / (denom * denom);
+                            answer += w0 * x[smpl] * w1 * x[smpl - lag];
+                        }
+                        answer *= num_samples / sqsum;
+                        EXPECT_NEAR(answer, auto_corr[lag], 1e-9 * fabs(answer) + 1e-12);
+                    }
+
+                    /* 窓なしの0次相関 */
+                    energy = 0.0;
+                    for (smpl = 0; smpl < num_samples; smpl++) {
+                        energy += x[smpl] * x[smpl];
+                    }
+                    EXPECT_NEAR(energy, SRLAAutoCorrelationCache_GetEnergy(cache, sig, start, end), 1e-9 * energy);
+
+                    /* 窓なしの相関 */
+                    for (lag = 0; lag <= ORDER; lag++) {
+                        double answer = 0.0;
+                        for (smpl = lag; smpl < num_samples; smpl++) {
+                            answer += x[smpl] * x[smpl - lag];
+                        }
+                        EXPECT_NEAR(answer,
+                            SRLAAutoCorrelationCache_GetRawAutoCorrelation(cache, sig, start, end, lag), 1e-9 * energy);
+                    }
+                }
+            }
+        }
+
+        /* 不正な引数 */
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT,
+            SRLAAutoCorrelationCache_Build(NULL, input, NUM_CHANNELS, NUM_SAMPLES, SEGMENT_LENGTH, ORDER, 16, 0));
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT,
+            SRLAAutoCorrelationCache_Build(cache, input, NUM_CHANNELS, NUM_SAMPLES, SEGMENT_LENGTH, ORDER + 1, 16, 0));
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT,
+            SRLAAutoCorrelationCache_Build(cache, input, NUM_CHANNELS, NUM_SAMPLES + 1, SEGMENT_LENGTH, ORDER, 16, 0));
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT,
+            SRLAAutoCorrelationCache_Build(cache, input, NUM_CHANNELS + 1, NUM_SAMPLES, SEGMENT_LENGTH, ORDER, 16, 0));
+
+        SRLAAutoCorrelationCache_Destroy(cache);
+        free(work);
+        free(signal);
+        for (ch = 0; ch < 2; ch++) {
+            free(ms[ch]);
+        }
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            free(input[ch]);
+        }
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+#undef SEGMENT_LENGTH
+#undef ORDER
+    }
+}
+
+/* 辺のコストのシフトテスト */
+TEST(SRLAEncoderTest, ShiftEdgeCostsTest)
+{
+    /* シフト後に重複区間の辺のコストが保たれているか */
+    {
+#define NUM_NODES 17
+#define BAND_WIDTH 4
+#define NUM_SHIFT_NODES 5
+        uint32_t i, k;
+        void *work;
+        int32_t work_size;
+        struct SRLAOptimalBlockPartitionCalculator *obpc;
+
+        work_size = SRLAOptimalBlockPartitionCalculator_CalculateWorkSize((NUM_NODES - 1) * 256, 256, BAND_WIDTH * 256);
+        ASSERT_TRUE(work_size > 0);
+        work = malloc(work_size);
+        obpc = SRLAOptimalBlockPartitionCalculator_Create((NUM_NODES - 1) * 256, 256, BAND_WIDTH * 256, work, work_size);
+        ASSERT_TRUE(obpc != NULL);
+        ASSERT_EQ(BAND_WIDTH, obpc->max_band_width);
+
+        for (i = 0; i < NUM_NODES; i++) {
+            for (k = 0; k < BAND_WIDTH; k++) {
+                obpc->edge_cost[i][k] = i * BAND_WIDTH + k;
+            }
+        }
+
+        EXPECT_EQ(SRLA_ERROR_OK, SRLAOptimalBlockPartitionCalculator_ShiftEdgeCosts(obpc, NUM_NODES, NUM_SHIFT_NODES));
+        for (i = 0; i < NUM_NODES - NUM_SHIFT_NODES; i++) {
+            for (k = 0; k < BAND_WIDTH; k++) {
+                EXPECT_EQ((i + NUM_SHIFT_NODES) * BAND_WIDTH + k, obpc->edge_cost[i][k]);
+            }
+        }
+
+        /* 不正な引数 */
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT, SRLAOptimalBlockPartitionCalculator_ShiftEdgeCosts(NULL, NUM_NODES, NUM_SHIFT_NODES));
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT, SRLAOptimalBlockPartitionCalculator_ShiftEdgeCosts(obpc, NUM_NODES, NUM_NODES + 1));
+        EXPECT_EQ(SRLA_ERROR_INVALID_ARGUMENT, SRLAOptimalBlockPartitionCalculator_ShiftEdgeCosts(obpc, obpc->max_num_nodes + 1, 0));
+
+        SRLAOptimalBlockPartitionCalculator_Destroy(obpc);
+        free(work);
+#undef NUM_NODES
+#undef BAND_WIDTH
+#undef NUM_SHIFT_NODES
+    }
+}
+
+/* ストリーミングエンコードの出力先 */
+struct SRLAStreamEncoderTestOutput {
+    uint8_t *data;
+    uint32_t data_size;
+    uint32_t output_size;
+    uint32_t num_callbacks;
+};
+
+/* ストリーミングエンコードの出力コールバック */
+static void SRLAStreamEncoderTest_OutputCallback(const uint8_t *data, uint32_t data_size, void *user_data)
+{
+    struct SRLAStreamEncoderTestOutput *output = (struct SRLAStreamEncoderTestOutput *)user_data;
+    ASSERT_TRUE((output->output_size + data_size) <= output->data_size);
+    memcpy(&output->data[output->output_size], data, data_size);
+    output->output_size += data_size;
+    output->num_callbacks++;
+}
+
+/* ストリーミングエンコードテスト */
+TEST(SRLAEncoderTest, StreamEncoderTest)
+{
+    /* ハンドル作成破棄テスト */
+    {
+        int32_t work_size;
+        void *work;
+        struct SRLAStreamEncoder *stream_encoder;
+        struct SRLAEncoderConfig config;
+
+        SRLAEncoder_SetValidConfig(&config);
+        work_size = SRLAStreamEncoder_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size > SRLAEncoder_CalculateWorkSize(&config));
+
+        /* ワーク領域を渡して作成 */
+        work = malloc(work_size);
+        stream_encoder = SRLAStreamEncoder_Create(&config, work, work_size);
+        ASSERT_TRUE(stream_encoder != NULL);
+        EXPECT_EQ(0, stream_encoder->alloced_by_own);
+        SRLAStreamEncoder_Destroy(stream_encoder);
+
+        /* ワーク領域不足 */
+        EXPECT_TRUE(SRLAStreamEncoder_Create(&config, work, work_size - 1) == NULL);
+        free(work);
+
+        /* 自前確保 */
+        stream_encoder = SRLAStreamEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(stream_encoder != NULL);
+        EXPECT_EQ(1, stream_encoder->alloced_by_own);
+        SRLAStreamEncoder_Destroy(stream_encoder);
+
+        /* 不正なコンフィグ */
+        EXPECT_TRUE(SRLAStreamEncoder_CalculateWorkSize(NULL) < 0);
+        config.max_num_channels = 0;
+        EXPECT_TRUE(SRLAStreamEncoder_CalculateWorkSize(&config) < 0);
+        EXPECT_TRUE(SRLAStreamEncoder_Create(&config, NULL, 0) == NULL);
+    }
+
+    /* 一括エンコードとバイナリ一致するか */
+    {
+#define NUM_SAMPLES 30000
+        struct SRLAEncoder *encoder;
+        struct SRLAStreamEncoder *stream_encoder;
+        struct SRLAEncoderConfig config;
+        struct SRLAEncodeParameter parameter;
+        struct SRLAStreamEncoderTestOutput output;
+        int32_t *input[SRLA_MAX_NUM_CHANNELS], *shifted_input[SRLA_MAX_NUM_CHANNELS];
+        uint8_t *whole_data, header_data[SRLA_HEADER_SIZE];
+        uint32_t ch, smpl, sufficient_size, whole_size, test_no;
+        struct StreamEncoderTestCase {
+            uint32_t min_num_samples_per_block;
+            uint32_t num_lookahead_samples;
+            uint8_t estimate_partition_cost;
+            uint8_t sliding_lookahead;
+            uint32_t offset_lshift;
+        };
+        static const struct StreamEncoderTestCase test_cases[] = {
+            { 4096, 4096, 0, 0, 0 },
+            { 1024, 8192, 0, 0, 0 },
+            { 1024, 8192, 0, 1, 0 },
+            { 1024, 8192, 1, 1, 0 },
+            { 4096, 4096, 0, 0, 2 },
+            { 1024, 8192, 0, 1, 2 },
+        };
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_channels = 2;
+        config.max_num_lookahead_samples = 8192;
+
+        /* 十分なデータサイズ */
+        sufficient_size = SRLA_HEADER_SIZE + 2 * config.max_num_channels * NUM_SAMPLES * sizeof(int32_t);
+        whole_data = (uint8_t *)malloc(sufficient_size);
+        output.data = (uint8_t *)malloc(sufficient_size);
+        output.data_size = sufficient_size;
+
+        /* 正弦波と乱数の混合信号 左シフト量が0になるよう奇数を含める */
+        srand(0);
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                input[ch][smpl] = (int32_t)(8000.0 * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+            }
+            input[ch][0] |= 1;
+        }
+
+        /* 下位2ビットが0の信号 */
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            shifted_input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                shifted_input[ch][smpl] = input[ch][smpl] * 4;
+            }
+        }
+
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+        stream_encoder = SRLAStreamEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(stream_encoder != NULL);
+
+        for (test_no = 0; test_no < sizeof(test_cases) / sizeof(test_cases[0]); test_no++) {
+            uint32_t progress;
+            const int32_t *input_ptr[SRLA_MAX_NUM_CHANNELS];
+            const struct StreamEncoderTestCase *test_case = &test_cases[test_no];
+            int32_t **test_input = (test_case->offset_lshift > 0) ? shifted_input : input;
+
+            SRLAEncoder_SetValidEncodeParameter(&parameter);
+            parameter.num_channels = (uint16_t)config.max_num_channels;
+            parameter.min_num_samples_per_block = test_case->min_num_samples_per_block;
+            parameter.max_num_samples_per_block = 4096;
+            parameter.num_lookahead_samples = test_case->num_lookahead_samples;
+            parameter.estimate_partition_cost = test_case->estimate_partition_cost;
+            parameter.sliding_lookahead = test_case->sliding_lookahead;
+            parameter.ltp_order = 0;
+            parameter.preset = 0;
+
+            /* 一括エンコード */
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAEncoder_EncodeWhole(encoder, test_input, NUM_SAMPLES, whole_data, sufficient_size, &whole_size, NULL));
+            /* 一括エンコードで検出される左シフト量 補足）左シフト量はヘッダ先頭から24byte目 */
+            ASSERT_EQ(test_case->offset_lshift, whole_data[24]);
+
+            /* 不揃いなサンプル数に分けて入力 */
+            output.output_size = output.num_callbacks = 0;
+            ASSERT_EQ(SRLA_APIRESULT_OK,
+                SRLAStreamEncoder_Start(stream_encoder, &parameter, test_case->offset_lshift,
+                    SRLAStreamEncoderTest_OutputCallback, &output));
+            ASSERT_EQ(SRLA_HEADER_SIZE, output.output_size);
+            progress = 0;
+            while (progress < NUM_SAMPLES) {
+                const uint32_t num_rand_samples = (uint32_t)(rand() % 5000);
+                const uint32_t num_push_samples = SRLAUTILITY_MIN(num_rand_samples, NUM_SAMPLES - progress);
+                for (ch = 0; ch < config.max_num_channels; ch++) {
+                    input_ptr[ch] = &test_input[ch][progress];
+                }
+                ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamEncoder_Push(stream_encoder, input_ptr, num_push_samples));
+                progress += num_push_samples;
+                /* 先読みサンプル数を越えてバッファしない */
+                EXPECT_TRUE(stream_encoder->num_buffered_samples <= test_case->num_lookahead_samples);
+            }
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamEncoder_Finish(stream_encoder, header_data, sizeof(header_data)));
+            EXPECT_TRUE(output.num_callbacks > 1);
+
+            /* 暫定ヘッダは総サンプル数が未確定 補足）総サンプル数はヘッダ先頭から14byte目 */
+            EXPECT_EQ(SRLA_NUM_SAMPLES_UNKNOWN, ByteArray_ReadUint32BE(&output.data[14]));
+            EXPECT_EQ(NUM_SAMPLES, ByteArray_ReadUint32BE(&header_data[14]));
+
+            /* 確定ヘッダで書き戻せば一括エンコードと一致 */
+            memcpy(output.data, header_data, SRLA_HEADER_SIZE);
+            EXPECT_EQ(whole_size, output.output_size);
+            EXPECT_EQ(0, memcmp(whole_data, output.data, whole_size));
+        }
+
+        /* 失敗ケース */
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Start(NULL, &parameter, 0, SRLAStreamEncoderTest_OutputCallback, &output));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Start(stream_encoder, NULL, 0, SRLAStreamEncoderTest_OutputCallback, &output));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Start(stream_encoder, &parameter, 0, NULL, &output));
+        /* 左シフト量がサンプルのビット数以上 */
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Start(stream_encoder, &parameter, parameter.bits_per_sample,
+                SRLAStreamEncoderTest_OutputCallback, &output));
+        /* シークテーブルは出力できない */
+        parameter.seek_table_interval = 4096;
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Start(stream_encoder, &parameter, 0, SRLAStreamEncoderTest_OutputCallback, &output));
+        parameter.seek_table_interval = 0;
+        /* 左シフト量と矛盾するサンプルの入力 */
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAStreamEncoder_Start(stream_encoder, &parameter, 2, SRLAStreamEncoderTest_OutputCallback, &output));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamEncoder_Push(stream_encoder, shifted_input, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_FORMAT, SRLAStreamEncoder_Push(stream_encoder, input, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_OK, SRLAStreamEncoder_Finish(stream_encoder, header_data, sizeof(header_data)));
+        /* 開始前の入力・終了 */
+        EXPECT_EQ(SRLA_APIRESULT_PARAMETER_NOT_SET,
+            SRLAStreamEncoder_Push(stream_encoder, input, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_PARAMETER_NOT_SET,
+            SRLAStreamEncoder_Finish(stream_encoder, header_data, sizeof(header_data)));
+        /* 入力なしで終了 */
+        output.output_size = output.num_callbacks = 0;
+        ASSERT_EQ(SRLA_APIRESULT_OK,
+            SRLAStreamEncoder_Start(stream_encoder, &parameter, 0, SRLAStreamEncoderTest_OutputCallback, &output));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_DATA,
+            SRLAStreamEncoder_Finish(stream_encoder, header_data, sizeof(header_data)));
+        /* 不正な引数 */
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Push(NULL, input, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Push(stream_encoder, NULL, NUM_SAMPLES));
+        ASSERT_EQ(SRLA_APIRESULT_OK, SRLAStreamEncoder_Push(stream_encoder, input, NUM_SAMPLES));
+        EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+            SRLAStreamEncoder_Finish(stream_encoder, header_data, SRLA_HEADER_SIZE - 1));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAStreamEncoder_Finish(stream_encoder, NULL, sizeof(header_data)));
+
+        for (ch = 0; ch < config.max_num_channels; ch++) {
+            free(input[ch]);
+            free(shifted_input[ch]);
+        }
+        free(whole_data);
+        free(output.data);
+        SRLAEncoder_Destroy(encoder);
+        SRLAStreamEncoder_Destroy(stream_encoder);
+#undef NUM_SAMPLES
+    }
+}
+
+/* シークテーブル付加テスト */
+TEST(SRLAEncoderTest, AppendSeekTableTest)
+{
+#define NUM_SAMPLES 20000
+    struct SRLAEncoder *encoder;
+    struct SRLAEncoderConfig config;
+    struct SRLAEncodeParameter parameter;
+    uint8_t *data;
+    int32_t *input[1];
+    uint32_t smpl, sufficient_size, encoded_size, output_size, num_points;
+
+    SRLAEncoder_SetValidConfig(&config);
+    SRLAEncoder_SetValidEncodeParameter(&parameter);
+    parameter.min_num_samples_per_block = parameter.max_num_samples_per_block = 1024;
+
+    sufficient_size = SRLA_HEADER_SIZE + 2 * NUM_SAMPLES * sizeof(int32_t);
+    data = (uint8_t *)malloc(sufficient_size);
+    input[0] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[0][smpl] = (rand() % 256) - 128;
+    }
+
+    encoder = SRLAEncoder_Create(&config, NULL, 0);
+    ASSERT_TRUE(encoder != NULL);
+    ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+    ASSERT_EQ(SRLA_APIRESULT_OK,
+        SRLAEncoder_EncodeWhole(encoder, input, NUM_SAMPLES, data, sufficient_size, &encoded_size, NULL));
+
+    /* 不正な引数 */
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLAEncoder_AppendSeekTable(NULL, sufficient_size, encoded_size, 4096, &output_size));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLAEncoder_AppendSeekTable(data, sufficient_size, encoded_size, 4096, NULL));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLAEncoder_AppendSeekTable(data, sufficient_size, encoded_size, 0, &output_size));
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+        SRLAEncoder_AppendSeekTable(data, encoded_size - 1, encoded_size, 4096, &output_size));
+
+    /* バッファ不足 */
+    EXPECT_EQ(SRLA_APIRESULT_INSUFFICIENT_BUFFER,
+        SRLAEncoder_AppendSeekTable(data, encoded_size + SRLA_SEEK_TABLE_CHUNK_SIZE(5) - 1, encoded_size, 4096, &output_size));
+
+    /* 途中で途切れたデータ */
+    EXPECT_EQ(SRLA_APIRESULT_INVALID_FORMAT,
+        SRLAEncoder_AppendSeekTable(data, sufficient_size, encoded_size - 1, 4096, &output_size));
+
+    /* 固定ブロックサイズ1024・間隔4096なら4ブロック毎にシーク点 */
+    EXPECT_EQ(SRLA_APIRESULT_OK,
+        SRLAEncoder_AppendSeekTable(data, sufficient_size, encoded_size, 4096, &output_size));
+    num_points = ByteArray_ReadUint32BE(&data[encoded_size]);
+    EXPECT_EQ(5, num_points);
+    EXPECT_EQ(encoded_size + SRLA_SEEK_TABLE_CHUNK_SIZE(num_points), output_size);
+    EXPECT_EQ(SRLA_SEEK_TABLE_CHUNK_SIZE(num_points), ByteArray_ReadUint32BE(&data[output_size - 8]));
+    EXPECT_EQ(SRLA_SEEK_TABLE_SIGNATURE, ByteArray_ReadUint32BE(&data[output_size - 4]));
+    for (smpl = 0; smpl < num_points; smpl++) {
+        const uint32_t offset = ByteArray_ReadUint32BE(&data[encoded_size + 4 + 8 * smpl]);
+        EXPECT_EQ(SRLA_BLOCK_SYNC_CODE, ByteArray_ReadUint16BE(&data[offset]));
+        EXPECT_EQ(4096 * smpl, ByteArray_ReadUint32BE(&data[encoded_size + 4 + 8 * smpl + 4]));
+    }
+
+    free(input[0]);
+    free(data);
+    SRLAEncoder_Destroy(encoder);
+#undef NUM_SAMPLES
+}
+
+/* インターリーブ入力のブロックエンコードテスト */
+TEST(SRLAEncoderTest, EncodeBlockInterleavedTest)
+{
+    /* 無効な引数 */
+    {
+        struct SRLAEncoder *encoder;
+        struct SRLAEncoderConfig config;
+        int16_t input[64];
+        uint8_t data[256];
+        uint32_t output_size;
+
+        SRLAEncoder_SetValidConfig(&config);
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(NULL, input, SRLA_PCM_FORMAT_INT16, 64, data, sizeof(data), &output_size));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, NULL, SRLA_PCM_FORMAT_INT16, 64, data, sizeof(data), &output_size));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, input, (SRLAPcmFormat)3, 64, data, sizeof(data), &output_size));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, input, SRLA_PCM_FORMAT_INT16, 0, data, sizeof(data), &output_size));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, input, SRLA_PCM_FORMAT_INT16, 64, NULL, sizeof(data), &output_size));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, input, SRLA_PCM_FORMAT_INT16, 64, data, 0, &output_size));
+        EXPECT_EQ(SRLA_APIRESULT_INVALID_ARGUMENT,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, input, SRLA_PCM_FORMAT_INT16, 64, data, sizeof(data), NULL));
+
+        /* パラメータ未セット */
+        EXPECT_EQ(SRLA_APIRESULT_PARAMETER_NOT_SET,
+            SRLAEncoder_EncodeBlockInterleaved(encoder, input, SRLA_PCM_FORMAT_INT16, 64, data, sizeof(data), &output_size));
+
+        SRLAEncoder_Destroy(encoder);
+    }
+
+    /* チャンネル毎の入力とバイナリ一致するか */
+    {
+#define NUM_SAMPLES 4096
+#define NUM_CHANNELS 2
+        struct SRLAEncoder *encoder;
+        struct SRLAEncoderConfig config;
+        struct SRLAEncodeParameter parameter;
+        int32_t *input[NUM_CHANNELS];
+        int16_t *input_int16;
+        uint8_t *input_int24;
+        int32_t *input_int32;
+        uint8_t *planar_data, *interleaved_data;
+        uint32_t ch, smpl, sufficient_size, planar_size, interleaved_size;
+        uint32_t bits_no, signal_no, format_no;
+        static const uint16_t bits_per_sample[] = { 16, 24 };
+        static const uint32_t num_samples[] = { NUM_SAMPLES, 1000, 16 };
+        static const SRLAPcmFormat formats[] = { SRLA_PCM_FORMAT_INT16, SRLA_PCM_FORMAT_INT24, SRLA_PCM_FORMAT_INT32 };
+
+        SRLAEncoder_SetValidConfig(&config);
+        config.max_num_channels = NUM_CHANNELS;
+
+        sufficient_size = 2 * NUM_CHANNELS * NUM_SAMPLES * sizeof(int32_t);
+        planar_data = (uint8_t *)malloc(sufficient_size);
+        interleaved_data = (uint8_t *)malloc(sufficient_size);
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            input[ch] = (int32_t *)malloc(sizeof(int32_t) * NUM_SAMPLES);
+        }
+        input_int16 = (int16_t *)malloc(sizeof(int16_t) * NUM_CHANNELS * NUM_SAMPLES);
+        input_int24 = (uint8_t *)malloc(3 * NUM_CHANNELS * NUM_SAMPLES);
+        input_int32 = (int32_t *)malloc(sizeof(int32_t) * NUM_CHANNELS * NUM_SAMPLES);
+
+        encoder = SRLAEncoder_Create(&config, NULL, 0);
+        ASSERT_TRUE(encoder != NULL);
+
+        for (bits_no = 0; bits_no < sizeof(bits_per_sample) / sizeof(bits_per_sample[0]); bits_no++) {
+            SRLAEncoder_SetValidEncodeParameter(&parameter);
+            parameter.num_channels = NUM_CHANNELS;
+            parameter.bits_per_sample = bits_per_sample[bits_no];
+            parameter.max_num_samples_per_block = NUM_SAMPLES;
+            parameter.preset = 2;
+            ASSERT_EQ(SRLA_APIRESULT_OK, SRLAEncoder_SetEncodeParameter(encoder, &parameter));
+
+            /* 0: 正弦波と乱数の混合信号, 1: 無音, 2: LPC次数以下の短いブロック（生データ） */
+            for (signal_no = 0; signal_no < sizeof(num_samples) / sizeof(num_samples[0]); signal_no++) {
+                const int32_t amplitude = (1 << (bits_per_sample[bits_no] - 2));
+                srand(signal_no);
+                for (smpl = 0; smpl < num_samples[signal_no]; smpl++) {
+                    for (ch = 0; ch < NUM_CHANNELS; ch++) {
+                        int32_t val = 0;
+                        if (signal_no != 1) {
+                            val = (int32_t)(amplitude * sin(0.01 * (ch + 1) * smpl)) + (rand() % 64) - 32;
+                        }
+                        input[ch][smpl] = val;
+                        input_int16[NUM_CHANNELS * smpl + ch] = (int16_t)val;
+                        SRLAUTILITY_PUT_INT24LE(&input_int24[3 * (NUM_CHANNELS * smpl + ch)], val);
+                        input_int32[NUM_CHANNELS * smpl + ch] = val;
+                    }
+                }
+
+                ASSERT_EQ(SRLA_APIRESULT_OK,
+                    SRLAEncoder_EncodeBlock(encoder,
+                        input, num_samples[signal_no], planar_data, sufficient_size, &planar_size));
+
+                for (format_no = 0; format_no < sizeof(formats) / sizeof(formats[0]); format_no++) {
+                    const void *interleaved;
+                    /* 16bit形式には24bitの信号は入らない */
+                    if ((formats[format_no] == SRLA_PCM_FORMAT_INT16) && (bits_per_sample[bits_no] > 16)) {
+                        continue;
+                    }
+                    switch (formats[format_no]) {
+                    case SRLA_PCM_FORMAT_INT16: interleaved = input_int16; break;
+                    case SRLA_PCM_FORMAT_INT24: interleaved = input_int24; break;
+                    default:                    interleaved = input_int32; break;
+                    }
+                    ASSERT_EQ(SRLA_APIRESULT_OK,
+                        SRLAEncoder_EncodeBlockInterleaved(encoder, interleaved, formats[format_no],
+                            num_samples[signal_no], interleaved_data, sufficient_size, &interleaved_size));
+                    EXPECT_EQ(planar_size, interleaved_size);
+                    EXPECT_EQ(0, memcmp(planar_data, interleaved_data, planar_size));
+                }
+            }
+        }
+
+        for (ch = 0; ch < NUM_CHANNELS; ch++) {
+            free(input[ch]);
+        }
+        free(input_int16);
+        free(input_int24);
+        free(input_int32);
+        free(planar_data);
+        free(interleaved_data);
+        SRLAEncoder_Destroy(encoder);
+#undef NUM_CHANNELS
+#undef NUM_SAMPLES
+    }
 }
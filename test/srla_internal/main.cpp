@@ -6,6 +6,7 @@
 /* テスト対象のモジュール */
 extern "C" {
 #include "../../libs/srla_internal/src/srla_utility.c"
+#include "../../libs/srla_internal/src/srla_simd.c"
 }
 
 /* Fletcher16の計算テスト */
@@ -74,6 +75,36 @@ TEST(SRLAUtilityTest, CalculateFletcher16Test)
     }
 }
 
+/* SIMD命令セットの選択テスト */
+TEST(SRLASIMDTest, InstructionSetTest)
+{
+    /* 命令セット名の解釈 */
+    {
+        SRLASIMDInstructionSet set;
+
+        EXPECT_EQ(1, SRLASIMD_ParseInstructionSetName("none", &set));
+        EXPECT_EQ(SRLA_SIMD_NONE, set);
+        EXPECT_EQ(1, SRLASIMD_ParseInstructionSetName("sse41", &set));
+        EXPECT_EQ(SRLA_SIMD_SSE41, set);
+        EXPECT_EQ(1, SRLASIMD_ParseInstructionSetName("avx2", &set));
+        EXPECT_EQ(SRLA_SIMD_AVX2, set);
+        EXPECT_EQ(1, SRLASIMD_ParseInstructionSetName("avx512", &set));
+        EXPECT_EQ(SRLA_SIMD_AVX512, set);
+
+        /* 不正な名前 */
+        EXPECT_EQ(0, SRLASIMD_ParseInstructionSetName(NULL, &set));
+        EXPECT_EQ(0, SRLASIMD_ParseInstructionSetName("none", NULL));
+        EXPECT_EQ(0, SRLASIMD_ParseInstructionSetName("", &set));
+        EXPECT_EQ(0, SRLASIMD_ParseInstructionSetName("AVX2", &set));
+        EXPECT_EQ(0, SRLASIMD_ParseInstructionSetName("neon", &set));
+    }
+
+    /* 実行環境で使えない命令セットは選ばれない */
+    {
+        EXPECT_LE(SRLASIMD_GetInstructionSet(), SRLASIMD_DetectInstructionSet());
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
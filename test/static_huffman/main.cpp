@@ -111,6 +111,10 @@ TEST(StaticHuffmanTest, BuildHuffmanTreeTest)
 /* エンコードデコードテスト */
 TEST(StaticHuffmanTest, PutGetCodeTest)
 {
+    /* 復号テーブルはサイズが大きいのでヒープに確保 */
+    struct StaticHuffmanDecodeTable *table
+        = (struct StaticHuffmanDecodeTable *)malloc(sizeof(struct StaticHuffmanDecodeTable));
+
     /* 簡単な例 */
     {
 #define NUM_SYMBOLS 100
@@ -142,6 +146,60 @@ TEST(StaticHuffmanTest, PutGetCodeTest)
             const uint32_t test = StaticHuffman_GetCode(&tree, &stream);
             EXPECT_EQ(symbol, test);
         }
+
+        /* 復号テーブルでも一致確認 */
+        StaticHuffman_BuildDecodeTable(&tree, table);
+        BitReader_Open(&stream, buffer, NUM_SYMBOLS);
+        for (symbol = 0; symbol < NUM_SYMBOLS; symbol++) {
+            const uint32_t test = StaticHuffman_GetCodeByTable(table, &stream);
+            EXPECT_EQ(symbol, test);
+        }
+#undef NUM_SYMBOLS
+    }
+
+    /* 1段目のテーブルに収まらない長い符号を含む例 */
+    {
+#define NUM_SYMBOLS 30
+        uint32_t symbol, i;
+        uint32_t counts[NUM_SYMBOLS];
+        uint8_t buffer[4096];
+        struct StaticHuffmanTree tree;
+        struct StaticHuffmanCodes codes;
+        struct BitStream stream;
+
+        /* フィボナッチ数列の頻度で最も偏った木を作る */
+        counts[0] = counts[1] = 1;
+        for (symbol = 2; symbol < NUM_SYMBOLS; symbol++) {
+            counts[symbol] = counts[symbol - 1] + counts[symbol - 2];
+        }
+
+        StaticHuffman_BuildHuffmanTree(counts, NUM_SYMBOLS, &tree);
+        StaticHuffman_ConvertTreeToCodes(&tree, &codes);
+        StaticHuffman_BuildDecodeTable(&tree, table);
+        EXPECT_GT(codes.codes[0].bit_count, STATICHUFFMAN_DECODE_TABLE_BITS + STATICHUFFMAN_DECODE_SUBTABLE_BITS);
+
+        /* 全シンボルを数回ずつ出力 */
+        BitWriter_Open(&stream, buffer, sizeof(buffer));
+        for (i = 0; i < 4; i++) {
+            for (symbol = 0; symbol < NUM_SYMBOLS; symbol++) {
+                StaticHuffman_PutCode(&codes, &stream, (symbol * 7 + i) % NUM_SYMBOLS);
+            }
+        }
+        BitStream_Flush(&stream);
+
+        /* 木を辿る復号とテーブル復号で一致確認 */
+        BitReader_Open(&stream, buffer, sizeof(buffer));
+        for (i = 0; i < 4; i++) {
+            for (symbol = 0; symbol < NUM_SYMBOLS; symbol++) {
+                EXPECT_EQ((symbol * 7 + i) % NUM_SYMBOLS, StaticHuffman_GetCode(&tree, &stream));
+            }
+        }
+        BitReader_Open(&stream, buffer, sizeof(buffer));
+        for (i = 0; i < 4; i++) {
+            for (symbol = 0; symbol < NUM_SYMBOLS; symbol++) {
+                EXPECT_EQ((symbol * 7 + i) % NUM_SYMBOLS, StaticHuffman_GetCodeByTable(table, &stream));
+            }
+        }
 #undef NUM_SYMBOLS
     }
 
@@ -194,10 +252,20 @@ TEST(StaticHuffmanTest, PutGetCodeTest)
             EXPECT_EQ(data[i], test);
         }
 
+        /* 復号テーブルでも一致確認 */
+        StaticHuffman_BuildDecodeTable(&tree, table);
+        BitReader_Open(&stream, buffer, output_size);
+        for (i = 0; i < file_size; i++) {
+            const uint32_t test = StaticHuffman_GetCodeByTable(table, &stream);
+            EXPECT_EQ(data[i], test);
+        }
+
         free(data);
         free(buffer);
 #undef FILENAME
     }
+
+    free(table);
 }
 
 int main(int argc, char **argv)
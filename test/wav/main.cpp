@@ -315,6 +315,461 @@ TEST(WAVTest, WriteTest)
 
 }
 
+/* PCMバイト列変換テスト */
+TEST(WAVTest, ConvertInterleavedPCMToPlanarTest)
+{
+#define MAX_NUM_CHANNELS 8
+#define MAX_NUM_SAMPLES 1500
+    uint32_t bytes_per_sample, i_ch, ch, smpl, i_byte, is_ok, simd;
+    uint8_t big_endian;
+    const uint32_t num_channels_list[] = { 1, 2, 3, 8 };
+    const uint32_t max_simd = (uint32_t)SRLASIMD_DetectInstructionSet();
+    static uint8_t data[4 * MAX_NUM_CHANNELS * MAX_NUM_SAMPLES];
+    static WAVPcmData output_buffer[MAX_NUM_CHANNELS][MAX_NUM_SAMPLES + 1];
+    WAVPcmData *output[MAX_NUM_CHANNELS];
+
+    srand(0);
+    for (ch = 0; ch < MAX_NUM_CHANNELS; ch++) {
+        output[ch] = output_buffer[ch];
+    }
+
+    /* 全てのビット深度・エンディアン・チャンネル数で素朴な変換と一致するか */
+    for (bytes_per_sample = 1; bytes_per_sample <= 4; bytes_per_sample++) {
+        for (big_endian = 0; big_endian <= 1; big_endian++) {
+            for (i_ch = 0; i_ch < sizeof(num_channels_list) / sizeof(num_channels_list[0]); i_ch++) {
+                const uint32_t num_channels = num_channels_list[i_ch];
+                /* 端数処理を確認するため半端なサンプル数にする */
+                const uint32_t num_samples = MAX_NUM_SAMPLES - 1 - (uint32_t)rand() % 7;
+                for (i_byte = 0; i_byte < bytes_per_sample * num_channels * num_samples; i_byte++) {
+                    data[i_byte] = (uint8_t)rand();
+                }
+                /* 実行環境で使える全ての命令セットの実装を確認 */
+                for (simd = (uint32_t)SRLA_SIMD_NONE; simd <= max_simd; simd++) {
+                    /* 書き出し位置のオフセットも確認 */
+                    memset(output_buffer, 0, sizeof(output_buffer));
+                    WAV_ConvertInterleavedPCMToPlanar(
+                        WAV_GetConvertFunctions((SRLASIMDInstructionSet)simd), data, num_samples, num_channels,
+                        bytes_per_sample, big_endian, output, 1);
+
+                    is_ok = 1;
+                    for (smpl = 0; smpl < num_samples; smpl++) {
+                        for (ch = 0; ch < num_channels; ch++) {
+                            const uint8_t *p = &data[(smpl * num_channels + ch) * bytes_per_sample];
+                            uint32_t bits = 0;
+                            int32_t ref;
+                            for (i_byte = 0; i_byte < bytes_per_sample; i_byte++) {
+                                const uint32_t shift = big_endian ? (8 * (bytes_per_sample - i_byte - 1)) : (8 * i_byte);
+                                bits |= (uint32_t)p[i_byte] << shift;
+                            }
+                            if (bytes_per_sample == 1) {
+                                ref = (int32_t)bits - 128;
+                            } else {
+                                /* 上位ビットに詰めて算術右シフトで符号拡張 */
+                                ref = (int32_t)(bits << (32 - 8 * bytes_per_sample)) >> (32 - 8 * bytes_per_sample);
+                            }
+                            if (output[ch][smpl + 1] != ref) {
+                                is_ok = 0;
+                            }
+                        }
+                    }
+                    EXPECT_EQ(1, is_ok);
+                }
+            }
+        }
+    }
+#undef MAX_NUM_CHANNELS
+#undef MAX_NUM_SAMPLES
+}
+
+/* インターリーブPCMバイト列への変換テスト */
+TEST(WAVTest, ConvertPlanarToInterleavedPCMTest)
+{
+#define MAX_NUM_CHANNELS 8
+#define MAX_NUM_SAMPLES 1500
+    uint32_t bytes_per_sample, i_ch, ch, smpl, i_byte, is_ok, simd;
+    uint8_t big_endian;
+    const uint32_t num_channels_list[] = { 1, 2, 3, 8 };
+    const uint32_t max_simd = (uint32_t)SRLASIMD_DetectInstructionSet();
+    static uint8_t data[4 * MAX_NUM_CHANNELS * MAX_NUM_SAMPLES];
+    static WAVPcmData input_buffer[MAX_NUM_CHANNELS][MAX_NUM_SAMPLES + 1];
+    WAVPcmData *input[MAX_NUM_CHANNELS];
+
+    srand(0);
+    for (ch = 0; ch < MAX_NUM_CHANNELS; ch++) {
+        input[ch] = input_buffer[ch];
+    }
+
+    /* 全てのビット深度・エンディアン・チャンネル数で素朴な変換と一致するか */
+    for (bytes_per_sample = 1; bytes_per_sample <= 4; bytes_per_sample++) {
+        for (big_endian = 0; big_endian <= 1; big_endian++) {
+            for (i_ch = 0; i_ch < sizeof(num_channels_list) / sizeof(num_channels_list[0]); i_ch++) {
+                const uint32_t num_channels = num_channels_list[i_ch];
+                /* 端数処理を確認するため半端なサンプル数にする */
+                const uint32_t num_samples = MAX_NUM_SAMPLES - 1 - (uint32_t)rand() % 7;
+                /* 表現できる範囲の値を生成 */
+                for (ch = 0; ch < num_channels; ch++) {
+                    for (smpl = 0; smpl < num_samples + 1; smpl++) {
+                        const uint32_t bits = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+                        if (bytes_per_sample == 1) {
+                            input[ch][smpl] = (int32_t)(bits & 0xFF) - 128;
+                        } else {
+                            input[ch][smpl] = (int32_t)(bits << (32 - 8 * bytes_per_sample)) >> (32 - 8 * bytes_per_sample);
+                        }
+                    }
+                }
+                /* 実行環境で使える全ての命令セットの実装を確認 */
+                for (simd = (uint32_t)SRLA_SIMD_NONE; simd <= max_simd; simd++) {
+                    /* 読み出し位置のオフセットも確認 */
+                    memset(data, 0, sizeof(data));
+                    WAV_ConvertPlanarToInterleavedPCM(
+                        WAV_GetConvertFunctions((SRLASIMDInstructionSet)simd), (const WAVPcmData *const *)input,
+                        1, num_samples, num_channels, bytes_per_sample, big_endian, data);
+
+                    is_ok = 1;
+                    for (smpl = 0; smpl < num_samples; smpl++) {
+                        for (ch = 0; ch < num_channels; ch++) {
+                            const uint8_t *p = &data[(smpl * num_channels + ch) * bytes_per_sample];
+                            const uint32_t bits = (uint32_t)(input[ch][smpl + 1] + ((bytes_per_sample == 1) ? 128 : 0));
+                            for (i_byte = 0; i_byte < bytes_per_sample; i_byte++) {
+                                const uint32_t shift = big_endian ? (8 * (bytes_per_sample - i_byte - 1)) : (8 * i_byte);
+                                if (p[i_byte] != (uint8_t)((bits >> shift) & 0xFF)) {
+                                    is_ok = 0;
+                                }
+                            }
+                        }
+                    }
+                    EXPECT_EQ(1, is_ok);
+                }
+            }
+        }
+    }
+#undef MAX_NUM_CHANNELS
+#undef MAX_NUM_SAMPLES
+}
+
+/* ストリーミング読み込みテスト */
+TEST(WAVTest, StreamReaderTest)
+{
+    /* 失敗テスト */
+    {
+        struct WAVStreamReader *reader;
+        struct WAVFormat format;
+        WAVPcmData *buffer[1] = { NULL };
+        uint32_t num_read_samples;
+
+        EXPECT_TRUE(WAVStreamReader_Open(NULL, 1024) == NULL);
+        EXPECT_TRUE(WAVStreamReader_Open("a.wav", 0) == NULL);
+        EXPECT_TRUE(WAVStreamReader_Open("dummy.a.wav.wav", 1024) == NULL);
+        WAVStreamReader_Close(NULL);
+
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_GetFormat(NULL, &format));
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_Read(NULL, buffer, 1, &num_read_samples));
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_Seek(NULL, 0));
+
+        reader = WAVStreamReader_Open("16bit.wav", 16);
+        ASSERT_TRUE(reader != NULL);
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_GetFormat(reader, NULL));
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_Read(reader, NULL, 1, &num_read_samples));
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_Read(reader, buffer, 1, NULL));
+        /* 最大サンプル数を越える要求 */
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_Read(reader, buffer, 17, &num_read_samples));
+        /* 末尾を越えるシーク */
+        ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_GetFormat(reader, &format));
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamReader_Seek(reader, format.num_samples + 1));
+        WAVStreamReader_Close(reader);
+    }
+
+    /* 一括読み込みと同じ結果が得られるか */
+    {
+#define MAX_NUM_READ_SAMPLES 1000
+        uint32_t ch, i_test, progress, num_read_samples, is_ok;
+        const char* test_sourcefile_list[] = {
+            "a.wav",
+            "8bit_2ch.wav",
+            "16bit_2ch.wav",
+            "24bit_2ch.wav",
+            "32bit_2ch.wav",
+            "M1F1-uint8-AFsp.wav",
+            "M1F1-int16WE-AFsp.wav",
+            "M1F1-int24-AFsp.wav",
+            "M1F1-int32WE-AFsp.wav",
+            "M1F1-int8-AFsp.aif",
+            "M1F1-int16-AFsp.aif",
+            "M1F1-int24-AFsp.aif",
+            "M1F1-int32-AFsp.aif",
+            "400Hz_loop_100000_300000.aif",
+        };
+
+        srand(0);
+        for (i_test = 0;
+                i_test < sizeof(test_sourcefile_list) / sizeof(test_sourcefile_list[0]);
+                i_test++) {
+            struct WAVFile *wavfile;
+            struct WAVStreamReader *reader;
+            struct WAVFormat format;
+            WAVPcmData **buffer;
+            uint32_t seek_sample;
+
+            wavfile = WAV_CreateFromFile(test_sourcefile_list[i_test]);
+            ASSERT_TRUE(wavfile != NULL);
+            reader = WAVStreamReader_Open(test_sourcefile_list[i_test], MAX_NUM_READ_SAMPLES);
+            ASSERT_TRUE(reader != NULL);
+
+            /* フォーマットの一致確認 */
+            ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_GetFormat(reader, &format));
+            EXPECT_EQ(0, memcmp(&wavfile->format, &format, sizeof(struct WAVFormat)));
+
+            buffer = (WAVPcmData **)malloc(sizeof(WAVPcmData *) * format.num_channels);
+            for (ch = 0; ch < format.num_channels; ch++) {
+                buffer[ch] = (WAVPcmData *)malloc(sizeof(WAVPcmData) * MAX_NUM_READ_SAMPLES);
+            }
+
+            /* ランダムなサンプル数ずつ読み込んで比較 */
+            is_ok = 1;
+            progress = 0;
+            while (1) {
+                const uint32_t num_request_samples = 1 + (uint32_t)rand() % MAX_NUM_READ_SAMPLES;
+                ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_Read(reader, buffer, num_request_samples, &num_read_samples));
+                if (num_read_samples == 0) {
+                    break;
+                }
+                for (ch = 0; ch < format.num_channels; ch++) {
+                    if (memcmp(&wavfile->data[ch][progress], buffer[ch], sizeof(WAVPcmData) * num_read_samples) != 0) {
+                        is_ok = 0;
+                    }
+                }
+                progress += num_read_samples;
+            }
+            EXPECT_EQ(1, is_ok);
+            EXPECT_EQ(format.num_samples, progress);
+
+            /* シークしてから読み込んで比較 */
+            seek_sample = format.num_samples / 3;
+            ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_Seek(reader, seek_sample));
+            ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_Read(reader, buffer, MAX_NUM_READ_SAMPLES, &num_read_samples));
+            EXPECT_EQ(WAV_Min(MAX_NUM_READ_SAMPLES, format.num_samples - seek_sample), num_read_samples);
+            for (ch = 0; ch < format.num_channels; ch++) {
+                EXPECT_EQ(0, memcmp(&wavfile->data[ch][seek_sample], buffer[ch], sizeof(WAVPcmData) * num_read_samples));
+            }
+
+            for (ch = 0; ch < format.num_channels; ch++) {
+                free(buffer[ch]);
+            }
+            free(buffer);
+            WAVStreamReader_Close(reader);
+            WAV_Destroy(wavfile);
+        }
+#undef MAX_NUM_READ_SAMPLES
+    }
+
+    /* RF64形式の読み込み */
+    {
+        const char test_filename[] = "tmp_rf64.wav";
+        struct WAVFile *wavfile;
+        struct WAVStreamReader *reader;
+        struct WAVFormat format;
+        FILE *fp;
+        uint8_t *riff_data;
+        long riff_size;
+        uint32_t ch, i, data_pos, num_read_samples;
+        uint64_t data_size;
+
+        /* RIFF形式で書き出したファイルをRF64形式に書き換える */
+        wavfile = WAV_CreateFromFile("16bit_2ch.wav");
+        ASSERT_TRUE(wavfile != NULL);
+        ASSERT_EQ(WAV_APIRESULT_OK, WAV_WriteToFile(test_filename, wavfile));
+        ASSERT_TRUE((fp = fopen(test_filename, "rb")) != NULL);
+        fseek(fp, 0, SEEK_END);
+        riff_size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        riff_data = (uint8_t *)malloc((size_t)riff_size);
+        ASSERT_EQ((size_t)riff_size, fread(riff_data, sizeof(uint8_t), (size_t)riff_size, fp));
+        fclose(fp);
+
+        for (data_pos = 12; data_pos < (uint32_t)riff_size - 4; data_pos++) {
+            if (memcmp(&riff_data[data_pos], "data", 4) == 0) {
+                break;
+            }
+        }
+        data_size = (uint64_t)riff_size - data_pos - 8;
+        /* dataチャンクのサイズはds64で指定 */
+        memset(&riff_data[data_pos + 4], 0xFF, 4);
+
+        ASSERT_TRUE((fp = fopen(test_filename, "wb")) != NULL);
+        fwrite("RF64\xFF\xFF\xFF\xFFWAVE", sizeof(uint8_t), 12, fp);
+        fwrite("ds64\x1C\x00\x00\x00", sizeof(uint8_t), 8, fp);
+        for (i = 0; i < 8; i++) {
+            fputc((int)((((uint64_t)riff_size + 36 - 8) >> (8 * i)) & 0xFF), fp);
+        }
+        for (i = 0; i < 8; i++) {
+            fputc((int)((data_size >> (8 * i)) & 0xFF), fp);
+        }
+        for (i = 0; i < 8; i++) {
+            fputc((int)(((uint64_t)wavfile->format.num_samples >> (8 * i)) & 0xFF), fp);
+        }
+        fwrite("\x00\x00\x00\x00", sizeof(uint8_t), 4, fp);
+        fwrite(&riff_data[12], sizeof(uint8_t), (size_t)riff_size - 12, fp);
+        fclose(fp);
+        free(riff_data);
+
+        reader = WAVStreamReader_Open(test_filename, wavfile->format.num_samples);
+        ASSERT_TRUE(reader != NULL);
+        ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_GetFormat(reader, &format));
+        EXPECT_EQ(0, memcmp(&wavfile->format, &format, sizeof(struct WAVFormat)));
+        {
+            WAVPcmData **buffer = (WAVPcmData **)malloc(sizeof(WAVPcmData *) * format.num_channels);
+            for (ch = 0; ch < format.num_channels; ch++) {
+                buffer[ch] = (WAVPcmData *)malloc(sizeof(WAVPcmData) * format.num_samples);
+            }
+            ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamReader_Read(reader, buffer, format.num_samples, &num_read_samples));
+            EXPECT_EQ(format.num_samples, num_read_samples);
+            for (ch = 0; ch < format.num_channels; ch++) {
+                EXPECT_EQ(0, memcmp(wavfile->data[ch], buffer[ch], sizeof(WAVPcmData) * format.num_samples));
+                free(buffer[ch]);
+            }
+            free(buffer);
+        }
+        WAVStreamReader_Close(reader);
+        WAV_Destroy(wavfile);
+    }
+}
+
+/* ファイル全体をメモリに読み込み */
+static uint8_t *WAVTest_ReadWholeFile(const char *filename, long *file_size)
+{
+    FILE *fp;
+    uint8_t *data;
+
+    if ((fp = fopen(filename, "rb")) == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    (*file_size) = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    data = (uint8_t *)malloc((size_t)(*file_size));
+    if (fread(data, sizeof(uint8_t), (size_t)(*file_size), fp) != (size_t)(*file_size)) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+
+    return data;
+}
+
+/* ストリーミング書き出しテスト */
+TEST(WAVTest, StreamWriterTest)
+{
+    /* 失敗テスト */
+    {
+        struct WAVStreamWriter *writer;
+        struct WAVFormat format;
+        WAVPcmData *buffer[1] = { NULL };
+
+        memset(&format, 0, sizeof(struct WAVFormat));
+        format.file_format = WAV_FILEFORMAT_PCMWAVEFORMAT;
+        format.num_channels = 1;
+        format.sampling_rate = 44100;
+        format.bits_per_sample = 16;
+        format.num_samples = 0;
+
+        EXPECT_TRUE(WAVStreamWriter_Open(NULL, &format, 1024) == NULL);
+        EXPECT_TRUE(WAVStreamWriter_Open("tmp_stream.wav", NULL, 1024) == NULL);
+        EXPECT_TRUE(WAVStreamWriter_Open("tmp_stream.wav", &format, 0) == NULL);
+        format.bits_per_sample = 12;
+        EXPECT_TRUE(WAVStreamWriter_Open("tmp_stream.wav", &format, 1024) == NULL);
+        format.bits_per_sample = 16;
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamWriter_Close(NULL));
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamWriter_Write(NULL, buffer, 1));
+
+        writer = WAVStreamWriter_Open("tmp_stream.wav", &format, 16);
+        ASSERT_TRUE(writer != NULL);
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamWriter_Write(writer, NULL, 1));
+        /* 最大サンプル数を越える要求 */
+        EXPECT_EQ(WAV_APIRESULT_INVALID_PARAMETER, WAVStreamWriter_Write(writer, buffer, 17));
+        EXPECT_EQ(WAV_APIRESULT_OK, WAVStreamWriter_Close(writer));
+        remove("tmp_stream.wav");
+    }
+
+    /* 一括書き出しと同じ結果が得られるか */
+    {
+#define MAX_NUM_WRITE_SAMPLES 1000
+        uint32_t i_test, i_pattern, progress;
+        const char* test_sourcefile_list[] = {
+            "8bit_2ch.wav",
+            "16bit_2ch.wav",
+            "24bit_2ch.wav",
+            "32bit_2ch.wav",
+            "M1F1-uint8-AFsp.wav",
+            "M1F1-int16WE-AFsp.wav",
+            "M1F1-int24-AFsp.aif",
+            "M1F1-int32-AFsp.aif",
+            "400Hz_loop_100000_300000.aif",
+        };
+        const char whole_filename[] = "tmp_whole.wav";
+        const char stream_filename[] = "tmp_stream.wav";
+
+        srand(0);
+        for (i_test = 0;
+                i_test < sizeof(test_sourcefile_list) / sizeof(test_sourcefile_list[0]);
+                i_test++) {
+            struct WAVFile *wavfile;
+            uint8_t *whole_data;
+            long whole_size;
+
+            wavfile = WAV_CreateFromFile(test_sourcefile_list[i_test]);
+            ASSERT_TRUE(wavfile != NULL);
+            ASSERT_EQ(WAV_APIRESULT_OK, WAV_WriteToFile(whole_filename, wavfile));
+            ASSERT_TRUE((whole_data = WAVTest_ReadWholeFile(whole_filename, &whole_size)) != NULL);
+
+            /* 0: ヘッダのサンプル数が正しい 1: ヘッダを後で書き直す */
+            for (i_pattern = 0; i_pattern < 2; i_pattern++) {
+                struct WAVStreamWriter *writer;
+                struct WAVFormat format;
+                uint8_t *stream_data;
+                long stream_size;
+                WAVPcmData *buffer[8];
+                uint32_t ch;
+
+                format = wavfile->format;
+                if (i_pattern == 1) {
+                    format.num_samples = 0;
+                }
+                writer = WAVStreamWriter_Open(stream_filename, &format, MAX_NUM_WRITE_SAMPLES);
+                ASSERT_TRUE(writer != NULL);
+
+                /* ランダムなサンプル数ずつ書き出し */
+                progress = 0;
+                while (progress < wavfile->format.num_samples) {
+                    const uint32_t num_request_samples = 1 + (uint32_t)rand() % MAX_NUM_WRITE_SAMPLES;
+                    const uint32_t num_write_samples
+                        = WAV_Min(num_request_samples, wavfile->format.num_samples - progress);
+                    for (ch = 0; ch < wavfile->format.num_channels; ch++) {
+                        buffer[ch] = &wavfile->data[ch][progress];
+                    }
+                    ASSERT_EQ(WAV_APIRESULT_OK,
+                        WAVStreamWriter_Write(writer, (const WAVPcmData *const *)buffer, num_write_samples));
+                    progress += num_write_samples;
+                }
+                ASSERT_EQ(WAV_APIRESULT_OK, WAVStreamWriter_Close(writer));
+
+                /* バイト単位で一致するか */
+                ASSERT_TRUE((stream_data = WAVTest_ReadWholeFile(stream_filename, &stream_size)) != NULL);
+                EXPECT_EQ(whole_size, stream_size);
+                if (whole_size == stream_size) {
+                    EXPECT_EQ(0, memcmp(whole_data, stream_data, (size_t)whole_size));
+                }
+                free(stream_data);
+            }
+
+            free(whole_data);
+            WAV_Destroy(wavfile);
+        }
+        remove(whole_filename);
+        remove(stream_filename);
+#undef MAX_NUM_WRITE_SAMPLES
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -2,6 +2,7 @@
 #include <srla_decoder.h>
 #include "wav.h"
 #include "command_line_parser.h"
+#include "mapped_file.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,10 +15,14 @@
 #define DEFALUT_MAX_NUM_BLOCK_SAMPLES 4096
 /* デフォルトの先読みサンプル数倍率 */
 #define DEFALUT_LOOKAHEAD_SAMPLES_FACTOR 4
+/* 先読み区間をスライドさせる場合のデフォルトの先読みサンプル数倍率 */
+#define DEFALUT_SLIDING_LOOKAHEAD_SAMPLES_FACTOR 1
 /* デフォルトの可変ブロック分割数 */
 #define DEFALUT_NUM_VARIABLE_BLOCK_DIVISIONS 1
 /* デフォルトのSVRによるフィルタ同定の学習繰り返し回数 */
 #define DEFALUT_NUM_SVR_FILTER_LEARNING_ITERATIONS 0
+/* デフォルトのエンコードスレッド数 */
+#define DEFALUT_NUM_THREADS 1
 /* パラメータプリセットの最大インデックス */
 #define SRLA_MAX_PARAMETER_PRESETS_INDEX 6
 #if SRLA_MAX_PARAMETER_PRESETS_INDEX != (SRLA_NUM_PARAMETER_PRESETS - 1)
@@ -53,6 +58,14 @@ static struct CommandLineParserSpecification command_line_spec[] = {
         COMMAND_LINE_PARSER_TRUE, NULL, COMMAND_LINE_PARSER_FALSE },
     {   0, "svr-filter-learning-iteration", "Specify the number of itration in filter computation using SVR (default:" TOSTRING(DEFALUT_NUM_SVR_FILTER_LEARNING_ITERATIONS) ")",
         COMMAND_LINE_PARSER_TRUE, NULL, COMMAND_LINE_PARSER_FALSE },
+    {   0, "estimate-block-partition", "Use estimated code length in variable block-size division search (faster, default:no)",
+        COMMAND_LINE_PARSER_FALSE, NULL, COMMAND_LINE_PARSER_FALSE },
+    {   0, "sliding-lookahead", "Slide the lookahead window in variable block-size division search (faster and better partitions at window edges, default lookahead factor becomes " TOSTRING(DEFALUT_SLIDING_LOOKAHEAD_SAMPLES_FACTOR) ", default:no)",
+        COMMAND_LINE_PARSER_FALSE, NULL, COMMAND_LINE_PARSER_FALSE },
+    {   0, "seek-table-interval", "Append a seek table with the specified interval of seek points in samples (default:0 (no seek table))",
+        COMMAND_LINE_PARSER_TRUE, NULL, COMMAND_LINE_PARSER_FALSE },
+    { 'T', "num-threads", "Specify number of threads used in encoding/decoding (default:" TOSTRING(DEFALUT_NUM_THREADS) ")",
+        COMMAND_LINE_PARSER_TRUE, NULL, COMMAND_LINE_PARSER_FALSE },
     {   0, "no-checksum-check", "Whether to NOT check checksum at decoding (default:no)",
         COMMAND_LINE_PARSER_FALSE, NULL, COMMAND_LINE_PARSER_FALSE },
     { 'h', "help", "Show command help message",
@@ -71,124 +84,467 @@ static void encode_block_callback(
     fflush(stdout);
 }
 
-/* エンコード 成功時は0、失敗時は0以外を返す */
-static int do_encode(const char *in_filename, const char *out_filename,
-    uint32_t encode_preset_no, uint32_t max_num_block_samples, uint32_t variable_block_num_divisions,
-    uint32_t lookahead_samples_factor, uint32_t ltp_order, uint32_t num_svr_filter_learning_iteration)
+/* ストリーミングエンコードの出力先 */
+struct StreamEncodeOutput {
+    FILE *fp; /* 出力ファイル */
+    uint64_t output_size; /* 出力したバイト数 */
+    uint8_t io_error; /* 書き出しに失敗したか？ */
+};
+
+/* ストリーミングエンコードの出力コールバック */
+static void stream_encode_output_callback(const uint8_t *data, uint32_t data_size, void *user_data)
+{
+    struct StreamEncodeOutput *output = (struct StreamEncodeOutput *)user_data;
+
+    if (fwrite(data, sizeof(uint8_t), data_size, output->fp) < data_size) {
+        output->io_error = 1;
+    }
+    output->output_size += data_size;
+}
+
+/* チャンネル毎のPCMバッファを作成 */
+static int32_t **create_pcm_buffer(uint32_t num_channels, uint32_t num_samples)
+{
+    uint32_t ch;
+    int32_t **buffer;
+
+    if ((buffer = (int32_t **)calloc(num_channels, sizeof(int32_t *))) == NULL) {
+        return NULL;
+    }
+    for (ch = 0; ch < num_channels; ch++) {
+        if ((buffer[ch] = (int32_t *)malloc(sizeof(int32_t) * num_samples)) == NULL) {
+            break;
+        }
+    }
+    /* 確保に失敗したら全て解放 */
+    if (ch < num_channels) {
+        for (ch = 0; ch < num_channels; ch++) {
+            free(buffer[ch]);
+        }
+        free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+/* チャンネル毎のPCMバッファを破棄 */
+static void destroy_pcm_buffer(int32_t **buffer, uint32_t num_channels)
+{
+    uint32_t ch;
+
+    for (ch = 0; ch < num_channels; ch++) {
+        free(buffer[ch]);
+    }
+    free(buffer);
+}
+
+/* 入力全体を走査してオフセットされた左シフト量を計算し、読み込み位置を先頭に戻す 成功時は0、失敗時は0以外を返す
+ * bufferは1回あたりnum_samples_per_readサンプル読み込める領域 */
+static int compute_offset_lshift(struct WAVStreamReader *in_wav,
+    int32_t **buffer, uint32_t num_samples_per_read, uint32_t *offset_lshift)
+{
+    struct WAVFormat format;
+    uint32_t ch, smpl, num_read_samples;
+    uint32_t mask = 0;
+
+    WAVStreamReader_GetFormat(in_wav, &format);
+
+    /* 使用されているビットを検査 */
+    while (1) {
+        if (WAVStreamReader_Read(in_wav, buffer, num_samples_per_read, &num_read_samples) != WAV_APIRESULT_OK) {
+            return 1;
+        }
+        if (num_read_samples == 0) {
+            break;
+        }
+        for (ch = 0; ch < format.num_channels; ch++) {
+            for (smpl = 0; smpl < num_read_samples; smpl++) {
+                mask |= (uint32_t)buffer[ch][smpl];
+            }
+        }
+    }
+
+    /* 末尾へ続く0の個数 全入力が0の場合はシフトなしとする */
+    (*offset_lshift) = 0;
+    if (mask != 0) {
+        while (((mask >> (*offset_lshift)) & 1) == 0) {
+            (*offset_lshift)++;
+        }
+    }
+
+    /* 先頭に戻す */
+    if (WAVStreamReader_Seek(in_wav, 0) != WAV_APIRESULT_OK) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/* 入力を少しずつ読みながらストリーミングエンコード 成功時は0、失敗時は0以外を返す
+ * 入力全体をメモリに載せないため、使用メモリ量は入力サイズによらない */
+static int do_stream_encode(struct WAVStreamReader *in_wav, const struct SRLAEncoderConfig *config,
+    const struct SRLAEncodeParameter *parameter, const char *out_filename, uint64_t *output_size)
+{
+    struct SRLAStreamEncoder *encoder;
+    struct StreamEncodeOutput output;
+    struct WAVFormat format;
+    int32_t **input;
+    uint8_t header[SRLA_HEADER_SIZE];
+    uint32_t progress, num_read_samples, offset_lshift;
+    SRLAApiResult ret;
+
+    WAVStreamReader_GetFormat(in_wav, &format);
+
+    /* エンコーダ作成 */
+    if ((encoder = SRLAStreamEncoder_Create(config, NULL, 0)) == NULL) {
+        fprintf(stderr, "Failed to create encoder handle. \n");
+        return 1;
+    }
+
+    /* 先読みサンプル数単位で読み込む */
+    if ((input = create_pcm_buffer(format.num_channels, config->max_num_lookahead_samples)) == NULL) {
+        fprintf(stderr, "Failed to allocate input buffer. \n");
+        return 1;
+    }
+
+    /* 左シフト量を求めるため、エンコード前に入力全体を一度走査 */
+    if (compute_offset_lshift(in_wav, input, config->max_num_lookahead_samples, &offset_lshift) != 0) {
+        fprintf(stderr, "Failed to read input data. \n");
+        return 1;
+    }
+
+    /* 出力ファイルを開いてエンコード開始 */
+    if ((output.fp = fopen(out_filename, "wb")) == NULL) {
+        fprintf(stderr, "Failed to open %s. \n", out_filename);
+        return 1;
+    }
+    output.output_size = 0;
+    output.io_error = 0;
+    if ((ret = SRLAStreamEncoder_Start(encoder, parameter, offset_lshift, stream_encode_output_callback, &output)) != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Failed to set encode parameter: %d \n", ret);
+        return 1;
+    }
+
+    /* 読み込んだ分だけ順次エンコード */
+    progress = 0;
+    while (1) {
+        if (WAVStreamReader_Read(in_wav, input, config->max_num_lookahead_samples, &num_read_samples) != WAV_APIRESULT_OK) {
+            fprintf(stderr, "Failed to read input data. \n");
+            return 1;
+        }
+        if (num_read_samples == 0) {
+            break;
+        }
+        if ((ret = SRLAStreamEncoder_Push(encoder, (const int32_t *const *)input, num_read_samples)) != SRLA_APIRESULT_OK) {
+            fprintf(stderr, "Failed to encode data: %d \n", ret);
+            return 1;
+        }
+        progress += num_read_samples;
+        printf("progress... %5.2f%% \r", (double)((progress * 100.0) / format.num_samples));
+        fflush(stdout);
+    }
+
+    /* 残りをエンコードし、先頭の暫定ヘッダを確定ヘッダで上書き */
+    if ((ret = SRLAStreamEncoder_Finish(encoder, header, sizeof(header))) != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Failed to encode data: %d \n", ret);
+        return 1;
+    }
+    if (output.io_error || (fseek(output.fp, 0, SEEK_SET) != 0)
+            || (fwrite(header, sizeof(uint8_t), sizeof(header), output.fp) < sizeof(header))) {
+        fprintf(stderr, "File output error! \n");
+        return 1;
+    }
+    (*output_size) = output.output_size;
+
+    /* リソース破棄 */
+    fclose(output.fp);
+    destroy_pcm_buffer(input, format.num_channels);
+    SRLAStreamEncoder_Destroy(encoder);
+
+    return 0;
+}
+
+/* 入力全体を読み込んでエンコード 成功時は0、失敗時は0以外を返す
+ * 並列エンコードとシークテーブルの付加は入力全体を必要とするため、こちらで行う */
+static int do_whole_encode(struct WAVStreamReader *in_wav, const struct SRLAEncoderConfig *config,
+    const struct SRLAEncodeParameter *parameter, uint32_t num_threads, uint64_t in_file_size,
+    const char *out_filename, uint64_t *output_size)
 {
     FILE *out_fp;
-    struct WAVFile *in_wav;
     struct SRLAEncoder *encoder;
-    struct SRLAEncoderConfig config;
-    struct SRLAEncodeParameter parameter;
-    struct stat fstat;
+    struct WAVFormat format;
+    int32_t **input, **input_ptr;
     uint8_t *buffer;
     uint32_t buffer_size, encoded_data_size;
+    uint32_t ch, progress, num_read_samples;
     SRLAApiResult ret;
-    uint32_t ch, smpl, num_channels, num_samples;
+
+    WAVStreamReader_GetFormat(in_wav, &format);
 
     /* エンコーダ作成 */
+    if ((encoder = SRLAEncoder_Create(config, NULL, 0)) == NULL) {
+        fprintf(stderr, "Failed to create encoder handle. \n");
+        return 1;
+    }
+    if ((ret = SRLAEncoder_SetEncodeParameter(encoder, parameter)) != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Failed to set encode parameter: %d \n", ret);
+        return 1;
+    }
+
+    /* 入力全体を読み込み */
+    if (((input = create_pcm_buffer(format.num_channels, format.num_samples)) == NULL)
+            || ((input_ptr = (int32_t **)malloc(sizeof(int32_t *) * format.num_channels)) == NULL)) {
+        fprintf(stderr, "Failed to allocate input buffer. \n");
+        return 1;
+    }
+    progress = 0;
+    do {
+        for (ch = 0; ch < format.num_channels; ch++) {
+            input_ptr[ch] = &input[ch][progress];
+        }
+        if (WAVStreamReader_Read(in_wav, input_ptr, config->max_num_lookahead_samples, &num_read_samples) != WAV_APIRESULT_OK) {
+            fprintf(stderr, "Failed to read input data. \n");
+            return 1;
+        }
+        progress += num_read_samples;
+    } while (num_read_samples > 0);
+    free(input_ptr);
+
+    /* 入力wavの2倍よりは大きくならないだろうという想定 */
+    /* 補足）APIのデータサイズは32bitのため、それを越える場合は上限で打ち切る */
+    buffer_size = (uint32_t)SRLACODEC_MIN(2 * in_file_size, 0xFFFFFFFFUL);
+
+    /* エンコードデータ領域を作成 */
+    buffer = (uint8_t *)malloc(buffer_size);
+
+    /* エンコード実行 */
+    if ((ret = SRLAEncoder_EncodeWholeParallel(encoder, num_threads,
+        (const int32_t *const *)input, format.num_samples, buffer, buffer_size, &encoded_data_size, encode_block_callback)) != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Failed to encode data: %d \n", ret);
+        return 1;
+    }
+
+    /* ファイル書き出し */
+    out_fp = fopen(out_filename, "wb");
+    if (fwrite(buffer, sizeof(uint8_t), encoded_data_size, out_fp) < encoded_data_size) {
+        fprintf(stderr, "File output error! %d \n", ret);
+        return 1;
+    }
+    (*output_size) = encoded_data_size;
+
+    /* リソース破棄 */
+    fclose(out_fp);
+    free(buffer);
+    destroy_pcm_buffer(input, format.num_channels);
+    SRLAEncoder_Destroy(encoder);
+
+    return 0;
+}
+
+/* エンコード 成功時は0、失敗時は0以外を返す */
+static int do_encode(const char *in_filename, const char *out_filename,
+    uint32_t encode_preset_no, uint32_t max_num_block_samples, uint32_t variable_block_num_divisions,
+    uint32_t lookahead_samples_factor, uint32_t ltp_order, uint32_t num_svr_filter_learning_iteration,
+    uint8_t estimate_partition_cost, uint8_t sliding_lookahead, uint32_t seek_table_interval, uint32_t num_threads)
+{
+    struct WAVStreamReader *in_wav;
+    struct WAVFormat format;
+    struct SRLAEncoderConfig config;
+    struct SRLAEncodeParameter parameter;
+    struct stat fstat;
+    uint64_t output_size;
+    int ret;
+
+    /* エンコーダコンフィグ */
     config.max_num_channels = SRLA_MAX_NUM_CHANNELS;
     config.min_num_samples_per_block = max_num_block_samples >> variable_block_num_divisions;
     config.max_num_samples_per_block = max_num_block_samples;
     config.max_num_lookahead_samples = lookahead_samples_factor * max_num_block_samples;
     config.max_num_parameters = SRLA_MAX_COEFFICIENT_ORDER;
-    if ((encoder = SRLAEncoder_Create(&config, NULL, 0)) == NULL) {
-        fprintf(stderr, "Failed to create encoder handle. \n");
-        return 1;
-    }
+    config.max_num_threads = num_threads;
 
     /* WAVファイルオープン */
-    if ((in_wav = WAV_CreateFromFile(in_filename)) == NULL) {
+    /* 補足）ヘッダだけを解釈し、PCMデータは先読みサンプル数単位で読み込む */
+    if ((in_wav = WAVStreamReader_Open(in_filename, config.max_num_lookahead_samples)) == NULL) {
         fprintf(stderr, "Failed to open %s. \n", in_filename);
         return 1;
     }
-    num_channels = in_wav->format.num_channels;
-    num_samples = in_wav->format.num_samples;
+    WAVStreamReader_GetFormat(in_wav, &format);
 
     /* エンコードパラメータセット */
-    parameter.num_channels = (uint16_t)num_channels;
-    parameter.bits_per_sample = (uint16_t)in_wav->format.bits_per_sample;
-    parameter.sampling_rate = in_wav->format.sampling_rate;
+    parameter.num_channels = (uint16_t)format.num_channels;
+    parameter.bits_per_sample = (uint16_t)format.bits_per_sample;
+    parameter.sampling_rate = format.sampling_rate;
     parameter.min_num_samples_per_block = max_num_block_samples >> variable_block_num_divisions;
     parameter.max_num_samples_per_block = max_num_block_samples;
     parameter.num_lookahead_samples = lookahead_samples_factor * max_num_block_samples;
     parameter.num_svr_filter_learning_iteration = num_svr_filter_learning_iteration;
     parameter.ltp_order = ltp_order;
+    parameter.estimate_partition_cost = estimate_partition_cost;
+    parameter.sliding_lookahead = sliding_lookahead;
+    parameter.seek_table_interval = seek_table_interval;
     /* プリセットの反映 */
     parameter.preset = (uint8_t)encode_preset_no;
-    if ((ret = SRLAEncoder_SetEncodeParameter(encoder, &parameter)) != SRLA_APIRESULT_OK) {
-        fprintf(stderr, "Failed to set encode parameter: %d \n", ret);
-        return 1;
-    }
 
     /* 入力ファイルのサイズを拾っておく */
     stat(in_filename, &fstat);
-    /* 入力wavの2倍よりは大きくならないだろうという想定 */
-    buffer_size = (uint32_t)(2 * fstat.st_size);
 
-    /* エンコードデータ領域を作成 */
-    buffer = (uint8_t *)malloc(buffer_size);
+    /* 並列エンコード・シークテーブルの付加を行わない場合は入力全体を読み込まずにエンコード */
+    if ((num_threads == 1) && (seek_table_interval == 0)) {
+        ret = do_stream_encode(in_wav, &config, &parameter, out_filename, &output_size);
+    } else {
+        ret = do_whole_encode(in_wav, &config, &parameter, num_threads, (uint64_t)fstat.st_size, out_filename, &output_size);
+    }
+    if (ret != 0) {
+        return ret;
+    }
 
-    /* エンコード実行 */
-    if ((ret = SRLAEncoder_EncodeWhole(encoder,
-        in_wav->data, num_samples, buffer, buffer_size, &encoded_data_size, encode_block_callback)) != SRLA_APIRESULT_OK) {
-        fprintf(stderr, "Failed to encode data: %d \n", ret);
+    /* 圧縮結果サマリの表示 */
+    printf("finished: %.0f -> %.0f (%6.2f %%) \n",
+            (double)fstat.st_size, (double)output_size, (double)((100.0 * (double)output_size) / (double)fstat.st_size));
+
+    /* リソース破棄 */
+    WAVStreamReader_Close(in_wav);
+
+    return 0;
+}
+
+/* ブロック毎にデコードしながらストリーミング書き出し 成功時は0、失敗時は0以外を返す */
+static int do_stream_decode(struct SRLADecoder *decoder,
+    const uint8_t *data, uint32_t data_size, const struct SRLAHeader *header,
+    const struct WAVFormat *wav_format, const char *out_filename)
+{
+    struct WAVStreamWriter *out_wav;
+    int32_t **buffer;
+    uint32_t progress, read_offset, read_block_size, num_decode_samples;
+    SRLAApiResult ret;
+
+    /* デコーダにヘッダをセット */
+    if ((ret = SRLADecoder_SetHeader(decoder, header)) != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Failed to set header: %d \n", ret);
         return 1;
     }
 
-    /* ファイル書き出し */
-    out_fp = fopen(out_filename, "wb");
-    if (fwrite(buffer, sizeof(uint8_t), encoded_data_size, out_fp) < encoded_data_size) {
-        fprintf(stderr, "File output error! %d \n", ret);
+    /* 1ブロック分のバッファを確保 */
+    if ((buffer = create_pcm_buffer(header->num_channels, header->max_num_samples_per_block)) == NULL) {
+        fprintf(stderr, "Failed to allocate decode buffer. \n");
         return 1;
     }
 
-    /* 圧縮結果サマリの表示 */
-    printf("finished: %zd -> %zd (%6.2f %%) \n",
-            fstat.st_size, encoded_data_size, (double)((100.0 * encoded_data_size) / (double)fstat.st_size));
+    /* 出力ファイルを開く */
+    if ((out_wav = WAVStreamWriter_Open(out_filename, wav_format, header->max_num_samples_per_block)) == NULL) {
+        fprintf(stderr, "Failed to open %s. \n", out_filename);
+        destroy_pcm_buffer(buffer, header->num_channels);
+        return 1;
+    }
 
-    /* リソース破棄 */
-    fclose(out_fp);
-    free(buffer);
-    WAV_Destroy(in_wav);
-    SRLAEncoder_Destroy(encoder);
+    /* ブロック単位でデコードして書き出し */
+    /* 補足）サンプル数分デコードしたら終了するため、末尾のシークテーブルは読まない */
+    progress = 0;
+    read_offset = SRLA_HEADER_SIZE;
+    while ((progress < header->num_samples) && (read_offset < data_size)) {
+        if ((ret = SRLADecoder_DecodeBlock(decoder,
+                        data + read_offset, data_size - read_offset,
+                        buffer, header->num_channels, header->max_num_samples_per_block,
+                        &read_block_size, &num_decode_samples)) != SRLA_APIRESULT_OK) {
+            fprintf(stderr, "Decoding error! %d \n", ret);
+            goto EXIT_FAILURE_WITH_DATA_RELEASE;
+        }
+        if (WAVStreamWriter_Write(out_wav, (const WAVPcmData *const *)buffer, num_decode_samples) != WAV_APIRESULT_OK) {
+            fprintf(stderr, "Failed to write wav file. \n");
+            goto EXIT_FAILURE_WITH_DATA_RELEASE;
+        }
+        read_offset += read_block_size;
+        progress += num_decode_samples;
+    }
+
+    destroy_pcm_buffer(buffer, header->num_channels);
+    if (WAVStreamWriter_Close(out_wav) != WAV_APIRESULT_OK) {
+        fprintf(stderr, "Failed to write wav file. \n");
+        return 1;
+    }
+
+    return 0;
+
+EXIT_FAILURE_WITH_DATA_RELEASE:
+    destroy_pcm_buffer(buffer, header->num_channels);
+    WAVStreamWriter_Close(out_wav);
+    return 1;
+}
+
+/* 全体をまとめてデコードしてから書き出し 成功時は0、失敗時は0以外を返す */
+static int do_whole_decode(struct SRLADecoder *decoder, uint32_t num_threads,
+    const uint8_t *data, uint32_t data_size, const struct WAVFormat *wav_format, const char *out_filename)
+{
+    struct WAVFile *out_wav;
+    SRLAApiResult ret;
+
+    /* 出力wavハンドルの生成 */
+    if ((out_wav = WAV_Create(wav_format)) == NULL) {
+        fprintf(stderr, "Failed to create wav handle. \n");
+        return 1;
+    }
+
+    /* 一括デコード */
+    if ((ret = SRLADecoder_DecodeWholeParallel(decoder, num_threads,
+                    data, data_size,
+                    (int32_t **)out_wav->data, out_wav->format.num_channels, out_wav->format.num_samples))
+                != SRLA_APIRESULT_OK) {
+        fprintf(stderr, "Decoding error! %d \n", ret);
+        WAV_Destroy(out_wav);
+        return 1;
+    }
+
+    /* WAVファイル書き出し */
+    if (WAV_WriteToFile(out_filename, out_wav) != WAV_APIRESULT_OK) {
+        fprintf(stderr, "Failed to write wav file. \n");
+        WAV_Destroy(out_wav);
+        return 1;
+    }
+
+    WAV_Destroy(out_wav);
 
     return 0;
 }
 
 /* デコード 成功時は0、失敗時は0以外を返す */
-static int do_decode(const char *in_filename, const char *out_filename, uint8_t check_checksum)
+static int do_decode(const char *in_filename, const char *out_filename, uint8_t check_checksum, uint32_t num_threads)
 {
-    FILE* in_fp;
-    struct WAVFile* out_wav;
+    struct MappedFile *in_file;
     struct WAVFormat wav_format;
-    struct stat fstat;
     struct SRLADecoder* decoder;
     struct SRLADecoderConfig config;
     struct SRLAHeader header;
-    uint8_t* buffer;
-    uint32_t ch, smpl, buffer_size;
+    const uint8_t* buffer;
+    uint32_t buffer_size;
     SRLAApiResult ret;
+    int err;
 
     /* デコーダハンドルの作成 */
     config.max_num_channels = SRLA_MAX_NUM_CHANNELS;
+    config.max_num_samples_per_block = 0;
     config.max_num_parameters = SRLA_MAX_COEFFICIENT_ORDER;
     config.check_checksum = check_checksum;
+    config.max_num_threads = num_threads;
     if ((decoder = SRLADecoder_Create(&config, NULL, 0)) == NULL) {
         fprintf(stderr, "Failed to create decoder handle. \n");
         return 1;
     }
 
-    /* 入力ファイルオープン */
-    in_fp = fopen(in_filename, "rb");
-    /* 入力ファイルのサイズ取得 / バッファ領域割り当て */
-    stat(in_filename, &fstat);
-    buffer_size = (uint32_t)fstat.st_size;
-    buffer = (uint8_t *)malloc(buffer_size);
-    /* バッファ領域にデータをロード */
-    fread(buffer, sizeof(uint8_t), buffer_size, in_fp);
-    fclose(in_fp);
+    /* 入力ファイルをマップ */
+    /* 補足）読み込みのコピーを行わず、マップした領域を直接デコーダに渡す */
+    if ((in_file = MappedFile_Open(in_filename, MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL)) == NULL) {
+        fprintf(stderr, "Failed to open %s. \n", in_filename);
+        return 1;
+    }
+    /* APIのデータサイズは32bitのため、それを越えるファイルは扱えない */
+    if (MappedFile_GetSize(in_file) > 0xFFFFFFFFUL) {
+        fprintf(stderr, "%s is too large. \n", in_filename);
+        return 1;
+    }
+    buffer = MappedFile_GetData(in_file);
+    buffer_size = (uint32_t)MappedFile_GetSize(in_file);
 
     /* ヘッダデコード */
     if ((ret = SRLADecoder_DecodeHeader(buffer, buffer_size, &header))
@@ -197,37 +553,25 @@ static int do_decode(const char *in_filename, const char *out_filename, uint8_t
         return 1;
     }
 
-    /* 出力wavハンドルの生成 */
+    /* 出力wavのフォーマット */
+    memset(&wav_format, 0, sizeof(struct WAVFormat));
     wav_format.file_format     = WAV_FILEFORMAT_PCMWAVEFORMAT;
     wav_format.num_channels    = header.num_channels;
     wav_format.sampling_rate   = header.sampling_rate;
     wav_format.bits_per_sample = header.bits_per_sample;
     wav_format.num_samples     = header.num_samples;
-    if ((out_wav = WAV_Create(&wav_format)) == NULL) {
-        fprintf(stderr, "Failed to create wav handle. \n");
-        return 1;
-    }
-
-    /* 一括デコード */
-    if ((ret = SRLADecoder_DecodeWhole(decoder,
-                    buffer, buffer_size,
-                    (int32_t **)out_wav->data, out_wav->format.num_channels, out_wav->format.num_samples))
-                != SRLA_APIRESULT_OK) {
-        fprintf(stderr, "Decoding error! %d \n", ret);
-        return 1;
-    }
 
-    /* WAVファイル書き出し */
-    if (WAV_WriteToFile(out_filename, out_wav) != WAV_APIRESULT_OK) {
-        fprintf(stderr, "Failed to write wav file. \n");
-        return 1;
+    /* シングルスレッドの場合はブロック毎に書き出し、出力全体を保持しない */
+    if (num_threads == 1) {
+        err = do_stream_decode(decoder, buffer, buffer_size, &header, &wav_format, out_filename);
+    } else {
+        err = do_whole_decode(decoder, num_threads, buffer, buffer_size, &wav_format, out_filename);
     }
 
-    free(buffer);
-    WAV_Destroy(out_wav);
+    MappedFile_Close(in_file);
     SRLADecoder_Destroy(decoder);
 
-    return 0;
+    return err;
 }
 
 /* 使用法の表示 */
@@ -248,6 +592,7 @@ int main(int argc, char** argv)
     const char *filename_ptr[2] = { NULL, NULL };
     const char *input_file;
     const char *output_file;
+    uint32_t num_threads = DEFALUT_NUM_THREADS;
 
     /* 引数が足らない */
     if (argc == 1) {
@@ -294,6 +639,21 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    /* スレッド数の取得 */
+    if (CommandLineParser_GetOptionAcquired(command_line_spec, "num-threads") == COMMAND_LINE_PARSER_TRUE) {
+        char *e;
+        const char *lstr = CommandLineParser_GetArgumentString(command_line_spec, "num-threads");
+        num_threads = (uint32_t)strtol(lstr, &e, 10);
+        if (*e != '\0') {
+            fprintf(stderr, "%s: invalid number of threads. (irregular character found in %s at %s)\n", argv[0], lstr, e);
+            return 1;
+        }
+        if ((num_threads == 0) || (num_threads > SRLA_MAX_NUM_THREADS)) {
+            fprintf(stderr, "%s: number of threads is out of range. \n", argv[0]);
+            return 1;
+        }
+    }
+
     if (CommandLineParser_GetOptionAcquired(command_line_spec, "decode") == COMMAND_LINE_PARSER_TRUE) {
         /* デコード */
         uint8_t crc_check = 1;
@@ -302,7 +662,7 @@ int main(int argc, char** argv)
             crc_check = 0;
         }
         /* 一括デコード実行 */
-        if (do_decode(input_file, output_file, crc_check) != 0) {
+        if (do_decode(input_file, output_file, crc_check, num_threads) != 0) {
             fprintf(stderr, "%s: failed to decode %s. \n", argv[0], input_file);
             return 1;
         }
@@ -314,6 +674,9 @@ int main(int argc, char** argv)
         uint32_t lookahead_samples_factor = DEFALUT_LOOKAHEAD_SAMPLES_FACTOR;
         uint32_t ltp_order = 0;
         uint32_t num_svr_filter_learning_iteration = DEFALUT_NUM_SVR_FILTER_LEARNING_ITERATIONS;
+        uint8_t estimate_partition_cost = 0;
+        uint8_t sliding_lookahead = 0;
+        uint32_t seek_table_interval = 0;
         /* エンコードプリセット番号取得 */
         if (CommandLineParser_GetOptionAcquired(command_line_spec, "mode") == COMMAND_LINE_PARSER_TRUE) {
             char *e;
@@ -397,10 +760,33 @@ int main(int argc, char** argv)
                 return 1;
             }
         }
+        /* 可変ブロック分割探索で推定符号長を使うか */
+        if (CommandLineParser_GetOptionAcquired(command_line_spec, "estimate-block-partition") == COMMAND_LINE_PARSER_TRUE) {
+            estimate_partition_cost = 1;
+        }
+        /* 先読み区間をスライドさせるか */
+        if (CommandLineParser_GetOptionAcquired(command_line_spec, "sliding-lookahead") == COMMAND_LINE_PARSER_TRUE) {
+            sliding_lookahead = 1;
+            /* 先読みサンプル数倍率の指定がなければスライド用のデフォルト値を使用 */
+            if (CommandLineParser_GetOptionAcquired(command_line_spec, "lookahead-sample-factor") != COMMAND_LINE_PARSER_TRUE) {
+                lookahead_samples_factor = DEFALUT_SLIDING_LOOKAHEAD_SAMPLES_FACTOR;
+            }
+        }
+        /* シークテーブルのシーク点間隔 */
+        if (CommandLineParser_GetOptionAcquired(command_line_spec, "seek-table-interval") == COMMAND_LINE_PARSER_TRUE) {
+            char *e;
+            const char *lstr = CommandLineParser_GetArgumentString(command_line_spec, "seek-table-interval");
+            seek_table_interval = (uint32_t)strtol(lstr, &e, 10);
+            if (*e != '\0') {
+                fprintf(stderr, "%s: invalid seek table interval. (irregular character found in %s at %s)\n", argv[0], lstr, e);
+                return 1;
+            }
+        }
         /* 一括エンコード実行 */
         if (do_encode(input_file, output_file,
             encode_preset_no, max_num_block_samples, variable_block_num_divisions,
-            lookahead_samples_factor, ltp_order, num_svr_filter_learning_iteration) != 0) {
+            lookahead_samples_factor, ltp_order, num_svr_filter_learning_iteration,
+            estimate_partition_cost, sliding_lookahead, seek_table_interval, num_threads) != 0) {
             fprintf(stderr, "%s: failed to encode %s. \n", argv[0], input_file);
             return 1;
         }
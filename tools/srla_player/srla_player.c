@@ -1,15 +1,10 @@
 #include "srla_player.h"
 #include <srla_decoder.h>
+#include "mapped_file.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/stat.h>
-
-/* Windows環境で64bitファイル長向けstatを使うため、statを差し替え */
-#if defined(WIN32)
-#define stat _stat64
-#endif
 
 /* 出力要求コールバック */
 static void SRLAPlayer_SampleRequestCallback(int32_t **buffer, uint32_t num_channels, uint32_t num_samples);
@@ -23,7 +18,8 @@ static int32_t *decode_buffer[SRLA_MAX_NUM_CHANNELS] = { NULL, };
 static uint32_t num_buffered_samples = 0;
 static uint32_t buffer_pos = 0;
 static uint32_t data_size = 0;
-static uint8_t *data = NULL;
+static const uint8_t *data = NULL;
+static struct MappedFile *in_file = NULL;
 static uint32_t decode_offset = 0;
 static struct SRLADecoder* decoder = NULL;
 
@@ -34,37 +30,41 @@ int main(int argc, char **argv)
     SRLAApiResult ret;
     struct SRLADecoderConfig decoder_config;
     struct SRLAPlayerConfig player_config;
+    double start_time = 0.0;
 
     /* 引数チェック 間違えたら使用方法を提示 */
-    if (argc != 2) {
-        printf("Usage: %s SRLAFILE \n", argv[0]);
+    if ((argc != 2) && (argc != 3)) {
+        printf("Usage: %s SRLAFILE [START_TIME_SEC] \n", argv[0]);
         return 1;
     }
 
-    /* lnnファイルのロード */
+    /* 再生開始位置 */
+    if (argc == 3) {
+        char *e;
+        start_time = strtod(argv[2], &e);
+        if ((*e != '\0') || (start_time < 0.0)) {
+            fprintf(stderr, "Invalid start time: %s \n", argv[2]);
+            return 1;
+        }
+    }
+
+    /* ファイルをマップ */
+    /* 補足）全体を読み込まず、マップした領域を直接デコーダに渡す */
     {
-        struct stat fstat;
-        FILE* fp;
         const char *filename = argv[1];
 
-        /* ファイルオープン */
-        if ((fp = fopen(filename, "rb")) == NULL) {
+        if ((in_file = MappedFile_Open(filename, MAPPED_FILE_ACCESS_PATTERN_SEQUENTIAL)) == NULL) {
             fprintf(stderr, "Failed to open %s \n", filename);
             return 1;
         }
 
-        /* 入力ファイルのサイズ取得 / バッファ領域割り当て */
-        stat(filename, &fstat);
-        data_size = (uint32_t)fstat.st_size;
-        data = (uint8_t *)malloc(data_size);
-
-        /* バッファ領域にデータをロード */
-        if (fread(data, sizeof(uint8_t), data_size, fp) < data_size) {
-            fprintf(stderr, "Failed to load %s data \n", filename);
+        /* APIのデータサイズは32bitのため、それを越えるファイルは扱えない */
+        if (MappedFile_GetSize(in_file) > 0xFFFFFFFFUL) {
+            fprintf(stderr, "%s is too large \n", filename);
             return 1;
         }
-
-        fclose(fp);
+        data = MappedFile_GetData(in_file);
+        data_size = (uint32_t)MappedFile_GetSize(in_file);
     }
 
     /* ヘッダデコード */
@@ -75,8 +75,10 @@ int main(int argc, char **argv)
 
     /* デコーダハンドルの作成 */
     decoder_config.max_num_channels = header.num_channels;
+    decoder_config.max_num_samples_per_block = 0;
     decoder_config.max_num_parameters = SRLA_MAX_COEFFICIENT_ORDER;
     decoder_config.check_checksum = 1;
+    decoder_config.max_num_threads = 1;
     if ((decoder = SRLADecoder_Create(&decoder_config, NULL, 0)) == NULL) {
         fprintf(stderr, "Failed to create decoder handle. \n");
         return 1;
@@ -97,6 +99,31 @@ int main(int argc, char **argv)
     /* デコード位置をヘッダ分進める */
     decode_offset = SRLA_HEADER_SIZE;
 
+    /* 再生開始位置へシーク */
+    if (start_time > 0.0) {
+        uint32_t decode_size, num_skip_samples;
+        const uint32_t start_sample = (uint32_t)(start_time * header.sampling_rate);
+        if (start_sample >= header.num_samples) {
+            fprintf(stderr, "Start time exceeds the length of the file. \n");
+            return 1;
+        }
+        if ((ret = SRLADecoder_Seek(decoder, data, data_size, start_sample, &decode_offset, &num_skip_samples)) != SRLA_APIRESULT_OK) {
+            fprintf(stderr, "Failed to seek: %d \n", ret);
+            return 1;
+        }
+        /* シーク先のブロックをデコードし、先頭の余分なサンプルを読み捨てる */
+        if ((ret = SRLADecoder_DecodeBlock(decoder,
+                    &data[decode_offset], data_size - decode_offset,
+                    decode_buffer, header.num_channels, header.max_num_samples_per_block,
+                    &decode_size, &num_buffered_samples)) != SRLA_APIRESULT_OK) {
+            fprintf(stderr, "decoding error! \n");
+            return 1;
+        }
+        decode_offset += decode_size;
+        buffer_pos = num_skip_samples;
+        output_samples = start_sample;
+    }
+
     /* プレイヤー初期化 */
     player_config.sampling_rate = header.sampling_rate;
     player_config.num_channels = header.num_channels;
@@ -160,7 +187,7 @@ static void exit_srla_player(void)
         free(decode_buffer[i]);
     }
     SRLADecoder_Destroy(decoder);
-    free(data);
+    MappedFile_Close(in_file);
 
     exit(0);
 }